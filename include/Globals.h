@@ -1,7 +1,7 @@
 /**
  * @file Globals.h
  * @brief Gerenciador de recursos globais (Singleton)
- * @version 2.1.0
+ * @version 2.2.0
  */
 
 #ifndef GLOBALS_H
@@ -15,7 +15,6 @@
 // ========== DECLARAÇÕES EXTERNAS (compatibilidade) ==========
 // Mutexes
 extern SemaphoreHandle_t xSerialMutex;
-extern SemaphoreHandle_t xI2CMutex;
 extern SemaphoreHandle_t xDataMutex;
 
 // Semáforos
@@ -44,7 +43,6 @@ public:
     
     // Getters para mutexes
     SemaphoreHandle_t getSerialMutex() const { return _serialMutex; }
-    SemaphoreHandle_t getI2CMutex() const { return _i2cMutex; }
     SemaphoreHandle_t getDataMutex() const { return _dataMutex; }
     
     // Getters para semáforos
@@ -67,7 +65,6 @@ private:
     
     // Mutexes
     SemaphoreHandle_t _serialMutex = NULL;
-    SemaphoreHandle_t _i2cMutex = NULL;
     SemaphoreHandle_t _dataMutex = NULL;
     
     // Semáforos
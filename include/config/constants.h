@@ -11,7 +11,7 @@
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 1.1.0
+ * @version 1.3.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -41,7 +41,55 @@
 // I2C
 //=============================================================================
 #define I2C_FREQUENCY 100000    ///< Frequência do barramento (100kHz standard)
-#define I2C_TIMEOUT_MS 3000     ///< Timeout de operações I2C     
+#define I2C_TIMEOUT_MS 10       ///< Timeout do Wire por transação (latência limitada)
+#define I2C_TIMEOUT_LONG_MS 30  ///< Rajadas longas (lote do FIFO do IMU: 252 B ~ 23 ms)
+#define I2C_RECOVERY_THRESHOLD 3    ///< Erros TIMEOUT/BUS seguidos que disparam recuperação
+#define I2C_ACQUIRE_TIMEOUT_MS 50   ///< Espera padrão pela posse do barramento
+#define I2C_AGING_MS 20             ///< Espera que promove uma prioridade (anti-inanição)
+
+//=============================================================================
+// IMU (MPU9250)
+//=============================================================================
+#define IMU_FIFO_RATE_HZ 200            ///< Amostragem no FIFO (4-1000 Hz; 0 = leitura direta)
+#define IMU_OUTPUT_RATE_HZ 50           ///< Saída após decimação (<= IMU_FIFO_RATE_HZ)
+#define IMU_TASK_TIMEOUT_MS 40          ///< FastTask drena mesmo sem interrupção
+
+//=============================================================================
+// AHRS (AttitudeEstimator)
+//=============================================================================
+#define AHRS_FIXED_POINT 0              ///< 1 = filtro em ponto fixo Q7.24; 0 = float
+#define AHRS_KP 1.0                     ///< Ganho proporcional de Mahony (1/s)
+#define AHRS_KI 0.02                    ///< Ganho integral (estimativa de bias do gyro)
+#define AHRS_BIAS_LIMIT_DPS 5.0         ///< Maior bias estimável por eixo (°/s)
+#define AHRS_ACCEL_MIN_G 0.85f          ///< Faixa do acelerômetro aceita para corrigir
+#define AHRS_ACCEL_MAX_G 1.15f          ///< a inclinação pela gravidade (g)
+#define AHRS_MAG_MIN_UT 15.0f           ///< Faixa plausível do campo terrestre
+#define AHRS_MAG_MAX_UT 100.0f          ///< após calibração (µT)
+
+//=============================================================================
+// CALIBRAÇÃO CONTÍNUA DO MAGNETÔMETRO (MagCalibrator)
+//=============================================================================
+#define MAG_CAL_MIN_SAMPLES 300         ///< Amostras aceitas antes da primeira solução
+#define MAG_CAL_MIN_STEP_UT 2.0f        ///< Distância mínima entre amostras aceitas (µT)
+#define MAG_CAL_MAX_RESIDUAL_PCT 3.0f   ///< Erro radial RMS máximo para aceitar (%)
+#define MAG_CAL_AUTO_SAVE 1             ///< 1 = grava na NVS ao convergir
+
+//=============================================================================
+// GPS (protocolo UBX)
+//=============================================================================
+#define GPS_NAV_RATE_HZ 5               ///< Soluções NAV-PVT por segundo (1-10)
+#define GPS_NAV_DOP_DIVIDER 5           ///< NAV-DOP a cada N soluções (0 = desligado)
+#define GPS_RX_BUFFER_SIZE 4096         ///< Ring buffer do driver UART (bytes, ~3,9 s a 10 Hz)
+#define GPS_UART_EVENT_QUEUE 16         ///< Fila de eventos UART (ISR -> GpsTask)
+#define GPS_RX_IDLE_SYMBOLS 4           ///< Linha parada por N bytes: evento de fim de rajada
+#define GPS_TASK_TIMEOUT_MS 100         ///< Espera máxima da GpsTask por evento (ms)
+#define GPS_MAX_HACC_M 50.0f            ///< hAcc máximo para aceitar a posição (m)
+#define GPS_RECONFIG_MS 5000            ///< Sem frames UBX por este tempo: reconfigura
+
+//=============================================================================
+// AMOSTRAGEM (SensorsTask)
+//=============================================================================
+#define SENSOR_TICK_MS 10               ///< Tick da SensorsTask (SensorScheduler)
 
 //=============================================================================
 // POWER MANAGEMENT
@@ -58,6 +106,13 @@
 #define HTTP_TIMEOUT_MS 5000            ///< Timeout requisição HTTP
 #define SYSTEM_HEALTH_INTERVAL 10000    ///< Intervalo verificação saúde
 
+//=============================================================================
+// RELÓGIO (RTC DS3231 + esp_timer)
+//=============================================================================
+#define RTC_REANCHOR_INTERVAL_MS 600000 ///< Releitura do DS3231 (10 min)
+#define RTC_DRIFT_MIN_BASELINE_S 3600   ///< Base mínima para estimar deriva
+#define RTC_DRIFT_MAX_PPM 200.0f        ///< Limite da correção de deriva
+
 //=============================================================================
 // WATCHDOG (segundos)
 //=============================================================================
@@ -92,6 +147,7 @@
 //=============================================================================
 #define PAYLOAD_MAX_SIZE 64             ///< Tamanho máximo payload
 #define MAX_GROUND_NODES 3              ///< Máximo de ground nodes
+#define MISSION_BATCH_MAX 16            ///< Pacotes de missão aguardando a StorageTask
 #define NODE_TTL_MS 1800000             ///< TTL de nó (30 min)             
 
 //=============================================================================
@@ -101,6 +157,43 @@
 #define SD_MISSION_FILE "/mission.csv"  ///< Arquivo de missão
 #define SD_SYSTEM_LOG "/system.log"     ///< Log do sistema
 #define SD_MAX_FILE_SIZE 5242880        ///< Tamanho máximo (5MB)
+#define SD_BINARY_LOG_FILE "/telemetry.bin" ///< Telemetria em formato binário
+#define SD_TELEMETRY_BINARY false       ///< Gravar telemetria em binário (em vez de CSV)
+#define SD_MOUNT_POINT "/sd"            ///< Ponto de montagem VFS do SD (truncate)
+#define SD_SPARE_SUFFIX ".next"         ///< Sufixo do arquivo pré-alocado reserva
+#define SD_CHECKPOINT_INTERVAL 32768    ///< Bytes entre checkpoints do fim lógico (NVS)
+#define STORAGE_IDLE_MS 1000            ///< Espera da StorageTask antes da manutenção
+#define SD_INDEX_SUFFIX ".idx"          ///< Sufixo do índice temporal (timestamp -> offset)
+#define SD_INDEX_STRIDE 8192            ///< Bytes de log entre entradas do índice
+#define SD_INDEX_CATCHUP_BYTES 65536    ///< Bytes reindexados por chamada ociosa
+#define SD_ARCHIVE_ENABLED true         ///< Comprimir arquivos .bak em segundo plano
+#define SD_ARCHIVE_SUFFIX ".lzs"        ///< Sufixo dos .bak comprimidos (LZSS)
+#define SD_ARCHIVE_SLICE_BYTES 8192     ///< Bytes comprimidos/verificados por chamada ociosa
+#define SD_ARCHIVE_SCAN_MS 60000        ///< Intervalo entre buscas por novos .bak
+#define SD_ARCHIVE_MAX_SKIPPED 8        ///< .bak com falha lembrados (não retentados até o SD remontar)
+#define SD_RETENTION_CAPACITY_MB 0      ///< Orçamento dos logs no SD (0 = cartão inteiro)
+#define SD_RETENTION_RESERVE_BYTES (4UL * SD_MAX_FILE_SIZE) ///< Livre mínimo mantido por remoção
+#define SD_RETENTION_LOW_PCT 10         ///< Livre abaixo disto (% do orçamento) = nível BAIXO
+#define SD_RETENTION_RESCAN_MS 600000   ///< Intervalo de reconciliação da contabilidade
+#define SD_QUOTA_TELEMETRY_PCT 70       ///< Cota da telemetria (% do orçamento)
+#define SD_QUOTA_MISSION_PCT 20         ///< Cota dos dados de missão (% do orçamento)
+#define SD_QUOTA_SYSTEM_PCT 5           ///< Cota do system.log (% do orçamento)
+#define SD_COLUMNAR_ARCHIVE false       ///< Cópia colunar da telemetria (análise pós-voo)
+#define SD_COLUMNAR_FILE "/telemetry.col" ///< Arquivo colunar (ColumnarFormat.h)
+#define SD_COLUMNAR_GROUP 64            ///< Registros por grupo colunar (RAM: 119 bytes cada)
+#define SD_COLUMNAR_MAX_AGE_MS 300000   ///< Grupo parcial gravado após este tempo
+#define SD_STALL_US 100000              ///< Registro acima disto no SD conta como stall
+#define SD_STATS_LOG_MS 600000          ///< Intervalo do resumo de latência no system.log
+#define REPLAY_MAX_RECORDS 20           ///< Registros por comando REPLAY (LoRa)
+#define QUERY_MAX_RECORDS 500           ///< Registros por comando QUERY (Serial)
+#define QUERY_CHUNK_RECORDS 25          ///< Registros por fatia da StorageTask
+#define FALLBACK_ENABLED true           ///< Gravar na flash interna (LittleFS) com o SD fora
+#define FALLBACK_DIR "/fb"              ///< Diretório do anel no LittleFS
+#define FALLBACK_SEGMENT_BYTES 65536    ///< Tamanho de cada segmento do anel
+#define FALLBACK_SEGMENTS 8             ///< Segmentos no anel (limite = 512KB)
+#define FALLBACK_BUFFER_BYTES 2048      ///< Registros agrupados em RAM por gravação
+#define FALLBACK_FLUSH_MS 5000          ///< Idade máxima do buffer em RAM
+#define FALLBACK_MIGRATE_RECORDS 32     ///< Registros migrados ao SD por chamada ociosa
 
 //=============================================================================
 // DEBUG
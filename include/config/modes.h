@@ -10,7 +10,7 @@
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 1.2.0
+ * @version 1.3.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -25,6 +25,11 @@
  * | Telemetry Interval | 20s       | 60s     | 120s     |
  * | Storage Interval   | 1s        | 10s     | 300s     |
  * | Beacon             | -         | -       | 180s     |
+ * | Barômetro          | 100ms     | 100ms   | 1s       |
+ * | Umidade (SI7021)   | 2s        | 2s      | 10s      |
+ * | Ar (CCS811)        | 2s        | 2s      | 10s      |
+ * | GPS (UART)         | 100ms     | 100ms   | 100ms    |
+ * | Bateria (ADC)      | 1s        | 1s      | 5s       |
  * 
  * ## Diagrama de Estados
  * ```
@@ -70,6 +75,18 @@ enum OperationMode : uint8_t {
 // ESTRUTURA DE CONFIGURAÇÃO DE MODO
 //=============================================================================
 
+/**
+ * @struct SensorRates
+ * @brief Períodos de amostragem do SensorScheduler (ms, múltiplos de SENSOR_TICK_MS)
+ */
+struct SensorRates {
+    uint16_t baroMs;               ///< BMP280
+    uint16_t humidityMs;           ///< SI7021 (disparo; coleta ~30ms depois)
+    uint16_t airMs;                ///< CCS811 + compensação ambiental
+    uint16_t gpsMs;                ///< Drenagem da UART do GPS (sem GpsTask)
+    uint16_t powerMs;              ///< Média do ADC da bateria
+};
+
 /**
  * @struct ModeConfig
  * @brief Configurações específicas para cada modo de operação
@@ -82,6 +99,7 @@ struct ModeConfig {
     uint32_t telemetrySendInterval;///< Intervalo de envio LoRa (ms)
     uint32_t storageSaveInterval;  ///< Intervalo de gravação SD (ms)
     uint32_t beaconInterval;       ///< Intervalo de beacon (ms, 0=desabilitado)
+    SensorRates sensorRates;       ///< Períodos de amostragem dos sensores
 };
 
 //=============================================================================
@@ -100,7 +118,14 @@ const ModeConfig PREFLIGHT_CONFIG = {
     .httpEnabled = true,
     .telemetrySendInterval = 20000,   // 20s - frequente para testes
     .storageSaveInterval = 1000,      // 1s - máxima resolução
-    .beaconInterval = 0               // Sem beacon
+    .beaconInterval = 0,              // Sem beacon
+    .sensorRates = {
+        .baroMs = 100,
+        .humidityMs = 2000,
+        .airMs = 2000,
+        .gpsMs = 100,                 // Só sem GpsTask (polling da UART)
+        .powerMs = 1000
+    }
 };
 
 /**
@@ -115,7 +140,14 @@ const ModeConfig FLIGHT_CONFIG = {
     .httpEnabled = true,
     .telemetrySendInterval = 60000,   // 60s - economia de duty cycle
     .storageSaveInterval = 10000,     // 10s - balanço resolução/espaço
-    .beaconInterval = 0               // Sem beacon
+    .beaconInterval = 0,              // Sem beacon
+    .sensorRates = {
+        .baroMs = 100,
+        .humidityMs = 2000,
+        .airMs = 2000,
+        .gpsMs = 100,                 // Só sem GpsTask (polling da UART)
+        .powerMs = 1000
+    }
 };
 
 /**
@@ -130,7 +162,14 @@ const ModeConfig SAFE_CONFIG = {
     .httpEnabled = false,             // HTTP desabilitado (economia)
     .telemetrySendInterval = 120000,  // 2min - máxima economia
     .storageSaveInterval = 300000,    // 5min - mínimo uso de SD
-    .beaconInterval = 180000          // 3min - beacon de localização
+    .beaconInterval = 180000,         // 3min - beacon de localização
+    .sensorRates = {
+        .baroMs = 1000,               // Economia: ambiente e bateria mais lentos
+        .humidityMs = 10000,
+        .airMs = 10000,
+        .gpsMs = 100,                 // Posição do beacon
+        .powerMs = 5000
+    }
 };
 
 #endif // MODES_H
@@ -11,7 +11,7 @@
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 1.1.0
+ * @version 1.2.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -27,7 +27,8 @@
  * │                  ├─ MOSI: GPIO27    │
  * │  I2C (Wire)      ├─ CS:   GPIO18    │
  * │  ├─ SDA: GPIO21  ├─ RST:  GPIO23    │
- * │  └─ SCL: GPIO22  └─ DIO0: GPIO26    │
+ * │  ├─ SCL: GPIO22  └─ DIO0: GPIO26    │
+ * │  └─ INT: GPIO36 (MPU9250)           │
  * │                                     │
  * │  SD Card (HSPI)  Outros             │
  * │  ├─ CS:   GPIO13 ├─ LED:  GPIO25    │
@@ -49,7 +50,9 @@
 //=============================================================================
 #define GPS_RX_PIN 34           ///< RX do GPS (entrada, somente leitura)
 #define GPS_TX_PIN 12           ///< TX para GPS (saída)
-#define GPS_BAUD_RATE 9600      ///< Baudrate padrão NEO-6M/M8N
+#define GPS_BAUD_RATE 9600      ///< Baudrate de fábrica NEO-6M/M8N (NMEA)
+#define GPS_UBX_BAUD_RATE 38400 ///< Baudrate após configurar o receptor (UBX)
+#define GPS_UART_NUM UART_NUM_2 ///< Porta do driver ESP-IDF (driver/uart.h)
 
 //=============================================================================
 // LORA SX1276 (VSPI)
@@ -71,6 +74,13 @@
 //=============================================================================
 #define SENSOR_I2C_SDA 21       ///< I2C Data
 #define SENSOR_I2C_SCL 22       ///< I2C Clock
+/**
+ * INT do MPU9250 (data-ready; -1 = não conectado). GPIO36 tem bordas falsas
+ * com ADC/WiFi ativos (errata 3.11 do ESP32, vale também para o 39), mas é
+ * a única entrada livre sem strapping: GPIO32/33 vão ao DIO2/DIO1 do
+ * SX1276 nesta placa. MPU9250Manager confere os pulsos com o FIFO_COUNT.
+ */
+#define MPU9250_INT_PIN 36
 
 //=============================================================================
 // POWER MANAGEMENT
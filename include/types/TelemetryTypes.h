@@ -7,11 +7,12 @@
  *          - TelemetryData: Dados dos sensores locais
  *          - MissionData: Dados dos ground nodes
  *          - GroundNodeBuffer: Buffer de nós coletados
+ *          - Fast/SlowSensorSnapshot: Instantâneos das tasks de sensores
  *          - Mensagens de fila para tasks assíncronas
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 1.2.0
+ * @version 1.5.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -19,7 +20,8 @@
  * ## Tamanhos de Estruturas
  * | Estrutura        | Tamanho Aprox. | Uso                    |
  * |------------------|----------------|------------------------|
- * | TelemetryData    | ~160 bytes     | Dados locais           |
+ * | TelemetryData    | ~170 bytes     | Dados locais           |
+ * | Fast/SlowSnapshot| ~70 bytes      | Instantâneos de tasks  |
  * | MissionData      | ~80 bytes      | Dados de ground node   |
  * | GroundNodeBuffer | ~260 bytes     | Buffer de 3 nós        |
  * | HttpQueueMessage | ~420 bytes     | Fila HTTP              |
@@ -111,6 +113,9 @@ struct TelemetryData {
     //--- IMU: Magnetômetro (µT) ---
     float magX, magY, magZ;
     
+    //--- Atitude (AHRS a bordo, graus; NAN até inicializar) ---
+    float roll, pitch, yaw;
+    
     //--- Ambiente ---
     float humidity;               ///< Umidade relativa (%)
     float co2;                    ///< eCO2 (ppm)
@@ -131,6 +136,48 @@ struct TelemetryData {
     char payload[64];             ///< Payload customizado
 };
 
+//=============================================================================
+// INSTANTÂNEOS DAS TASKS DE SENSORES
+//=============================================================================
+
+/**
+ * @struct FastSensorSnapshot
+ * @brief Publicado pela FastTask (IMU + barômetro) a cada ciclo
+ */
+struct FastSensorSnapshot {
+    uint32_t timestampMs;         ///< millis() da publicação
+    float gyroX, gyroY, gyroZ;    ///< Giroscópio (°/s)
+    float accelX, accelY, accelZ; ///< Acelerômetro (g)
+    float magX, magY, magZ;       ///< Magnetômetro (µT)
+    float roll, pitch, yaw;       ///< Atitude AHRS (°; NAN até inicializar)
+    float temperatureBMP;         ///< Temperatura BMP280 (°C)
+    float pressure;               ///< Pressão (hPa)
+    float altitude;               ///< Altitude barométrica (m)
+    bool imuOnline;               ///< MPU9250 respondendo?
+    bool baroOnline;              ///< BMP280 respondendo?
+};
+
+/**
+ * @struct SlowSensorSnapshot
+ * @brief Publicado pela SensorsTask (ambiente, GPS, bateria) a cada tick
+ */
+struct SlowSensorSnapshot {
+    uint32_t timestampMs;         ///< millis() da publicação
+    float temperatureSI;          ///< Temperatura SI7021 (°C)
+    float humidity;               ///< Umidade relativa (%)
+    float co2;                    ///< eCO2 (ppm)
+    float tvoc;                   ///< TVOC (ppb)
+    double latitude;              ///< Latitude (graus decimais)
+    double longitude;             ///< Longitude (graus decimais)
+    float gpsAltitude;            ///< Altitude GPS (m)
+    float batteryVoltage;         ///< Tensão (V)
+    float batteryPercentage;      ///< Carga (%)
+    uint8_t satellites;           ///< Satélites no fix
+    bool gpsFix;                  ///< Fix válido?
+    bool si7021Online;            ///< SI7021 respondendo?
+    bool ccs811DataValid;         ///< CCS811 online e aquecido?
+};
+
 //=============================================================================
 // DADOS DE MISSÃO (GROUND NODES)
 //=============================================================================
@@ -212,6 +259,15 @@ struct HttpQueueMessage {
     GroundNodeBuffer nodes;   ///< Buffer de ground nodes
 };
 
+/**
+ * @enum StorageSignal
+ * @brief Sinal de 1 byte enviado na xStorageQueue
+ */
+enum StorageSignal : uint8_t {
+    STORAGE_SIGNAL_SAVE = 1,   ///< Gravar o registro de s_storageData
+    STORAGE_SIGNAL_QUERY = 2   ///< Consulta QUERY/REPLAY pendente (acorda a task)
+};
+
 /**
  * @struct StorageQueueMessage
  * @brief Mensagem para fila de armazenamento SD
@@ -70,6 +70,9 @@ public:
     
     // Inicialização com endereço I2C especificado
     bool begin(uint8_t i2cAddress = I2C_ADDR_PRIMARY);
+
+    // Endereço em uso (0 antes do begin)
+    uint8_t getAddress() const { return _i2cAddress; }
     
     // Configuração avançada (opcional - defaults já otimizados)
     bool configure(Mode mode = Mode::NORMAL,
@@ -82,6 +85,17 @@ public:
     float readTemperature();    // Retorna temperatura em °C
     float readPressure();       // Retorna pressão em Pa
     float readAltitude(float seaLevelPressure = 101325.0f); // Altitude em metros
+
+    // Leitura completa: uma rajada de 6 bytes e uma compensação para os três
+    // valores (°C, Pa, m). Cada read*() acima faz sua própria rajada.
+    bool readAll(float& temperature, float& pressure, float& altitude,
+                 float seaLevelPressure = 101325.0f);
+
+    // Fórmula barométrica 44330 * (1 - (p/p0)^0.1903) por tabela com
+    // interpolação de Hermite: erro < 0.02 m para 0.25 <= p/p0 <= 1.25
+    // (máximo ~0.017 m na ponta de baixa pressão, p/p0 ~ 0.26; fora da
+    // faixa, usa powf). Conferido por tools/bmp280_golden.cpp
+    static float altitudeFromPressure(float pressure, float seaLevelPressure);
     
     // Utilitários
     bool isInitialized() const { return _initialized; }
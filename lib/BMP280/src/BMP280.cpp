@@ -1,5 +1,52 @@
 #include "BMP280.h"
 
+// ============================================================================
+// Tabela da fórmula barométrica: (p/p0)^0.1903 em 33 nós de 0.25 a 1.25
+// {valor, derivada * passo} para interpolação cúbica de Hermite
+// ============================================================================
+namespace {
+constexpr float ALT_EXPONENT = 0.1903f;
+constexpr float ALT_X0 = 0.25f;
+constexpr float ALT_INV_STEP = 32.0f;
+constexpr int ALT_SEGMENTS = 32;
+
+const float ALT_TABLE[ALT_SEGMENTS + 1][2] = {
+    {0.768118073f, 0.018271609f}, // 0.25000
+    {0.785529155f, 0.016609578f}, // 0.28125
+    {0.801438053f, 0.015251366f}, // 0.31250
+    {0.816106782f, 0.014118647f}, // 0.34375
+    {0.829732593f, 0.013158176f}, // 0.37500
+    {0.842467933f, 0.012332434f}, // 0.40625
+    {0.854433218f, 0.011614189f}, // 0.43750
+    {0.865725332f, 0.010983169f}, // 0.46875
+    {0.876423455f, 0.010423961f}, // 0.50000
+    {0.886593185f, 0.009924628f}, // 0.53125
+    {0.896289517f, 0.009475772f}, // 0.56250
+    {0.905559038f, 0.009069889f}, // 0.59375
+    {0.914441584f, 0.008700912f}, // 0.62500
+    {0.922971500f, 0.008363880f}, // 0.65625
+    {0.931178619f, 0.008054695f}, // 0.68750
+    {0.939089028f, 0.007769941f}, // 0.71875
+    {0.946725682f, 0.007506746f}, // 0.75000
+    {0.954108891f, 0.007262677f}, // 0.78125
+    {0.961256716f, 0.007035660f}, // 0.81250
+    {0.968185298f, 0.006823913f}, // 0.84375
+    {0.974909119f, 0.006625900f}, // 0.87500
+    {0.981441229f, 0.006440285f}, // 0.90625
+    {0.987793431f, 0.006265903f}, // 0.93750
+    {0.993976438f, 0.006101733f}, // 0.96875
+    {1.000000000f, 0.005946875f}, // 1.00000
+    {1.005873026f, 0.005800534f}, // 1.03125
+    {1.011603672f, 0.005662005f}, // 1.06250
+    {1.017199430f, 0.005530659f}, // 1.09375
+    {1.022667195f, 0.005405932f}, // 1.12500
+    {1.028013333f, 0.005287323f}, // 1.15625
+    {1.033243728f, 0.005174376f}, // 1.18750
+    {1.038363835f, 0.005066683f}, // 1.21875
+    {1.043378721f, 0.004963874f}, // 1.25000
+};
+} // namespace
+
 // ============================================================================
 // Construtor
 // ============================================================================
@@ -146,6 +193,35 @@ float BMP280::readPressure() {
     return press / 256.0f;
 }
 
+// ============================================================================
+// Leitura completa (uma rajada, uma compensação)
+// ============================================================================
+bool BMP280::readAll(float& temperature, float& pressure, float& altitude,
+                     float seaLevelPressure) {
+    if (!_initialized) {
+        return false;
+    }
+    
+    int32_t adcTemp = 0;
+    int32_t adcPress = 0;
+    
+    if (!_readRawData(adcTemp, adcPress)) {
+        return false;
+    }
+    
+    // Temperatura primeiro: atualiza _t_fine usado pela pressão
+    int32_t temp = _compensateTemp(adcTemp);
+    uint32_t press = _compensatePress(adcPress);
+    if (press == 0) {
+        return false;
+    }
+    
+    temperature = temp / 100.0f;
+    pressure = press / 256.0f;
+    altitude = altitudeFromPressure(pressure, seaLevelPressure);
+    return true;
+}
+
 // ============================================================================
 // Cálculo de altitude (fórmula barométrica internacional)
 // ============================================================================
@@ -155,8 +231,30 @@ float BMP280::readAltitude(float seaLevelPressure) {
         return NAN;
     }
     
+    return altitudeFromPressure(pressure, seaLevelPressure);
+}
+
+float BMP280::altitudeFromPressure(float pressure, float seaLevelPressure) {
     // Fórmula barométrica: h = 44330 * (1 - (p/p0)^(1/5.255))
-    return 44330.0f * (1.0f - pow(pressure / seaLevelPressure, 0.1903f));
+    float x = pressure / seaLevelPressure;
+    float u = (x - ALT_X0) * ALT_INV_STEP;
+    
+    if (!(u >= 0.0f && u < (float)ALT_SEGMENTS)) {
+        return 44330.0f * (1.0f - powf(x, ALT_EXPONENT));
+    }
+    
+    // Hermite cúbica entre os nós i e i+1 (t em [0, 1))
+    int i = (int)u;
+    float t = u - i;
+    float t2 = t * t;
+    float t3 = t2 * t;
+    
+    float f = (2.0f * t3 - 3.0f * t2 + 1.0f) * ALT_TABLE[i][0] +
+              (t3 - 2.0f * t2 + t) * ALT_TABLE[i][1] +
+              (3.0f * t2 - 2.0f * t3) * ALT_TABLE[i + 1][0] +
+              (t3 - t2) * ALT_TABLE[i + 1][1];
+    
+    return 44330.0f * (1.0f - f);
 }
 
 // ============================================================================
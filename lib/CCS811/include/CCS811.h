@@ -26,6 +26,7 @@ public:
     explicit CCS811(TwoWire& wire = Wire);
 
     bool begin(uint8_t addr = ADDR_5A);
+    uint8_t getAddress() const { return _addr; }
     void reset();
 
     // Controle
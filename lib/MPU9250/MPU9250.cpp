@@ -99,24 +99,112 @@ xyzFloat MPU9250::getGyrValues() {
 }
 
 xyzFloat MPU9250::getMagValues() {
-    if (!_magInitialized) return {0,0,0};
+    xyzFloat mag;
+    if (!readMag(mag)) return {0,0,0};
+    return mag;
+}
+
+bool MPU9250::readAll(xyzFloat& acc, xyzFloat& gyr, float& tempC) {
+    // ACCEL_XOUT_H (0x3B) .. GYRO_ZOUT_L (0x48): accel, temperatura e gyro
+    // da mesma amostra em uma única transação
+    uint8_t buf[FIFO_FRAME];
+    if (!_readBytes(_addr, REG_ACCEL_XOUT_H, buf, FIFO_FRAME)) return false;
+    parseFrame(buf, acc, gyr, tempC);
+    return true;
+}
 
-    // Verificar DRDY
-    uint8_t st1 = _readRegister(AK8963_ADDR, AK8963_ST1);
-    if (!(st1 & 0x01)) return {0,0,0}; // Sem dados novos
+void MPU9250::parseFrame(const uint8_t* f, xyzFloat& acc, xyzFloat& gyr, float& tempC) {
+    int16_t ax = (int16_t)((f[0] << 8) | f[1]);
+    int16_t ay = (int16_t)((f[2] << 8) | f[3]);
+    int16_t az = (int16_t)((f[4] << 8) | f[5]);
+    int16_t t  = (int16_t)((f[6] << 8) | f[7]);
+    int16_t gx = (int16_t)((f[8] << 8) | f[9]);
+    int16_t gy = (int16_t)((f[10] << 8) | f[11]);
+    int16_t gz = (int16_t)((f[12] << 8) | f[13]);
+
+    acc = {ax * _accScale, ay * _accScale, az * _accScale};
+    gyr = {gx * _gyroScale, gy * _gyroScale, gz * _gyroScale};
+    tempC = t / 333.87f + 21.0f; // Datasheet: TEMP_degC = raw/333.87 + 21
+}
+
+bool MPU9250::readMag(xyzFloat& mag) {
+    if (!_magInitialized) return false;
+
+    // ST1 (0x02) .. ST2 (0x09) em rajada: DRDY vem junto com os dados e
+    // a leitura de ST2 libera o próximo dado (modo contínuo)
+    uint8_t buf[8];
+    if (!_readBytes(AK8963_ADDR, AK8963_ST1, buf, 8)) return false;
+
+    if (!(buf[0] & 0x01)) return false; // Sem dados novos (DRDY)
 
-    uint8_t buf[7];
-    if (!_readBytes(AK8963_ADDR, AK8963_HXL, buf, 7)) return {0,0,0};
-    
     // Verificar Overflow Magnético (HOFL bit)
-    if (buf[6] & 0x08) return {0,0,0};
+    if (buf[7] & 0x08) return false;
 
     // AK8963 é Little Endian
-    int16_t x = (int16_t)((buf[1] << 8) | buf[0]);
-    int16_t y = (int16_t)((buf[3] << 8) | buf[2]);
-    int16_t z = (int16_t)((buf[5] << 8) | buf[4]);
+    int16_t x = (int16_t)((buf[2] << 8) | buf[1]);
+    int16_t y = (int16_t)((buf[4] << 8) | buf[3]);
+    int16_t z = (int16_t)((buf[6] << 8) | buf[5]);
+
+    mag = {x * _magScale, y * _magScale, z * _magScale};
+    return true;
+}
+
+// === FIFO ===
+
+uint16_t MPU9250::enableFifo(uint16_t rateHz) {
+    if (rateHz < 4) rateHz = 4;
+    if (rateHz > 1000) rateHz = 1000;
+
+    // Taxa interna de 1 kHz com DLPF ativo: rate = 1000 / (1 + SMPLRT_DIV)
+    uint8_t div = (uint8_t)(1000 / rateHz - 1);
+    uint16_t rate = 1000 / (1 + div);
+
+    // DLPF (gyro e accel) abaixo de Nyquist: 184, 92, 41, 20, 10 Hz
+    static const uint16_t bw[] = {184, 92, 41, 20, 10};
+    uint8_t dlpf = 1;
+    while (dlpf < 5 && bw[dlpf - 1] * 2 > rate) dlpf++;
+
+    bool ok = true;
+    ok &= _writeRegister(_addr, REG_USER_CTRL, 0x00);        // FIFO parado
+    ok &= _writeRegister(_addr, REG_SMPLRT_DIV, div);
+    ok &= _writeRegister(_addr, REG_CONFIG, 0x40 | dlpf);    // FIFO_MODE: não sobrescreve
+    ok &= _writeRegister(_addr, REG_ACCEL_CONFIG2, dlpf);
+    ok &= _writeRegister(_addr, REG_FIFO_EN, 0xF8);          // TEMP + GYRO XYZ + ACCEL
+    ok &= _writeRegister(_addr, REG_USER_CTRL, 0x04);        // FIFO_RST
+    ok &= _writeRegister(_addr, REG_USER_CTRL, 0x40);        // FIFO_EN
+    return ok ? rate : 0;
+}
+
+void MPU9250::disableFifo() {
+    _writeRegister(_addr, REG_FIFO_EN, 0x00);
+    _writeRegister(_addr, REG_USER_CTRL, 0x04);
+    _writeRegister(_addr, REG_SMPLRT_DIV, 0x00);
+    _writeRegister(_addr, REG_CONFIG, 0x03);      // DLPF ~41Hz
+}
+
+void MPU9250::resetFifo() {
+    // FIFO_RST é limpo pelo hardware; FIFO_EN reescrito no mesmo valor
+    _writeRegister(_addr, REG_USER_CTRL, 0x44);
+}
+
+int16_t MPU9250::fifoCount() {
+    uint8_t buf[2];
+    if (!_readBytes(_addr, REG_FIFO_COUNTH, buf, 2)) return -1;
+    return (int16_t)(((buf[0] & 0x1F) << 8) | buf[1]);
+}
+
+bool MPU9250::readFifo(uint8_t* buf, uint8_t frames) {
+    // Leituras em rajada de FIFO_R_W consomem o FIFO (sem auto-incremento)
+    if (frames == 0 || frames > 255 / FIFO_FRAME) return false;
+    return _readBytes(_addr, REG_FIFO_R_W, buf, frames * FIFO_FRAME);
+}
 
-    return {x * _magScale, y * _magScale, z * _magScale};
+bool MPU9250::enableDataReadyInterrupt(bool enable) {
+    // INT_PIN_CFG: preserva só BYPASS_EN (ativo alto, push-pull, pulso)
+    uint8_t cfg = _readRegister(_addr, REG_INT_PIN_CFG) & 0x02;
+    bool ok = _writeRegister(_addr, REG_INT_PIN_CFG, cfg);
+    ok &= _writeRegister(_addr, REG_INT_ENABLE, enable ? 0x01 : 0x00); // RAW_RDY_EN
+    return ok;
 }
 
 // === Helpers I2C ===
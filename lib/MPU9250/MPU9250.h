@@ -37,6 +37,23 @@ public:
     xyzFloat getGyrValues();    // Giroscópio (°/s)
     xyzFloat getMagValues();    // Magnetômetro (µT) - Retorna (0,0,0) se inválido
 
+    // Leitura em rajada (uma transação por sensor)
+    bool readAll(xyzFloat& acc, xyzFloat& gyr, float& tempC); // ACCEL..GYRO (14 bytes)
+    bool readMag(xyzFloat& mag); // ST1..ST2 (8 bytes) - false se sem dado novo
+
+    // FIFO (quadro = ACCEL, TEMP, GYRO na mesma ordem de readAll)
+    static constexpr uint16_t FIFO_SIZE  = 512; // Bytes
+    static constexpr uint8_t  FIFO_FRAME = 14;  // Bytes por amostra
+    uint16_t enableFifo(uint16_t rateHz); // Retorna a taxa efetiva (Hz); 0 = falha
+    void disableFifo();
+    void resetFifo();
+    int16_t fifoCount();                  // Bytes no FIFO; -1 = erro I2C
+    bool readFifo(uint8_t* buf, uint8_t frames);
+    void parseFrame(const uint8_t* f, xyzFloat& acc, xyzFloat& gyr, float& tempC);
+
+    // Pino INT: pulso de 50us ativo alto (push-pull) a cada amostra
+    bool enableDataReadyInterrupt(bool enable);
+
     // Raw Reads (para diagnósticos)
     int16_t readRawAccelX();
     
@@ -52,10 +69,16 @@ private:
     static constexpr uint8_t REG_CONFIG       = 0x1A;
     static constexpr uint8_t REG_GYRO_CONFIG  = 0x1B;
     static constexpr uint8_t REG_ACCEL_CONFIG = 0x1C;
+    static constexpr uint8_t REG_ACCEL_CONFIG2= 0x1D;
+    static constexpr uint8_t REG_FIFO_EN      = 0x23;
     static constexpr uint8_t REG_INT_PIN_CFG  = 0x37;
+    static constexpr uint8_t REG_INT_ENABLE   = 0x38;
     static constexpr uint8_t REG_ACCEL_XOUT_H = 0x3B;
     static constexpr uint8_t REG_GYRO_XOUT_H  = 0x43;
+    static constexpr uint8_t REG_USER_CTRL    = 0x6A;
     static constexpr uint8_t REG_PWR_MGMT_1   = 0x6B;
+    static constexpr uint8_t REG_FIFO_COUNTH  = 0x72;
+    static constexpr uint8_t REG_FIFO_R_W     = 0x74;
     static constexpr uint8_t REG_WHO_AM_I     = 0x75;
 
     // Registradores AK8963
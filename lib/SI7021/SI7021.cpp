@@ -20,18 +20,15 @@ void SI7021::reset() {
     delay(50); // Datasheet: Powerup/Reset time ~15ms
 }
 
+bool SI7021::softReset() {
+    return _writeCommand(CMD_RESET);
+}
+
 bool SI7021::readHumidity(float& humidity) {
     uint16_t raw = _readSensorData(CMD_MEASURE_RH_NOHOLD);
     if (raw == 0xFFFF) return false;
 
-    // Fórmula Datasheet: %RH = ((125 * Code) / 65536) - 6
-    float val = (125.0f * raw) / 65536.0f - 6.0f;
-    
-    // Clamp 0-100%
-    if (val < 0.0f) val = 0.0f;
-    if (val > 100.0f) val = 100.0f;
-    
-    humidity = val;
+    humidity = _humidityFromRaw(raw);
     return true;
 }
 
@@ -39,8 +36,38 @@ bool SI7021::readTemperature(float& temperature) {
     uint16_t raw = _readSensorData(CMD_MEASURE_TEMP_NOHOLD);
     if (raw == 0xFFFF) return false;
 
-    // Fórmula Datasheet: Temp = ((175.72 * Code) / 65536) - 46.85
-    temperature = (175.72f * raw) / 65536.0f - 46.85f;
+    temperature = _temperatureFromRaw(raw);
+    return true;
+}
+
+bool SI7021::startHumidity() {
+    return _writeCommand(CMD_MEASURE_RH_NOHOLD);
+}
+
+SI7021::Result SI7021::fetchHumidity(float& humidity) {
+    // Em modo No Hold o sensor responde NACK à leitura até terminar
+    if (_wire->requestFrom(I2C_ADDR, (uint8_t)2) != 2) return Result::PENDING;
+
+    uint8_t msb = _wire->read();
+    uint8_t lsb = _wire->read();
+    uint16_t raw = (msb << 8) | lsb;
+    if (raw == 0xFFFF) return Result::ERROR;
+
+    humidity = _humidityFromRaw(raw);
+    return Result::OK;
+}
+
+bool SI7021::readPreviousTemperature(float& temperature) {
+    // Temperatura medida durante a última conversão de RH (sem conversão nova)
+    if (!_writeCommand(CMD_READ_TEMP_PREV)) return false;
+    if (_wire->requestFrom(I2C_ADDR, (uint8_t)2) != 2) return false;
+
+    uint8_t msb = _wire->read();
+    uint8_t lsb = _wire->read();
+    uint16_t raw = (msb << 8) | lsb;
+    if (raw == 0xFFFF) return false;
+
+    temperature = _temperatureFromRaw(raw);
     return true;
 }
 
@@ -62,6 +89,21 @@ uint8_t SI7021::getDeviceID() {
 
 // === Métodos Privados ===
 
+float SI7021::_humidityFromRaw(uint16_t raw) {
+    // Fórmula Datasheet: %RH = ((125 * Code) / 65536) - 6
+    float val = (125.0f * raw) / 65536.0f - 6.0f;
+    
+    // Clamp 0-100%
+    if (val < 0.0f) val = 0.0f;
+    if (val > 100.0f) val = 100.0f;
+    return val;
+}
+
+float SI7021::_temperatureFromRaw(uint16_t raw) {
+    // Fórmula Datasheet: Temp = ((175.72 * Code) / 65536) - 46.85
+    return (175.72f * raw) / 65536.0f - 46.85f;
+}
+
 bool SI7021::_writeCommand(uint8_t cmd) {
     _wire->beginTransmission(I2C_ADDR);
     _wire->write(cmd);
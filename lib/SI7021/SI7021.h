@@ -31,10 +31,26 @@ public:
     bool begin();
     void reset();
 
+    // Reset sem espera: só envia 0xFE. O sensor fica NACK por até RESET_MS;
+    // quem chama espera em outro ciclo antes de falar com ele de novo
+    static constexpr uint8_t RESET_MS = 15; // Datasheet: Powerup/Reset time
+    bool softReset();
+
     // Retorna true se leitura ok. Valores em humidity (%) e temperature (°C)
     bool readHumidity(float& humidity);
     bool readTemperature(float& temperature);
 
+    // Medição em duas fases (sem espera): startHumidity() dispara a conversão
+    // de RH, que também converte a temperatura; fetchHumidity() coleta em um
+    // ciclo posterior e readPreviousTemperature() lê a temperatura dessa
+    // mesma conversão (0xE0, sem nova medição)
+    enum class Result : uint8_t { OK, PENDING, ERROR };
+    static constexpr uint8_t CONVERSION_MS = 25; // RH 12ms + Temp 10.8ms (máx.)
+
+    bool startHumidity();
+    Result fetchHumidity(float& humidity); // PENDING = conversão em andamento (NACK)
+    bool readPreviousTemperature(float& temperature);
+
     // Utilitários
     uint8_t getDeviceID();
     bool isSensorPresent();
@@ -44,6 +60,8 @@ private:
     
     bool _writeCommand(uint8_t cmd);
     uint16_t _readSensorData(uint8_t cmd);
+    static float _humidityFromRaw(uint16_t raw);
+    static float _temperatureFromRaw(uint16_t raw);
 };
 
 #endif // SI7021_H
\ No newline at end of file
@@ -4,34 +4,37 @@
  */
 
 #include "TelemetryCollector.h"
-#include "sensors/SensorManager/SensorManager.h"
-#include "sensors/GPSManager/GPSManager.h"
-#include "core/PowerManager/PowerManager.h"
 #include "core/SystemHealth/SystemHealth.h"
 #include "core/RTCManager/RTCManager.h"
 #include "app/GroundNodeManager/GroundNodeManager.h"
 #include "app/MissionController/MissionController.h"
 
 TelemetryCollector::TelemetryCollector(
-    SensorManager& sensors,
-    GPSManager& gps,
-    PowerManager& power,
+    const SeqSnapshot<FastSensorSnapshot>& fast,
+    const SeqSnapshot<SlowSensorSnapshot>& slow,
     SystemHealth& health,
     RTCManager& rtc,
     GroundNodeManager& nodes,
     MissionController& mission
 ) :
-    _sensors(sensors),
-    _gps(gps),
-    _power(power),
+    _fastSource(fast),
+    _slowSource(slow),
     _health(health),
     _rtc(rtc),
     _nodes(nodes),
-    _mission(mission)
+    _mission(mission),
+    _snapshotMisses(0)
 {
+    // Até a primeira publicação: sensores offline, medidas inválidas
+    memset(&_fast, 0, sizeof(_fast));
+    memset(&_slow, 0, sizeof(_slow));
+    _fast.temperatureBMP = _fast.pressure = _fast.altitude = NAN;
+    _fast.roll = _fast.pitch = _fast.yaw = NAN;
+    _slow.batteryVoltage = _slow.batteryPercentage = NAN;
 }
 
 void TelemetryCollector::collect(TelemetryData& data) {
+    _readSnapshots();
     _collectTimestamp(data);
     _collectPowerAndSystem(data);
     _collectCoreSensors(data);
@@ -42,9 +45,15 @@ void TelemetryCollector::collect(TelemetryData& data) {
     _generateNodeSummary(data);
 }
 
+void TelemetryCollector::_readSnapshots() {
+    // Escritor no meio de uma publicação: fica a cópia anterior (<= 1 ciclo)
+    if (_fastSource.version() > 0 && !_fastSource.read(_fast)) _snapshotMisses++;
+    if (_slowSource.version() > 0 && !_slowSource.read(_slow)) _snapshotMisses++;
+}
+
 void TelemetryCollector::_collectTimestamp(TelemetryData& data) {
     if (_rtc.isInitialized()) {
-        data.timestamp = _rtc.getUnixTime();
+        data.timestamp = _rtc.getUnixTime();  // hora em cache, sem I2C
     } else {
         data.timestamp = millis() / 1000;
     }
@@ -53,25 +62,28 @@ void TelemetryCollector::_collectTimestamp(TelemetryData& data) {
 void TelemetryCollector::_collectPowerAndSystem(TelemetryData& data) {
     data.missionTime = _mission.getDuration();
     
-    data.batteryVoltage = _power.getVoltage();
-    data.batteryPercentage = _power.getPercentage();
+    data.batteryVoltage = _slow.batteryVoltage;
+    data.batteryPercentage = _slow.batteryPercentage;
     
     data.systemStatus = _health.getSystemStatus();
     data.errorCount = _health.getErrorCount();
 }
 
 void TelemetryCollector::_collectCoreSensors(TelemetryData& data) {
-    data.temperature = _sensors.getTemperature();
-    data.temperatureBMP = _sensors.getTemperatureBMP280();
-    data.pressure = _sensors.getPressure();
-    data.altitude = _sensors.getAltitude();
+    data.temperature = _fast.temperatureBMP;
+    data.temperatureBMP = _fast.temperatureBMP;
+    data.pressure = _fast.pressure;
+    data.altitude = _fast.altitude;
     
-    data.gyroX = _sensors.getGyroX();
-    data.gyroY = _sensors.getGyroY();
-    data.gyroZ = _sensors.getGyroZ();
-    data.accelX = _sensors.getAccelX();
-    data.accelY = _sensors.getAccelY();
-    data.accelZ = _sensors.getAccelZ();
+    data.gyroX = _fast.gyroX;
+    data.gyroY = _fast.gyroY;
+    data.gyroZ = _fast.gyroZ;
+    data.accelX = _fast.accelX;
+    data.accelY = _fast.accelY;
+    data.accelZ = _fast.accelZ;
+    data.roll = _fast.roll;
+    data.pitch = _fast.pitch;
+    data.yaw = _fast.yaw;
     
     data.temperatureSI = NAN;
     data.humidity = NAN;
@@ -83,47 +95,47 @@ void TelemetryCollector::_collectCoreSensors(TelemetryData& data) {
 }
 
 void TelemetryCollector::_collectGPS(TelemetryData& data) {
-    data.latitude = _gps.getLatitude();
-    data.longitude = _gps.getLongitude();
-    data.gpsAltitude = _gps.getAltitude();
-    data.satellites = _gps.getSatellites();
-    data.gpsFix = _gps.hasFix();
+    data.latitude = _slow.latitude;
+    data.longitude = _slow.longitude;
+    data.gpsAltitude = _slow.gpsAltitude;
+    data.satellites = _slow.satellites;
+    data.gpsFix = _slow.gpsFix;
 }
 
 void TelemetryCollector::_collectAndValidateSI7021(TelemetryData& data) {
-    if (!_sensors.isSI7021Online()) return;
+    if (!_slow.si7021Online) return;
     
-    float tempSI = _sensors.getTemperatureSI7021();
+    float tempSI = _slow.temperatureSI;
     if (!isnan(tempSI) && tempSI >= TEMP_MIN_VALID && tempSI <= TEMP_MAX_VALID) {
         data.temperatureSI = tempSI;
     }
     
-    float humidity = _sensors.getHumidity();
+    float humidity = _slow.humidity;
     if (!isnan(humidity) && humidity >= HUMIDITY_MIN_VALID && humidity <= HUMIDITY_MAX_VALID) {
         data.humidity = humidity;
     }
 }
 
 void TelemetryCollector::_collectAndValidateCCS811(TelemetryData& data) {
-    if (!_sensors.isCCS811DataValid()) return;
+    if (!_slow.ccs811DataValid) return;
     
-    float co2 = _sensors.getCO2();
+    float co2 = _slow.co2;
     if (!isnan(co2) && co2 >= CO2_MIN_VALID && co2 <= CO2_MAX_VALID) {
         data.co2 = co2;
     }
     
-    float tvoc = _sensors.getTVOC();
+    float tvoc = _slow.tvoc;
     if (!isnan(tvoc) && tvoc >= TVOC_MIN_VALID && tvoc <= TVOC_MAX_VALID) {
         data.tvoc = tvoc;
     }
 }
 
 void TelemetryCollector::_collectAndValidateMagnetometer(TelemetryData& data) {
-    if (!_sensors.isMPU9250Online()) return;
+    if (!_fast.imuOnline) return;
     
-    float magX = _sensors.getMagX();
-    float magY = _sensors.getMagY();
-    float magZ = _sensors.getMagZ();
+    float magX = _fast.magX;
+    float magY = _fast.magY;
+    float magZ = _fast.magZ;
     
     if (isnan(magX) || isnan(magY) || isnan(magZ)) return;
     
@@ -3,7 +3,9 @@
  * @brief Coletor centralizado de dados de telemetria
  * 
  * @details Responsável por agregar dados de todos os subsistemas
- *          em uma única estrutura TelemetryData:
+ *          em uma única estrutura TelemetryData. Sensores, GPS e bateria
+ *          vêm dos instantâneos publicados pelas tasks de sensores
+ *          (SeqSnapshot), lidos sem trava:
  *          - Timestamps (RTC e missão)
  *          - Dados de bateria e sistema
  *          - Sensores ambientais (BMP280, SI7021, CCS811)
@@ -13,7 +15,7 @@
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 1.1.0
+ * @version 1.2.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -22,6 +24,7 @@
  * ```
  * collect()
  * ├── _collectTimestamp()         // RTC + missionTime
+ * ├── _readSnapshots()           // FastTask + SensorsTask
  * ├── _collectPowerAndSystem()    // Bateria + health
  * ├── _collectCoreSensors()       // BMP280 + IMU
  * ├── _collectGPS()               // Posição
@@ -36,6 +39,8 @@
  * - Verificação de warmup do CCS811
  * - Verificação de calibração do magnetômetro
  * - Valores inválidos substituídos por NAN
+ * - Instantâneo sendo publicado durante todas as tentativas: mantém a
+ *   cópia anterior (contado em getSnapshotMisses())
  * 
  * @see TelemetryData para estrutura de saída
  * @see TelemetryManager para orquestração
@@ -46,11 +51,9 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "core/SeqSnapshot/SeqSnapshot.h"
 
 // Forward declarations
-class SensorManager;
-class GPSManager;
-class PowerManager;
 class SystemHealth;
 class RTCManager;
 class GroundNodeManager;
@@ -64,18 +67,16 @@ class TelemetryCollector {
 public:
     /**
      * @brief Construtor com injeção de todas as dependências
-     * @param sensors Referência ao SensorManager
-     * @param gps Referência ao GPSManager
-     * @param power Referência ao PowerManager
+     * @param fast Instantâneo da FastTask (IMU + barômetro)
+     * @param slow Instantâneo da SensorsTask (ambiente, GPS, bateria)
      * @param health Referência ao SystemHealth
      * @param rtc Referência ao RTCManager
      * @param nodes Referência ao GroundNodeManager
      * @param mission Referência ao MissionController
      */
     TelemetryCollector(
-        SensorManager& sensors,
-        GPSManager& gps,
-        PowerManager& power,
+        const SeqSnapshot<FastSensorSnapshot>& fast,
+        const SeqSnapshot<SlowSensorSnapshot>& slow,
         SystemHealth& health,
         RTCManager& rtc,
         GroundNodeManager& nodes,
@@ -85,26 +86,38 @@ public:
     /**
      * @brief Coleta dados de todos os subsistemas
      * @param[out] data Estrutura TelemetryData a ser preenchida
-     * @note Thread-safe se chamado com mutex externo
+     * @note Não trava as tasks de sensores; chamar de uma única task
      */
     void collect(TelemetryData& data);
+
+    /** @brief Leituras que desistiram de um instantâneo (cópia anterior usada) */
+    uint32_t getSnapshotMisses() const { return _snapshotMisses; }
     
 private:
     //=========================================================================
     // DEPENDÊNCIAS
     //=========================================================================
-    SensorManager& _sensors;       ///< Gerenciador de sensores
-    GPSManager&    _gps;           ///< Gerenciador de GPS
-    PowerManager&  _power;         ///< Gerenciador de energia
+    const SeqSnapshot<FastSensorSnapshot>& _fastSource; ///< Publicado pela FastTask
+    const SeqSnapshot<SlowSensorSnapshot>& _slowSource; ///< Publicado pela SensorsTask
     SystemHealth&  _health;        ///< Monitor de saúde
     RTCManager&    _rtc;           ///< Gerenciador de RTC
     GroundNodeManager& _nodes;     ///< Gerenciador de ground nodes
     MissionController& _mission;   ///< Controlador de missão
+
+    //=========================================================================
+    // CÓPIAS DOS INSTANTÂNEOS
+    //=========================================================================
+    FastSensorSnapshot _fast;      ///< Última cópia estável (FastTask)
+    SlowSensorSnapshot _slow;      ///< Última cópia estável (SensorsTask)
+    uint32_t _snapshotMisses;      ///< Leituras sem cópia estável
     
     //=========================================================================
     // MÉTODOS DE COLETA
     //=========================================================================
     
+    /** @brief Copia os instantâneos das tasks de sensores */
+    void _readSnapshots();
+
     /** @brief Coleta timestamps (RTC + missão) */
     void _collectTimestamp(TelemetryData& data);
     
@@ -1,25 +1,91 @@
 /**
  * @file TelemetryManager.cpp
  * @brief Gerenciador Central (FIX: Timeouts e logs de mutex)
- * @version 11.1.0
+ * @version 11.8.1
  */
 
 #include "TelemetryManager.h"
 #include "config.h"
 #include "Globals.h" 
+#include "core/I2CBus/I2CBus.h"
 
 // currentSerialLogsEnabled definido em Globals.cpp
 const ModeConfig* activeModeConfig = &PREFLIGHT_CONFIG;
 
-// Contadores de falhas de mutex para diagnóstico
-static uint16_t s_dataMutexTimeouts = 0;
-static uint16_t s_i2cMutexTimeouts = 0;
+static uint32_t s_busErrorsSeen = 0;     // Erros do I2CBus já repassados ao SystemHealth
+
+// SensorsTask parada por mais que isso (ticks): recomeça a contagem nominal
+static constexpr uint32_t SLOW_RESYNC_TICKS = 100;
+
+// Buffer estatico para dados de storage (evita copia na fila)
+static TelemetryData s_storageData;
+static GroundNodeBuffer s_storageNodes;
+static SemaphoreHandle_t s_storageMutex = NULL;
+
+// Pacotes de missao recebidos: gravados em lote pela StorageTask
+static MissionData s_missionBatch[MISSION_BATCH_MAX];
+static uint8_t s_missionBatchCount = 0;
+static uint16_t s_missionBatchDropped = 0;
+
+// Consulta por intervalo (QUERY / REPLAY): pedida pelo loop, executada pela
+// StorageTask (única task que abre arquivos no SD) em fatias, com a fila
+// de gravação vazia. Estado protegido por s_storageMutex.
+struct StoredQuery {
+    bool active;          ///< Consulta em andamento
+    bool replay;          ///< REPLAY: registros voltam ao loop para o rádio
+    uint32_t from;        ///< Próximo timestamp a percorrer
+    uint32_t to;          ///< Fim do intervalo (inclusive)
+    uint16_t skip;        ///< Registros em 'from' já entregues
+    uint32_t delivered;   ///< Registros entregues até agora
+};
+static StoredQuery s_query = {};
+static TelemetryData s_replayRecords[REPLAY_MAX_RECORDS];
+static uint8_t s_replayCount = 0;    // Registros prontos para o rádio
+static uint8_t s_replaySent = 0;     // Já reenviados pelo loop
+
+// Fatia de uma consulta (visitante do StorageManager::queryTelemetry)
+struct QueryChunk {
+    uint32_t skipTs;      ///< Timestamp com registros já entregues
+    uint16_t skip;        ///< Registros a pular em skipTs
+    uint16_t limit;       ///< Registros nesta fatia
+    uint16_t count;       ///< Entregues nesta fatia
+    uint32_t lastTs;      ///< Timestamp do último entregue
+    uint16_t atLastTs;    ///< Entregues (no total) com timestamp lastTs
+    TelemetryData* out;   ///< REPLAY: destino; nullptr = imprime (QUERY)
+};
+
+static bool visitStoredRecord(const TelemetryData& d, uint32_t seq, void* ctx) {
+    QueryChunk* c = static_cast<QueryChunk*>(ctx);
+    // Retomada: registros do mesmo segundo já entregues na fatia anterior
+    if (c->skip > 0 && d.timestamp == c->skipTs) {
+        c->skip--;
+        return true;
+    }
+    if (c->out != nullptr) {
+        c->out[c->count] = d;
+    } else {
+        DEBUG_PRINTF("#%lu %lu T=%.2fC P=%.1fhPa Alt=%.1fm Bat=%.2fV GPS=%.6f,%.6f\n",
+                     (unsigned long)seq, d.timestamp, d.temperature, d.pressure,
+                     d.altitude, d.batteryVoltage, d.latitude, d.longitude);
+    }
+    if (d.timestamp == c->lastTs) {
+        c->atLastTs++;
+    } else {
+        c->lastTs = d.timestamp;
+        c->atLastTs = 1;
+    }
+    return ++c->count < c->limit;
+}
 
 TelemetryManager::TelemetryManager() :
+    _fastSnapshot(), _slowSnapshot(),
+    _fastDeadline("FastTask", 1000000UL / IMU_OUTPUT_RATE_HZ),  // Um lote do IMU
+    _slowDeadline("SensorsTask", SENSOR_TICK_MS * 1000UL),
+    _slowReleaseUs(0), _slowStarted(false),
     _sensors(), _gps(), _power(), _systemHealth(), _rtc(), 
     _button(), _storage(), _comm(), _groundNodes(),
     _mission(_rtc, _groundNodes),
-    _telemetryCollector(_sensors, _gps, _power, _systemHealth, _rtc, _groundNodes, _mission),
+    _telemetryCollector(_fastSnapshot, _slowSnapshot, _systemHealth, _rtc, _groundNodes, _mission),
     _commandHandler(_sensors),
     _mode(MODE_INIT), 
     _lastTelemetrySend(0), _lastStorageSave(0),
@@ -28,6 +94,7 @@ TelemetryManager::TelemetryManager() :
     memset(&_telemetryData, 0, sizeof(TelemetryData));
     _telemetryData.humidity = NAN; _telemetryData.co2 = NAN; _telemetryData.tvoc = NAN;
     _telemetryData.magX = NAN; _telemetryData.magY = NAN; _telemetryData.magZ = NAN;
+    _telemetryData.roll = NAN; _telemetryData.pitch = NAN; _telemetryData.yaw = NAN;
     _telemetryData.latitude = 0.0; _telemetryData.longitude = 0.0;
     _telemetryData.gpsAltitude = 0.0; _telemetryData.satellites = 0; _telemetryData.gpsFix = false;
 }
@@ -80,12 +147,17 @@ void TelemetryManager::_initSubsystems(uint8_t& subsystemsOk, bool& success) {
     DEBUG_PRINTLN("[TelemetryManager] Init GPSManager");
     if (_gps.begin()) subsystemsOk++;
 
+    // GPS e bateria entram na tabela de amostragem da SensorsTask
+    _sensors.attachJob(SensorManager::SensorJob::GPS, _gpsJob, this);
+    _sensors.attachJob(SensorManager::SensorJob::POWER, _powerJob, this);
+
     DEBUG_PRINTLN("[TelemetryManager] Init Storage");
-    if (_storage.begin()) {
-        _storage.setRTCManager(&_rtc); 
-        _storage.setSystemHealth(&_systemHealth); 
-        subsystemsOk++;
-    } else success = false;
+    // Antes do begin(): ele já grava cabeçalhos com a hora do RTC, e sem
+    // SD a flash interna também precisa do RTC e do SystemHealth
+    _storage.setRTCManager(&_rtc);
+    _storage.setSystemHealth(&_systemHealth);
+    if (_storage.begin()) subsystemsOk++;
+    else success = false;
 
     DEBUG_PRINTLN("[TelemetryManager] Init Communication");
     if (_comm.begin()) subsystemsOk++;
@@ -109,33 +181,124 @@ void TelemetryManager::feedWatchdog() {
     _systemHealth.feedWatchdog();
 }
 
-// === Atualização Física (Task Sensores) ===
-// FIX: Timeout aumentado de 100ms para 200ms e logs de falha adicionados
-void TelemetryManager::updatePhySensors() {
-    if (xSemaphoreTake(xDataMutex, pdMS_TO_TICKS(200)) == pdTRUE) {
-        if (xSemaphoreTake(xI2CMutex, pdMS_TO_TICKS(200)) == pdTRUE) {
-            _sensors.update(); 
-            _rtc.update();
-            xSemaphoreGive(xI2CMutex);
-        } else {
-            // FIX: Log de falha e contagem
-            s_i2cMutexTimeouts++;
-            if (s_i2cMutexTimeouts % 10 == 1) { // Log a cada 10 falhas
-                DEBUG_PRINTF("[TM] AVISO: I2C mutex timeout (#%u)\n", s_i2cMutexTimeouts);
-            }
-            _systemHealth.incrementI2CError();
-        }
-        _gps.update();
-        _power.update();
-        _power.adjustCpuFrequency();
-        xSemaphoreGive(xDataMutex);
+// === Atualização Física (tasks de sensores) ===
+// I2C: cada sensor/RTC pede sua própria sessão ao I2CBus
+// Dados: cada task publica o seu instantâneo; nenhuma toma o xDataMutex
+void TelemetryManager::updateSlowSensors() {
+    uint32_t start = micros();
+    const uint32_t tickUs = SENSOR_TICK_MS * 1000UL;
+
+    // Liberação nominal avança um tick por chamada (vTaskDelayUntil executa
+    // em sequência os ticks atrasados); após uma parada longa, recomeça
+    if (!_slowStarted || (int32_t)(start - _slowReleaseUs) > (int32_t)(SLOW_RESYNC_TICKS * tickUs)) {
+        _slowReleaseUs = start;
+        _slowStarted = true;
+    }
+
+    // Recuperação do barramento avança um passo por ciclo (não bloqueia)
+    I2CBus::instance().service();
+
+    _sensors.update();
+    _rtc.update();
+
+    // Sem FastTask, IMU e BMP280 são jobs desta task: ela publica os dois
+    if (!_sensors.hasFastTask()) _publishFast();
+    _publishSlow();
+
+    _slowDeadline.record(_slowReleaseUs, start, micros());
+    _slowReleaseUs += tickUs;
+}
+
+void TelemetryManager::updateFastSensors() {
+    if (!_sensors.hasFastTask()) return;
+
+    uint32_t start = micros();
+    uint32_t release = _sensors.takeFastReleaseUs(start);
+
+    _sensors.updateFast();
+    _publishFast();
+
+    _fastDeadline.record(release, start, micros());
+}
+
+void TelemetryManager::_publishFast() {
+    FastSensorSnapshot s;
+    s.timestampMs = millis();
+    s.gyroX = _sensors.getGyroX();
+    s.gyroY = _sensors.getGyroY();
+    s.gyroZ = _sensors.getGyroZ();
+    s.accelX = _sensors.getAccelX();
+    s.accelY = _sensors.getAccelY();
+    s.accelZ = _sensors.getAccelZ();
+    s.magX = _sensors.getMagX();
+    s.magY = _sensors.getMagY();
+    s.magZ = _sensors.getMagZ();
+    s.roll = _sensors.getRoll();
+    s.pitch = _sensors.getPitch();
+    s.yaw = _sensors.getYaw();
+    s.temperatureBMP = _sensors.getTemperatureBMP280();
+    s.pressure = _sensors.getPressure();
+    s.altitude = _sensors.getAltitude();
+    s.imuOnline = _sensors.isMPU9250Online();
+    s.baroOnline = _sensors.isBMP280Online();
+    _fastSnapshot.publish(s);
+}
+
+void TelemetryManager::_publishSlow() {
+    SlowSensorSnapshot s;
+    s.timestampMs = millis();
+    s.temperatureSI = _sensors.getTemperatureSI7021();
+    s.humidity = _sensors.getHumidity();
+    s.co2 = _sensors.getCO2();
+    s.tvoc = _sensors.getTVOC();
+    GPSManager::Fix fix;
+    _gps.getFix(fix);  // Cópia coerente publicada pela GpsTask
+    s.latitude = fix.latitude;
+    s.longitude = fix.longitude;
+    s.gpsAltitude = fix.altitude;
+    s.satellites = fix.satellites;
+    s.gpsFix = fix.hasFix;
+    s.batteryVoltage = _power.getVoltage();
+    s.batteryPercentage = _power.getPercentage();
+    s.si7021Online = _sensors.isSI7021Online();
+    s.ccs811DataValid = _sensors.isCCS811DataValid();
+    _slowSnapshot.publish(s);
+}
+
+uint16_t TelemetryManager::_gpsJob(void* ctx) {
+    static_cast<TelemetryManager*>(ctx)->_gps.update();
+    return 0;
+}
+
+uint16_t TelemetryManager::_powerJob(void* ctx) {
+    // Média do ADC colhida uma amostra por tick
+    TelemetryManager* tm = static_cast<TelemetryManager*>(ctx);
+    if (tm->_power.update()) return SENSOR_TICK_MS;
+    tm->_power.adjustCpuFrequency();
+    return 0;
+}
+
+void TelemetryManager::attachFastTask(TaskHandle_t task) {
+    _sensors.attachFastTask(task);
+}
+
+void TelemetryManager::attachGpsTask() {
+    _sensors.attachJob(SensorManager::SensorJob::GPS, nullptr, nullptr);
+}
+
+void TelemetryManager::_printTaskStats() {
+    DEBUG_PRINTLN("=== TASKS DE SENSORES ===");
+    if (_sensors.hasFastTask()) {
+        _fastDeadline.printStatus();
     } else {
-        // FIX: Log de falha
-        s_dataMutexTimeouts++;
-        if (s_dataMutexTimeouts % 10 == 1) {
-            DEBUG_PRINTF("[TM] AVISO: Data mutex timeout (#%u)\n", s_dataMutexTimeouts);
-        }
+        DEBUG_PRINTLN("  FastTask   : inativa (IMU e BMP280 na SensorsTask)");
     }
+    _slowDeadline.printStatus();
+    DEBUG_PRINTF("Instantaneos: rapido v%lu, lento v%lu, leituras sem copia estavel %lu\n",
+                 (unsigned long)_fastSnapshot.version(),
+                 (unsigned long)_slowSnapshot.version(),
+                 (unsigned long)_telemetryCollector.getSnapshotMisses());
+    DEBUG_PRINTLN("=========================");
 }
 
 void TelemetryManager::loop() {
@@ -166,16 +329,22 @@ void TelemetryManager::loop() {
 
     _handleIncomingRadio();
     _maintainGroundNetwork();
+    _serviceReplay();
 
-    // FIX: Timeout aumentado de 50ms para 100ms
-    if (xSemaphoreTake(xDataMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        _telemetryCollector.collect(_telemetryData);
-        xSemaphoreGive(xDataMutex);
+    // Instantâneos das tasks de sensores: sem trava, nunca espera
+    _telemetryCollector.collect(_telemetryData);
+
+    // Erros do I2CBus repassados aqui, na task dona do SystemHealth
+    uint32_t busErrors = I2CBus::instance().getErrorCount();
+    if (busErrors != s_busErrorsSeen) {
+        _systemHealth.addI2CErrors((uint16_t)(busErrors - s_busErrorsSeen));
+        s_busErrorsSeen = busErrors;
     }
 
     _systemHealth.setCurrentMode((uint8_t)_mode);
-    _systemHealth.setBatteryVoltage(_power.getVoltage());
-    _systemHealth.setSDCardStatus(_storage.isAvailable());
+    _systemHealth.setBatteryVoltage(_telemetryData.batteryVoltage);
+    // Orçamento esgotado conta como falha: registros estão sendo descartados
+    _systemHealth.setSDCardStatus(_storage.isAvailable() && !_storage.isStorageFull());
     
     _checkOperationalConditions();
 
@@ -211,11 +380,7 @@ void TelemetryManager::_checkOperationalConditions() {
         static unsigned long lastSensorReset = 0;
         if (millis() - lastSensorReset > 10000) {
             DEBUG_PRINTLN("[TM] Sensores instaveis. Tentando reset...");
-            // FIX: Timeout aumentado e convertido para ms
-            if (xSemaphoreTake(xI2CMutex, pdMS_TO_TICKS(200)) == pdTRUE) {
-                _sensors.resetAll();
-                xSemaphoreGive(xI2CMutex);
-            }
+            _sensors.resetAll();
             lastSensorReset = millis();
         }
     }
@@ -250,7 +415,22 @@ void TelemetryManager::_handleIncomingRadio() {
             rxData.collectionTime = _rtc.isInitialized() ? _rtc.getUnixTime() : (millis()/1000);
             
             _groundNodes.updateNode(rxData);
-            _storage.saveMissionData(rxData); 
+            
+            // Sem I/O de SD aqui: entra no lote do proximo ciclo de storage
+            if (s_storageMutex == NULL) {
+                s_storageMutex = xSemaphoreCreateMutex();
+            }
+            if (s_storageMutex != NULL &&
+                xSemaphoreTake(s_storageMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+                if (s_missionBatchCount < MISSION_BATCH_MAX) {
+                    s_missionBatch[s_missionBatchCount++] = rxData;
+                } else {
+                    s_missionBatchDropped++;
+                }
+                xSemaphoreGive(s_storageMutex);
+            } else {
+                s_missionBatchDropped++;
+            }
             
             DEBUG_PRINTF("[TM] Node %u RX: RSSI=%d dBm, SNR=%.1f dB\n", 
                          rxData.nodeId, rssi, snr);
@@ -286,6 +466,7 @@ void TelemetryManager::applyModeConfig(uint8_t modeIndex) {
     _comm.enableLoRa(activeModeConfig->loraEnabled);
     _comm.enableHTTP(activeModeConfig->httpEnabled);
     _systemHealth.setWatchdogTimeout(wdtTimeout);
+    _sensors.setRates(activeModeConfig->sensorRates);
     
     DEBUG_PRINTF("[TelemetryManager] Modo: %d (LoRa=%d HTTP=%d Beacon=%d WDT=%ds)\n", 
                  mode, activeModeConfig->loraEnabled, activeModeConfig->httpEnabled,
@@ -325,11 +506,6 @@ void TelemetryManager::_sendTelemetry() {
     _comm.sendTelemetry(_telemetryData, buf);
 }
 
-// Buffer estatico para dados de storage (evita copia na fila)
-static TelemetryData s_storageData;
-static GroundNodeBuffer s_storageNodes;
-static SemaphoreHandle_t s_storageMutex = NULL;
-
 void TelemetryManager::_saveToStorage() {
     // Criar mutex na primeira chamada
     if (s_storageMutex == NULL) {
@@ -344,41 +520,183 @@ void TelemetryManager::_saveToStorage() {
             xSemaphoreGive(s_storageMutex);
             
             // Envia sinal para a task processar
-            uint8_t signal = 1;
+            uint8_t signal = STORAGE_SIGNAL_SAVE;
             if (xQueueSend(xStorageQueue, &signal, 0) != pdTRUE) {
+                _storage.noteQueueFull();
                 DEBUG_PRINTLN("[TM] AVISO: Fila SD cheia.");
             }
         }
     }
 }
 
+void TelemetryManager::serviceStorage() {
+    _runQueryChunk();
+    _storage.service();
+}
+
+bool TelemetryManager::hasPendingQuery() const {
+    return s_query.active;
+}
+
+void TelemetryManager::_requestQuery(uint32_t from, uint32_t to, bool replay) {
+    if (s_storageMutex == NULL) {
+        s_storageMutex = xSemaphoreCreateMutex();
+    }
+    if (s_storageMutex == NULL ||
+        xSemaphoreTake(s_storageMutex, pdMS_TO_TICKS(50)) != pdTRUE) {
+        DEBUG_PRINTLN("[CMD] Consulta recusada: storage ocupado.");
+        return;
+    }
+    bool busy = s_query.active || s_replaySent < s_replayCount;
+    if (!busy) {
+        s_query.active = true;
+        s_query.replay = replay;
+        s_query.from = from;
+        s_query.to = to;
+        s_query.skip = 0;
+        s_query.delivered = 0;
+    }
+    xSemaphoreGive(s_storageMutex);
+
+    if (busy) {
+        DEBUG_PRINTLN("[CMD] Consulta anterior ainda em andamento.");
+        return;
+    }
+    // Só acorda a StorageTask; a consulta roda com a fila de gravação vazia
+    uint8_t signal = STORAGE_SIGNAL_QUERY;
+    if (xStorageQueue != NULL) xQueueSend(xStorageQueue, &signal, 0);
+}
+
+void TelemetryManager::_runQueryChunk() {
+    if (s_storageMutex == NULL) return;
+
+    StoredQuery q;
+    if (xSemaphoreTake(s_storageMutex, pdMS_TO_TICKS(50)) != pdTRUE) return;
+    q = s_query;
+    xSemaphoreGive(s_storageMutex);
+    if (!q.active) return;
+
+    // REPLAY é uma fatia só; o loop não lê s_replayRecords enquanto ativa
+    QueryChunk c = {};
+    c.skipTs = q.from;
+    c.skip = q.skip;
+    c.lastTs = q.from;
+    c.atLastTs = q.skip;
+    if (q.replay) {
+        c.limit = REPLAY_MAX_RECORDS;
+        c.out = s_replayRecords;
+    } else {
+        uint32_t left = QUERY_MAX_RECORDS - q.delivered;
+        c.limit = (left < QUERY_CHUNK_RECORDS) ? left : QUERY_CHUNK_RECORDS;
+    }
+    if (c.limit > 0) {
+        _storage.queryTelemetry(q.from, q.to, visitStoredRecord, &c);
+    }
+    q.delivered += c.count;
+
+    bool more = !q.replay && c.limit > 0 && c.count == c.limit &&
+                q.delivered < QUERY_MAX_RECORDS;
+    bool capped = !q.replay && c.count == c.limit && q.delivered >= QUERY_MAX_RECORDS;
+    if (more) {
+        q.from = c.lastTs;
+        q.skip = c.atLastTs;
+    }
+    q.active = more;
+
+    if (xSemaphoreTake(s_storageMutex, portMAX_DELAY) == pdTRUE) {
+        s_query = q;
+        if (q.replay) {
+            s_replayCount = (uint8_t)c.count;
+            s_replaySent = 0;
+        }
+        xSemaphoreGive(s_storageMutex);
+    }
+
+    if (q.replay) {
+        if (c.count == 0) DEBUG_PRINTLN("[CMD] REPLAY: 0 registros no intervalo");
+    } else if (!more) {
+        DEBUG_PRINTF("[CMD] QUERY: %lu registros\n", (unsigned long)q.delivered);
+        if (capped) {
+            DEBUG_PRINTF("[CMD] QUERY: limite de %d atingido; continuar com QUERY %lu %lu\n",
+                         QUERY_MAX_RECORDS, (unsigned long)c.lastTs, (unsigned long)q.to);
+        }
+    }
+}
+
+void TelemetryManager::_serviceReplay() {
+    if (s_storageMutex == NULL) return;
+
+    // Um registro por passada do loop: rádio e comandos seguem atendidos
+    TelemetryData record;
+    bool have = false;
+    if (xSemaphoreTake(s_storageMutex, 0) != pdTRUE) return;
+    if (s_replaySent < s_replayCount) {
+        record = s_replayRecords[s_replaySent];
+        have = true;
+    }
+    xSemaphoreGive(s_storageMutex);
+    if (!have) return;
+
+    bool ok = _comm.sendStoredTelemetry(record);
+
+    uint8_t sent = 0;
+    bool done = false;
+    if (xSemaphoreTake(s_storageMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+        if (ok) s_replaySent++;
+        else s_replayCount = s_replaySent;   // Duty cycle cheio: encerra
+        sent = s_replaySent;
+        done = s_replaySent >= s_replayCount;
+        xSemaphoreGive(s_storageMutex);
+    }
+    if (done) {
+        DEBUG_PRINTF("[CMD] REPLAY: %u registros reenviados\n", sent);
+    }
+}
+
 void TelemetryManager::processStoragePacket(const StorageQueueMessage& msg) {
     (void)msg;
     
     if (s_storageMutex == NULL) return;
     
+    // Sinais ainda na fila: SD mais lento que a produção
+    _storage.noteBacklog(uxQueueMessagesWaiting(xStorageQueue));
+    
     TelemetryData localData;
     GroundNodeBuffer localNodes;
+    // Estatico: so a StorageTask usa (evita ~1.5KB na stack)
+    static MissionData batch[MISSION_BATCH_MAX + MAX_GROUND_NODES];
+    uint8_t count = 0;
+    uint16_t dropped = 0;
     
     if (xSemaphoreTake(s_storageMutex, pdMS_TO_TICKS(500)) == pdTRUE) {
         memcpy(&localData, &s_storageData, sizeof(TelemetryData));
         localNodes = s_storageNodes;
+        for (; count < s_missionBatchCount; count++) {
+            batch[count] = s_missionBatch[count];
+        }
+        s_missionBatchCount = 0;
+        dropped = s_missionBatchDropped;
+        s_missionBatchDropped = 0;
         xSemaphoreGive(s_storageMutex);
     } else {
         return;
     }
     
-    // Verificar se dados sao validos (timestamp ou bateria devem ter valor)
-    if (localData.timestamp == 0 && localData.batteryVoltage < 0.1f) {
-        return; // Dados ainda nao coletados
+    if (dropped > 0) {
+        DEBUG_PRINTF("[TM] AVISO: %u pacotes de missao descartados (lote cheio).\n", dropped);
     }
     
-    bool saved = _storage.saveTelemetry(localData);
-    if (saved) {
+    // Verificar se dados sao validos (timestamp ou bateria devem ter valor)
+    bool collected = !(localData.timestamp == 0 && localData.batteryVoltage < 0.1f);
+    
+    if (collected && _storage.saveTelemetry(localData)) {
         for(int i=0; i<localNodes.activeNodes; i++) {
-            _storage.saveMissionData(localNodes.nodes[i]);
+            batch[count++] = localNodes.nodes[i];
         }
     }
+    
+    // Pacotes recebidos + estado dos nos: uma escrita por ciclo
+    _storage.saveMissionBatch(batch, count);
 }
 
 void TelemetryManager::_handleButtonEvents() {
@@ -455,12 +773,34 @@ bool TelemetryManager::handleCommand(const String& cmd) {
         DEBUG_PRINTLN("==================");
         return true;
     }
-    // FIX: Comando para ver estatísticas de mutex
+    // Barramento I2C (substituiu o mutex I2C; tasks de sensores sem xDataMutex)
     if (cmdUpper == "MUTEX_STATS") {
-        DEBUG_PRINTLN("=== MUTEX STATS ===");
-        DEBUG_PRINTF("Data Mutex Timeouts: %u\n", s_dataMutexTimeouts);
-        DEBUG_PRINTF("I2C Mutex Timeouts: %u\n", s_i2cMutexTimeouts);
-        DEBUG_PRINTLN("===================");
+        I2CBus::instance().printStatus();
+        return true;
+    }
+    if (cmdUpper == "TASK_STATS") {
+        _printTaskStats();
+        return true;
+    }
+    if (cmdUpper == "GPS_STATS") {
+        _gps.printStatus();
+        return true;
+    }
+    if (cmdUpper == "STORAGE_STATS") {
+        _storage.printStats();
+        return true;
+    }
+    // Consulta por intervalo no SD: "QUERY <unixIni> <unixFim>"
+    // (máx. QUERY_MAX_RECORDS, impressos pela StorageTask em fatias)
+    unsigned long from, to;
+    if (sscanf(cmdUpper.c_str(), "QUERY %lu %lu", &from, &to) == 2) {
+        _requestQuery(from, to, false);
+        return true;
+    }
+    // Reenvio via LoRa: "REPLAY <unixIni> <unixFim>" (máx. REPLAY_MAX_RECORDS,
+    // lidos pela StorageTask e enviados pelo loop, um por passada)
+    if (sscanf(cmdUpper.c_str(), "REPLAY %lu %lu", &from, &to) == 2) {
+        _requestQuery(from, to, true);
         return true;
     }
     return _commandHandler.handle(cmdUpper);
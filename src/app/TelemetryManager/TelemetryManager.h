@@ -8,7 +8,7 @@
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 3.0.0
+ * @version 3.4.1
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -23,6 +23,16 @@
  * | Armazenamento        | StorageManager        | SD Card logging             |
  * | Controle de Missão   | MissionController     | Estados e transições        |
  * 
+ * ## Tasks de Sensores
+ * | Task        | Chamada             | Publica                        |
+ * |-------------|---------------------|--------------------------------|
+ * | FastTask    | updateFastSensors() | FastSensorSnapshot (IMU, baro) |
+ * | SensorsTask | updateSlowSensors() | SlowSensorSnapshot (ambiente, GPS, bateria) |
+ * | GpsTask     | serviceGps()        | GPSManager::Fix (lido pela SensorsTask)    |
+ *
+ * Nenhuma delas toma o xDataMutex: o loop() junta os instantâneos no
+ * TelemetryCollector. Cada task tem um DeadlineMonitor (comando TASK_STATS).
+ * 
  * ## Modos de Operação
  * - **PREFLIGHT**: Inicialização e verificações
  * - **FLIGHT**: Coleta ativa de telemetria
@@ -51,6 +61,8 @@
 #include "app/MissionController/MissionController.h"
 #include "app/TelemetryCollector/TelemetryCollector.h"
 #include "core/CommandHandler/CommandHandler.h"
+#include "core/SeqSnapshot/SeqSnapshot.h"
+#include "core/DeadlineMonitor/DeadlineMonitor.h"
 
 /**
  * @class TelemetryManager
@@ -82,10 +94,40 @@ public:
     void loop();
     
     /**
-     * @brief Atualiza sensores físicos (chamado pela SensorsTask)
-     * @note Thread-safe - usa mutexes internamente
+     * @brief Um tick da SensorsTask (a cada SENSOR_TICK_MS)
+     * @details Jobs vencidos do SensorScheduler (ambiente, GPS, bateria),
+     *          RTC e publicação do SlowSensorSnapshot.
+     * @note Sem trava: só a SensorsTask chama
+     */
+    void updateSlowSensors();
+
+    /**
+     * @brief Um ciclo da FastTask (a cada lote do IMU ou timeout)
+     * @details IMU, BMP280 quando vence e publicação do FastSensorSnapshot.
+     * @note Sem trava: só a FastTask chama
+     */
+    void updateFastSensors();
+
+    /**
+     * @brief Entrega IMU e barômetro à FastTask (pino INT do MPU9250)
+     * @param task Handle da FastTask
+     * @note Chamar antes de criar a SensorsTask (um escritor por instantâneo)
      */
-    void updatePhySensors();
+    void attachFastTask(TaskHandle_t task);
+
+    /**
+     * @brief Tira o GPS da tabela da SensorsTask (a GpsTask assume)
+     * @note Chamar antes de criar a GpsTask e a SensorsTask: as duas nunca
+     *       alimentam o UbxParser ao mesmo tempo. Sem ela o job GPS continua
+     *       drenando a UART por polling
+     */
+    void attachGpsTask();
+
+    /**
+     * @brief Um ciclo da GpsTask: espera eventos da UART e decodifica
+     * @see GPSManager::service()
+     */
+    void serviceGps() { _gps.service(GPS_TASK_TIMEOUT_MS); }
     
     /**
      * @brief Processa comando recebido via Serial
@@ -136,8 +178,31 @@ public:
      * @param msg Mensagem da fila de armazenamento
      */
     void processStoragePacket(const StorageQueueMessage& msg);
+    
+    /**
+     * @brief Manutenção do SD com a fila vazia (chamado pela StorageTask)
+     * @details Uma fatia da consulta QUERY/REPLAY pendente, depois
+     *          StorageManager::service()
+     */
+    void serviceStorage();
+
+    /**
+     * @brief Consulta QUERY/REPLAY com fatias ainda por ler?
+     * @note A StorageTask não espera STORAGE_IDLE_MS enquanto houver
+     */
+    bool hasPendingQuery() const;
 
 private:
+    //=========================================================================
+    // INSTANTÂNEOS E PRAZOS DAS TASKS DE SENSORES
+    //=========================================================================
+    SeqSnapshot<FastSensorSnapshot> _fastSnapshot; ///< Escrito pela FastTask
+    SeqSnapshot<SlowSensorSnapshot> _slowSnapshot; ///< Escrito pela SensorsTask
+    DeadlineMonitor      _fastDeadline;       ///< Prazo da FastTask (período do IMU)
+    DeadlineMonitor      _slowDeadline;       ///< Prazo da SensorsTask (SENSOR_TICK_MS)
+    uint32_t             _slowReleaseUs;      ///< Tick nominal da SensorsTask
+    bool                 _slowStarted;        ///< Primeiro tick já medido?
+
     //=========================================================================
     // SUBSISTEMAS
     //=========================================================================
@@ -186,6 +251,20 @@ private:
     void _handleButtonEvents();         ///< Processa eventos de botão
     void _updateLEDIndicator(unsigned long currentTime); ///< Atualiza LED de status
     void _sendSafeBeacon();             ///< Envia beacon em modo SAFE
+    void _serviceReplay();              ///< Reenvia um registro do REPLAY pronto
+
+    //=========================================================================
+    // MÉTODOS PRIVADOS - CONSULTA NO SD (QUERY / REPLAY)
+    //=========================================================================
+    void _requestQuery(uint32_t from, uint32_t to, bool replay); ///< Agenda na StorageTask
+    void _runQueryChunk();              ///< Uma fatia da consulta (StorageTask)
+
+    void _publishFast();                ///< FastSensorSnapshot a partir dos sensores
+    void _publishSlow();                ///< SlowSensorSnapshot a partir dos sensores
+    void _printTaskStats();             ///< Prazos por task (TASK_STATS)
+
+    static uint16_t _gpsJob(void* ctx);   ///< Job GPS do SensorScheduler
+    static uint16_t _powerJob(void* ctx); ///< Job de bateria do SensorScheduler
 };
 
 #endif
\ No newline at end of file
@@ -114,6 +114,20 @@ bool CommunicationManager::sendTelemetry(const TelemetryData& tData,
     return success;
 }
 
+bool CommunicationManager::sendStoredTelemetry(const TelemetryData& tData) {
+    if (!_loraEnabled) return false;
+
+    uint8_t txBuffer[256];
+    int satLen = _payload.createSatellitePayload(tData, txBuffer);
+    if (satLen <= 0) return false;
+
+    if (!_lora.canTransmitNow(satLen)) {
+        DEBUG_PRINTLN("[Comm] Duty Cycle cheio. Replay interrompido.");
+        return false;
+    }
+    return _lora.send(txBuffer, satLen, false);
+}
+
 void CommunicationManager::processHttpQueuePacket(const HttpQueueMessage& packet) {
     if (_wifi.isConnected()) {
         String json = _payload.createTelemetryJSON(packet.data, packet.nodes);
@@ -34,6 +34,10 @@ public:
     // Telemetria
     bool sendTelemetry(const TelemetryData& tData, GroundNodeBuffer& gBuffer);
 
+    // Reenvio de telemetria gravada (comando REPLAY): só payload satélite,
+    // false se LoRa desabilitado ou duty cycle cheio
+    bool sendStoredTelemetry(const TelemetryData& tData);
+
     // Processa o pacote da fila
     void processHttpQueuePacket(const HttpQueueMessage& packet);
     
@@ -316,6 +316,17 @@ void PayloadManager::_encodeSatelliteData(const TelemetryData& data, uint8_t* bu
     buffer[offset++] = encIMU(data.accelY, 16.0); 
     buffer[offset++] = encIMU(data.accelZ, 16.0);
 
+    // Atitude do AHRS em ângulo binário (180°/32768 por LSB);
+    // 0x8000 = ainda não inicializada (±180° vira -32767)
+    auto encAngle = [&](float deg) {
+        int32_t v = isnan(deg) ? -32768 : (int32_t)lroundf(deg * (32768.0f / 180.0f));
+        if (!isnan(deg) && (v <= -32768 || v > 32767)) v = -32767;
+        buffer[offset++] = (v >> 8) & 0xFF; buffer[offset++] = v & 0xFF;
+    };
+    encAngle(data.roll);
+    encAngle(data.pitch);
+    encAngle(data.yaw);
+
     int32_t latI = 0, lonI = 0; 
     uint16_t gpsAlt = 0;
     if (data.gpsFix) {
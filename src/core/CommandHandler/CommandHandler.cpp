@@ -25,11 +25,10 @@ bool CommandHandler::handle(String cmd) {
     }
 
     if (cmd == "CALIB_MAG") {
-        DEBUG_PRINTLN("[CMD] Iniciando calibracao do magnetometro...");
         if (_sensors.recalibrateMagnetometer()) {
-            DEBUG_PRINTLN("[CMD] Calibracao MAG concluida.");
+            DEBUG_PRINTLN("[CMD] Calibracao MAG em segundo plano (salva sozinha ao convergir).");
         } else {
-            DEBUG_PRINTLN("[CMD] Calibracao MAG falhou.");
+            DEBUG_PRINTLN("[CMD] Calibracao MAG indisponivel: magnetometro offline.");
         }
         return true;
     }
@@ -55,7 +54,7 @@ bool CommandHandler::handle(String cmd) {
 void CommandHandler::_printHelp() {
     DEBUG_PRINTLN("--- COMANDOS DISPONIVEIS ---");
     DEBUG_PRINTLN("  STATUS          : Status detalhado dos sensores");
-    DEBUG_PRINTLN("  CALIB_MAG       : Calibra magnetometro (gire em 8)");
+    DEBUG_PRINTLN("  CALIB_MAG       : Recalibra magnetometro (gire em 8)");
     DEBUG_PRINTLN("  CLEAR_MAG       : Apaga calibracao do magnetometro");
     DEBUG_PRINTLN("  SAVE_BASELINE   : Salva baseline do CCS811");
     DEBUG_PRINTLN("----------------------------");
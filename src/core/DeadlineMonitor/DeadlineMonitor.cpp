@@ -0,0 +1,48 @@
+/**
+ * @file DeadlineMonitor.cpp
+ * @brief Implementação dos contadores de prazo por task
+ */
+
+#include "DeadlineMonitor.h"
+#include "config.h"
+
+DeadlineMonitor::DeadlineMonitor(const char* name, uint32_t deadlineUs)
+    : _name(name), _deadlineUs(deadlineUs)
+{
+    reset();
+}
+
+void DeadlineMonitor::record(uint32_t releaseUs, uint32_t startUs, uint32_t endUs) {
+    // Liberação no futuro (relógio da fonte adiantado): conta a partir do início
+    uint32_t latency = startUs - releaseUs;
+    if ((int32_t)latency < 0) { latency = 0; releaseUs = startUs; }
+    uint32_t response = endUs - releaseUs;
+    uint32_t exec = endUs - startUs;
+
+    _cycles++;
+    if (response > _deadlineUs) _misses++;
+    if (latency > _latencyMaxUs) _latencyMaxUs = latency;
+    if (response > _responseMaxUs) _responseMaxUs = response;
+    if (exec > _execMaxUs) _execMaxUs = exec;
+    _responseLastUs = response;
+    _responseTotalUs += response;
+}
+
+void DeadlineMonitor::reset() {
+    _cycles = 0;
+    _misses = 0;
+    _latencyMaxUs = 0;
+    _responseLastUs = 0;
+    _responseMaxUs = 0;
+    _execMaxUs = 0;
+    _responseTotalUs = 0;
+}
+
+void DeadlineMonitor::printStatus() const {
+    DEBUG_PRINTF("  %-11s: prazo %lu us, %lu ciclos, %lu perdidos, atraso max %lu us, "
+                 "resposta med %lu us max %lu us, execucao max %lu us\n",
+                 _name, (unsigned long)_deadlineUs, (unsigned long)_cycles,
+                 (unsigned long)_misses, (unsigned long)_latencyMaxUs,
+                 (unsigned long)(_cycles ? _responseTotalUs / _cycles : 0),
+                 (unsigned long)_responseMaxUs, (unsigned long)_execMaxUs);
+}
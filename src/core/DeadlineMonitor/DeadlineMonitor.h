@@ -0,0 +1,77 @@
+/**
+ * @file DeadlineMonitor.h
+ * @brief Contadores de prazo por task periódica (latência, resposta, perdas)
+ *
+ * @details Cada ciclo da task informa três instantes:
+ *          - Liberação: quando o ciclo deveria começar (tick nominal,
+ *            pulso de data-ready)
+ *          - Início: quando a task de fato começou
+ *          - Fim: quando terminou
+ *          Resposta = fim - liberação. Prazo perdido quando a resposta
+ *          passa do prazo (em geral o período da task).
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * @note Escrito só pela task medida; leituras de outra task veem
+ *       contadores de 32 bits coerentes individualmente
+ */
+
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include <Arduino.h>
+
+/**
+ * @class DeadlineMonitor
+ * @brief Estatística de prazo de uma task
+ */
+class DeadlineMonitor {
+public:
+    /**
+     * @brief Construtor
+     * @param name Nome no relatório (literal)
+     * @param deadlineUs Prazo relativo à liberação
+     */
+    DeadlineMonitor(const char* name, uint32_t deadlineUs);
+
+    /** @brief Troca o prazo (ex.: taxa do IMU) */
+    void setDeadline(uint32_t deadlineUs) { _deadlineUs = deadlineUs; }
+
+    /**
+     * @brief Registra um ciclo
+     * @param releaseUs Liberação nominal (micros)
+     * @param startUs Início real
+     * @param endUs Fim
+     */
+    void record(uint32_t releaseUs, uint32_t startUs, uint32_t endUs);
+
+    uint32_t getCycles() const { return _cycles; }              ///< Ciclos medidos
+    uint32_t getMisses() const { return _misses; }              ///< Prazos perdidos
+    uint32_t getLatencyMaxUs() const { return _latencyMaxUs; }  ///< Maior início - liberação
+    uint32_t getResponseMaxUs() const { return _responseMaxUs; } ///< Maior fim - liberação
+    uint32_t getDeadlineUs() const { return _deadlineUs; }      ///< Prazo atual
+
+    /** @brief Zera os contadores */
+    void reset();
+
+    /** @brief Imprime uma linha de resumo */
+    void printStatus() const;
+
+private:
+    const char* _name;           ///< Nome no relatório
+    uint32_t _deadlineUs;        ///< Prazo
+    uint32_t _cycles;            ///< Ciclos medidos
+    uint32_t _misses;            ///< Resposta acima do prazo
+    uint32_t _latencyMaxUs;      ///< Pior atraso de início
+    uint32_t _responseLastUs;    ///< Última resposta
+    uint32_t _responseMaxUs;     ///< Pior resposta
+    uint32_t _execMaxUs;         ///< Pior tempo de execução (fim - início)
+    uint64_t _responseTotalUs;   ///< Soma das respostas (média)
+};
+
+#endif // DEADLINE_MONITOR_H
@@ -0,0 +1,609 @@
+/**
+ * @file I2CBus.cpp
+ * @brief Implementação do escalonador central do barramento I2C
+ */
+
+#include "I2CBus.h"
+
+static const char* const PRIORITY_NAMES[I2CBus::PRIORITY_LEVELS] = {
+    "IMU", "FAST", "SLOW", "BACKGROUND"
+};
+
+static const char* const RECOVERY_NAMES[] = {
+    "IDLE", "PENDING", "CLOCK", "STOP", "RESTART", "SETTLE"
+};
+
+I2CBus::I2CBus()
+    : _wire(nullptr), _lock(NULL), _owner(NULL), _depth(0), _sessionErr(ErrorClass::NONE),
+      _ownerAddr(0), _grantUs(0), _seq(0),
+      _deviceCount(0), _busyUs(0), _statsSinceMs(0), _queueFull(0), _errorTotal(0),
+      _wireTimeoutMs(0), _busErrorStreak(0), _recovery(Recovery::IDLE),
+      _recoveryUntilMs(0), _recoveryNotBeforeMs(0), _recoveries(0),
+      _recoveryFailures(0), _rejected(0)
+{
+    memset(_waiters, 0, sizeof(_waiters));
+    memset(_pending, 0, sizeof(_pending));
+    memset(_devices, 0, sizeof(_devices));
+    memset(_prio, 0, sizeof(_prio));
+}
+
+//=============================================================================
+// DESCRITORES
+//=============================================================================
+
+I2CBus::Transaction I2CBus::readReg(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len,
+                                    Priority prio) {
+    Transaction t = {};
+    t.op = Transaction::Op::READ;
+    t.addr = addr;
+    t.reg = reg;
+    t.data = buf;
+    t.len = len;
+    t.priority = prio;
+    return t;
+}
+
+I2CBus::Transaction I2CBus::writeReg(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len,
+                                     Priority prio) {
+    Transaction t = readReg(addr, reg, buf, len, prio);
+    t.op = Transaction::Op::WRITE;
+    return t;
+}
+
+I2CBus::Transaction I2CBus::probe(uint8_t addr, Priority prio) {
+    Transaction t = readReg(addr, 0, nullptr, 0, prio);
+    t.op = Transaction::Op::PROBE;
+    return t;
+}
+
+I2CBus::ErrorClass I2CBus::classify(uint8_t result) {
+    switch (result) {
+        case RESULT_OK:         return ErrorClass::NONE;
+        case 2:                 return ErrorClass::NACK;     // NACK no endereço
+        case 1:                                              // Dados demais p/ o buffer
+        case 3:                                              // NACK em dado
+        case RESULT_SHORT_READ: return ErrorClass::DATA;
+        case 5:                 return ErrorClass::TIMEOUT;
+        default:                return ErrorClass::BUS;      // 4 e desconhecidos
+    }
+}
+
+//=============================================================================
+// CICLO DE VIDA
+//=============================================================================
+
+bool I2CBus::begin(TwoWire* wire) {
+    if (_lock == NULL) {
+        _lock = xSemaphoreCreateMutex();
+        bool ok = (_lock != NULL);
+        for (uint8_t i = 0; i < MAX_WAITERS && ok; i++) {
+            _waiters[i].sem = xSemaphoreCreateBinary();
+            ok = (_waiters[i].sem != NULL);
+        }
+        if (!ok) {
+            DEBUG_PRINTLN("[I2CBus] ERRO: Falha ao criar semaforos!");
+            return false;
+        }
+    }
+
+    _wire = wire;
+    _wire->begin(SENSOR_I2C_SDA, SENSOR_I2C_SCL);
+    _wire->setClock(I2C_FREQUENCY);
+    _wire->setBufferSize(512);
+    _wireTimeoutMs = 0;
+    _applyTimeout(I2C_TIMEOUT_MS);
+
+    resetStats();
+    return true;
+}
+
+void I2CBus::setDeviceTimeout(uint8_t addr, uint16_t timeoutMs) {
+    if (_lock == NULL) return;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    DeviceStats* d = _device(addr);
+    if (d != nullptr) d->timeoutMs = timeoutMs;
+    xSemaphoreGive(_lock);
+}
+
+void I2CBus::_applyTimeout(uint16_t timeoutMs) {
+    if (timeoutMs == _wireTimeoutMs) return;
+    // setTimeOut (não o setTimeout do Stream) é o limite por transação I2C
+    _wire->setTimeOut(timeoutMs);
+    _wireTimeoutMs = timeoutMs;
+}
+
+uint16_t I2CBus::_timeoutFor(const Transaction& txn) {
+    // endereço + registrador + dados (+ endereço de leitura), 9 bits por byte
+    uint32_t bytes = 2 + txn.len + (txn.op == Transaction::Op::READ ? 1 : 0);
+    uint32_t ms = (bytes * 9UL * 1000UL) / I2C_FREQUENCY;
+    ms = 2 * ms + 1;
+    return (ms > I2C_TIMEOUT_MS) ? (uint16_t)ms : (uint16_t)I2C_TIMEOUT_MS;
+}
+
+//=============================================================================
+// SESSÕES
+//=============================================================================
+
+bool I2CBus::acquire(Priority prio, uint8_t addr, uint32_t timeoutMs) {
+    if (_lock == NULL) return false;
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (_owner == self) {
+        _depth++;
+        xSemaphoreGive(_lock);
+        return true;
+    }
+    if (_recovery != Recovery::IDLE) {
+        _rejected++;
+        xSemaphoreGive(_lock);
+        return false;
+    }
+    if (_owner == NULL) {
+        _grant(self, prio, addr, 0);
+        xSemaphoreGive(_lock);
+        return true;
+    }
+
+    Waiter* w = nullptr;
+    for (uint8_t i = 0; i < MAX_WAITERS; i++) {
+        if (!_waiters[i].used) { w = &_waiters[i]; break; }
+    }
+    if (w == nullptr || timeoutMs == 0) {
+        _prio[(uint8_t)prio].timeouts++;
+        _errorTotal++;
+        xSemaphoreGive(_lock);
+        return false;
+    }
+    w->used = true;
+    w->granted = false;
+    w->task = self;
+    w->prio = prio;
+    w->addr = addr;
+    w->seq = _seq++;
+    w->sinceMs = millis();
+    w->sinceUs = micros();
+    xSemaphoreGive(_lock);
+
+    bool got = (xSemaphoreTake(w->sem, pdMS_TO_TICKS(timeoutMs)) == pdTRUE);
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (!got && w->granted) {
+        // Concedido entre o timeout e o _lock: consome o sinal pendente
+        xSemaphoreTake(w->sem, 0);
+        got = true;
+    }
+    if (!got) {
+        _prio[(uint8_t)prio].timeouts++;
+        _errorTotal++;
+    }
+    w->used = false;
+    xSemaphoreGive(_lock);
+    return got;
+}
+
+void I2CBus::release(bool ok) {
+    if (_lock == NULL) return;
+
+    // Falha do driver: probe do endereço (ainda com a posse) separa
+    // dispositivo ausente / barramento preso de erro de protocolo
+    ErrorClass err = ErrorClass::NONE;
+    if (!ok && _owner == xTaskGetCurrentTaskHandle() && _sessionErr == ErrorClass::NONE) {
+        err = ErrorClass::DATA;
+        if (_ownerAddr != 0) {
+            _wire->beginTransmission(_ownerAddr);
+            uint8_t code = _wire->endTransmission();
+            if (code != RESULT_OK) err = classify(code);
+        }
+    }
+    _finish(err);
+}
+
+void I2CBus::_finish(ErrorClass err) {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (_owner != xTaskGetCurrentTaskHandle()) {
+        xSemaphoreGive(_lock);
+        return;
+    }
+    if (_sessionErr == ErrorClass::NONE) _sessionErr = err;
+    if (--_depth > 0) {
+        xSemaphoreGive(_lock);
+        return;
+    }
+
+    _account(_ownerAddr, micros() - _grantUs, _sessionErr);
+    _owner = NULL;
+    _dispatch();
+    xSemaphoreGive(_lock);
+}
+
+//=============================================================================
+// TRANSAÇÕES
+//=============================================================================
+
+bool I2CBus::transfer(Transaction& txn, uint32_t timeoutMs) {
+    uint32_t t0 = micros();
+    if (!acquire(txn.priority, txn.addr, timeoutMs)) {
+        txn.result = RESULT_BUSY;
+        txn.latencyUs = micros() - t0;
+        return false;
+    }
+    _execute(txn);
+    txn.latencyUs = micros() - t0;
+    _finish(classify(txn.result));
+    return (txn.result == RESULT_OK);
+}
+
+bool I2CBus::submit(const Transaction& txn) {
+    if (_lock == NULL) return false;
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool runNow = (_owner == self) || (_owner == NULL && _recovery == Recovery::IDLE);
+    if (!runNow) {
+        Pending* p = nullptr;
+        for (uint8_t i = 0; i < MAX_PENDING; i++) {
+            if (!_pending[i].used) { p = &_pending[i]; break; }
+        }
+        if (p == nullptr) {
+            _queueFull++;
+            _errorTotal++;
+            xSemaphoreGive(_lock);
+            return false;
+        }
+        p->used = true;
+        p->txn = txn;
+        p->seq = _seq++;
+        p->sinceMs = millis();
+        p->sinceUs = micros();
+        xSemaphoreGive(_lock);
+        return true;
+    }
+    xSemaphoreGive(_lock);
+
+    // Barramento livre (ou já nosso): executa agora, na task de quem submeteu
+    Transaction t = txn;
+    transfer(t, t.deadlineMs > 0 ? t.deadlineMs : I2C_ACQUIRE_TIMEOUT_MS);
+    if (t.callback) t.callback(t, t.ctx);
+    return true;
+}
+
+//=============================================================================
+// ESCALONAMENTO (chamado com _lock)
+//=============================================================================
+
+uint8_t I2CBus::_effective(Priority prio, uint32_t waitedMs) {
+    uint32_t boost = waitedMs / I2C_AGING_MS;
+    uint8_t p = (uint8_t)prio;
+    return (boost >= p) ? 0 : (uint8_t)(p - boost);
+}
+
+int8_t I2CBus::_pickWaiter(uint8_t& effPrio, uint32_t& seq, uint32_t now) const {
+    int8_t best = -1;
+    for (uint8_t i = 0; i < MAX_WAITERS; i++) {
+        const Waiter& w = _waiters[i];
+        if (!w.used || w.granted) continue;
+        uint8_t e = _effective(w.prio, now - w.sinceMs);
+        if (best < 0 || e < effPrio || (e == effPrio && (int32_t)(w.seq - seq) < 0)) {
+            best = i;
+            effPrio = e;
+            seq = w.seq;
+        }
+    }
+    return best;
+}
+
+int8_t I2CBus::_pickPending(uint8_t& effPrio, uint32_t& seq, uint32_t now) const {
+    int8_t best = -1;
+    for (uint8_t i = 0; i < MAX_PENDING; i++) {
+        const Pending& p = _pending[i];
+        if (!p.used) continue;
+        uint8_t e = _effective(p.txn.priority, now - p.sinceMs);
+        if (best < 0 || e < effPrio || (e == effPrio && (int32_t)(p.seq - seq) < 0)) {
+            best = i;
+            effPrio = e;
+            seq = p.seq;
+        }
+    }
+    return best;
+}
+
+void I2CBus::_dispatch() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    for (;;) {
+        // Recuperação agendada: ninguém recebe o barramento até terminar
+        if (_recovery != Recovery::IDLE) return;
+
+        uint32_t now = millis();
+        uint8_t wPrio = 0, pPrio = 0;
+        uint32_t wSeq = 0, pSeq = 0;
+        int8_t w = _pickWaiter(wPrio, wSeq, now);
+        int8_t p = _pickPending(pPrio, pSeq, now);
+        if (w < 0 && p < 0) return;
+
+        if (w >= 0 && (p < 0 || wPrio < pPrio ||
+                       (wPrio == pPrio && (int32_t)(wSeq - pSeq) < 0))) {
+            Waiter& wt = _waiters[w];
+            _grant(wt.task, wt.prio, wt.addr, micros() - wt.sinceUs);
+            wt.granted = true;
+            xSemaphoreGive(wt.sem);
+            return;
+        }
+
+        // Transação da fila: roda nesta task, que segura o barramento
+        Pending& pd = _pending[p];
+        Transaction txn = pd.txn;
+        uint32_t sinceUs = pd.sinceUs;
+        bool expired = (txn.deadlineMs > 0 && now - pd.sinceMs > txn.deadlineMs);
+        pd.used = false;
+
+        if (expired) {
+            _prio[(uint8_t)txn.priority].expired++;
+            _errorTotal++;
+            _owner = self;
+            _depth = 1;
+            txn.result = RESULT_EXPIRED;
+        } else {
+            _grant(self, txn.priority, txn.addr, micros() - sinceUs);
+        }
+        xSemaphoreGive(_lock);
+
+        uint32_t busyUs = 0;
+        if (!expired) {
+            _execute(txn);
+            busyUs = micros() - _grantUs;
+        }
+        txn.latencyUs = micros() - sinceUs;
+        if (txn.callback) txn.callback(txn, txn.ctx);
+
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        if (!expired) _account(txn.addr, busyUs, classify(txn.result));
+        _owner = NULL;
+        _depth = 0;
+    }
+}
+
+void I2CBus::_grant(TaskHandle_t task, Priority prio, uint8_t addr, uint32_t waitedUs) {
+    _owner = task;
+    _depth = 1;
+    _sessionErr = ErrorClass::NONE;
+    _ownerAddr = addr;
+    _grantUs = micros();
+
+    DeviceStats* d = _device(addr);
+    _applyTimeout(d != nullptr ? d->timeoutMs : (uint16_t)I2C_TIMEOUT_MS);
+
+    PriorityStats& s = _prio[(uint8_t)prio];
+    s.grants++;
+    s.waitTotalUs += waitedUs;
+    if (waitedUs > s.waitMaxUs) s.waitMaxUs = waitedUs;
+}
+
+void I2CBus::_account(uint8_t addr, uint32_t busyUs, ErrorClass err) {
+    _busyUs += busyUs;
+
+    if (err == ErrorClass::TIMEOUT || err == ErrorClass::BUS) {
+        if (_busErrorStreak < 255) _busErrorStreak++;
+        if (_busErrorStreak >= I2C_RECOVERY_THRESHOLD) _scheduleRecovery();
+    } else if (err == ErrorClass::NONE) {
+        _busErrorStreak = 0;
+    }
+
+    DeviceStats* d = _device(addr);
+    if (err != ErrorClass::NONE) _errorTotal++;
+    if (d == nullptr) return;
+
+    d->count++;
+    if (err != ErrorClass::NONE) {
+        d->errors++;
+        d->byClass[(uint8_t)err]++;
+    }
+    d->lastUs = busyUs;
+    if (busyUs > d->maxUs) d->maxUs = busyUs;
+    d->totalUs += busyUs;
+}
+
+I2CBus::DeviceStats* I2CBus::_device(uint8_t addr) {
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        if (_devices[i].addr == addr) return &_devices[i];
+    }
+    if (_deviceCount >= MAX_DEVICES) return nullptr;
+    DeviceStats* d = &_devices[_deviceCount++];
+    memset(d, 0, sizeof(*d));
+    d->addr = addr;
+    d->timeoutMs = I2C_TIMEOUT_MS;
+    return d;
+}
+
+//=============================================================================
+// RECUPERAÇÃO
+//=============================================================================
+
+void I2CBus::requestRecovery() {
+    if (_lock == NULL) return;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _scheduleRecovery();
+    xSemaphoreGive(_lock);
+}
+
+void I2CBus::_scheduleRecovery() {
+    if (_recovery != Recovery::IDLE) return;
+    if ((int32_t)(millis() - _recoveryNotBeforeMs) < 0) return;
+    _recovery = Recovery::PENDING;
+    DEBUG_PRINTLN("[I2CBus] Recuperacao do barramento agendada");
+}
+
+void I2CBus::service() {
+    if (_lock == NULL || _recovery == Recovery::IDLE) return;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _stepRecovery(millis());
+    xSemaphoreGive(_lock);
+}
+
+void I2CBus::_stepRecovery(uint32_t now) {
+    switch (_recovery) {
+        case Recovery::PENDING:
+            if (_owner != NULL) return;     // Sessão em curso termina primeiro
+            DEBUG_PRINTLN("[I2CBus] >>> RECUPERANDO BARRAMENTO I2C <<<");
+            _wire->end();
+            pinMode(SENSOR_I2C_SDA, INPUT_PULLUP);
+            pinMode(SENSOR_I2C_SCL, OUTPUT_OPEN_DRAIN);
+            digitalWrite(SENSOR_I2C_SCL, HIGH);
+            _recovery = Recovery::CLOCK;
+            return;
+
+        case Recovery::CLOCK:
+            // Escravo preso no meio de um byte solta SDA em até 9 clocks
+            for (uint8_t i = 0; i < RECOVERY_PULSES && digitalRead(SENSOR_I2C_SDA) == LOW; i++) {
+                digitalWrite(SENSOR_I2C_SCL, LOW);
+                delayMicroseconds(RECOVERY_HALF_US);
+                digitalWrite(SENSOR_I2C_SCL, HIGH);
+                delayMicroseconds(RECOVERY_HALF_US);
+            }
+            _recovery = Recovery::STOP;
+            return;
+
+        case Recovery::STOP:
+            digitalWrite(SENSOR_I2C_SCL, LOW);
+            pinMode(SENSOR_I2C_SDA, OUTPUT_OPEN_DRAIN);
+            digitalWrite(SENSOR_I2C_SDA, LOW);
+            delayMicroseconds(RECOVERY_HALF_US);
+            digitalWrite(SENSOR_I2C_SCL, HIGH);
+            delayMicroseconds(RECOVERY_HALF_US);
+            digitalWrite(SENSOR_I2C_SDA, HIGH);
+            delayMicroseconds(RECOVERY_HALF_US);
+            pinMode(SENSOR_I2C_SDA, INPUT_PULLUP);
+            if (digitalRead(SENSOR_I2C_SDA) == LOW) {
+                _recoveryFailures++;
+                _recoveryNotBeforeMs = now + RECOVERY_BACKOFF_MS;
+                DEBUG_PRINTLN("[I2CBus] AVISO: SDA continua preso apos recuperacao");
+            }
+            _recovery = Recovery::RESTART;
+            return;
+
+        case Recovery::RESTART:
+            _wire->begin(SENSOR_I2C_SDA, SENSOR_I2C_SCL);
+            _wire->setClock(I2C_FREQUENCY);
+            _wireTimeoutMs = 0;
+            _applyTimeout(I2C_TIMEOUT_MS);
+            _recoveryUntilMs = now + RECOVERY_SETTLE_MS;
+            _recovery = Recovery::SETTLE;
+            return;
+
+        case Recovery::SETTLE:
+            if ((int32_t)(now - _recoveryUntilMs) < 0) return;
+            _recovery = Recovery::IDLE;
+            _recoveries++;
+            _busErrorStreak = 0;
+            DEBUG_PRINTF("[I2CBus] Barramento reiniciado (#%lu)\n", (unsigned long)_recoveries);
+            if (_owner == NULL) _dispatch();   // Transações que ficaram na fila
+            return;
+
+        default:
+            return;
+    }
+}
+
+//=============================================================================
+// EXECUÇÃO (sem _lock, com a posse do barramento)
+//=============================================================================
+
+void I2CBus::_execute(Transaction& txn) {
+    // Prazo da transação (descritor ou pelo tamanho); volta ao da sessão depois
+    uint16_t sessionTimeout = _wireTimeoutMs;
+    _applyTimeout(txn.timeoutMs ? txn.timeoutMs : _timeoutFor(txn));
+    _transact(txn);
+    _applyTimeout(sessionTimeout);
+}
+
+void I2CBus::_transact(Transaction& txn) {
+    _wire->beginTransmission(txn.addr);
+    if (txn.op == Transaction::Op::PROBE) {
+        txn.result = _wire->endTransmission();
+        return;
+    }
+
+    _wire->write(txn.reg);
+    if (txn.op == Transaction::Op::WRITE) {
+        if (txn.len > 0) _wire->write(txn.data, txn.len);
+        txn.result = _wire->endTransmission();
+        return;
+    }
+
+    txn.result = _wire->endTransmission(false);
+    if (txn.result != RESULT_OK) return;
+
+    if (_wire->requestFrom(txn.addr, txn.len) != txn.len) {
+        while (_wire->available()) _wire->read();
+        txn.result = RESULT_SHORT_READ;
+        return;
+    }
+    for (uint8_t i = 0; i < txn.len; i++) txn.data[i] = _wire->read();
+}
+
+//=============================================================================
+// ESTATÍSTICAS
+//=============================================================================
+
+float I2CBus::getUtilization() const {
+    uint32_t elapsedMs = millis() - _statsSinceMs;
+    if (elapsedMs == 0) return 0.0f;
+    float pct = (float)_busyUs / ((float)elapsedMs * 10.0f);
+    return (pct > 100.0f) ? 100.0f : pct;   // janela em ms truncados
+}
+
+void I2CBus::resetStats() {
+    if (_lock != NULL) xSemaphoreTake(_lock, portMAX_DELAY);
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        // Endereço e timeout configurado sobrevivem ao reset
+        uint8_t addr = _devices[i].addr;
+        uint16_t timeoutMs = _devices[i].timeoutMs;
+        memset(&_devices[i], 0, sizeof(_devices[i]));
+        _devices[i].addr = addr;
+        _devices[i].timeoutMs = timeoutMs;
+    }
+    memset(_prio, 0, sizeof(_prio));
+    _busyUs = 0;
+    _queueFull = 0;
+    _statsSinceMs = millis();
+    if (_lock != NULL) xSemaphoreGive(_lock);
+}
+
+void I2CBus::printStatus() const {
+    DEBUG_PRINTLN("=== I2C BUS ===");
+    DEBUG_PRINTF("Ocupacao: %.1f%% em %lu ms, erros desde o boot: %lu\n",
+                 getUtilization(), (unsigned long)(millis() - _statsSinceMs),
+                 (unsigned long)_errorTotal);
+
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        const DeviceStats& d = _devices[i];
+        DEBUG_PRINTF("  0x%02X: %lu acessos, %lu erros, ultimo %lu us, media %lu us, max %lu us, timeout %u ms\n",
+                     d.addr, (unsigned long)d.count, (unsigned long)d.errors,
+                     (unsigned long)d.lastUs,
+                     (unsigned long)(d.count ? d.totalUs / d.count : 0),
+                     (unsigned long)d.maxUs, (unsigned)d.timeoutMs);
+        if (d.errors > 0) {
+            DEBUG_PRINTF("        NACK %lu, DADOS %lu, TIMEOUT %lu, BARRAMENTO %lu\n",
+                         (unsigned long)d.byClass[(uint8_t)ErrorClass::NACK],
+                         (unsigned long)d.byClass[(uint8_t)ErrorClass::DATA],
+                         (unsigned long)d.byClass[(uint8_t)ErrorClass::TIMEOUT],
+                         (unsigned long)d.byClass[(uint8_t)ErrorClass::BUS]);
+        }
+    }
+
+    for (uint8_t p = 0; p < PRIORITY_LEVELS; p++) {
+        const PriorityStats& s = _prio[p];
+        DEBUG_PRINTF("  %-10s: %lu concessoes, espera media %lu us, max %lu us, "
+                     "%lu timeouts, %lu expiradas\n",
+                     PRIORITY_NAMES[p], (unsigned long)s.grants,
+                     (unsigned long)(s.grants ? s.waitTotalUs / s.grants : 0),
+                     (unsigned long)s.waitMaxUs, (unsigned long)s.timeouts,
+                     (unsigned long)s.expired);
+    }
+    DEBUG_PRINTF("Fila cheia: %lu\n", (unsigned long)_queueFull);
+    DEBUG_PRINTF("Recuperacao: %s, %lu concluidas, %lu com SDA preso, %lu recusas\n",
+                 RECOVERY_NAMES[(uint8_t)_recovery], (unsigned long)_recoveries,
+                 (unsigned long)_recoveryFailures, (unsigned long)_rejected);
+    DEBUG_PRINTLN("===============");
+}
@@ -0,0 +1,437 @@
+/**
+ * @file I2CBus.h
+ * @brief Escalonador central do barramento I2C (prioridades, prazos, estatísticas)
+ *
+ * @details Dono único do Wire. Substitui o xI2CMutex global e o mutex
+ *          próprio do SensorManager:
+ *          - Sessões exclusivas (acquire/release) concedidas por prioridade
+ *          - Transações descritas (probe, escrita, leitura de registrador)
+ *            executadas em sequência com callback de conclusão
+ *          - Envelhecimento: quem espera sobe de prioridade (sem inanição)
+ *          - Prazos: sessão com timeout, transação expira na fila
+ *          - Estatísticas: ocupação do barramento, latência e erros por
+ *            dispositivo, espera e timeouts por prioridade
+ *          - Latência limitada: timeout do Wire por dispositivo/transação
+ *            (poucos ms), erros classificados, recuperação incremental
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.1.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Prioridades
+ * | Prioridade | Uso                                   |
+ * |------------|---------------------------------------|
+ * | IMU        | FIFO do MPU9250 (FastTask)            |
+ * | FAST       | BMP280, reconfiguração de sensores    |
+ * | SLOW       | SI7021, CCS811                        |
+ * | BACKGROUND | DS3231, baseline, calibração          |
+ *
+ * ## Escolha do próximo dono
+ * Ao liberar o barramento, o dono atual escolhe entre sessões em espera e
+ * transações na fila a de menor prioridade efetiva:
+ * `prioridade - tempo_esperando / I2C_AGING_MS` (empate: ordem de chegada).
+ * Uma sessão BACKGROUND espera no máximo ~3 x I2C_AGING_MS atrás de
+ * tráfego IMU contínuo.
+ *
+ * ## Transações assíncronas
+ * submit() executa na hora se o barramento está livre (ou se quem chama já
+ * é o dono); senão enfileira. Transações enfileiradas rodam em sequência
+ * na task que libera o barramento, e o callback é chamado nessa task.
+ *
+ * ## Erros e Recuperação
+ * | Classe  | Origem                                   | Ação              |
+ * |---------|------------------------------------------|-------------------|
+ * | NACK    | Endereço sem ACK (código 2)              | Só contabiliza    |
+ * | DATA    | NACK de dado, leitura curta, falha do driver com o endereço respondendo | Só contabiliza |
+ * | TIMEOUT | Timeout do Wire (código 5)               | Conta para recuperar |
+ * | BUS     | Erro de barramento (código 4)            | Conta para recuperar |
+ *
+ * Sessão marcada com falha é classificada por um probe do endereço.
+ * I2C_RECOVERY_THRESHOLD erros TIMEOUT/BUS seguidos (ou requestRecovery())
+ * iniciam a recuperação, que avança um passo por service():
+ *
+ * PENDING (espera o dono soltar) -> CLOCK (até 9 pulsos de SCL enquanto
+ * SDA baixo) -> STOP -> RESTART (Wire.begin) -> SETTLE -> IDLE
+ *
+ * Nenhum passo bloqueia mais que ~100 us. Durante a recuperação acquire()
+ * é recusado na hora e transações ficam na fila.
+ *
+ * @note Drivers de biblioteca (Wire direto) rodam dentro de uma Session;
+ *       a sessão é a unidade de arbitragem e de estatística
+ * @warning Callbacks devem ser curtos: rodam com o barramento ocupado
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "config.h"
+
+/**
+ * @class I2CBus
+ * @brief Arbitragem e execução de transações no barramento I2C (Singleton)
+ */
+class I2CBus {
+public:
+    /**
+     * @enum Priority
+     * @brief Prioridade de acesso (menor valor = mais urgente)
+     */
+    enum class Priority : uint8_t {
+        IMU = 0,         ///< Lote do FIFO do IMU
+        FAST = 1,        ///< Barômetro e sensores rápidos
+        SLOW = 2,        ///< Sensores ambientais
+        BACKGROUND = 3   ///< RTC, baseline, manutenção
+    };
+    static constexpr uint8_t PRIORITY_LEVELS = 4;  ///< Número de prioridades
+
+    /**
+     * @enum ErrorClass
+     * @brief Classificação de falha por dispositivo
+     */
+    enum class ErrorClass : uint8_t {
+        NONE = 0,   ///< Sem erro
+        NACK,       ///< Endereço não respondeu
+        DATA,       ///< Dispositivo responde, operação falhou
+        TIMEOUT,    ///< Timeout do Wire (SCL preso / clock stretching)
+        BUS         ///< Erro de barramento (arbitragem, SDA preso)
+    };
+    static constexpr uint8_t ERROR_CLASSES = 5;    ///< Número de classes
+
+    /**
+     * @enum Recovery
+     * @brief Estados da recuperação do barramento
+     */
+    enum class Recovery : uint8_t {
+        IDLE,       ///< Operação normal
+        PENDING,    ///< Aguardando o dono atual liberar
+        CLOCK,      ///< Pulsos de SCL para soltar SDA
+        STOP,       ///< Condição de STOP manual
+        RESTART,    ///< Reinicia o periférico I2C
+        SETTLE      ///< Espera antes de liberar o barramento
+    };
+
+    struct Transaction;
+
+    /** @brief Callback de conclusão de transação assíncrona */
+    typedef void (*Callback)(const Transaction& txn, void* ctx);
+
+    /**
+     * @struct Transaction
+     * @brief Descritor de uma transação I2C
+     */
+    struct Transaction {
+        /** @brief Tipo de operação */
+        enum class Op : uint8_t {
+            PROBE,   ///< Escrita vazia (detecção de ACK)
+            WRITE,   ///< reg + data[0..len)
+            READ     ///< reg, repeated start, len bytes para data
+        };
+
+        Op op;                ///< Operação
+        uint8_t addr;         ///< Endereço de 7 bits
+        uint8_t reg;          ///< Registrador (ignorado em PROBE)
+        uint8_t* data;        ///< Buffer de escrita/leitura
+        uint8_t len;          ///< Bytes em data
+        Priority priority;    ///< Prioridade na fila
+        uint16_t deadlineMs;  ///< Prazo na fila (0 = sem prazo)
+        uint8_t timeoutMs;    ///< Timeout do Wire (0 = pelo tamanho)
+        Callback callback;    ///< Conclusão (pode ser nullptr)
+        void* ctx;            ///< Contexto do callback
+
+        uint8_t result;       ///< [out] RESULT_OK, código do Wire ou RESULT_*
+        uint32_t latencyUs;   ///< [out] Submissão até conclusão
+    };
+
+    static constexpr uint8_t RESULT_OK = 0;            ///< Sucesso
+    static constexpr uint8_t RESULT_SHORT_READ = 0xF0; ///< requestFrom incompleto
+    static constexpr uint8_t RESULT_EXPIRED = 0xF1;    ///< Prazo vencido na fila
+    static constexpr uint8_t RESULT_BUSY = 0xF2;       ///< Barramento não concedido
+
+    /** @brief Classe de erro de um resultado (código do Wire ou RESULT_*) */
+    static ErrorClass classify(uint8_t result);
+
+    /** @brief Leitura de len bytes a partir de reg */
+    static Transaction readReg(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len,
+                               Priority prio);
+    /** @brief Escrita de len bytes a partir de reg */
+    static Transaction writeReg(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len,
+                                Priority prio);
+    /** @brief Detecção de dispositivo (ACK do endereço) */
+    static Transaction probe(uint8_t addr, Priority prio);
+
+    /**
+     * @struct DeviceStats
+     * @brief Estatísticas de um endereço (por sessão ou transação)
+     */
+    struct DeviceStats {
+        uint8_t addr;         ///< Endereço de 7 bits
+        uint16_t timeoutMs;   ///< Timeout do Wire nas sessões deste endereço
+        uint32_t count;       ///< Sessões/transações concluídas
+        uint32_t errors;      ///< Concluídas com falha
+        uint32_t byClass[ERROR_CLASSES]; ///< Falhas por ErrorClass
+        uint32_t lastUs;      ///< Última ocupação do barramento
+        uint32_t maxUs;       ///< Pior ocupação
+        uint64_t totalUs;     ///< Ocupação acumulada
+    };
+
+    /**
+     * @struct PriorityStats
+     * @brief Estatísticas de espera por prioridade
+     */
+    struct PriorityStats {
+        uint32_t grants;      ///< Concessões
+        uint32_t timeouts;    ///< Sessões não concedidas no prazo
+        uint32_t expired;     ///< Transações descartadas por prazo
+        uint32_t waitMaxUs;   ///< Pior espera até a concessão
+        uint64_t waitTotalUs; ///< Espera acumulada
+    };
+
+    /**
+     * @class Session
+     * @brief Posse exclusiva do barramento no escopo (RAII)
+     *
+     * @code
+     * I2CBus::Session bus(I2CBus::Priority::FAST, BMP280::I2C_ADDR_PRIMARY);
+     * if (bus) { _bmp280.update(); }
+     * @endcode
+     */
+    class Session {
+    public:
+        Session(Priority prio, uint8_t addr, uint32_t timeoutMs = I2C_ACQUIRE_TIMEOUT_MS)
+            : _held(I2CBus::instance().acquire(prio, addr, timeoutMs)), _ok(true) {}
+        ~Session() { if (_held) I2CBus::instance().release(_ok); }
+
+        explicit operator bool() const { return _held; }
+
+        /** @brief Marca a sessão como falha (conta erro no dispositivo) */
+        void fail() { _ok = false; }
+
+    private:
+        Session(const Session&) = delete;
+        Session& operator=(const Session&) = delete;
+        bool _held;  ///< Barramento concedido
+        bool _ok;    ///< Sessão sem falha
+    };
+
+    static I2CBus& instance() {
+        static I2CBus inst;
+        return inst;
+    }
+
+    //=========================================================================
+    // CICLO DE VIDA
+    //=========================================================================
+
+    /**
+     * @brief Configura o Wire e cria os recursos do escalonador
+     * @param wire Barramento (SDA/SCL de pins.h, I2C_FREQUENCY)
+     * @return false se falhou ao criar semáforos
+     */
+    bool begin(TwoWire* wire);
+
+    /** @brief Barramento gerenciado (uso dentro de uma sessão) */
+    TwoWire* wire() const { return _wire; }
+
+    /**
+     * @brief Timeout do Wire nas sessões de um endereço
+     * @details Padrão I2C_TIMEOUT_MS; aumentar só para rajadas longas.
+     */
+    void setDeviceTimeout(uint8_t addr, uint16_t timeoutMs);
+
+    //=========================================================================
+    // RECUPERAÇÃO
+    //=========================================================================
+
+    /**
+     * @brief Avança a recuperação do barramento (um passo)
+     * @note Chamado a cada ciclo da SensorsTask; não bloqueia
+     */
+    void service();
+
+    /** @brief Agenda recuperação (ignorado se já em curso ou em backoff) */
+    void requestRecovery();
+
+    /** @brief Recuperação em curso? */
+    bool isRecovering() const { return _recovery != Recovery::IDLE; }
+
+    /** @brief Recuperações concluídas desde o boot */
+    uint32_t getRecoveryCount() const { return _recoveries; }
+
+    //=========================================================================
+    // SESSÕES
+    //=========================================================================
+
+    /**
+     * @brief Aguarda a posse do barramento
+     * @param prio Prioridade da sessão
+     * @param addr Dispositivo atribuído nas estatísticas
+     * @param timeoutMs Prazo para a concessão
+     * @return true se concedido (reentrante na mesma task)
+     */
+    bool acquire(Priority prio, uint8_t addr, uint32_t timeoutMs = I2C_ACQUIRE_TIMEOUT_MS);
+
+    /**
+     * @brief Libera o barramento e entrega ao próximo (sessão ou transação)
+     * @param ok false conta erro no dispositivo da sessão
+     */
+    void release(bool ok = true);
+
+    //=========================================================================
+    // TRANSAÇÕES
+    //=========================================================================
+
+    /**
+     * @brief Executa uma transação e aguarda o resultado
+     * @param txn Descritor (result e latencyUs preenchidos)
+     * @param timeoutMs Prazo para a concessão do barramento
+     * @return true se result == RESULT_OK
+     */
+    bool transfer(Transaction& txn, uint32_t timeoutMs = I2C_ACQUIRE_TIMEOUT_MS);
+
+    /**
+     * @brief Submete uma transação assíncrona
+     * @details Buffer de data deve permanecer válido até o callback.
+     * @return false se a fila está cheia (callback não será chamado)
+     */
+    bool submit(const Transaction& txn);
+
+    //=========================================================================
+    // ESTATÍSTICAS
+    //=========================================================================
+
+    /** @brief Ocupação do barramento desde begin()/resetStats() (%) */
+    float getUtilization() const;
+
+    /** @brief Dispositivos com estatística */
+    uint8_t getDeviceCount() const { return _deviceCount; }
+
+    /** @brief Estatística do i-ésimo dispositivo */
+    const DeviceStats& getDevice(uint8_t i) const { return _devices[i]; }
+
+    /** @brief Estatística de espera de uma prioridade */
+    const PriorityStats& getPriorityStats(Priority p) const {
+        return _prio[(uint8_t)p];
+    }
+
+    /** @brief Erros, timeouts e expirações desde o boot (resetStats não zera) */
+    uint32_t getErrorCount() const { return _errorTotal; }
+
+    /** @brief Transações recusadas com a fila cheia */
+    uint32_t getQueueFull() const { return _queueFull; }
+
+    /** @brief Sessões recusadas durante a recuperação */
+    uint32_t getRecoveryRejects() const { return _rejected; }
+
+    /** @brief Zera contadores e a janela de ocupação */
+    void resetStats();
+
+    /** @brief Imprime ocupação, dispositivos e prioridades */
+    void printStatus() const;
+
+private:
+    I2CBus();
+    I2CBus(const I2CBus&) = delete;
+    I2CBus& operator=(const I2CBus&) = delete;
+
+    static constexpr uint8_t MAX_WAITERS = 6;   ///< Sessões em espera simultâneas
+    static constexpr uint8_t MAX_PENDING = 8;   ///< Transações na fila
+    static constexpr uint8_t MAX_DEVICES = 10;  ///< Endereços com estatística
+    static constexpr uint8_t RECOVERY_PULSES = 9;          ///< Pulsos de SCL
+    static constexpr uint8_t RECOVERY_HALF_US = 5;         ///< Meio período (100 kHz)
+    static constexpr uint32_t RECOVERY_SETTLE_MS = 50;     ///< Espera após Wire.begin
+    static constexpr uint32_t RECOVERY_BACKOFF_MS = 1000;  ///< Após falha (SDA preso)
+
+    /**
+     * @struct Waiter
+     * @brief Sessão aguardando concessão
+     */
+    struct Waiter {
+        bool used;                 ///< Slot ocupado
+        bool granted;              ///< Concedido pelo dono anterior
+        TaskHandle_t task;         ///< Task em espera
+        SemaphoreHandle_t sem;     ///< Sinal de concessão (binário, por slot)
+        Priority prio;             ///< Prioridade pedida
+        uint8_t addr;              ///< Dispositivo da sessão
+        uint32_t seq;              ///< Ordem de chegada
+        uint32_t sinceMs;          ///< Início da espera (envelhecimento)
+        uint32_t sinceUs;          ///< Início da espera (estatística)
+    };
+
+    /**
+     * @struct Pending
+     * @brief Transação assíncrona na fila
+     */
+    struct Pending {
+        bool used;                 ///< Slot ocupado
+        Transaction txn;           ///< Descritor (cópia)
+        uint32_t seq;              ///< Ordem de chegada
+        uint32_t sinceMs;          ///< Submissão (prazo e envelhecimento)
+        uint32_t sinceUs;          ///< Submissão (latência)
+    };
+
+    //=========================================================================
+    // ESTADO (protegido por _lock)
+    //=========================================================================
+    TwoWire* _wire;                ///< Barramento gerenciado
+    SemaphoreHandle_t _lock;       ///< Protege o estado do escalonador
+    TaskHandle_t _owner;           ///< Dono atual (NULL = livre)
+    uint8_t _depth;                ///< Aninhamento de acquire do dono
+    ErrorClass _sessionErr;        ///< Primeiro erro da sessão (aninhadas inclusas)
+    uint8_t _ownerAddr;            ///< Dispositivo da sessão atual
+    uint32_t _grantUs;             ///< Início da posse atual
+    uint32_t _seq;                 ///< Contador de chegada
+
+    Waiter _waiters[MAX_WAITERS];  ///< Sessões em espera
+    Pending _pending[MAX_PENDING]; ///< Transações na fila
+
+    //=========================================================================
+    // ESTATÍSTICAS
+    //=========================================================================
+    DeviceStats _devices[MAX_DEVICES];      ///< Por endereço
+    uint8_t _deviceCount;                   ///< Entradas em _devices
+    PriorityStats _prio[PRIORITY_LEVELS];   ///< Por prioridade
+    uint64_t _busyUs;                       ///< Ocupação acumulada
+    uint32_t _statsSinceMs;                 ///< Início da janela
+    uint32_t _queueFull;                    ///< submit() recusados
+    uint32_t _errorTotal;                   ///< Falhas desde o boot
+
+    //=========================================================================
+    // LATÊNCIA E RECUPERAÇÃO
+    //=========================================================================
+    uint16_t _wireTimeoutMs;                ///< Timeout aplicado ao Wire
+    uint8_t _busErrorStreak;                ///< TIMEOUT/BUS seguidos
+    Recovery _recovery;                     ///< Estado da recuperação
+    uint32_t _recoveryUntilMs;              ///< Fim da espera do passo atual
+    uint32_t _recoveryNotBeforeMs;          ///< Backoff após falha
+    uint32_t _recoveries;                   ///< Recuperações concluídas
+    uint32_t _recoveryFailures;             ///< SDA ainda preso após o STOP
+    uint32_t _rejected;                     ///< acquire() recusados na recuperação
+
+    //=========================================================================
+    // MÉTODOS PRIVADOS
+    //=========================================================================
+    void _grant(TaskHandle_t task, Priority prio, uint8_t addr, uint32_t waitedUs); ///< Passa a posse
+    void _account(uint8_t addr, uint32_t busyUs, ErrorClass err); ///< Atualiza dispositivo e ocupação
+    DeviceStats* _device(uint8_t addr);      ///< Entrada do endereço (cria se preciso)
+    void _applyTimeout(uint16_t timeoutMs);  ///< setTimeOut só se mudou
+    static uint16_t _timeoutFor(const Transaction& txn); ///< Timeout pelo tamanho
+    void _scheduleRecovery();                ///< IDLE -> PENDING, respeitando o backoff
+    void _stepRecovery(uint32_t now);        ///< Um passo da recuperação (com _lock)
+    void _finish(ErrorClass err);            ///< Fim de sessão já classificado
+    void _dispatch();                        ///< Entrega ao próximo (com _lock, pode soltá-lo)
+    int8_t _pickWaiter(uint8_t& effPrio, uint32_t& seq, uint32_t now) const; ///< Melhor sessão
+    int8_t _pickPending(uint8_t& effPrio, uint32_t& seq, uint32_t now) const; ///< Melhor transação
+    void _execute(Transaction& txn);         ///< Aplica o prazo e executa (sem _lock)
+    void _transact(Transaction& txn);        ///< Sequência Wire da transação
+    static uint8_t _effective(Priority prio, uint32_t waitedMs); ///< Prioridade com envelhecimento
+};
+
+#endif // I2C_BUS_H
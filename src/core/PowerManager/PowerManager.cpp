@@ -1,7 +1,7 @@
 /**
  * @file PowerManager.cpp
  * @brief Implementação PowerManager com Curva Li-ion Corrigida
- * @version 2.1.0
+ * @version 2.2.0
  */
 
 #include "PowerManager.h"
@@ -10,7 +10,7 @@
 PowerManager::PowerManager() :
     _voltage(0.0f), _percentage(0.0f),
     _isCritical(false), _isLow(false), _powerSaveEnabled(false),
-    _avgVoltage(0.0f), _lastUpdate(0)
+    _avgVoltage(0.0f), _sampleSum(0), _sampleCount(0)
 {}
 
 bool PowerManager::begin() {
@@ -27,12 +27,14 @@ bool PowerManager::begin() {
     return true;
 }
 
-void PowerManager::update() {
-    uint32_t now = millis();
-    if (now - _lastUpdate < UPDATE_INTERVAL) return;
-    _lastUpdate = now;
+bool PowerManager::update() {
+    // Uma amostra por chamada: a média não bloqueia a SensorsTask
+    _sampleSum += analogRead(BATTERY_PIN);
+    if (++_sampleCount < SAMPLES) return true;
 
-    float rawV = _readVoltage();
+    float rawV = _toVoltage(_sampleSum / (float)SAMPLES);
+    _sampleSum = 0;
+    _sampleCount = 0;
     
     // Filtro Exponencial (Low Pass)
     _avgVoltage = (0.2f * rawV) + (0.8f * _avgVoltage);
@@ -41,18 +43,20 @@ void PowerManager::update() {
     _percentage = _calculatePercentage(_voltage);
     
     _updateStatus(_voltage);
+    return false;
 }
 
 float PowerManager::_readVoltage() {
     uint32_t sum = 0;
-    const int samples = 10;
-    for (int i = 0; i < samples; i++) {
+    for (uint8_t i = 0; i < SAMPLES; i++) {
         sum += analogRead(BATTERY_PIN);
         delay(2);
     }
-    
-    float rawVoltage = (sum / (float)samples) / 4095.0f * BATTERY_VREF;
-    return rawVoltage * BATTERY_DIVIDER;
+    return _toVoltage(sum / (float)SAMPLES);
+}
+
+float PowerManager::_toVoltage(float raw) {
+    return raw / 4095.0f * BATTERY_VREF * BATTERY_DIVIDER;
 }
 
 // ============================================================================
@@ -11,7 +11,7 @@
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 2.1.0
+ * @version 2.2.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -66,10 +66,11 @@ public:
     bool begin();
     
     /**
-     * @brief Atualiza leitura de tensão e status
-     * @note Usa média móvel para estabilidade
+     * @brief Colhe uma amostra do ADC; a cada SAMPLES atualiza tensão e status
+     * @return true se a média em curso ainda precisa de amostras
+     * @note Período definido pelo SensorScheduler (SensorRates::powerMs)
      */
-    void update();
+    bool update();
 
     //=========================================================================
     // GETTERS DE DADOS
@@ -116,20 +117,24 @@ private:
     bool _powerSaveEnabled;      ///< Modo economia ativo
 
     float _avgVoltage;           ///< Média móvel de tensão
-    uint32_t _lastUpdate;        ///< Timestamp última atualização
+    uint32_t _sampleSum;         ///< Soma das amostras da média em curso
+    uint8_t _sampleCount;        ///< Amostras colhidas na média em curso
     
     //=========================================================================
     // CONSTANTES
     //=========================================================================
-    static constexpr uint32_t UPDATE_INTERVAL = 1000;  ///< Intervalo de atualização (ms)
+    static constexpr uint8_t SAMPLES = 10;             ///< Amostras do ADC por leitura
     static constexpr float HYSTERESIS = 0.1f;          ///< Histerese para flags (V)
 
     //=========================================================================
     // MÉTODOS PRIVADOS
     //=========================================================================
     
-    /** @brief Lê tensão do ADC com média de amostras */
+    /** @brief Lê tensão do ADC com média de amostras (bloqueante, só no begin) */
     float _readVoltage();
+
+    /** @brief Converte leitura média do ADC em tensão da bateria */
+    float _toVoltage(float raw);
     
     /**
      * @brief Calcula percentual usando curva Li-ion real
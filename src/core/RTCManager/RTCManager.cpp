@@ -8,10 +8,28 @@
 #include <WiFi.h>
 #include "time.h"
 
-RTCManager::RTCManager() : _wire(nullptr), _initialized(false), _lost_power(true) {}
+RTCManager::RTCManager() : _wire(nullptr), _initialized(false), _lost_power(true),
+    _anchorUnix(0), _anchorUs(0), _lastLocalUs(0), _driftPpm(0.0f),
+    _baseValid(false), _baseUnix(0), _baseUs(0),
+    _hunting(false), _huntSecond(0xFF), _huntPrevUs(0), _huntStartUs(0), _nextAnchorUs(0)
+{
+    _prefixDay[0] = _prefixDay[1] = -1;
+}
+
+// Dois dígitos decimais (0-99) sem snprintf
+static inline void put2(char* p, uint32_t v) {
+    p[0] = '0' + (v / 10);
+    p[1] = '0' + (v % 10);
+}
 
 bool RTCManager::begin(TwoWire* wire) {
     _wire = wire;
+
+    I2CBus::Session bus(I2CBus::Priority::BACKGROUND, DS3231_ADDR);
+    if (!bus) {
+        DEBUG_PRINTLN("[RTC] ERRO: I2C ocupado ao iniciar.");
+        return false;
+    }
     
     if (!_detectRTC()) {
         DEBUG_PRINTLN("[RTC] ERRO: DS3231 nao detectado.");
@@ -26,10 +44,15 @@ bool RTCManager::begin(TwoWire* wire) {
     _initialized = true;
     _lost_power = _rtc.lostPower();
 
+    DateTime now;
     if (_lost_power) {
         DEBUG_PRINTLN("[RTC] Bateria perdida. Ajustando tempo...");
-        _rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
+        now = DateTime(F(__DATE__), F(__TIME__));
+        _rtc.adjust(now);
+    } else {
+        now = _rtc.now();
     }
+    _resetAnchor(now.unixtime(), esp_timer_get_time());
     
     _syncSystemToRTC();
     
@@ -37,7 +60,44 @@ bool RTCManager::begin(TwoWire* wire) {
     return true;
 }
 
-void RTCManager::update() {}
+void RTCManager::update() {
+    if (!_initialized) return;
+
+    int64_t nowUs = esp_timer_get_time();
+    if (!_hunting) {
+        if (nowUs < _nextAnchorUs) return;
+        _hunting = true;
+        _huntSecond = 0xFF;
+        _huntStartUs = nowUs;
+    }
+
+    // Procura a virada do segundo do DS3231 entre duas leituras consecutivas
+    // (instante tomado ainda com o barramento: release pode rodar a fila)
+    DateTime rtcNow;
+    {
+        I2CBus::Session bus(I2CBus::Priority::BACKGROUND, DS3231_ADDR);
+        if (!bus) return;
+        rtcNow = _rtc.now();
+        nowUs = esp_timer_get_time();
+    }
+
+    if (_huntSecond != 0xFF && rtcNow.second() != _huntSecond &&
+        nowUs - _huntPrevUs <= EDGE_MAX_GAP_US) {
+        _reanchor(rtcNow.unixtime(), (_huntPrevUs + nowUs) / 2);
+        _hunting = false;
+        _nextAnchorUs = nowUs + (int64_t)RTC_REANCHOR_INTERVAL_MS * 1000LL;
+        return;
+    }
+
+    _huntSecond = rtcNow.second();
+    _huntPrevUs = nowUs;
+
+    if (nowUs - _huntStartUs > EDGE_TIMEOUT_US) {
+        DEBUG_PRINTLN("[RTC] AVISO: Virada do segundo nao detectada.");
+        _hunting = false;
+        _nextAnchorUs = nowUs + (int64_t)RTC_REANCHOR_INTERVAL_MS * 1000LL;
+    }
+}
 
 bool RTCManager::syncWithNTP() {
     if (WiFi.status() != WL_CONNECTED) {
@@ -64,8 +124,18 @@ bool RTCManager::syncWithNTP() {
         time_t now;
         time(&now);
         struct tm* tm_local = localtime(&now);
-        _rtc.adjust(DateTime(tm_local->tm_year + 1900, tm_local->tm_mon + 1, tm_local->tm_mday,
-                             tm_local->tm_hour, tm_local->tm_min, tm_local->tm_sec));
+        DateTime adjusted(tm_local->tm_year + 1900, tm_local->tm_mon + 1, tm_local->tm_mday,
+                          tm_local->tm_hour, tm_local->tm_min, tm_local->tm_sec);
+        {
+            I2CBus::Session bus(I2CBus::Priority::BACKGROUND, DS3231_ADDR);
+            if (!bus) {
+                DEBUG_PRINTLN("[RTC] NTP: I2C ocupado, DS3231 nao ajustado.");
+                return false;
+            }
+            _rtc.adjust(adjusted);
+        }
+        // Gravar os segundos reinicia o divisor do DS3231: o segundo começa agora
+        _resetAnchor(adjusted.unixtime(), esp_timer_get_time());
         _lost_power = false;
         DEBUG_PRINTF("[RTC] NTP sincronizado: %s\n", getDateTime().c_str());
         return true;
@@ -76,44 +146,139 @@ bool RTCManager::syncWithNTP() {
 }
 
 String RTCManager::getDateTime() {
-    if (!_initialized) return "2000-01-01 00:00:00";
-    DateTime now = _rtc.now();
-    char buf[25];
-    snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d",
-             now.year(), now.month(), now.day(),
-             now.hour(), now.minute(), now.second());
+    char buf[DATETIME_LEN + 1];
+    formatDateTime(buf, sizeof(buf));
     return String(buf);
 }
 
 String RTCManager::getUTCDateTime() {
-    if (!_initialized) return "2000-01-01 00:00:00";
-    uint32_t unix = _rtc.now().unixtime();
-    DateTime utc(unix - GMT_OFFSET_SEC);
-    
-    char buf[25];
-    snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d",
-             utc.year(), utc.month(), utc.day(),
-             utc.hour(), utc.minute(), utc.second());
+    char buf[DATETIME_LEN + 1];
+    formatDateTime(buf, sizeof(buf), ' ', true);
     return String(buf);
 }
 
 uint32_t RTCManager::getUnixTime() {
     if (!_initialized) return 0;
-    return _rtc.now().unixtime() - GMT_OFFSET_SEC;
+    return (uint32_t)(_nowLocalUs() / 1000000LL) - GMT_OFFSET_SEC;
+}
+
+size_t RTCManager::formatDateTime(char* out, size_t outSize, char separator, bool utc) {
+    if (out == nullptr || outSize < DATETIME_LEN + 1) return 0;
+
+    if (!_initialized) {
+        memcpy(out, "2000-01-01 00:00:00", DATETIME_LEN + 1);
+        out[10] = separator;
+        return DATETIME_LEN;
+    }
+
+    uint32_t secs = (uint32_t)(_nowLocalUs() / 1000000LL);
+    if (utc) secs -= GMT_OFFSET_SEC;
+    int32_t day = secs / 86400;
+    uint32_t sod = secs % 86400;
+    uint8_t slot = utc ? 1 : 0;
+
+    portENTER_CRITICAL(&_timeMux);
+    bool cached = (_prefixDay[slot] == day);
+    if (cached) memcpy(out, _prefix[slot], 10);
+    portEXIT_CRITICAL(&_timeMux);
+
+    if (!cached) {
+        DateTime d(secs - sod);
+        snprintf(out, 11, "%04u-%02u-%02u", d.year(), d.month(), d.day());
+        portENTER_CRITICAL(&_timeMux);
+        memcpy(_prefix[slot], out, 10);
+        _prefixDay[slot] = day;
+        portEXIT_CRITICAL(&_timeMux);
+    }
+
+    out[10] = separator;
+    put2(out + 11, sod / 3600);
+    out[13] = ':';
+    put2(out + 14, (sod / 60) % 60);
+    out[16] = ':';
+    put2(out + 17, sod % 60);
+    out[DATETIME_LEN] = '\0';
+    return DATETIME_LEN;
 }
 
 bool RTCManager::isInitialized() const { return _initialized; }
 
 bool RTCManager::_detectRTC() {
-    _wire->beginTransmission(DS3231_ADDR);
-    return (_wire->endTransmission() == 0);
+    I2CBus::Transaction probe = I2CBus::probe(DS3231_ADDR, I2CBus::Priority::BACKGROUND);
+    return I2CBus::instance().transfer(probe);
 }
 
 void RTCManager::_syncSystemToRTC() {
     if (!_initialized) return;
+    I2CBus::Session bus(I2CBus::Priority::BACKGROUND, DS3231_ADDR);
+    if (!bus) return;
     DateTime now = _rtc.now();
     struct timeval tv;
     tv.tv_sec = now.unixtime();
     tv.tv_usec = 0;
     settimeofday(&tv, NULL);
-}
\ No newline at end of file
+}
+
+void RTCManager::_resetAnchor(uint32_t localUnix, int64_t atUs) {
+    portENTER_CRITICAL(&_timeMux);
+    _anchorUnix = localUnix;
+    _anchorUs = atUs;
+    _lastLocalUs = 0;
+    portEXIT_CRITICAL(&_timeMux);
+
+    // Nova base de deriva na próxima virada medida
+    _baseValid = false;
+    _hunting = false;
+    _nextAnchorUs = 0;
+}
+
+void RTCManager::_reanchor(uint32_t localUnix, int64_t edgeUs) {
+    portENTER_CRITICAL(&_timeMux);
+    int64_t elapsed = edgeUs - _anchorUs;
+    int64_t predicted = (int64_t)_anchorUnix * 1000000LL + elapsed +
+                        (int64_t)((float)elapsed * _driftPpm * 1e-6f);
+    portEXIT_CRITICAL(&_timeMux);
+
+    int64_t errorUs = (int64_t)localUnix * 1000000LL - predicted;
+    bool stepped = (errorUs > STEP_THRESHOLD_US || errorUs < -STEP_THRESHOLD_US);
+
+    if (!_baseValid || stepped) {
+        _baseValid = true;
+        _baseUnix = localUnix;
+        _baseUs = edgeUs;
+    } else {
+        int64_t span = edgeUs - _baseUs;
+        if (span >= (int64_t)RTC_DRIFT_MIN_BASELINE_S * 1000000LL) {
+            int64_t rtcSpan = (int64_t)(localUnix - _baseUnix) * 1000000LL;
+            float ppm = (float)(rtcSpan - span) * 1e6f / (float)span;
+            if (ppm > RTC_DRIFT_MAX_PPM) ppm = RTC_DRIFT_MAX_PPM;
+            if (ppm < -RTC_DRIFT_MAX_PPM) ppm = -RTC_DRIFT_MAX_PPM;
+            _driftPpm = ppm;
+        }
+    }
+
+    portENTER_CRITICAL(&_timeMux);
+    _anchorUnix = localUnix;
+    _anchorUs = edgeUs;
+    if (stepped) _lastLocalUs = 0;
+    portEXIT_CRITICAL(&_timeMux);
+
+    DEBUG_PRINTF("[RTC] Reancorado: erro %ld ms, deriva %.1f ppm\n",
+                 (long)(errorUs / 1000), _driftPpm);
+}
+
+int64_t RTCManager::_nowLocalUs() {
+    int64_t nowUs = esp_timer_get_time();
+
+    portENTER_CRITICAL(&_timeMux);
+    int64_t elapsed = nowUs - _anchorUs;
+    int64_t t = (int64_t)_anchorUnix * 1000000LL + elapsed +
+                (int64_t)((float)elapsed * _driftPpm * 1e-6f);
+    if (t < _lastLocalUs) {
+        t = _lastLocalUs;
+    } else {
+        _lastLocalUs = t;
+    }
+    portEXIT_CRITICAL(&_timeMux);
+    return t;
+}
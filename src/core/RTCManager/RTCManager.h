@@ -8,10 +8,12 @@
  *          - Detecção de perda de energia do RTC
  *          - Conversão entre horário local e UTC
  *          - Timestamp Unix para logging
+ *          - Hora em cache: DS3231 lido uma vez e extrapolado pelo
+ *            esp_timer, com reancoragem periódica e correção de deriva
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 1.1.0
+ * @version 1.3.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -29,6 +31,13 @@
  * 2. **DS3231** (backup) - Mantém hora offline
  * 3. **millis()** (fallback) - Último recurso
  * 
+ * ## Hora em Cache
+ * Os getters não acessam o I2C. A hora é `âncora DS3231 + esp_timer`,
+ * corrigida pela deriva estimada. A cada RTC_REANCHOR_INTERVAL_MS o
+ * update() (SensorsTask, sessão BACKGROUND do I2CBus) procura a virada do segundo do
+ * DS3231 e reancora; com base >= RTC_DRIFT_MIN_BASELINE_S estima a deriva
+ * do oscilador do ESP32 em ppm. A hora entregue nunca retrocede.
+ * 
  * @note Fuso horário configurado: UTC-3 (Brasília)
  * @note Endereço I2C do DS3231: 0x68
  */
@@ -40,6 +49,9 @@
 #include <RTClib.h>
 #include <Wire.h>
 #include "esp_sntp.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include "core/I2CBus/I2CBus.h"
 
 /**
  * @class RTCManager
@@ -65,7 +77,8 @@ public:
     bool begin(TwoWire* wire = &Wire);
     
     /**
-     * @brief Atualiza estado interno (verificações periódicas)
+     * @brief Reancoragem periódica da hora em cache
+     * @note Acessa o DS3231 em sessão BACKGROUND do I2CBus
      */
     void update();
 
@@ -110,6 +123,27 @@ public:
      */
     uint32_t getUnixTime();
     
+    /**
+     * @brief Formata data/hora sem alocação "YYYY-MM-DD?HH:MM:SS"
+     * @param out Buffer de saída (mínimo 20 bytes)
+     * @param outSize Tamanho do buffer
+     * @param separator Separador data/hora (' ' ou 'T' para ISO8601)
+     * @param utc true para UTC, false para horário local
+     * @return Caracteres escritos (0 se o buffer for pequeno)
+     * @note Prefixo da data em cache; recalculado só na virada do dia
+     */
+    size_t formatDateTime(char* out, size_t outSize, char separator = ' ',
+                          bool utc = false);
+    
+    /** @brief Deriva estimada do esp_timer em relação ao DS3231 (ppm) */
+    float getDriftPpm() const { return _driftPpm; }
+    
+    /**
+     * @brief Offset do horário local em relação ao UTC
+     * @return Segundos (negativo a oeste de Greenwich)
+     */
+    static constexpr long getUtcOffsetSeconds() { return GMT_OFFSET_SEC; }
+    
 private:
     //=========================================================================
     // HARDWARE
@@ -123,6 +157,25 @@ private:
     bool _initialized;           ///< RTC inicializado?
     bool _lost_power;            ///< RTC perdeu energia?
     
+    //=========================================================================
+    // HORA EM CACHE
+    //=========================================================================
+    portMUX_TYPE _timeMux = portMUX_INITIALIZER_UNLOCKED; ///< Protege âncora/cache
+    uint32_t _anchorUnix;        ///< Segundo local do DS3231 na âncora
+    int64_t _anchorUs;           ///< esp_timer no início desse segundo
+    int64_t _lastLocalUs;        ///< Último instante entregue (monotônico)
+    float _driftPpm;             ///< Correção aplicada ao esp_timer
+    bool _baseValid;             ///< Base de deriva definida?
+    uint32_t _baseUnix;          ///< Segundo da primeira virada medida
+    int64_t _baseUs;             ///< esp_timer nessa virada
+    bool _hunting;               ///< Procurando a virada do segundo?
+    uint8_t _huntSecond;         ///< Segundo lido na última tentativa
+    int64_t _huntPrevUs;         ///< esp_timer da última tentativa
+    int64_t _huntStartUs;        ///< Início da procura
+    int64_t _nextAnchorUs;       ///< Próxima reancoragem
+    int32_t _prefixDay[2];       ///< Dia em cache (local, UTC)
+    char _prefix[2][11];         ///< "YYYY-MM-DD" em cache (local, UTC)
+    
     //=========================================================================
     // CONFIGURAÇÕES
     //=========================================================================
@@ -131,6 +184,10 @@ private:
     static constexpr int DAYLIGHT_OFFSET_SEC = 0;          ///< Sem horário de verão
     static constexpr const char* NTP_SERVER_1 = "pool.ntp.org";   ///< NTP primário
     static constexpr const char* NTP_SERVER_2 = "time.nist.gov";  ///< NTP secundário
+    static constexpr int64_t EDGE_MAX_GAP_US = 500000;     ///< Leituras mais espaçadas reiniciam a procura
+    static constexpr int64_t EDGE_TIMEOUT_US = 3000000;    ///< Desiste da virada (RTC parado?)
+    static constexpr int64_t STEP_THRESHOLD_US = 2000000;  ///< Erro maior = RTC ajustado externamente
+    static constexpr size_t DATETIME_LEN = 19;             ///< "YYYY-MM-DD HH:MM:SS"
     
     //=========================================================================
     // MÉTODOS PRIVADOS
@@ -141,6 +198,15 @@ private:
     
     /** @brief Sincroniza relógio do sistema com RTC */
     void _syncSystemToRTC();
+    
+    /** @brief Ancora no segundo recém-gravado/lido e agenda procura da virada */
+    void _resetAnchor(uint32_t localUnix, int64_t atUs);
+    
+    /** @brief Reancora na virada do segundo e atualiza a deriva */
+    void _reanchor(uint32_t localUnix, int64_t edgeUs);
+    
+    /** @brief Instante local em µs desde 1970 (monotônico, sem I2C) */
+    int64_t _nowLocalUs();
 };
 
 #endif
\ No newline at end of file
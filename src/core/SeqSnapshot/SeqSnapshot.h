@@ -0,0 +1,88 @@
+/**
+ * @file SeqSnapshot.h
+ * @brief Instantâneo sem trava (seqlock) de um escritor para leitores
+ *
+ * @details Publica uma estrutura inteira de uma task para outras sem
+ *          mutex:
+ *          - Escritor nunca bloqueia nem espera leitor
+ *          - Leitor copia e confere o contador de sequência; se uma
+ *            publicação aconteceu no meio, tenta de novo
+ *          - Tentativas limitadas: leitor nunca fica preso
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Protocolo
+ * | Passo | Escritor                 | Leitor                          |
+ * |-------|--------------------------|---------------------------------|
+ * | 1     | seq++ (ímpar = gravando) | s1 = seq; ímpar -> repete       |
+ * | 2     | copia os dados           | copia os dados                  |
+ * | 3     | seq++ (par = estável)    | s2 = seq; s1 != s2 -> repete    |
+ *
+ * @note Um único escritor por instância (a task dona do instantâneo)
+ * @note T deve ser trivialmente copiável (sem ponteiros para o escritor)
+ */
+
+#ifndef SEQ_SNAPSHOT_H
+#define SEQ_SNAPSHOT_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @class SeqSnapshot
+ * @brief Última versão publicada de T, lida sem trava
+ */
+template <typename T>
+class SeqSnapshot {
+public:
+    static constexpr uint8_t READ_TRIES = 8;  ///< Tentativas padrão do leitor
+
+    SeqSnapshot() : _seq(0) { memset(&_data, 0, sizeof(T)); }
+
+    /**
+     * @brief Publica uma nova versão (somente a task escritora)
+     * @param value Estrutura completa
+     */
+    void publish(const T& value) {
+        uint32_t s = __atomic_load_n(&_seq, __ATOMIC_RELAXED);
+        __atomic_store_n(&_seq, s + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);   // seq ímpar antes dos dados
+        memcpy(&_data, &value, sizeof(T));
+        __atomic_store_n(&_seq, s + 2, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @brief Copia a última versão estável
+     * @param out [out] Cópia (intocada se falhar)
+     * @param tries Tentativas antes de desistir
+     * @return false se o escritor publicou durante todas as tentativas
+     */
+    bool read(T& out, uint8_t tries = READ_TRIES) const {
+        T tmp;
+        while (tries-- > 0) {
+            uint32_t s1 = __atomic_load_n(&_seq, __ATOMIC_ACQUIRE);
+            if (s1 & 1) continue;
+            memcpy(&tmp, &_data, sizeof(T));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);  // dados antes do seq final
+            if (__atomic_load_n(&_seq, __ATOMIC_RELAXED) == s1) {
+                out = tmp;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** @brief Publicações feitas (0 = nada publicado ainda) */
+    uint32_t version() const { return __atomic_load_n(&_seq, __ATOMIC_ACQUIRE) >> 1; }
+
+private:
+    uint32_t _seq;   ///< Contador de sequência (ímpar = gravando)
+    T _data;         ///< Última versão
+};
+
+#endif // SEQ_SNAPSHOT_H
@@ -0,0 +1,191 @@
+/**
+ * @file SlidingMedian.h
+ * @brief Mediana e MAD de uma janela deslizante, sem reordenar a janela
+ *
+ * @details Estatística de ordem para filtros de outlier dos sensores:
+ *          - Anel em ordem de chegada + vetor mantido ordenado
+ *          - Entrada nova ocupa o lugar da mais antiga: busca binária
+ *            (O(log n)) e deslocamento só entre as duas posições
+ *          - Mediana em O(1): elemento central do vetor ordenado
+ *          - MAD em O(log n): k-ésimo menor desvio tirado direto do vetor
+ *            ordenado, sem montar nem ordenar o vetor de desvios
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## MAD sem vetor de desvios
+ * Com o vetor ordenado s e a mediana m = s[n/2], os desvios |s[i] - m|
+ * formam duas sequências já crescentes:
+ * | Lado      | Sequência                              |
+ * |-----------|----------------------------------------|
+ * | Esquerdo  | m - s[n/2 - 1], m - s[n/2 - 2], ...    |
+ * | Direito   | s[n/2] - m (= 0), s[n/2 + 1] - m, ...  |
+ *
+ * O MAD é o (n/2)-ésimo menor elemento da união: busca binária em quantos
+ * vêm do lado esquerdo.
+ *
+ * ## Custo por amostra (janela cheia)
+ * | Operação  | Comparações | Movimentos                          |
+ * |-----------|-------------|-------------------------------------|
+ * | push()    | O(log n)    | Distância entre a posição antiga e a nova |
+ * | median()  | O(1)        | -                                   |
+ * | mad()     | O(log n)    | -                                   |
+ *
+ * Em sinais que variam devagar (pressão, temperatura) a entrada nova cai
+ * perto da que sai e o deslocamento é curto.
+ *
+ * @note Mediana e MAD seguem a convenção "superior" (s[n/2]) para n par
+ * @note Sem alocação; uma instância por sinal (não é thread-safe)
+ * @note NaN não entra na janela (quebra a ordem): validar antes de push()
+ */
+
+#ifndef SLIDING_MEDIAN_H
+#define SLIDING_MEDIAN_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @class SlidingMedian
+ * @brief Janela deslizante com mediana e MAD incrementais
+ * @tparam T Tipo numérico (float, int32_t...)
+ * @tparam N Tamanho da janela (1-255)
+ */
+template <typename T, uint8_t N>
+class SlidingMedian {
+    static_assert(N > 0, "SlidingMedian: janela vazia");
+
+public:
+    SlidingMedian() { clear(); }
+
+    /** @brief Esvazia a janela */
+    void clear() {
+        _count = 0;
+        _head = 0;
+    }
+
+    /** @brief Enche a janela com um único valor (semente após reset) */
+    void fill(T value) {
+        for (uint8_t i = 0; i < N; i++) _ring[i] = _sorted[i] = value;
+        _count = N;
+        _head = 0;
+    }
+
+    /**
+     * @brief Insere um valor; com a janela cheia, descarta o mais antigo
+     * @param value Amostra nova
+     */
+    void push(T value) {
+        uint8_t pos;
+        if (_count < N) {
+            // Crescendo: abre espaço no fim e desliza para a esquerda
+            _ring[(_head + _count) % N] = value;
+            pos = _count++;
+        } else {
+            // Cheia: a mais antiga sai do vetor ordenado e a nova ocupa o lugar
+            T old = _ring[_head];
+            _ring[_head] = value;
+            _head = (_head + 1) % N;
+            pos = _find(old);
+        }
+
+        // Desliza até a posição ordenada (só entre a antiga e a nova)
+        if (pos > 0 && value < _sorted[pos - 1]) {
+            uint8_t to = _upperBound(value, 0, pos);
+            memmove(&_sorted[to + 1], &_sorted[to], (pos - to) * sizeof(T));
+            pos = to;
+        } else if (pos + 1 < _count && _sorted[pos + 1] < value) {
+            uint8_t to = _lowerBound(value, pos + 1, _count) - 1;
+            memmove(&_sorted[pos], &_sorted[pos + 1], (to - pos) * sizeof(T));
+            pos = to;
+        }
+        _sorted[pos] = value;
+    }
+
+    uint8_t size() const { return _count; }          ///< Amostras na janela
+    bool full() const { return _count == N; }        ///< Janela cheia?
+    static constexpr uint8_t capacity() { return N; }///< Tamanho da janela
+
+    /** @brief Amostra mais recente (janela não vazia) */
+    T newest() const { return _ring[(_head + _count - 1) % N]; }
+
+    /** @brief Mediana (janela não vazia) */
+    T median() const { return _sorted[_count / 2]; }
+
+    /** @brief Mediana dos desvios absolutos em torno da mediana (janela não vazia) */
+    T mad() const {
+        const uint8_t mid = _count / 2;
+        const T m = _sorted[mid];
+        const uint8_t nLeft = mid;               // m - s[mid-1-j]
+        const uint8_t nRight = _count - mid;     // s[mid+j] - m
+        const uint8_t k = _count / 2;            // 0-based
+
+        // i = desvios vindos da esquerda entre os k+1 menores
+        int lo = (k + 1 > nRight) ? k + 1 - nRight : 0;
+        int hi = (k + 1 < nLeft) ? k + 1 : nLeft;
+        while (lo < hi) {
+            int i = (lo + hi) / 2;
+            // Mais um da esquerda ainda é menor que o último da direita usado?
+            if (m - _sorted[mid - 1 - i] < _sorted[mid + (k - i)] - m) lo = i + 1;
+            else hi = i;
+        }
+        int i = lo, j = k + 1 - lo;
+        T a = (i > 0) ? T(m - _sorted[mid - i]) : T(0);
+        T b = (j > 0) ? T(_sorted[mid + j - 1] - m) : T(0);
+        return (a > b) ? a : b;
+    }
+
+    /**
+     * @brief Teste robusto: |value - mediana| / max(MAD, madFloor) > threshold
+     * @param value Amostra candidata (ainda fora da janela)
+     * @param threshold Escore máximo aceito
+     * @param madFloor MAD mínimo (janela quase constante)
+     * @return true se outlier (janela com menos de 3 amostras nunca rejeita)
+     */
+    bool isOutlier(T value, float threshold, T madFloor) const {
+        if (_count < 3) return false;
+        T m = median();
+        T d = (value > m) ? T(value - m) : T(m - value);
+        T s = mad();
+        if (s < madFloor) s = madFloor;
+        return (float)d > threshold * (float)s;
+    }
+
+private:
+    T _ring[N];          ///< Ordem de chegada
+    T _sorted[N];        ///< Mesmos valores, ordenados
+    uint8_t _count;      ///< Amostras válidas
+    uint8_t _head;       ///< Mais antiga em _ring (janela cheia)
+
+    /** @brief Posição de algum elemento igual a value (presente) */
+    uint8_t _find(T value) const {
+        uint8_t p = _lowerBound(value, 0, _count);
+        return (p < _count) ? p : _count - 1;
+    }
+
+    /** @brief Primeiro índice em [lo, hi) com _sorted[i] >= value */
+    uint8_t _lowerBound(T value, uint8_t lo, uint8_t hi) const {
+        while (lo < hi) {
+            uint8_t mid = lo + (hi - lo) / 2;
+            if (_sorted[mid] < value) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    /** @brief Primeiro índice em [lo, hi) com _sorted[i] > value */
+    uint8_t _upperBound(T value, uint8_t lo, uint8_t hi) const {
+        while (lo < hi) {
+            uint8_t mid = lo + (hi - lo) / 2;
+            if (value < _sorted[mid]) hi = mid;
+            else lo = mid + 1;
+        }
+        return lo;
+    }
+};
+
+#endif // SLIDING_MEDIAN_H
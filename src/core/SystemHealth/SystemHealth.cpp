@@ -21,7 +21,10 @@ SystemHealth::SystemHealth() :
     _lastWatchdogFeed(0), _lastHealthCheck(0),
     _currentWdtTimeout(WATCHDOG_TIMEOUT_PREFLIGHT),
     _resetCount(0), _resetReason(0), _crcErrors(0), _i2cErrors(0),
-    _watchdogResets(0), _sdCardStatus(0), _currentMode(0), _batteryVoltage(0.0f)
+    _watchdogResets(0), _sdCardStatus(0), _sdMaxAppendUs(0),
+    _sdFreePercent(100), _sdAppendP95Us(0), _sdStalls(0), _sdMaxBacklog(0),
+    _sdLongestBacklogMs(0), _currentMode(0),
+    _batteryVoltage(0.0f)
 {}
 
 bool SystemHealth::begin() {
@@ -162,6 +165,12 @@ HealthTelemetryExtended SystemHealth::getHealthTelemetry() {
     health.watchdogResets = _watchdogResets;
     health.currentMode = _currentMode;
     health.batteryVoltage = _batteryVoltage;
+    health.sdMaxAppendUs = _sdMaxAppendUs;
+    health.sdFreePercent = _sdFreePercent;
+    health.sdAppendP95Us = _sdAppendP95Us;
+    health.sdStalls = _sdStalls;
+    health.sdMaxBacklog = _sdMaxBacklog;
+    health.sdLongestBacklogMs = _sdLongestBacklogMs;
     return health;
 }
 
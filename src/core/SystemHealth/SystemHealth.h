@@ -7,13 +7,14 @@
  *          - Temperatura interna do ESP32
  *          - Contagem e razão de resets
  *          - Erros de CRC e I2C
+ *          - Latência de escrita no SD Card (pior caso, p95, stalls)
  *          - Status do watchdog
  *          - Uptime do sistema
  *          - Persistência de dados críticos na NVS
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 2.0.0
+ * @version 2.0.1
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -65,6 +66,12 @@ struct HealthTelemetryExtended {
     uint16_t watchdogResets;
     uint8_t currentMode;
     float batteryVoltage;
+    uint32_t sdMaxAppendUs;
+    uint8_t sdFreePercent;
+    uint32_t sdAppendP95Us;
+    uint16_t sdStalls;
+    uint8_t sdMaxBacklog;
+    uint32_t sdLongestBacklogMs;
 };
 
 /**
@@ -161,6 +168,48 @@ public:
     
     /** @brief Incrementa contador de erros I2C */
     void incrementI2CError() { _i2cErrors++; }
+
+    /** @brief Soma erros I2C reportados pelo I2CBus */
+    void addI2CErrors(uint16_t n) { _i2cErrors += n; }
+    
+    /**
+     * @brief Registra latência de uma escrita de log no SD
+     * @param us Duração da escrita em microssegundos
+     * @note Mantém apenas o pior caso desde o boot
+     */
+    void reportStorageLatency(uint32_t us) {
+        if (us > _sdMaxAppendUs) _sdMaxAppendUs = us;
+    }
+    
+    /** @brief Retorna a pior latência de escrita no SD (µs) */
+    uint32_t getSDMaxAppendUs() const { return _sdMaxAppendUs; }
+    
+    /**
+     * @brief Registra o espaço livre no orçamento de logs do SD
+     * @param freePercent Livre em % (ver RetentionManager)
+     */
+    void reportStorageSpace(uint8_t freePercent) { _sdFreePercent = freePercent; }
+    
+    /** @brief Espaço livre no SD (% do orçamento de logs) */
+    uint8_t getSDFreePercent() const { return _sdFreePercent; }
+    
+    /**
+     * @brief Registra o resumo de desempenho do SD (ver StorageStats)
+     * @param p95Us Percentil 95 da escrita de um registro (µs)
+     * @param stalls Escritas acima de SD_STALL_US desde o boot
+     * @param maxBacklog Maior número de sinais na fila da StorageTask
+     * @param longestBacklogMs Maior tempo com a fila sem esvaziar
+     */
+    void reportStorageStats(uint32_t p95Us, uint32_t stalls,
+                            uint32_t maxBacklog, uint32_t longestBacklogMs) {
+        _sdAppendP95Us = p95Us;
+        _sdStalls = stalls > 0xFFFF ? 0xFFFF : stalls;
+        _sdMaxBacklog = maxBacklog > 0xFF ? 0xFF : maxBacklog;
+        _sdLongestBacklogMs = longestBacklogMs;
+    }
+    
+    /** @brief Escritas no SD acima de SD_STALL_US */
+    uint16_t getSDStalls() const { return _sdStalls; }
     
     /**
      * @brief Define ou limpa flag de erro do sistema
@@ -221,6 +270,12 @@ private:
     // STATUS EXTERNO
     //=========================================================================
     uint8_t _sdCardStatus;       ///< Status do SD Card
+    uint32_t _sdMaxAppendUs;     ///< Pior latência de escrita no SD (µs)
+    uint8_t _sdFreePercent;      ///< Livre no orçamento de logs do SD (%)
+    uint32_t _sdAppendP95Us;     ///< p95 da escrita de um registro (µs)
+    uint16_t _sdStalls;          ///< Escritas acima de SD_STALL_US
+    uint8_t _sdMaxBacklog;       ///< Maior fila da StorageTask (sinais)
+    uint32_t _sdLongestBacklogMs; ///< Maior tempo com a fila sem esvaziar
     uint8_t _currentMode;        ///< Modo de operação atual
     float _batteryVoltage;       ///< Tensão da bateria
     
@@ -8,7 +8,7 @@
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 10.9.0
+ * @version 10.18.2
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -19,11 +19,24 @@
  * ## Arquitetura de Tasks
  * | Task         | Core | Prioridade | Stack | Função                    |
  * |--------------|------|------------|-------|---------------------------|
- * | SensorsTask  | 1    | 2          | 4KB   | Leitura de sensores 10Hz  |
+ * | FastTask     | 1    | 3          | 5KB   | IMU (INT) + BMP280, 50Hz  |
+ * | SensorsTask  | 1    | 2          | 4KB   | Ambiente/bateria, 100Hz   |
+ * | GpsTask      | 0    | 1          | 4KB   | Eventos UART + UBX        |
  * | HttpTask     | 0    | 1          | 8KB   | Processamento HTTP        |
  * | StorageTask  | 0    | 1          | 8KB   | Persistência em SD Card   |
  * 
  * ## Changelog
+ * - v10.18.2: Job GPS desligado antes de criar a GpsTask e a SensorsTask
+ * - v10.18.1: QUERY/REPLAY executados pela StorageTask, em fatias
+ * - v10.18.0: GpsTask acordada por eventos da UART (driver ESP-IDF)
+ * - v10.17.0: GPS em protocolo binário UBX (NAV-PVT/NAV-DOP), sem TinyGPS++
+ * - v10.16.0: Filtro de outlier do BMP280 com mediana/MAD incrementais
+ * - v10.15.0: Calibração contínua do magnetômetro (elipsoide em streaming); FastTask 5KB
+ * - v10.14.0: AHRS a bordo (atitude no payload LoRa)
+ * - v10.13.0: FastTask (IMU + BMP280) e SensorsTask com instantâneos próprios
+ * - v10.12.0: SensorsTask a SENSOR_TICK_MS com SensorScheduler
+ * - v10.11.0: I2CBus central substitui o xI2CMutex
+ * - v10.10.0: ImuTask acordada pelo data-ready do MPU9250
  * - v10.9.0: Verificação de criação de tasks com restart automático
  * - v10.8.0: Separação de tasks por núcleo
  * - v10.0.0: Migração para arquitetura multi-task
@@ -37,6 +50,7 @@
 #include "Globals.h" 
 #include "config.h"
 #include "app/TelemetryManager/TelemetryManager.h"
+#include "core/I2CBus/I2CBus.h"
 
 TelemetryManager telemetry;
 
@@ -48,7 +62,9 @@ void processSerialCommands();                ///< Processa comandos via Serial
 void printAvailableCommands();               ///< Exibe menu de comandos
 void vTaskHttp(void *pvParameters);          ///< Task de processamento HTTP
 void vTaskStorage(void *pvParameters);       ///< Task de armazenamento SD
-void vTaskSensors(void *pvParameters);       ///< Task de leitura de sensores
+void vTaskSensors(void *pvParameters);       ///< Task de sensores lentos
+void vTaskFast(void *pvParameters);          ///< Task de IMU e barômetro
+void vTaskGps(void *pvParameters);           ///< Task de recepção do GPS
 
 //=============================================================================
 // TASK HANDLES
@@ -57,6 +73,8 @@ void vTaskSensors(void *pvParameters);       ///< Task de leitura de sensores
 TaskHandle_t hTaskHttp = NULL;               ///< Handle da task HTTP
 TaskHandle_t hTaskStorage = NULL;            ///< Handle da task Storage
 TaskHandle_t hTaskSensors = NULL;            ///< Handle da task Sensores
+TaskHandle_t hTaskFast = NULL;               ///< Handle da task IMU/barômetro
+TaskHandle_t hTaskGps = NULL;                ///< Handle da task GPS
 
 //=============================================================================
 // SETUP - INICIALIZAÇÃO DO SISTEMA
@@ -67,7 +85,7 @@ TaskHandle_t hTaskSensors = NULL;            ///< Handle da task Sensores
  * 
  * @details Sequência de inicialização:
  *          1. Recursos globais (mutexes e filas FreeRTOS)
- *          2. Barramento I2C com proteção de mutex
+ *          2. Barramento I2C (I2CBus, escalonador por prioridade)
  *          3. Periféricos (LED, botão)
  *          4. Watchdog timer
  *          5. Subsistema de telemetria
@@ -81,14 +99,9 @@ void setup() {
 
     Serial.begin(DEBUG_BAUDRATE);
     
-    // 2. I2C Seguro
+    // 2. I2C (escalonador central é o dono do Wire)
     DEBUG_PRINTLN("[Main] Configurando I2C Mestre...");
-    if (xSemaphoreTake(xI2CMutex, portMAX_DELAY) == pdTRUE) {
-        Wire.begin(SENSOR_I2C_SDA, SENSOR_I2C_SCL);
-        Wire.setClock(I2C_FREQUENCY);
-        Wire.setTimeout(I2C_TIMEOUT_MS);
-        Wire.setBufferSize(512); 
-        xSemaphoreGive(xI2CMutex);
+    if (I2CBus::instance().begin(&Wire)) {
         DEBUG_PRINTF("[Main] I2C Configurado: %d kHz\n", I2C_FREQUENCY/1000);
     }
     delay(500); 
@@ -114,7 +127,33 @@ void setup() {
     // 3. TAREFAS - FIX: Verificação de criação
     BaseType_t taskResult;
     
-    // Tarefa de Sensores (Alta Prioridade - Tempo Real)
+    // Tarefa rápida: IMU + barômetro (acordada pelo pino INT do MPU9250)
+    // Criada e ligada antes da SensorsTask: um escritor por instantâneo
+    taskResult = xTaskCreatePinnedToCore(
+        vTaskFast, "FastTask", 5120, NULL, 3, &hTaskFast, 1
+    );
+    if (taskResult != pdPASS) {
+        DEBUG_PRINTLN("[Main] ERRO CRITICO: Falha ao criar FastTask!");
+        delay(1000);
+        ESP.restart();
+    }
+    telemetry.attachFastTask(hTaskFast);
+    DEBUG_PRINTLN("[Main] FastTask criada com sucesso.");
+
+    // Tarefa GPS: dorme na fila de eventos do driver UART. O job GPS sai
+    // da tabela antes de ela existir e da SensorsTask: um leitor da UART
+    telemetry.attachGpsTask();
+    taskResult = xTaskCreatePinnedToCore(
+        vTaskGps, "GpsTask", 4096, NULL, 1, &hTaskGps, 0
+    );
+    if (taskResult != pdPASS) {
+        DEBUG_PRINTLN("[Main] ERRO CRITICO: Falha ao criar GpsTask!");
+        delay(1000);
+        ESP.restart();
+    }
+    DEBUG_PRINTLN("[Main] GpsTask criada com sucesso.");
+
+    // Tarefa de Sensores lentos (ambiente, bateria; GPS só sem GpsTask)
     taskResult = xTaskCreatePinnedToCore(
         vTaskSensors,    "SensorsTask",   4096, NULL, 
         2, &hTaskSensors, 1
@@ -182,29 +221,67 @@ void loop() {
 //=============================================================================
 
 /**
- * @brief Task de leitura de sensores (tempo real)
+ * @brief Task de sensores lentos
  * 
  * @param pvParameters Parâmetros da task (não utilizado)
  * 
- * @details Executa leitura dos sensores físicos a 10Hz (100ms)
- *          usando vTaskDelayUntil() para timing preciso.
- *          Sensores: MPU9250, BMP280, SI7021, CCS811, GPS
+ * @details Um tick do SensorScheduler a cada SENSOR_TICK_MS usando
+ *          vTaskDelayUntil(); cada sensor roda no seu período e fase
+ *          (SI7021, CCS811, GPS, bateria) e o SlowSensorSnapshot é
+ *          publicado ao fim do tick.
  * 
- * @note Pinned ao Core 1 para isolamento de tempo real
- * @warning Não bloquear esta task por mais de 100ms
+ * @note Pinned ao Core 1, abaixo da FastTask
+ * @warning Jobs devem caber em um tick (estouros no STATUS, prazos em TASK_STATS)
  */
 void vTaskSensors(void *pvParameters) {
     TickType_t xLastWakeTime;
-    const TickType_t xFrequency = pdMS_TO_TICKS(100); // 100ms = 10Hz
+    const TickType_t xFrequency = pdMS_TO_TICKS(SENSOR_TICK_MS);
     
     xLastWakeTime = xTaskGetTickCount();
 
     for (;;) {
-        telemetry.updatePhySensors();
+        telemetry.updateSlowSensors();
         vTaskDelayUntil(&xLastWakeTime, xFrequency);
     }
 }
 
+/**
+ * @brief Task de IMU e barômetro
+ * 
+ * @param pvParameters Parâmetros da task (não utilizado)
+ * 
+ * @details Acordada pela ISR do pino INT do MPU9250 a cada amostra de
+ *          saída (lote de decimação): drena o FIFO, lê o BMP280 quando
+ *          vence e publica o FastSensorSnapshot. Sem pulsos (INT não
+ *          conectado), roda a cada IMU_TASK_TIMEOUT_MS.
+ * 
+ * @note Prioridade acima da SensorsTask; nenhuma trava compartilhada com
+ *       ela além das sessões priorizadas do I2CBus
+ */
+void vTaskFast(void *pvParameters) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IMU_TASK_TIMEOUT_MS));
+        telemetry.updateFastSensors();
+    }
+}
+
+/**
+ * @brief Task de recepção do GPS
+ * 
+ * @param pvParameters Parâmetros da task (não utilizado)
+ * 
+ * @details Bloqueia na fila de eventos do driver UART (rajada recebida,
+ *          linha ociosa, overrun) e decodifica os frames UBX do ring
+ *          buffer. Publica o GPSManager::Fix que a SensorsTask copia.
+ * 
+ * @note Core 0, prioridade baixa: o ring buffer absorve atrasos longos
+ */
+void vTaskGps(void *pvParameters) {
+    for (;;) {
+        telemetry.serviceGps();
+    }
+}
+
 /**
  * @brief Task de processamento HTTP
  * 
@@ -231,7 +308,10 @@ void vTaskHttp(void *pvParameters) {
  * @param pvParameters Parâmetros da task (não utilizado)
  * 
  * @details Aguarda sinais na fila xStorageQueue para persistir
- *          dados de telemetria no cartão SD em formato CSV.
+ *          dados de telemetria no cartão SD em formato CSV. Com a fila
+ *          vazia, executa a manutenção do SD (arquivos pré-alocados) e
+ *          as fatias das consultas QUERY/REPLAY: todo acesso ao SD fica
+ *          nesta task.
  * 
  * @note Stack de 8KB para suportar buffers JSON + operações SD
  */
@@ -239,9 +319,16 @@ void vTaskStorage(void *pvParameters) {
     uint8_t signal;
     StorageQueueMessage dummyMsg; // Apenas para manter compatibilidade da API
     for (;;) {
-        if (xQueueReceive(xStorageQueue, &signal, portMAX_DELAY) == pdTRUE) {
+        // Consulta em fatias: não dorme entre elas (gravações têm a vez na fila)
+        TickType_t wait = telemetry.hasPendingQuery() ? 0 : pdMS_TO_TICKS(STORAGE_IDLE_MS);
+        if (xQueueReceive(xStorageQueue, &signal, wait) == pdTRUE &&
+            signal == STORAGE_SIGNAL_SAVE) {
             telemetry.processStoragePacket(dummyMsg);
         }
+        // Pré-alocação, checkpoints e consultas só com a fila vazia
+        if (uxQueueMessagesWaiting(xStorageQueue) == 0) {
+            telemetry.serviceStorage();
+        }
     }
 }
 
@@ -280,7 +367,12 @@ void printAvailableCommands() {
     DEBUG_PRINTLN("  START_MISSION   : Inicia modo FLIGHT");
     DEBUG_PRINTLN("  STOP_MISSION    : Retorna ao modo PREFLIGHT");
     DEBUG_PRINTLN("  SAFE_MODE       : Forca modo SAFE");
-    DEBUG_PRINTLN("  MUTEX_STATS     : Estatisticas de mutex");
+    DEBUG_PRINTLN("  MUTEX_STATS     : Estatisticas do barramento I2C");
+    DEBUG_PRINTLN("  TASK_STATS      : Prazos das tasks de sensores");
+    DEBUG_PRINTLN("  GPS_STATS       : Fix, precisao e frames UBX do GPS");
+    DEBUG_PRINTLN("  STORAGE_STATS   : Latencia do SD, stalls e fila");
+    DEBUG_PRINTLN("  QUERY t1 t2     : Telemetria gravada entre t1 e t2 (unix)");
+    DEBUG_PRINTLN("  REPLAY t1 t2    : Reenvia via LoRa a telemetria entre t1 e t2");
     DEBUG_PRINTLN("  HELP            : Este menu");
     DEBUG_PRINTLN("============================");
 }
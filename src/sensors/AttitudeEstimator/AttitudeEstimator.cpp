@@ -0,0 +1,120 @@
+/**
+ * @file AttitudeEstimator.cpp
+ * @brief Implementação do AHRS a bordo (Mahony, float ou Q7.24)
+ */
+
+#include "AttitudeEstimator.h"
+
+AttitudeEstimator::AttitudeEstimator()
+    : _dt(1.0f / IMU_OUTPUT_RATE_HZ), _ready(false),
+      _roll(NAN), _pitch(NAN), _yaw(NAN),
+      _updates(0), _skipped(0), _accelRejects(0), _magRejects(0),
+      _cyclesLast(0), _cyclesMax(0), _cyclesTotal(0)
+{
+    _filter.setGains(AHRS_KP, AHRS_KI, AHRS_BIAS_LIMIT_DPS * DEG_TO_RAD);
+}
+
+void AttitudeEstimator::begin(uint16_t rateHz) {
+    _dt = 1.0f / (rateHz ? rateHz : IMU_OUTPUT_RATE_HZ);
+    _updates = _skipped = _accelRejects = _magRejects = 0;
+    _cyclesLast = _cyclesMax = 0;
+    _cyclesTotal = 0;
+    reset();
+}
+
+void AttitudeEstimator::reset() {
+    _filter.reset();
+    _ready = false;
+    _roll = _pitch = _yaw = NAN;
+}
+
+bool AttitudeEstimator::update(float gx, float gy, float gz,
+                               float ax, float ay, float az,
+                               float mx, float my, float mz,
+                               bool magValid, uint32_t steps) {
+    if (steps == 0 || isnan(gx) || isnan(gy) || isnan(gz)) return _ready;
+
+    uint32_t c0 = ESP.getCycleCount();
+
+    float an2 = ax * ax + ay * ay + az * az;
+    bool useAccel = (an2 >= AHRS_ACCEL_MIN_G * AHRS_ACCEL_MIN_G &&
+                     an2 <= AHRS_ACCEL_MAX_G * AHRS_ACCEL_MAX_G);
+    float mn2 = mx * mx + my * my + mz * mz;
+    bool useMag = magValid && (mn2 >= AHRS_MAG_MIN_UT * AHRS_MAG_MIN_UT &&
+                               mn2 <= AHRS_MAG_MAX_UT * AHRS_MAG_MAX_UT);
+
+    // Lacuna longa (recuperação do bus, reset do FIFO): integrar o gyro
+    // sobre ela só acumularia erro
+    float dt = _dt * steps;
+    if (_ready && dt > MAX_GAP_S) reset();
+
+    if (!_ready) {
+        // Inclinação exige gravidade confiável; guinada usa o mag se houver
+        if (!useAccel) return false;
+        _filter.initFromVectors(ax, ay, az, mx, my, mz, useMag);
+        _ready = true;
+        _updateEuler();
+        return true;
+    }
+
+    if (!useAccel) _accelRejects++;
+    if (!useMag) _magRejects++;
+    _skipped += steps - 1;
+
+    float ia = useAccel ? 1.0f / sqrtf(an2) : 0.0f;
+    float im = useMag ? 1.0f / sqrtf(mn2) : 0.0f;
+    _filter.update(AhrsScalar(gx * DEG_TO_RAD), AhrsScalar(gy * DEG_TO_RAD), AhrsScalar(gz * DEG_TO_RAD),
+                   AhrsScalar(ax * ia), AhrsScalar(ay * ia), AhrsScalar(az * ia),
+                   AhrsScalar(mx * im), AhrsScalar(my * im), AhrsScalar(mz * im),
+                   AhrsScalar(dt), useAccel, useAccel && useMag);
+
+    uint32_t cycles = ESP.getCycleCount() - c0;
+    _cyclesLast = cycles;
+    if (cycles > _cyclesMax) _cyclesMax = cycles;
+    _cyclesTotal += cycles;
+    _updates++;
+
+    _updateEuler();
+    return true;
+}
+
+void AttitudeEstimator::_updateEuler() {
+    if (!_ready) return;
+    float q0, q1, q2, q3;
+    _filter.getQuaternion(q0, q1, q2, q3);
+
+    float sinp = 2.0f * (q0 * q2 - q3 * q1);
+    if (sinp > 1.0f) sinp = 1.0f;
+    if (sinp < -1.0f) sinp = -1.0f;
+
+    _roll = atan2f(2.0f * (q0 * q1 + q2 * q3), 1.0f - 2.0f * (q1 * q1 + q2 * q2)) * RAD_TO_DEG;
+    _pitch = asinf(sinp) * RAD_TO_DEG;
+    _yaw = atan2f(2.0f * (q0 * q3 + q1 * q2), 1.0f - 2.0f * (q2 * q2 + q3 * q3)) * RAD_TO_DEG;
+}
+
+void AttitudeEstimator::getGyroBias(float& bx, float& by, float& bz) const {
+    _filter.getGyroBias(bx, by, bz);
+    bx *= RAD_TO_DEG;
+    by *= RAD_TO_DEG;
+    bz *= RAD_TO_DEG;
+}
+
+uint32_t AttitudeEstimator::getCyclesAvg() const {
+    return _updates ? (uint32_t)(_cyclesTotal / _updates) : 0;
+}
+
+void AttitudeEstimator::printStatus() const {
+    if (!_ready) {
+        DEBUG_PRINTF("AHRS (Mahony %s): aguardando acelerometro em ~1 g\n", getBuildName());
+        return;
+    }
+    float bx, by, bz;
+    getGyroBias(bx, by, bz);
+    DEBUG_PRINTF("AHRS (Mahony %s): roll %.1f pitch %.1f yaw %.1f graus, bias gyro %.3f %.3f %.3f dps\n",
+                 getBuildName(), _roll, _pitch, _yaw, bx, by, bz);
+    DEBUG_PRINTF("  %lu passos (%lu amostras perdidas), sem gravidade %lu, sem mag %lu, "
+                 "ciclos/passo med %lu max %lu\n",
+                 (unsigned long)_updates, (unsigned long)_skipped,
+                 (unsigned long)_accelRejects, (unsigned long)_magRejects,
+                 (unsigned long)getCyclesAvg(), (unsigned long)_cyclesMax);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file AttitudeEstimator.h
+ * @brief AHRS a bordo: atitude (quaternião e Euler) a partir do MPU9250
+ *
+ * @details Roda um MahonyFilter a cada amostra de saída do IMU:
+ *          - Passo fixo = 1 / taxa de saída do IMU (amostras perdidas
+ *            entram como múltiplos do passo)
+ *          - Primeira amostra válida inicializa a atitude por acc + mag
+ *          - Acelerômetro só corrige perto de 1 g (fora disso, aceleração
+ *            dinâmica); magnetômetro só com módulo plausível (faixas
+ *            AHRS_ACCEL_* e AHRS_MAG_*, as mesmas de tools/ahrs_replay)
+ *          - Bias do giroscópio estimado pela realimentação integral
+ *          - Ciclos de CPU por atualização medidos (último, médio, máximo)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.1
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Builds
+ * | AHRS_FIXED_POINT | Escalar     | Observação                          |
+ * |------------------|-------------|-------------------------------------|
+ * | 0 (padrão)       | float       | FPU do ESP32                        |
+ * | 1                | QFixed<24>  | Q7.24; raiz inteira de 64 bits      |
+ *
+ * Nas duas builds, normalização das entradas e conversão para Euler
+ * ficam em float (bordas do filtro).
+ *
+ * ## Ângulos (graus)
+ * | Ângulo | Eixo       | Faixa       | Zero                          |
+ * |--------|------------|-------------|-------------------------------|
+ * | roll   | X do corpo | -180..180   | Nivelado                      |
+ * | pitch  | Y do corpo | -90..90     | Nivelado                      |
+ * | yaw    | Z (cima)   | -180..180   | X do corpo no norte magnético |
+ *
+ * @note Chamado só pela task que lê o IMU (FastTask ou SensorsTask)
+ */
+
+#ifndef ATTITUDE_ESTIMATOR_H
+#define ATTITUDE_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "MahonyFilter.h"
+
+#if AHRS_FIXED_POINT
+typedef QFixed<24> AhrsScalar;  ///< Escalar do filtro (Q7.24)
+#else
+typedef float AhrsScalar;       ///< Escalar do filtro
+#endif
+
+/**
+ * @class AttitudeEstimator
+ * @brief Estimador de atitude de passo fixo com estatística de custo
+ */
+class AttitudeEstimator {
+public:
+    AttitudeEstimator();
+
+    /**
+     * @brief Define a taxa do filtro e reinicia a estimativa
+     * @param rateHz Taxa de saída do IMU (passo = 1/rateHz)
+     */
+    void begin(uint16_t rateHz);
+
+    /** @brief Descarta a atitude; a próxima amostra reinicializa por acc + mag */
+    void reset();
+
+    /**
+     * @brief Atualiza com uma amostra do IMU
+     * @param gx,gy,gz Giroscópio (°/s)
+     * @param ax,ay,az Acelerômetro (g)
+     * @param mx,my,mz Magnetômetro (µT), já nos eixos do acelerômetro
+     * @param magValid Magnetômetro online e com leitura nova?
+     * @param steps Amostras de saída desde a chamada anterior (>= 1)
+     * @return true se a atitude é válida após a chamada
+     */
+    bool update(float gx, float gy, float gz,
+                float ax, float ay, float az,
+                float mx, float my, float mz,
+                bool magValid, uint32_t steps);
+
+    //=========================================================================
+    // SAÍDAS
+    //=========================================================================
+
+    bool isReady() const { return _ready; }        ///< Atitude inicializada?
+    float getRoll() const { return _roll; }        ///< Rolagem (°)
+    float getPitch() const { return _pitch; }      ///< Arfagem (°)
+    float getYaw() const { return _yaw; }          ///< Guinada (°)
+
+    /** @brief Quaternião (corpo -> Terra) */
+    void getQuaternion(float& q0, float& q1, float& q2, float& q3) const {
+        _filter.getQuaternion(q0, q1, q2, q3);
+    }
+
+    /** @brief Bias estimado do giroscópio (°/s) */
+    void getGyroBias(float& bx, float& by, float& bz) const;
+
+    //=========================================================================
+    // ESTATÍSTICAS
+    //=========================================================================
+
+    uint32_t getUpdates() const { return _updates; }            ///< Passos executados
+    uint32_t getSkippedSteps() const { return _skipped; }       ///< Amostras perdidas (dt estendido)
+    uint32_t getAccelRejects() const { return _accelRejects; }  ///< Passos sem correção por gravidade
+    uint32_t getMagRejects() const { return _magRejects; }      ///< Passos sem correção magnética
+    uint32_t getCyclesLast() const { return _cyclesLast; }      ///< Ciclos da última atualização
+    uint32_t getCyclesMax() const { return _cyclesMax; }        ///< Pior caso
+    uint32_t getCyclesAvg() const;                              ///< Média desde o begin()
+
+    /** @brief Nome da build ("float" ou "Q7.24") */
+    static const char* getBuildName() { return AHRS_FIXED_POINT ? "Q7.24" : "float"; }
+
+    /** @brief Imprime atitude, bias e custo */
+    void printStatus() const;
+
+private:
+    MahonyFilter<AhrsScalar> _filter;  ///< Filtro
+    float _dt;                  ///< Passo nominal (s)
+    bool _ready;                ///< Atitude inicializada?
+    float _roll, _pitch, _yaw;  ///< Euler da última atualização (°)
+
+    uint32_t _updates;          ///< Passos executados
+    uint32_t _skipped;          ///< Amostras perdidas
+    uint32_t _accelRejects;     ///< Acelerômetro fora de ~1 g
+    uint32_t _magRejects;       ///< Magnetômetro ausente ou implausível
+    uint32_t _cyclesLast;       ///< Ciclos da última atualização
+    uint32_t _cyclesMax;        ///< Maior custo
+    uint64_t _cyclesTotal;      ///< Soma (média)
+
+    static constexpr float MAX_GAP_S = 0.5f;      ///< Lacuna acima disso reinicializa
+
+    void _updateEuler();        ///< Quaternião -> roll/pitch/yaw
+};
+
+#endif // ATTITUDE_ESTIMATOR_H
@@ -0,0 +1,211 @@
+/**
+ * @file MahonyFilter.h
+ * @brief Filtro complementar de Mahony (AHRS) genérico no tipo escalar
+ *
+ * @details Estima a atitude como quaternião a partir de giroscópio,
+ *          acelerômetro e magnetômetro:
+ *          - Integra o giroscópio (rad/s) a passo fixo dt
+ *          - Erro = produto vetorial entre gravidade/campo medidos e
+ *            estimados pelo quaternião atual
+ *          - Realimentação proporcional (Kp) corrige a atitude
+ *          - Realimentação integral (Ki) acumula o bias do giroscópio
+ *
+ *          O mesmo código serve float e QFixed<F>: T precisa de +, -, *,
+ *          * int, >, construtor a partir de float e das funções livres
+ *          ahrsSqrt()/ahrsInvSqrt() (QFixed.h).
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Convenções
+ * - Quaternião (q0, q1, q2, q3) leva o corpo ao referencial da Terra
+ * - Terra: Z para cima, X na componente horizontal do campo magnético
+ * - Em repouso e nivelado, o acelerômetro lê (0, 0, +1)
+ *
+ * @note Entradas de acelerômetro e magnetômetro já normalizadas (vetores
+ *       unitários): mantém a build em ponto fixo dentro da faixa
+ * @see Mahony, Hamel, Pflimlin, "Nonlinear Complementary Filters on the
+ *      Special Orthogonal Group", IEEE TAC 2008
+ */
+
+#ifndef MAHONY_FILTER_H
+#define MAHONY_FILTER_H
+
+#include "QFixed.h"
+
+/**
+ * @class MahonyFilter
+ * @brief AHRS de Mahony com estimativa de bias do giroscópio
+ * @tparam T Escalar (float ou QFixed<F>)
+ */
+template<typename T>
+class MahonyFilter {
+public:
+    MahonyFilter() : _twoKp(2.0f), _twoKi(0.0f), _integralLimit(0.0f) { reset(); }
+
+    /**
+     * @brief Define os ganhos
+     * @param kp Ganho proporcional (1/s)
+     * @param ki Ganho integral (1/s²; 0 = sem estimativa de bias)
+     * @param integralLimit Maior bias estimável por eixo (rad/s)
+     */
+    void setGains(float kp, float ki, float integralLimit) {
+        _twoKp = T(2.0f * kp);
+        _twoKi = T(2.0f * ki);
+        _integralLimit = T(integralLimit);
+    }
+
+    /** @brief Volta à identidade e zera o bias */
+    void reset() {
+        _q0 = T(1.0f); _q1 = T(0.0f); _q2 = T(0.0f); _q3 = T(0.0f);
+        _ix = T(0.0f); _iy = T(0.0f); _iz = T(0.0f);
+    }
+
+    /** @brief Força a atitude (inicialização por acc/mag) */
+    void setQuaternion(float q0, float q1, float q2, float q3) {
+        _q0 = T(q0); _q1 = T(q1); _q2 = T(q2); _q3 = T(q3);
+    }
+
+    /**
+     * @brief Inicializa a atitude por uma amostra em repouso
+     * @details Roll/pitch pela gravidade; yaw leva o campo nivelado para +X
+     *          (0 sem magnetômetro). Calculado em float nas duas builds.
+     * @param ax,ay,az Acelerômetro (qualquer escala)
+     * @param mx,my,mz Magnetômetro (qualquer escala)
+     * @param useMag Usar o magnetômetro para a guinada?
+     */
+    void initFromVectors(float ax, float ay, float az,
+                         float mx, float my, float mz, bool useMag) {
+        // Em repouso o acelerômetro lê R^T·(0,0,1) = (-sθ, sφ·cθ, cφ·cθ)
+        float roll = atan2f(ay, az);
+        float pitch = atan2f(-ax, sqrtf(ay * ay + az * az));
+
+        // Campo nivelado = Ry(θ)·Rx(φ)·m
+        float yaw = 0.0f;
+        if (useMag) {
+            float sr = sinf(roll), cr = cosf(roll);
+            float sp = sinf(pitch), cp = cosf(pitch);
+            float hx = mx * cp + (my * sr + mz * cr) * sp;
+            float hy = my * cr - mz * sr;
+            yaw = -atan2f(hy, hx);
+        }
+
+        // Quaternião de Euler ZYX (ângulos pela metade)
+        float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+        float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+        float cy = cosf(yaw * 0.5f), sy = sinf(yaw * 0.5f);
+        setQuaternion(cr * cp * cy + sr * sp * sy,
+                      sr * cp * cy - cr * sp * sy,
+                      cr * sp * cy + sr * cp * sy,
+                      cr * cp * sy - sr * sp * cy);
+    }
+
+    /**
+     * @brief Um passo do filtro
+     * @param gx,gy,gz Giroscópio (rad/s)
+     * @param ax,ay,az Acelerômetro normalizado (ignorado se !useAccel)
+     * @param mx,my,mz Magnetômetro normalizado (ignorado se !useMag)
+     * @param dt Passo (s)
+     * @param useAccel Corrigir inclinação pela gravidade?
+     * @param useMag Corrigir guinada pelo campo magnético? (requer useAccel)
+     */
+    void update(T gx, T gy, T gz, T ax, T ay, T az, T mx, T my, T mz,
+                T dt, bool useAccel, bool useMag) {
+        const T half(0.5f);
+
+        if (useAccel) {
+            T q0q0 = _q0 * _q0, q0q1 = _q0 * _q1, q0q2 = _q0 * _q2, q0q3 = _q0 * _q3;
+            T q1q1 = _q1 * _q1, q1q2 = _q1 * _q2, q1q3 = _q1 * _q3;
+            T q2q2 = _q2 * _q2, q2q3 = _q2 * _q3;
+            T q3q3 = _q3 * _q3;
+
+            // Gravidade estimada no corpo (metade)
+            T vx = q1q3 - q0q2;
+            T vy = q0q1 + q2q3;
+            T vz = q0q0 - half + q3q3;
+
+            T ex = ay * vz - az * vy;
+            T ey = az * vx - ax * vz;
+            T ez = ax * vy - ay * vx;
+
+            if (useMag) {
+                // Campo medido levado à Terra; referência = (|h_xy|, 0, h_z)
+                T hx = (mx * (half - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2)) * 2;
+                T hy = (mx * (q1q2 + q0q3) + my * (half - q1q1 - q3q3) + mz * (q2q3 - q0q1)) * 2;
+                T bx = ahrsSqrt(hx * hx + hy * hy);
+                T bz = (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (half - q1q1 - q2q2)) * 2;
+
+                // Campo estimado no corpo (metade)
+                T wx = bx * (half - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+                T wy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+                T wz = bx * (q0q2 + q1q3) + bz * (half - q1q1 - q2q2);
+
+                ex += my * wz - mz * wy;
+                ey += mz * wx - mx * wz;
+                ez += mx * wy - my * wx;
+            }
+
+            // Integral = -bias do giroscópio (limitado contra windup)
+            if (_twoKi > T(0.0f)) {
+                T kdt = _twoKi * dt;
+                _ix = _clamp(_ix + kdt * ex);
+                _iy = _clamp(_iy + kdt * ey);
+                _iz = _clamp(_iz + kdt * ez);
+            }
+            gx += _ix + _twoKp * ex;
+            gy += _iy + _twoKp * ey;
+            gz += _iz + _twoKp * ez;
+        } else {
+            // Sem referência: mantém a correção de bias já aprendida
+            gx += _ix;
+            gy += _iy;
+            gz += _iz;
+        }
+
+        // q += 0.5 * q ⊗ (0, g) * dt
+        T hdt = half * dt;
+        gx *= hdt;
+        gy *= hdt;
+        gz *= hdt;
+        T qa = _q0, qb = _q1, qc = _q2;
+        _q0 += -qb * gx - qc * gy - _q3 * gz;
+        _q1 += qa * gx + qc * gz - _q3 * gy;
+        _q2 += qa * gy - qb * gz + _q3 * gx;
+        _q3 += qa * gz + qb * gy - qc * gx;
+
+        T n = ahrsInvSqrt(_q0 * _q0 + _q1 * _q1 + _q2 * _q2 + _q3 * _q3);
+        _q0 *= n;
+        _q1 *= n;
+        _q2 *= n;
+        _q3 *= n;
+    }
+
+    /** @brief Quaternião atual */
+    void getQuaternion(float& q0, float& q1, float& q2, float& q3) const {
+        q0 = (float)_q0; q1 = (float)_q1; q2 = (float)_q2; q3 = (float)_q3;
+    }
+
+    /** @brief Bias estimado do giroscópio (rad/s) */
+    void getGyroBias(float& bx, float& by, float& bz) const {
+        bx = -(float)_ix; by = -(float)_iy; bz = -(float)_iz;
+    }
+
+private:
+    T _q0, _q1, _q2, _q3;       ///< Atitude (corpo -> Terra)
+    T _ix, _iy, _iz;            ///< Realimentação integral (rad/s)
+    T _twoKp;                   ///< 2·Kp
+    T _twoKi;                   ///< 2·Ki
+    T _integralLimit;           ///< |integral| máximo por eixo
+
+    T _clamp(T v) const {
+        if (v > _integralLimit) return _integralLimit;
+        if (-_integralLimit > v) return -_integralLimit;
+        return v;
+    }
+};
+
+#endif // MAHONY_FILTER_H
@@ -0,0 +1,120 @@
+/**
+ * @file QFixed.h
+ * @brief Número em ponto fixo Q(31-F).F com aritmética de 32/64 bits
+ *
+ * @details Tipo de valor usado como escalar do MahonyFilter na build em
+ *          ponto fixo (AHRS_FIXED_POINT = 1):
+ *          - Armazenamento int32_t com F bits fracionários
+ *          - Produto em 64 bits com arredondamento
+ *          - Raiz e inverso da raiz por raiz inteira de 64 bits
+ *          - Conversão de/para float só nas bordas (entrada do sensor,
+ *            saída em graus)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Faixa (F = 24, Q7.24)
+ * | Grandeza                  | Faixa típica  | Cabe em ±128? |
+ * |---------------------------|---------------|---------------|
+ * | Quaternião, vetores unit. | ±1            | Sim           |
+ * | Giroscópio (rad/s)        | ±35 (2000°/s) | Sim           |
+ * | Erro × Kp                 | ±2·Kp         | Sim (Kp < 32) |
+ *
+ * Resolução 2^-24 ≈ 6e-8: o passo do integrador (Ki·e·dt) continua
+ * representável para erros de ~1e-4.
+ *
+ * @warning Sem saturação: o chamador mantém os valores na faixa
+ */
+
+#ifndef QFIXED_H
+#define QFIXED_H
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * @class QFixed
+ * @brief Ponto fixo com sinal, F bits fracionários
+ * @tparam F Bits fracionários (1..30)
+ */
+template<int F>
+class QFixed {
+public:
+    static constexpr int32_t ONE = (int32_t)1 << F;  ///< 1.0
+
+    QFixed() : _raw(0) {}
+    QFixed(float v) : _raw((int32_t)(v * (float)ONE + (v >= 0 ? 0.5f : -0.5f))) {}
+
+    /** @brief Constrói a partir da representação bruta */
+    static QFixed fromRaw(int32_t raw) { QFixed q; q._raw = raw; return q; }
+
+    int32_t raw() const { return _raw; }                         ///< Representação bruta
+    explicit operator float() const { return (float)_raw / (float)ONE; }  ///< Valor em float
+
+    QFixed operator+(QFixed o) const { return fromRaw(_raw + o._raw); }
+    QFixed operator-(QFixed o) const { return fromRaw(_raw - o._raw); }
+    QFixed operator-() const { return fromRaw(-_raw); }
+    QFixed operator*(QFixed o) const {
+        int64_t p = (int64_t)_raw * o._raw;
+        return fromRaw((int32_t)((p + ((int64_t)1 << (F - 1))) >> F));
+    }
+    QFixed operator*(int32_t k) const { return fromRaw(_raw * k); }
+    QFixed& operator+=(QFixed o) { _raw += o._raw; return *this; }
+    QFixed& operator-=(QFixed o) { _raw -= o._raw; return *this; }
+    QFixed& operator*=(QFixed o) { return *this = *this * o; }
+    bool operator>(QFixed o) const { return _raw > o._raw; }
+    bool operator==(QFixed o) const { return _raw == o._raw; }
+
+private:
+    int32_t _raw;   ///< Valor × 2^F
+};
+
+/**
+ * @brief Raiz inteira de 64 bits (bit a bit, sem divisão)
+ * @return floor(sqrt(v))
+ */
+inline uint32_t qfixedIsqrt64(uint64_t v) {
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+/** @brief Raiz quadrada em Q (x <= 0 retorna 0) */
+template<int F>
+inline QFixed<F> ahrsSqrt(QFixed<F> x) {
+    if (x.raw() <= 0) return QFixed<F>();
+    // sqrt(raw / 2^F) * 2^F = sqrt(raw * 2^F)
+    return QFixed<F>::fromRaw((int32_t)qfixedIsqrt64((uint64_t)x.raw() << F));
+}
+
+/** @brief 1/sqrt(x) em Q (x <= 0 retorna 0) */
+template<int F>
+inline QFixed<F> ahrsInvSqrt(QFixed<F> x) {
+    if (x.raw() <= 0) return QFixed<F>();
+    // s = sqrt(x) em Q; 1/sqrt(x) em Q = 2^F * 2^F / s (divisão de 64 bits)
+    uint32_t s = qfixedIsqrt64((uint64_t)x.raw() << F);
+    if (s == 0) return QFixed<F>();
+    return QFixed<F>::fromRaw((int32_t)(((int64_t)1 << (2 * F)) / s));
+}
+
+/** @brief Raiz quadrada em float */
+inline float ahrsSqrt(float x) { return x > 0.0f ? sqrtf(x) : 0.0f; }
+
+/** @brief 1/sqrt(x) em float (x <= 0 retorna 0) */
+inline float ahrsInvSqrt(float x) { return x > 0.0f ? 1.0f / sqrtf(x) : 0.0f; }
+
+#endif // QFIXED_H
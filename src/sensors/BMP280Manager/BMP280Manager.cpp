@@ -12,18 +12,9 @@ BMP280Manager::BMP280Manager()
       _online(false), _tempValid(false),
       _failCount(0),
       _lastReinitTime(0), _warmupStartTime(0),
-      _historyIndex(0), _historyFull(false), _lastUpdateTime(0),
+      _lastUpdateTime(0),
       _lastPressureRead(0.0f), _identicalReadings(0)
 {
-    _initHistoryValues();
-}
-
-void BMP280Manager::_initHistoryValues() {
-    for (uint8_t i = 0; i < HISTORY_SIZE; i++) {
-        _pressureHistory[i] = 1013.25f;
-        _altitudeHistory[i] = 0.0f;
-        _tempHistory[i] = 20.0f;
-    }
 }
 
 bool BMP280Manager::begin() {
@@ -33,7 +24,7 @@ bool BMP280Manager::begin() {
     _tempValid = false;
     _failCount = 0;
     _identicalReadings = 0;
-    _initHistoryValues();
+    _pressureHistory.clear();
     
     uint8_t addresses[] = {BMP280::I2C_ADDR_PRIMARY, BMP280::I2C_ADDR_SECONDARY};
     bool detected = false;
@@ -68,7 +59,8 @@ bool BMP280Manager::begin() {
         _online = true;
         _tempValid = true;
         _warmupStartTime = millis();
-        for(int i=0; i<HISTORY_SIZE; i++) _updateHistory(t, p, a);
+        _pressureHistory.fill(p);
+        _lastUpdateTime = millis();
         DEBUG_PRINTLN("[BMP280Manager] Inicializado com sucesso.");
         return true;
     }
@@ -80,18 +72,9 @@ bool BMP280Manager::begin() {
 void BMP280Manager::update() {
     if (!_online) return;
     
+    // Uma tentativa por ciclo: falhas isoladas só avançam _failCount
     float temp, press, alt;
-    bool readSuccess = false;
-    
-    for (int i = 0; i < 3; i++) {
-        if (_readRaw(temp, press, alt)) {
-            readSuccess = true;
-            break;
-        }
-        delay(10);
-    }
-    
-    if (!readSuccess) {
+    if (!_readRaw(temp, press, alt)) {
         _failCount++;
         if (_failCount >= 10 && _canReinit()) {
             DEBUG_PRINTLN("[BMP280Manager] Falhas excessivas. Reinicializando...");
@@ -107,12 +90,7 @@ void BMP280Manager::update() {
         _tempValid = true;
         _failCount = 0;
         
-        for (uint8_t i = 0; i < HISTORY_SIZE; i++) {
-            _pressureHistory[i] = press;
-            _altitudeHistory[i] = alt;
-            _tempHistory[i] = temp;
-        }
-        _historyFull = true;
+        _pressureHistory.fill(press);
         _lastUpdateTime = millis();
         DEBUG_PRINTLN("[BMP280Manager] Historico reiniciado.");
         return;
@@ -136,7 +114,8 @@ void BMP280Manager::update() {
     _altitude = alt;
     _tempValid = true;
     _failCount = 0;
-    _updateHistory(temp, press, alt);
+    _pressureHistory.push(press);
+    _lastUpdateTime = millis();
 }
 
 void BMP280Manager::reset() {
@@ -153,9 +132,8 @@ void BMP280Manager::forceReinit() {
 }
 
 bool BMP280Manager::_readRaw(float& temp, float& press, float& alt) {
-    temp = _bmp280.readTemperature();
-    press = _bmp280.readPressure() / 100.0f; // Pa -> hPa
-    alt = _bmp280.readAltitude();
+    if (!_bmp280.readAll(temp, press, alt)) return false;
+    press /= 100.0f; // Pa -> hPa
     return (!isnan(temp) && !isnan(press) && !isnan(alt));
 }
 
@@ -172,9 +150,8 @@ bool BMP280Manager::_validateReading(float temp, float press, float alt) {
         }
     }
     
-    if (_historyFull || _historyIndex >= 3) {
-        if (_isOutlier(press, _pressureHistory, _historyFull ? HISTORY_SIZE : _historyIndex)) return false;
-    }
+    // Mediana/MAD da janela em O(log n), sem ordenar cópias
+    if (_pressureHistory.isOutlier(press, OUTLIER_SCORE, OUTLIER_MAD_MIN)) return false;
     
     return true;
 }
@@ -190,50 +167,12 @@ bool BMP280Manager::_isFrozen(float currentPressure) {
 }
 
 bool BMP280Manager::_checkRateOfChange(float temp, float press, float alt, float deltaTime) {
-    uint8_t prevIdx = (_historyIndex == 0) ? HISTORY_SIZE - 1 : _historyIndex - 1;
-    float pressRate = fabs(press - _pressureHistory[prevIdx]) / deltaTime;
+    if (_pressureHistory.size() == 0) return true;
+    float pressRate = fabs(press - _pressureHistory.newest()) / deltaTime;
     if (pressRate > (MAX_PRESSURE_RATE * 2.0f)) return false; 
     return true;
 }
 
-bool BMP280Manager::_isOutlier(float value, float* history, uint8_t count) const {
-    if (count < 3) return false;
-    
-    float median = _getMedian(history, count);
-    float deviations[HISTORY_SIZE];
-    for (uint8_t i = 0; i < count; i++) deviations[i] = fabs(history[i] - median);
-    
-    float mad = _getMedian(deviations, count);
-    if (mad < 0.1f) mad = 0.1f; 
-    
-    float score = fabs(value - median) / mad;
-    return (score > 8.0f);
-}
-
-float BMP280Manager::_getMedian(float* values, uint8_t count) const {
-    float sorted[HISTORY_SIZE];
-    memcpy(sorted, values, count * sizeof(float));
-    for (uint8_t i = 0; i < count - 1; i++) {
-        for (uint8_t j = 0; j < count - i - 1; j++) {
-            if (sorted[j] > sorted[j + 1]) {
-                float temp = sorted[j];
-                sorted[j] = sorted[j + 1];
-                sorted[j + 1] = temp;
-            }
-        }
-    }
-    return sorted[count / 2];
-}
-
-void BMP280Manager::_updateHistory(float temp, float press, float alt) {
-    _pressureHistory[_historyIndex] = press;
-    _altitudeHistory[_historyIndex] = alt;
-    _tempHistory[_historyIndex] = temp;
-    _historyIndex = (_historyIndex + 1) % HISTORY_SIZE;
-    if (_historyIndex == 0) _historyFull = true;
-    _lastUpdateTime = millis();
-}
-
 bool BMP280Manager::_canReinit() const {
     return ((millis() - _lastReinitTime) > REINIT_COOLDOWN);
 }
\ No newline at end of file
@@ -13,7 +13,7 @@
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 2.0.0
+ * @version 2.2.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -30,7 +30,7 @@
  * 1. **Range check**: Valores dentro dos limites físicos
  * 2. **Rate-of-change**: Variação máxima por segundo
  * 3. **Frozen detection**: Leituras idênticas consecutivas
- * 4. **Outlier filter**: Mediana do histórico
+ * 4. **Outlier filter**: Mediana/MAD da janela (SlidingMedian, O(log n))
  * 
  * @note Endereço I2C: 0x76 (SDO=GND) ou 0x77 (SDO=VCC)
  * @warning Requer período de warmup de 2 segundos após inicialização
@@ -43,6 +43,7 @@
 #include <Wire.h>
 #include "BMP280.h"
 #include "config.h"
+#include "core/SlidingMedian/SlidingMedian.h"
 
 /**
  * @class BMP280Manager
@@ -108,6 +109,11 @@ public:
     
     /** @brief Contador de falhas consecutivas */
     uint8_t getFailCount() const { return _failCount; }
+
+    /** @brief Endereço I2C detectado (primário se ainda não detectado) */
+    uint8_t getAddress() const {
+        return _bmp280.getAddress() ? _bmp280.getAddress() : BMP280::I2C_ADDR_PRIMARY;
+    }
     
 private:
     //=========================================================================
@@ -133,12 +139,10 @@ private:
     //=========================================================================
     // HISTÓRICO PARA FILTRO DE OUTLIERS
     //=========================================================================
-    static constexpr uint8_t HISTORY_SIZE = 10;  ///< Tamanho do buffer circular
-    float _pressureHistory[HISTORY_SIZE];   ///< Histórico de pressão
-    float _altitudeHistory[HISTORY_SIZE];   ///< Histórico de altitude
-    float _tempHistory[HISTORY_SIZE];       ///< Histórico de temperatura
-    uint8_t _historyIndex;                  ///< Índice circular
-    bool _historyFull;                      ///< Buffer cheio?
+    static constexpr uint8_t HISTORY_SIZE = 10;  ///< Tamanho da janela
+    static constexpr float OUTLIER_SCORE = 8.0f;     ///< |p - mediana| / MAD máximo
+    static constexpr float OUTLIER_MAD_MIN = 0.1f;   ///< MAD mínimo (hPa)
+    SlidingMedian<float, HISTORY_SIZE> _pressureHistory;  ///< Janela de pressão (hPa)
     unsigned long _lastUpdateTime;          ///< Timestamp última leitura
     unsigned long _warmupStartTime;         ///< Início do warmup
 
@@ -174,7 +178,7 @@ private:
     // MÉTODOS PRIVADOS
     //=========================================================================
     
-    /** @brief Lê valores raw do sensor */
+    /** @brief Lê temperatura, pressão e altitude em uma rajada I2C */
     bool _readRaw(float& temp, float& press, float& alt);
     
     /** @brief Valida leitura contra limites do datasheet */
@@ -186,18 +190,6 @@ private:
     /** @brief Detecta sensor travado (leituras idênticas) */
     bool _isFrozen(float currentPressure);
     
-    /** @brief Verifica se valor é outlier comparado ao histórico */
-    bool _isOutlier(float value, float* history, uint8_t count) const;
-    
-    /** @brief Calcula mediana de array */
-    float _getMedian(float* values, uint8_t count) const;
-    
-    /** @brief Atualiza buffer circular de histórico */
-    void _updateHistory(float temp, float press, float alt);
-    
-    /** @brief Inicializa valores do histórico */
-    void _initHistoryValues();
-    
     /** @brief Verifica se pode reinicializar (cooldown) */
     bool _canReinit() const;
 };
@@ -41,7 +41,6 @@ bool CCS811Manager::begin() {
 void CCS811Manager::update() {
     if (!_online) return;
 
-    if (millis() - _lastRead < READ_INTERVAL) return;
     _lastRead = millis();
 
     // Só tenta ler se tiver dados prontos
@@ -11,7 +11,7 @@
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 1.2.0
+ * @version 1.3.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -70,8 +70,8 @@ public:
     bool begin();
     
     /**
-     * @brief Atualiza leituras do sensor
-     * @note Respeita intervalo mínimo de 2 segundos
+     * @brief Atualiza leituras do sensor (se houver dado novo)
+     * @note Período definido pelo SensorScheduler (SensorRates::airMs)
      */
     void update();
     
@@ -96,6 +96,14 @@ public:
     
     /** @brief Sensor respondendo? */
     bool isOnline() const { return _online; }
+
+    /** @brief Contador de falhas consecutivas */
+    uint8_t getFailCount() const { return _failCount; }
+
+    /** @brief Endereço I2C detectado (0x5A se ainda não detectado) */
+    uint8_t getAddress() const {
+        return _ccs811.getAddress() ? _ccs811.getAddress() : CCS811::ADDR_5A;
+    }
     
     /**
      * @brief Verifica se dados são válidos
@@ -160,7 +168,6 @@ private:
     //=========================================================================
     // CONSTANTES
     //=========================================================================
-    static constexpr unsigned long READ_INTERVAL = 2000;   ///< Intervalo entre leituras (ms)
     static constexpr unsigned long WARMUP_TIME = 20000;    ///< Tempo de warmup (20s)
 };
 
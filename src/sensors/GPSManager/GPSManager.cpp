@@ -1,154 +1,527 @@
 /**
  * @file GPSManager.cpp
- * @brief Implementação com filtros de suavização e detecção de anomalias
- * @version 1.3.0
+ * @brief Implementação do driver UBX com filtros de suavização e detecção de anomalias
+ * @version 2.1.0
  */
 
 #include "GPSManager.h"
 #include <math.h>
+#include <esp_timer.h>
+
+static_assert(GPS_NAV_RATE_HZ >= 1 && GPS_NAV_RATE_HZ <= 10,
+              "GPS_NAV_RATE_HZ deve ficar entre 1 e 10 (limite do NEO-M8N)");
 
 GPSManager::GPSManager()
-    : _serial(nullptr), _latitude(0.0), _longitude(0.0), _prevLatitude(0.0),
-      _prevLongitude(0.0), _altitude(0.0), _filteredAltitude(0.0), _hdop(99.0f),
-      _speed(0.0f), _satellites(0), _hasFix(false), _isFirstFix(true),
-      _lastEncoded(0), _lastValidFix(0) {}
+    : _uartQueue(nullptr), _uartReady(false), _byteUs(0), _solution(),
+      _latitude(0.0), _longitude(0.0),
+      _prevLatitude(0.0), _prevLongitude(0.0), _altitude(0.0),
+      _filteredAltitude(0.0), _speed(0.0f), _satellites(0), _hasFix(false),
+      _isFirstFix(true), _lastEncoded(0), _lastValidFix(0), _lastDebugTime(0),
+      _rxOffsetUs(0), _rxOffsetValid(false), _maxLatencyUs(0), _configured(false), _reconfigStep(0), _lastFrame(0),
+      _lastConfigAttempt(0), _ackClass(0), _ackId(0), _ackReceived(false),
+      _ackOk(false), _pvtCount(0), _dopCount(0), _nakCount(0),
+      _reconfigCount(0), _events(0), _idleEvents(0), _fifoOverruns(0),
+      _bufferOverruns(0), _lineErrors(0), _maxBuffered(0) {
+  _solution.hAcc = _solution.vAcc = 9999.0f;
+  _solution.pDop = _solution.hDop = _solution.vDop = 99.0f;
+  _publish();
+}
+
+//=============================================================================
+// CICLO DE VIDA
+//=============================================================================
 
 bool GPSManager::begin() {
-  DEBUG_PRINTLN("[GPSManager] Inicializando GPS NEO-M8N...");
+  DEBUG_PRINTLN("[GPSManager] Inicializando GPS NEO-M8N (UBX)...");
 
-  _serial = &Serial2;
+  // Driver do ESP-IDF: ISR move a FIFO para o ring buffer e posta eventos
+  if (uart_driver_install(GPS_UART_NUM, GPS_RX_BUFFER_SIZE, 0,
+                          GPS_UART_EVENT_QUEUE, &_uartQueue, 0) != ESP_OK) {
+    DEBUG_PRINTLN("[GPSManager] ERRO: driver UART nao instalado");
+    return false;
+  }
+  uart_config_t cfg = {};
+  cfg.baud_rate = GPS_UBX_BAUD_RATE;
+  cfg.data_bits = UART_DATA_8_BITS;
+  cfg.parity = UART_PARITY_DISABLE;
+  cfg.stop_bits = UART_STOP_BITS_1;
+  cfg.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  cfg.source_clk = UART_SCLK_APB;
+  uart_param_config(GPS_UART_NUM, &cfg);
+  uart_set_pin(GPS_UART_NUM, GPS_TX_PIN, GPS_RX_PIN, UART_PIN_NO_CHANGE,
+               UART_PIN_NO_CHANGE);
+
+  // Fim de rajada: linha parada por GPS_RX_IDLE_SYMBOLS bytes gera UART_DATA
+  uart_set_rx_timeout(GPS_UART_NUM, GPS_RX_IDLE_SYMBOLS);
+  _uartReady = true;
+  _setBaud(GPS_UBX_BAUD_RATE);
+
+  // Receptor já configurado (reset só do ESP32, módulo continuou ligado)?
+  _configured = _configure();
+
+  if (!_configured && GPS_UBX_BAUD_RATE != GPS_BAUD_RATE) {
+    // Padrão de fábrica: NMEA a GPS_BAUD_RATE. O ACK do CFG-PRT sai já
+    // no baud novo, então não é esperado aqui.
+    _setBaud(GPS_BAUD_RATE);
+    _sendPortConfig();
+    uart_wait_tx_done(GPS_UART_NUM, pdMS_TO_TICKS(BAUD_SWITCH_MS));
+    delay(BAUD_SWITCH_MS);
+    _setBaud(GPS_UBX_BAUD_RATE);
+    _configured = _configure();
+  }
 
-  // Inicia com a velocidade confirmada e pinos do config.h
-  _serial->begin(GPS_BAUD_RATE, SERIAL_8N1, GPS_RX_PIN, GPS_TX_PIN);
+  // Eventos da configuração já foram drenados por polling
+  xQueueReset(_uartQueue);
+  _lastConfigAttempt = millis();
 
-  return true;
+  if (_configured) {
+    DEBUG_PRINTF("[GPSManager] UBX: NAV-PVT a %d Hz, %lu baud\n",
+                 GPS_NAV_RATE_HZ, (unsigned long)GPS_UBX_BAUD_RATE);
+  } else {
+    DEBUG_PRINTLN("[GPSManager] Receptor nao confirmou configuracao UBX "
+                  "(nova tentativa no service)");
+  }
+  return _configured;
 }
 
-void GPSManager::update() {
-  uint32_t now = millis();
+void GPSManager::service(uint32_t timeoutMs) {
+  if (!_uartReady) {
+    if (timeoutMs > 0) vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+    return;
+  }
 
-  // Rate limiting para mensagens de debug (evita flooding)
-  static uint32_t lastDebugTime = 0;
-  constexpr uint32_t DEBUG_INTERVAL_MS = 5000; // Mensagens a cada 5s no máximo
-  bool canPrintDebug = (now - lastDebugTime >= DEBUG_INTERVAL_MS);
+  // Dorme até a ISR postar um evento; depois esvazia a fila sem esperar
+  uart_event_t event;
+  TickType_t wait = pdMS_TO_TICKS(timeoutMs);
+  while (xQueueReceive(_uartQueue, &event, wait) == pdTRUE) {
+    _handleEvent(event);
+    wait = 0;
+  }
 
-  // Processa todos os caracteres disponíveis
-  while (_serial->available() > 0) {
-    char c = _serial->read();
+  uint32_t now = millis();
 
-    // Alimenta a biblioteca TinyGPS++ para processamento
-    if (_gps.encode(c)) {
-      _lastEncoded = now;
+  // Eventos descartados com a fila cheia: o ring buffer ainda tem os bytes
+  _drain(now);
 
-      // Atualiza contagem de satélites primeiro
-      if (_gps.satellites.isValid()) {
-        _satellites = _gps.satellites.value();
-      }
+  // Receptor perdeu a configuração (ou ainda não respondeu)
+  _reconfigureStep(now);
 
-      // Atualiza HDOP (qualidade do fix)
-      if (_gps.hdop.isValid()) {
-        _hdop = _gps.hdop.hdop();
-      }
+  // Timeout de segurança: Se passar 5s sem NAV-PVT, perde o fix
+  if (_hasFix && now - _lastEncoded > FIX_TIMEOUT_MS) {
+    _hasFix = false;
+    _publish();
+  }
+}
 
-      // Verifica qualidade mínima antes de aceitar posição
-      if (_satellites < MIN_SATELLITES) {
-        if (canPrintDebug) {
-          DEBUG_PRINTF("[GPS] Poucos satelites: %d (min: %d)\n", _satellites,
-                       MIN_SATELLITES);
-          lastDebugTime = now;
+//=============================================================================
+// RECEPÇÃO
+//=============================================================================
+
+void GPSManager::_drain(uint32_t now) {
+  uint8_t chunk[READ_CHUNK];
+  size_t buffered = 0;
+  while (uart_get_buffered_data_len(GPS_UART_NUM, &buffered) == ESP_OK &&
+         buffered > 0) {
+    // O último byte bufferizado chegou no máximo agora; os anteriores, um
+    // tempo de byte antes cada
+    int64_t tLast = esp_timer_get_time();
+    if (buffered > _maxBuffered) _maxBuffered = buffered;
+
+    size_t left = buffered;
+    while (left > 0) {
+      size_t want = (left < sizeof(chunk)) ? left : sizeof(chunk);
+      int n = uart_read_bytes(GPS_UART_NUM, chunk, want, 0);
+      if (n <= 0) return;
+      for (int i = 0; i < n; i++) {
+        left--;
+        if (_parser.feed(chunk[i])) {
+          _handleFrame(now, tLast - (int64_t)left * _byteUs);
         }
-        continue; // Continua processando mas não atualiza posição
       }
+    }
+  }
+}
 
-      if (_hdop > MAX_HDOP) {
-        if (canPrintDebug) {
-          DEBUG_PRINTF("[GPS] HDOP muito alto: %.1f (max: %.1f)\n", _hdop,
-                       MAX_HDOP);
-          lastDebugTime = now;
-        }
-        continue;
-      }
+void GPSManager::_handleEvent(const uart_event_t& event) {
+  switch (event.type) {
+    case UART_DATA:
+      _events++;
+      if (event.timeout_flag) _idleEvents++;
+      _drain(millis());
+      break;
+    case UART_FIFO_OVF:
+      _fifoOverruns++;
+      _recoverOverrun();
+      break;
+    case UART_BUFFER_FULL:
+      _bufferOverruns++;
+      _recoverOverrun();
+      break;
+    case UART_FRAME_ERR:
+    case UART_PARITY_ERR:
+      _lineErrors++;
+      break;
+    default:
+      break;
+  }
+}
 
-      // Atualiza cache apenas se a localização for válida
-      if (_gps.location.isValid()) {
-        double lat = _gps.location.lat();
-        double lng = _gps.location.lng();
-
-        // Validação de range para coordenadas
-        if (!_isValidCoordinate(lat, lng)) {
-          if (canPrintDebug) {
-            DEBUG_PRINTF("[GPS] Coordenadas invalidas: %.6f, %.6f\n", lat, lng);
-            lastDebugTime = now;
-          }
-          _hasFix = false;
-          continue;
-        }
+void GPSManager::_recoverOverrun() {
+  // Bytes perdidos no meio: o que está no buffer não fecha frame válido.
+  // Eventos UART_DATA ainda na fila só encontram o buffer vazio.
+  uart_flush_input(GPS_UART_NUM);
+  _parser.reset();
+}
 
-        // Calcula delta tempo desde último fix válido
-        uint32_t dtMs = now - _lastValidFix;
+void GPSManager::_handleFrame(uint32_t now, int64_t rxUs) {
+  const uint8_t* p = _parser.payload();
+  const uint8_t cls = _parser.msgClass();
+  const uint8_t id = _parser.msgId();
+  const uint16_t len = _parser.length();
+
+  _lastFrame = now;
+
+  if (cls == CLS_NAV) {
+    if (id == ID_NAV_PVT && len >= NAV_PVT_LEN) {
+      _handlePvt(p, now, rxUs);
+      _publish();
+    } else if (id == ID_NAV_DOP && len >= NAV_DOP_LEN) {
+      _handleDop(p);
+      _publish();
+    }
+  } else if (cls == CLS_ACK && len >= 2) {
+    _ackClass = p[0];
+    _ackId = p[1];
+    _ackOk = (id == ID_ACK_ACK);
+    _ackReceived = true;
+    if (!_ackOk) _nakCount++;
+  }
+}
 
-        // Detecção de salto anômalo (exceto no primeiro fix)
-        if (!_isFirstFix && _isAnomalousJump(lat, lng, dtMs)) {
-          if (canPrintDebug) {
-            DEBUG_PRINTF("[GPS] Salto anomalo detectado! Ignorando leitura.\n");
-            lastDebugTime = now;
-          }
-          continue;
-        }
+void GPSManager::_handlePvt(const uint8_t* p, uint32_t now, int64_t rxUs) {
+  Solution& s = _solution;
+
+  // Layout fixo do NAV-PVT (u-blox M8, protocolo 15+)
+  s.iTowMs = UbxParser::u4(p, 0);
+  s.year = UbxParser::u2(p, 4);
+  s.month = p[6];
+  s.day = p[7];
+  s.hour = p[8];
+  s.minute = p[9];
+  s.second = p[10];
+  s.dateValid = (p[11] & 0x01) != 0;
+  s.timeValid = (p[11] & 0x06) == 0x06;  // validTime + fullyResolved
+  s.tAccNs = UbxParser::u4(p, 12);
+  s.fixType = (FixType)p[20];
+  s.fixOk = (p[21] & 0x01) != 0;
+  s.numSV = p[23];
+  s.longitude = UbxParser::i4(p, 24) * 1e-7;
+  s.latitude = UbxParser::i4(p, 28) * 1e-7;
+  s.heightMsl = UbxParser::i4(p, 36) * 0.001f;
+  s.hAcc = UbxParser::u4(p, 40) * 0.001f;
+  s.vAcc = UbxParser::u4(p, 44) * 0.001f;
+  s.velN = UbxParser::i4(p, 48) * 0.001f;
+  s.velE = UbxParser::i4(p, 52) * 0.001f;
+  s.velD = UbxParser::i4(p, 56) * 0.001f;
+  s.groundSpeed = UbxParser::i4(p, 60) * 0.001f;
+  s.heading = UbxParser::i4(p, 64) * 1e-5f;
+  s.sAcc = UbxParser::u4(p, 68) * 0.001f;
+  s.pDop = UbxParser::u2(p, 76) * 0.01f;
+  s.rxMillis = now;
+  s.rxTimeUs = _dejitter(s.iTowMs, rxUs);
+
+  _lastEncoded = now;
+  _pvtCount++;
+  _configured = true;  // Só chega NAV-PVT com a configuração aplicada
+  _satellites = s.numSV;
+
+  bool canPrintDebug = (now - _lastDebugTime >= DEBUG_INTERVAL_MS);
+
+  // Solução sem posição utilizável (ainda a adquirir satélites)
+  if (!s.fixOk || s.fixType < FIX_2D || s.fixType > FIX_GNSS_DR) {
+    _hasFix = false;
+    return;
+  }
 
-        // Salva posição anterior
-        _prevLatitude = _latitude;
-        _prevLongitude = _longitude;
-
-        // Aplica filtro de suavização na posição (exceto primeiro fix)
-        if (_isFirstFix) {
-          _latitude = lat;
-          _longitude = lng;
-          _isFirstFix = false;
-        } else {
-          // Média móvel exponencial para suavizar
-          _latitude = _latitude + POSITION_FILTER_ALPHA * (lat - _latitude);
-          _longitude = _longitude + POSITION_FILTER_ALPHA * (lng - _longitude);
-        }
+  // Verifica qualidade mínima antes de aceitar posição
+  if (_satellites < MIN_SATELLITES) {
+    if (canPrintDebug) {
+      DEBUG_PRINTF("[GPS] Poucos satelites: %d (min: %d)\n", _satellites,
+                   MIN_SATELLITES);
+      _lastDebugTime = now;
+    }
+    return;
+  }
 
-        // Calcula velocidade baseada no deslocamento
-        if (dtMs > 0 && _prevLatitude != 0.0) {
-          double dist = _haversineDistance(_prevLatitude, _prevLongitude,
-                                           _latitude, _longitude);
-          _speed = (float)((dist / dtMs) * 3600.0); // m/ms -> km/h
-        }
+  if (s.pDop > MAX_PDOP || s.hAcc > GPS_MAX_HACC_M) {
+    if (canPrintDebug) {
+      DEBUG_PRINTF("[GPS] Precisao insuficiente: pDOP %.1f, hAcc %.1f m\n",
+                   s.pDop, s.hAcc);
+      _lastDebugTime = now;
+    }
+    return;
+  }
+
+  double lat = s.latitude;
+  double lng = s.longitude;
+
+  // Validação de range para coordenadas
+  if (!_isValidCoordinate(lat, lng)) {
+    if (canPrintDebug) {
+      DEBUG_PRINTF("[GPS] Coordenadas invalidas: %.6f, %.6f\n", lat, lng);
+      _lastDebugTime = now;
+    }
+    _hasFix = false;
+    return;
+  }
+
+  // Calcula delta tempo desde último fix válido
+  uint32_t dtMs = now - _lastValidFix;
+
+  // Detecção de salto anômalo (exceto no primeiro fix)
+  if (!_isFirstFix && _isAnomalousJump(lat, lng, dtMs)) {
+    if (canPrintDebug) {
+      DEBUG_PRINTF("[GPS] Salto anomalo detectado! Ignorando leitura.\n");
+      _lastDebugTime = now;
+    }
+    return;
+  }
+
+  // Salva posição anterior
+  _prevLatitude = _latitude;
+  _prevLongitude = _longitude;
+
+  // Aplica filtro de suavização na posição (exceto primeiro fix)
+  if (_isFirstFix) {
+    _latitude = lat;
+    _longitude = lng;
+    _isFirstFix = false;
+  } else {
+    // Média móvel exponencial para suavizar
+    _latitude = _latitude + POSITION_FILTER_ALPHA * (lat - _latitude);
+    _longitude = _longitude + POSITION_FILTER_ALPHA * (lng - _longitude);
+  }
 
-        _hasFix = true;
-        _lastValidFix = now;
+  // Velocidade medida pelo receptor (Doppler), não pelo deslocamento
+  _speed = s.groundSpeed * 3.6f;  // m/s -> km/h
 
+  _hasFix = true;
+  _lastValidFix = now;
+
+  // Validação e filtro de altitude (só fix 3D)
+  if (s.fixType == FIX_3D || s.fixType == FIX_GNSS_DR) {
+    float alt = s.heightMsl;
+    if (alt >= -500.0f && alt <= 50000.0f) {
+      _altitude = alt;
+      // Aplica filtro de suavização na altitude
+      if (_filteredAltitude == 0.0f) {
+        _filteredAltitude = alt; // Primeiro valor
       } else {
-        // Sentença válida mas sem fix (ainda a adquirir satélites)
-        _hasFix = false;
+        _filteredAltitude = _exponentialFilter(_filteredAltitude, alt,
+                                               ALTITUDE_FILTER_ALPHA);
       }
+    }
+  }
+}
 
-      // Validação e filtro de altitude
-      if (_gps.altitude.isValid()) {
-        float alt = _gps.altitude.meters();
-        if (alt >= -500.0f && alt <= 50000.0f) {
-          _altitude = alt;
-          // Aplica filtro de suavização na altitude
-          if (_filteredAltitude == 0.0f) {
-            _filteredAltitude = alt; // Primeiro valor
-          } else {
-            _filteredAltitude = _exponentialFilter(_filteredAltitude, alt,
-                                                   ALTITUDE_FILTER_ALPHA);
-          }
-        }
-      }
+void GPSManager::_handleDop(const uint8_t* p) {
+  // gDOP, pDOP, tDOP, vDOP, hDOP... em 0.01
+  _solution.vDop = UbxParser::u2(p, 10) * 0.01f;
+  _solution.hDop = UbxParser::u2(p, 12) * 0.01f;
+  _dopCount++;
+}
+
+int64_t GPSManager::_dejitter(uint32_t iTowMs, int64_t rxUs) {
+  int64_t offset = rxUs - (int64_t)iTowMs * 1000;
+
+  // Primeira época, virada de semana ou receptor reiniciado: recomeça
+  if (!_rxOffsetValid || offset < _rxOffsetUs - RX_OFFSET_RESET_US ||
+      offset > _rxOffsetUs + RX_OFFSET_RESET_US) {
+    _rxOffsetUs = offset;
+    _rxOffsetValid = true;
+  } else if (offset < _rxOffsetUs) {
+    _rxOffsetUs = offset;            // Caminho mais rápido visto
+  } else {
+    // Sobe devagar: acompanha a deriva entre os relógios
+    _rxOffsetUs += (int64_t)(1000 / GPS_NAV_RATE_HZ) * RX_OFFSET_DRIFT_PPM / 1000;
+    if (_rxOffsetUs > offset) _rxOffsetUs = offset;
+  }
+
+  int64_t t = (int64_t)iTowMs * 1000 + _rxOffsetUs;
+  uint32_t latency = (uint32_t)(rxUs - t);
+  if (latency > _maxLatencyUs) _maxLatencyUs = latency;
+  return t;
+}
+
+void GPSManager::_publish() {
+  Fix f;
+  f.latitude = _latitude;
+  f.longitude = _longitude;
+  f.altitude = _altitude;
+  f.speed = _speed;
+  f.satellites = _satellites;
+  f.hasFix = _hasFix;
+  f.solution = _solution;
+  _published.publish(f);
+}
+
+//=============================================================================
+// CONFIGURAÇÃO DO RECEPTOR
+//=============================================================================
+
+void GPSManager::_send(uint8_t msgClass, uint8_t msgId, const uint8_t* payload,
+                       uint16_t len) {
+  uint8_t frame[UbxParser::FRAME_OVERHEAD + 20];
+  if (len > sizeof(frame) - UbxParser::FRAME_OVERHEAD) return;
+  size_t n = UbxParser::build(frame, msgClass, msgId, payload, len);
+  uart_write_bytes(GPS_UART_NUM, (const char*)frame, n);
+}
+
+void GPSManager::_setBaud(uint32_t baud) {
+  uart_set_baudrate(GPS_UART_NUM, baud);
+  _byteUs = (uint16_t)(10000000UL / baud);  // 8N1: 10 bits por byte
+  _parser.reset();
+}
+
+void GPSManager::_sendPortConfig() {
+  const uint32_t baud = GPS_UBX_BAUD_RATE;
+  uint8_t p[20] = {0};
+  p[0] = 1;                       // portID: UART1 do receptor
+  p[4] = 0xD0;                    // mode: 8 bits, sem paridade, 1 stop
+  p[5] = 0x08;
+  p[8] = (uint8_t)(baud);
+  p[9] = (uint8_t)(baud >> 8);
+  p[10] = (uint8_t)(baud >> 16);
+  p[11] = (uint8_t)(baud >> 24);
+  p[12] = 0x01;                   // inProtoMask: só UBX
+  p[14] = 0x01;                   // outProtoMask: só UBX (desliga NMEA)
+  _send(CLS_CFG, ID_CFG_PRT, p, sizeof(p));
+}
+
+bool GPSManager::_sendNavConfig(bool confirm) {
+  const uint16_t measMs = 1000 / GPS_NAV_RATE_HZ;
+
+  // CFG-RATE: measRate, navRate = 1, timeRef = GPS
+  const uint8_t rate[6] = {(uint8_t)(measMs & 0xFF), (uint8_t)(measMs >> 8),
+                           1, 0, 1, 0};
+  _send(CLS_CFG, ID_CFG_RATE, rate, sizeof(rate));
+  if (confirm && !_waitAck(CLS_CFG, ID_CFG_RATE)) return false;
+
+  // CFG-MSG (forma curta: taxa na porta atual, em soluções)
+  const uint8_t pvt[3] = {CLS_NAV, ID_NAV_PVT, 1};
+  _send(CLS_CFG, ID_CFG_MSG, pvt, sizeof(pvt));
+  if (confirm && !_waitAck(CLS_CFG, ID_CFG_MSG)) return false;
+
+  const uint8_t dop[3] = {CLS_NAV, ID_NAV_DOP, GPS_NAV_DOP_DIVIDER};
+  _send(CLS_CFG, ID_CFG_MSG, dop, sizeof(dop));
+  if (confirm && !_waitAck(CLS_CFG, ID_CFG_MSG)) return false;
+
+  return true;
+}
+
+bool GPSManager::_waitAck(uint8_t msgClass, uint8_t msgId) {
+  _ackReceived = false;
+  uint32_t start = millis();
+  while (millis() - start < ACK_TIMEOUT_MS) {
+    _drain(millis());
+    if (_ackReceived) {
+      if (_ackClass == msgClass && _ackId == msgId) return _ackOk;
+      _ackReceived = false;  // ACK de outro comando: continua esperando
     }
+    delay(2);
   }
+  return false;
+}
 
-  // Timeout de segurança: Se passar 5s sem dados válidos, perde o fix
-  if (now - _lastEncoded > 5000) {
-    _hasFix = false;
+bool GPSManager::_configure() {
+  // Mesmo baud: reafirma só UBX na porta (ACK volta no baud atual)
+  _sendPortConfig();
+  if (!_waitAck(CLS_CFG, ID_CFG_PRT)) return false;
+  return _sendNavConfig(true);
+}
+
+void GPSManager::_reconfigureStep(uint32_t now) {
+  if (_reconfigStep == 0) {
+    if (now - _lastFrame < GPS_RECONFIG_MS ||
+        now - _lastConfigAttempt < GPS_RECONFIG_MS) {
+      return;
+    }
+    // Passo 1: fala no baud de fábrica e pede a troca de porta
+    _lastConfigAttempt = now;
+    _configured = false;
+    _setBaud(GPS_BAUD_RATE);
+    _sendPortConfig();
+    _reconfigStep = 1;
+    return;
   }
+
+  // Passo 2 (próxima chamada): CFG-PRT já saiu; volta ao baud UBX
+  if (now - _lastConfigAttempt < BAUD_SWITCH_MS) return;
+  _setBaud(GPS_UBX_BAUD_RATE);
+  _sendPortConfig();
+  _sendNavConfig(false);  // ACKs contados no _handleFrame
+  _reconfigStep = 0;
+  _reconfigCount++;
+  DEBUG_PRINTLN("[GPS] Sem frames UBX: receptor reconfigurado");
 }
 
+//=============================================================================
+// STATUS
+//=============================================================================
+
+uint32_t GPSManager::unixTime(const Solution& s) {
+  if (!s.dateValid || !s.timeValid || s.year < 1970) return 0;
+
+  // Dias desde 1970-01-01 (calendário civil, algoritmo de Hinnant)
+  int32_t y = s.year - (s.month <= 2 ? 1 : 0);
+  int32_t era = y / 400;
+  int32_t yoe = y - era * 400;
+  int32_t mp = (s.month + 9) % 12;
+  int32_t doy = (153 * mp + 2) / 5 + s.day - 1;
+  int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  int32_t days = era * 146097 + doe - 719468;
+
+  return (uint32_t)days * 86400UL + s.hour * 3600UL + s.minute * 60UL + s.second;
+}
+
+void GPSManager::printStatus() const {
+  static const char* const FIX_NAMES[] = {"sem fix", "DR", "2D", "3D", "GNSS+DR", "tempo"};
+  const Solution& s = _solution;
+  const char* fixName = (s.fixType <= FIX_TIME_ONLY) ? FIX_NAMES[s.fixType] : "?";
+
+  DEBUG_PRINTLN("=== GPS (UBX) ===");
+  DEBUG_PRINTF("Receptor: %s, %lu baud, NAV-PVT %d Hz, reconfiguracoes %lu\n",
+               _configured ? "configurado" : "sem resposta",
+               (unsigned long)GPS_UBX_BAUD_RATE, GPS_NAV_RATE_HZ,
+               (unsigned long)_reconfigCount);
+  DEBUG_PRINTF("Fix: %s%s, sats %d, pDOP %.2f, hDOP %.2f, vDOP %.2f\n",
+               fixName, s.fixOk ? " (ok)" : "", s.numSV, s.pDop, s.hDop, s.vDop);
+  DEBUG_PRINTF("Precisao: h %.2f m, v %.2f m, vel %.2f m/s, tempo %lu ns\n",
+               s.hAcc, s.vAcc, s.sAcc, (unsigned long)s.tAccNs);
+  DEBUG_PRINTF("Tempo: iTOW %lu ms, UTC %04u-%02u-%02u %02u:%02u:%02u%s\n",
+               (unsigned long)s.iTowMs, s.year, s.month, s.day, s.hour,
+               s.minute, s.second, s.timeValid ? "" : " (nao resolvido)");
+  DEBUG_PRINTF("Frames: %lu (PVT %lu, DOP %lu), checksum %lu, grandes %lu, "
+               "bytes fora %lu, NAK %lu\n",
+               (unsigned long)_parser.getFrames(), (unsigned long)_pvtCount,
+               (unsigned long)_dopCount, (unsigned long)_parser.getChecksumErrors(),
+               (unsigned long)_parser.getOversized(),
+               (unsigned long)_parser.getSkippedBytes(), (unsigned long)_nakCount);
+  DEBUG_PRINTF("UART: eventos %lu (idle %lu), overrun FIFO %lu, buffer %lu, "
+               "erros de linha %lu, pico %lu/%d bytes\n",
+               (unsigned long)_events, (unsigned long)_idleEvents,
+               (unsigned long)_fifoOverruns, (unsigned long)_bufferOverruns,
+               (unsigned long)_lineErrors, (unsigned long)_maxBuffered,
+               GPS_RX_BUFFER_SIZE);
+  DEBUG_PRINTF("Timestamp: latencia maxima removida %lu us\n",
+               (unsigned long)_maxLatencyUs);
+  DEBUG_PRINTLN("=================");
+}
+
+//=============================================================================
+// VALIDAÇÃO E FILTROS
+//=============================================================================
+
 bool GPSManager::_isValidCoordinate(double lat, double lng) const {
   // Latitude: -90 a +90
   if (lat < -90.0 || lat > 90.0)
@@ -203,7 +576,7 @@ bool GPSManager::_isAnomalousJump(double newLat, double newLng, uint32_t dtMs) {
 
   // Se velocidade > MAX_SPEED_KMH, é salto anômalo
   if (speedKmh > MAX_SPEED_KMH) {
-    // Nota: Debug já é impresso no update() com rate limiting
+    // Nota: Debug já é impresso no _handlePvt() com rate limiting
     return true;
   }
 
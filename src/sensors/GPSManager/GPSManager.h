@@ -1,54 +1,163 @@
 /**
  * @file GPSManager.h
  * @brief Gerenciador do módulo GPS NEO-M8N/NEO-6M
- * 
+ *
  * @details Driver para módulos GPS u-blox com suporte a:
- *          - Parsing de sentenças NMEA via TinyGPS++
+ *          - Protocolo binário UBX (NAV-PVT e NAV-DOP), sem NMEA
+ *          - Configuração do receptor no boot (porta, taxa, mensagens)
+ *          - Reconfiguração automática se o receptor perder a configuração
+ *          - Tipo de fix, estimativas de precisão (hAcc/vAcc/sAcc) e tempo GPS/UTC
+ *          - Recepção por eventos do driver UART do ESP-IDF (ring buffer grande)
+ *          - Timestamp de recepção por frame, sem o atraso de escalonamento
+ *          - Publicação sem trava (SeqSnapshot) para as outras tasks
  *          - Coordenadas geográficas (latitude/longitude)
  *          - Altitude GPS (acima do nível do mar)
- *          - Contagem de satélites visíveis
  *          - Validação de coordenadas (range check)
  *          - Detecção de perda de fix
  *          - Filtro de suavização (média móvel exponencial)
  *          - Detecção de saltos anômalos
- *          - Verificação de HDOP (qualidade do fix)
- * 
+ *
  * @author AgroSat Team
  * @date 2025
- * @version 1.3.0
- * 
+ * @version 2.1.0
+ *
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
- * 
+ *
  * ## Módulos Suportados
  * | Modelo    | Frequência | Canais | Precisão  |
  * |-----------|------------|--------|----------|
  * | NEO-6M    | 5 Hz       | 50     | 2.5m CEP |
  * | NEO-M8N   | 10 Hz      | 72     | 2.0m CEP |
  * | NEO-M9N   | 25 Hz      | 92     | 1.5m CEP |
- * 
- * ## Sentenças NMEA Processadas
- * - **GGA**: Posição e altitude
- * - **RMC**: Posição, velocidade e data/hora
- * - **GSV**: Satélites visíveis
- * 
- * @note Usa Serial2 (UART1) do ESP32
- * @note Baudrate padrão: 9600 (configurável em config.h)
+ *
+ * ## Mensagens UBX
+ * | Mensagem  | Classe/ID | Bytes | Uso                                   |
+ * |-----------|-----------|-------|---------------------------------------|
+ * | NAV-PVT   | 0x01 0x07 | 100   | Posição, velocidade, tempo, precisão  |
+ * | NAV-DOP   | 0x01 0x04 | 26    | hDOP/vDOP (a cada GPS_NAV_DOP_DIVIDER)|
+ * | ACK-ACK   | 0x05 0x01 | 10    | Confirmação dos comandos CFG          |
+ * | ACK-NAK   | 0x05 0x00 | 10    | Comando CFG recusado                  |
+ *
+ * Uma solução custa ~100 bytes na UART (NMEA GGA+RMC+GSV: ~400 bytes) e
+ * é decodificada com leituras de inteiros em offsets fixos, uma vez por
+ * frame, sem conversão de texto.
+ *
+ * ## Configuração no boot
+ * 1. Tenta o receptor já em GPS_UBX_BAUD_RATE (reset quente)
+ * 2. Senão, fala a GPS_BAUD_RATE (fábrica) e troca porta para UBX a
+ *    GPS_UBX_BAUD_RATE (CFG-PRT)
+ * 3. CFG-RATE (GPS_NAV_RATE_HZ) e CFG-MSG (NAV-PVT, NAV-DOP), cada um
+ *    confirmado por ACK
+ *
+ * A configuração fica só na RAM do receptor: sem frames por
+ * GPS_RECONFIG_MS (queda de energia do módulo), service() repete a
+ * sequência sem bloquear, em duas chamadas.
+ *
+ * ## Recepção orientada a eventos
+ * O driver UART do ESP-IDF move a FIFO de hardware (128 B) para um ring
+ * buffer de GPS_RX_BUFFER_SIZE na própria ISR e posta eventos numa fila:
+ * | Evento           | Gatilho                                       |
+ * |------------------|-----------------------------------------------|
+ * | UART_DATA        | FIFO no limiar ou linha parada por            |
+ * |                  | GPS_RX_IDLE_SYMBOLS bytes (fim da rajada)     |
+ * | UART_FIFO_OVF    | FIFO de hardware transbordou (overrun)        |
+ * | UART_BUFFER_FULL | Ring buffer cheio (task sem drenar)           |
+ * | UART_FRAME_ERR   | Erro de framing/paridade na linha             |
+ *
+ * A GpsTask (prioridade baixa) dorme na fila e consome o ring buffer; o
+ * UBX é binário, então o fim de rajada vem do timeout de linha parada, não
+ * de detecção de padrão. Sem GpsTask, update() faz o mesmo por polling
+ * (job GPS da SensorsTask).
+ *
+ * ## Timestamp de recepção
+ * Cada byte drenado recebe o instante estimado de chegada: leitura do
+ * esp_timer no dreno menos os bytes que chegaram depois dele (tempo de
+ * byte no baud atual). Esse valor carrega o atraso de acordar a task; o
+ * NAV-PVT, porém, sai do receptor a um atraso fixo do início da época
+ * (iTOW). O menor (recepção - iTOW) visto é o caminho sem atraso: o
+ * timestamp publicado é iTOW + esse mínimo, que sobe devagar
+ * (RX_OFFSET_DRIFT_PPM) para seguir a deriva do cristal do ESP32.
+ *
+ * @note Usa a UART2 pelo driver ESP-IDF (o Serial2 do Arduino fica livre)
+ * @warning NEO-6M (protocolo UBX 7) não tem NAV-PVT: requer NEO-M8N ou mais novo
  */
 
 #ifndef GPS_MANAGER_H
 #define GPS_MANAGER_H
 
 #include <Arduino.h>
-#include <TinyGPSPlus.h>
 #include "config.h"
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "core/SeqSnapshot/SeqSnapshot.h"
+#include "sensors/UbxParser/UbxParser.h"
 
 /**
  * @class GPSManager
- * @brief Driver para módulos GPS u-blox (NEO-6M/M8N/M9N)
+ * @brief Driver UBX para módulos GPS u-blox (NEO-M8N/M9N)
  */
 class GPSManager {
 public:
+    /**
+     * @enum FixType
+     * @brief Tipo de fix do NAV-PVT
+     */
+    enum FixType : uint8_t {
+        FIX_NONE = 0,           ///< Sem fix
+        FIX_DEAD_RECKONING = 1, ///< Só navegação estimada
+        FIX_2D = 2,             ///< 2D (altitude não confiável)
+        FIX_3D = 3,             ///< 3D
+        FIX_GNSS_DR = 4,        ///< GNSS + navegação estimada
+        FIX_TIME_ONLY = 5       ///< Só tempo (posição fixa)
+    };
+
+    /**
+     * @struct Solution
+     * @brief Última solução NAV-PVT (e NAV-DOP) decodificada, em unidades SI
+     */
+    struct Solution {
+        uint32_t iTowMs;        ///< Tempo da semana GPS (ms)
+        uint16_t year;          ///< Data UTC
+        uint8_t month, day;
+        uint8_t hour, minute, second;
+        bool dateValid;         ///< Data UTC válida
+        bool timeValid;         ///< Hora UTC válida e totalmente resolvida
+        uint32_t tAccNs;        ///< Precisão do tempo (ns)
+        FixType fixType;        ///< Tipo de fix
+        bool fixOk;             ///< gnssFixOK (dentro das máscaras de DOP/precisão)
+        uint8_t numSV;          ///< Satélites usados
+        double latitude;        ///< Graus
+        double longitude;       ///< Graus
+        float heightMsl;        ///< Altitude acima do nível do mar (m)
+        float hAcc;             ///< Precisão horizontal (m)
+        float vAcc;             ///< Precisão vertical (m)
+        float velN, velE, velD; ///< Velocidade NED (m/s)
+        float groundSpeed;      ///< Velocidade horizontal (m/s)
+        float heading;          ///< Rumo do movimento (graus)
+        float sAcc;             ///< Precisão da velocidade (m/s)
+        float pDop;             ///< Position DOP (NAV-PVT)
+        float hDop;             ///< Horizontal DOP (NAV-DOP; 99 se ausente)
+        float vDop;             ///< Vertical DOP (NAV-DOP; 99 se ausente)
+        uint32_t rxMillis;      ///< millis() da recepção do NAV-PVT
+        int64_t rxTimeUs;       ///< Recepção do NAV-PVT (esp_timer, µs), sem atraso de task
+    };
+
+    /**
+     * @struct Fix
+     * @brief Estado publicado a cada frame (lido sem trava por outras tasks)
+     */
+    struct Fix {
+        double latitude;        ///< Latitude filtrada (graus)
+        double longitude;       ///< Longitude filtrada (graus)
+        float altitude;         ///< Altitude acima do nível do mar (m)
+        float speed;            ///< Velocidade horizontal (km/h)
+        uint8_t satellites;     ///< Satélites no fix
+        bool hasFix;            ///< Posição válida e recente
+        Solution solution;      ///< Última solução completa
+    };
+
     /**
      * @brief Construtor padrão
      */
@@ -57,76 +166,242 @@ public:
     //=========================================================================
     // CICLO DE VIDA
     //=========================================================================
-    
+
     /**
-     * @brief Inicializa a UART nos pinos definidos em config.h
-     * @return true sempre (Serial.begin não retorna erro no ESP32)
-     * @note Usa Serial2 com pinos GPS_RX_PIN e GPS_TX_PIN
+     * @brief Inicializa a UART e configura o receptor para UBX
+     * @return true se o receptor confirmou a configuração (ACK)
+     * @note Bloqueia até ~0,6 s sem receptor; com receptor, ~50 ms
      */
     bool begin();
 
     /**
-     * @brief Processa dados NMEA da Serial
-     * @note Deve ser chamado frequentemente (idealmente a cada 100ms)
+     * @brief Espera eventos da UART e decodifica os frames UBX completos
+     * @param timeoutMs Espera máxima por um evento (0 = só o que já chegou)
+     * @note Corpo da GpsTask; também cuida da reconfiguração e do timeout de fix
+     */
+    void service(uint32_t timeoutMs);
+
+    /**
+     * @brief Polling sem GpsTask: processa o que já está no ring buffer
+     * @note Job GPS da SensorsTask (idealmente a cada 100ms)
      */
-    void update();
+    void update() { service(0); }
 
     //=========================================================================
     // GETTERS DE DADOS
     //=========================================================================
-    
+
+    /**
+     * @brief Copia o último estado publicado (uma leitura consistente)
+     * @param out [out] Estado
+     * @return false se a task do GPS publicou durante todas as tentativas
+     */
+    bool getFix(Fix& out) const { return _published.read(out); }
+
     /** @brief Retorna latitude em graus decimais (-90 a +90) */
-    double getLatitude() const { return _latitude; }
-    
+    double getLatitude() const { return _read().latitude; }
+
     /** @brief Retorna longitude em graus decimais (-180 a +180) */
-    double getLongitude() const { return _longitude; }
-    
+    double getLongitude() const { return _read().longitude; }
+
     /** @brief Retorna altitude GPS em metros (acima do nível do mar) */
-    float getAltitude() const { return _altitude; }
-    
+    float getAltitude() const { return _read().altitude; }
+
     /** @brief Retorna número de satélites usados no fix */
-    uint8_t getSatellites() const { return _satellites; }
-    
+    uint8_t getSatellites() const { return _read().satellites; }
+
+    /** @brief Velocidade horizontal (km/h) */
+    float getSpeed() const { return _read().speed; }
+
+    /** @brief Tipo de fix da última solução */
+    FixType getFixType() const { return _read().solution.fixType; }
+
+    /** @brief Precisão horizontal estimada (m) */
+    float getHorizontalAccuracy() const { return _read().solution.hAcc; }
+
+    /** @brief Precisão vertical estimada (m) */
+    float getVerticalAccuracy() const { return _read().solution.vAcc; }
+
+    /** @brief Última solução completa (cópia) */
+    Solution getSolution() const { return _read().solution; }
+
+    /**
+     * @brief Tempo UTC da última solução
+     * @return Unix time (s), ou 0 se data/hora não resolvidas
+     */
+    uint32_t getUnixTime() const { return unixTime(_read().solution); }
+
+    /**
+     * @brief Tempo UTC de uma solução
+     * @return Unix time (s), ou 0 se data/hora não resolvidas
+     */
+    static uint32_t unixTime(const Solution& s);
+
     //=========================================================================
     // STATUS
     //=========================================================================
-    
+
     /**
      * @brief Verifica se há fix GPS válido
      * @return true se posição válida e recente
      * @return false se sem fix ou coordenadas inválidas
      */
-    bool hasFix() const { return _hasFix; }
-    
+    bool hasFix() const { return _read().hasFix; }
+
+    /** @brief Receptor confirmou a configuração UBX? */
+    bool isConfigured() const { return _configured; }
+
+    /** @brief Imprime configuração, fix, precisão, eventos da UART e contadores */
+    void printStatus() const;
+
+    /** @brief Overruns: FIFO de hardware + ring buffer cheio */
+    uint32_t getOverruns() const { return _fifoOverruns + _bufferOverruns; }
+
+    /** @brief Erros de parse: checksum + frames grandes demais + erros de linha */
+    uint32_t getParseErrors() const {
+        return _parser.getChecksumErrors() + _parser.getOversized() + _lineErrors;
+    }
+
 private:
     //=========================================================================
     // HARDWARE
     //=========================================================================
-    TinyGPSPlus _gps;            ///< Parser NMEA TinyGPS++
-    HardwareSerial* _serial;     ///< Ponteiro para Serial2
+    UbxParser _parser;           ///< Enquadrador UBX
+    QueueHandle_t _uartQueue;    ///< Fila de eventos do driver UART
+    bool _uartReady;             ///< Driver instalado?
+    uint16_t _byteUs;            ///< Duração de um byte no baud atual (µs)
 
     //=========================================================================
     // CACHE DE DADOS
     //=========================================================================
+    Solution _solution;          ///< Última solução decodificada (só a task do GPS)
     double _latitude;            ///< Latitude em graus decimais
     double _longitude;           ///< Longitude em graus decimais
     double _prevLatitude;        ///< Latitude anterior (para detecção de saltos)
     double _prevLongitude;       ///< Longitude anterior (para detecção de saltos)
     float _altitude;             ///< Altitude GPS raw (m)
     float _filteredAltitude;     ///< Altitude filtrada/suavizada (m)
-    float _hdop;                 ///< Horizontal Dilution of Precision
-    float _speed;                ///< Velocidade calculada (km/h)
+    float _speed;                ///< Velocidade horizontal (km/h)
     uint8_t _satellites;         ///< Satélites no fix
     bool _hasFix;                ///< Fix válido?
     bool _isFirstFix;            ///< Primeiro fix após inicialização?
-    
-    uint32_t _lastEncoded;       ///< Timestamp última decodificação
+
+    uint32_t _lastEncoded;       ///< Timestamp último NAV-PVT
     uint32_t _lastValidFix;      ///< Timestamp último fix válido
-    
+    uint32_t _lastDebugTime;     ///< Rate limiting das mensagens de rejeição
+    SeqSnapshot<Fix> _published; ///< Estado para as outras tasks
+
+    //=========================================================================
+    // TIMESTAMP
+    //=========================================================================
+    int64_t _rxOffsetUs;         ///< Menor (recepção - iTOW) visto (µs)
+    bool _rxOffsetValid;         ///< _rxOffsetUs inicializado?
+    uint32_t _maxLatencyUs;      ///< Maior atraso de dreno removido (µs)
+
+    //=========================================================================
+    // CONFIGURAÇÃO DO RECEPTOR
+    //=========================================================================
+    bool _configured;            ///< Configuração confirmada por ACK
+    uint8_t _reconfigStep;       ///< 0 = ocioso, 1 = porta trocada a GPS_BAUD_RATE
+    uint32_t _lastFrame;         ///< Timestamp último frame UBX válido
+    uint32_t _lastConfigAttempt; ///< Timestamp da última tentativa de configuração
+    uint8_t _ackClass, _ackId;   ///< Comando do último ACK/NAK recebido
+    bool _ackReceived;           ///< Chegou ACK/NAK para _ackClass/_ackId?
+    bool _ackOk;                 ///< ACK (true) ou NAK (false)
+
+    //=========================================================================
+    // ESTATÍSTICAS
+    //=========================================================================
+    uint32_t _pvtCount;          ///< NAV-PVT decodificados
+    uint32_t _dopCount;          ///< NAV-DOP decodificados
+    uint32_t _nakCount;          ///< Comandos CFG recusados
+    uint32_t _reconfigCount;     ///< Reconfigurações em voo
+    uint32_t _events;            ///< Eventos UART_DATA
+    uint32_t _idleEvents;        ///< ... disparados por linha parada
+    uint32_t _fifoOverruns;      ///< UART_FIFO_OVF
+    uint32_t _bufferOverruns;    ///< UART_BUFFER_FULL
+    uint32_t _lineErrors;        ///< UART_FRAME_ERR / UART_PARITY_ERR
+    uint32_t _maxBuffered;       ///< Maior ocupação vista do ring buffer (bytes)
+
     //=========================================================================
     // MÉTODOS PRIVADOS
     //=========================================================================
-    
+
+    /**
+     * @brief Lê o ring buffer em blocos e entrega cada frame completo
+     * @param now millis() atual
+     * @note Cada byte ganha o instante estimado de chegada
+     */
+    void _drain(uint32_t now);
+
+    /** @brief Trata um evento do driver UART */
+    void _handleEvent(const uart_event_t& event);
+
+    /** @brief Descarta o ring buffer após overrun (frame parcial perdido) */
+    void _recoverOverrun();
+
+    /**
+     * @brief Despacha um frame válido do enquadrador
+     * @param now millis() atual
+     * @param rxUs Chegada estimada do último byte (esp_timer)
+     */
+    void _handleFrame(uint32_t now, int64_t rxUs);
+
+    /** @brief Decodifica NAV-PVT e aplica a validação de posição */
+    void _handlePvt(const uint8_t* p, uint32_t now, int64_t rxUs);
+
+    /**
+     * @brief Remove o atraso de dreno do timestamp (mínimo de recepção - iTOW)
+     * @param iTowMs Época da solução
+     * @param rxUs Chegada estimada
+     * @return Chegada sem o atraso de escalonamento
+     */
+    int64_t _dejitter(uint32_t iTowMs, int64_t rxUs);
+
+    /** @brief Publica o estado atual em _published */
+    void _publish();
+
+    /** @brief Leitura do estado publicado (zeros se nunca publicado) */
+    Fix _read() const {
+        Fix f;
+        if (!_published.read(f)) memset(&f, 0, sizeof(f));
+        return f;
+    }
+
+    /** @brief Decodifica NAV-DOP */
+    void _handleDop(const uint8_t* p);
+
+    /** @brief Envia um frame UBX */
+    void _send(uint8_t msgClass, uint8_t msgId, const uint8_t* payload, uint16_t len);
+
+    /** @brief Troca o baud da UART local e descarta o frame parcial */
+    void _setBaud(uint32_t baud);
+
+    /** @brief CFG-PRT: UART1 só UBX (entrada e saída) a GPS_UBX_BAUD_RATE */
+    void _sendPortConfig();
+
+    /**
+     * @brief CFG-RATE e CFG-MSG (NAV-PVT, NAV-DOP)
+     * @param confirm Esperar o ACK de cada comando
+     * @return true se confirmado (sempre true com confirm = false)
+     */
+    bool _sendNavConfig(bool confirm);
+
+    /**
+     * @brief Espera ACK/NAK de um comando CFG (processa frames no meio)
+     * @return true se ACK dentro de ACK_TIMEOUT_MS
+     */
+    bool _waitAck(uint8_t msgClass, uint8_t msgId);
+
+    /**
+     * @brief Envia toda a configuração no baud atual, confirmando cada passo
+     * @return true se todos os comandos receberam ACK
+     */
+    bool _configure();
+
+    /** @brief Reconfiguração sem bloqueio (chamada pelo service()) */
+    void _reconfigureStep(uint32_t now);
+
     /**
      * @brief Valida coordenadas contra limites físicos
      * @param lat Latitude (-90 a +90)
@@ -135,7 +410,7 @@ private:
      * @note Rejeita (0,0) se poucos satélites
      */
     bool _isValidCoordinate(double lat, double lng) const;
-    
+
     /**
      * @brief Calcula distância entre dois pontos usando fórmula de Haversine
      * @param lat1 Latitude ponto 1
@@ -145,7 +420,7 @@ private:
      * @return Distância em metros
      */
     double _haversineDistance(double lat1, double lon1, double lat2, double lon2) const;
-    
+
     /**
      * @brief Detecta se houve um salto anômalo na posição
      * @param newLat Nova latitude
@@ -154,7 +429,7 @@ private:
      * @return true se o salto é anômalo (velocidade impossível)
      */
     bool _isAnomalousJump(double newLat, double newLng, uint32_t dtMs);
-    
+
     /**
      * @brief Aplica filtro de média móvel exponencial
      * @param current Valor atual filtrado
@@ -163,15 +438,38 @@ private:
      * @return Valor filtrado
      */
     float _exponentialFilter(float current, float newValue, float alpha) const;
-    
+
     //=========================================================================
     // CONSTANTES DE CONFIGURAÇÃO
     //=========================================================================
     static constexpr uint8_t MIN_SATELLITES = 4;       ///< Mínimo de satélites para fix
-    static constexpr float MAX_HDOP = 5.0f;            ///< HDOP máximo aceitável
+    static constexpr float MAX_PDOP = 6.0f;            ///< pDOP máximo aceitável
     static constexpr float MAX_SPEED_KMH = 500.0f;     ///< Velocidade máxima plausível (km/h)
     static constexpr float ALTITUDE_FILTER_ALPHA = 0.3f; ///< Suavização altitude (0.3 = 30% novo)
     static constexpr float POSITION_FILTER_ALPHA = 0.5f; ///< Suavização posição
+    static constexpr uint32_t FIX_TIMEOUT_MS = 5000;   ///< Sem NAV-PVT por este tempo: perde o fix
+    static constexpr uint32_t DEBUG_INTERVAL_MS = 5000;///< Mensagens de rejeição a cada 5s no máximo
+    static constexpr uint32_t ACK_TIMEOUT_MS = 250;    ///< Espera por ACK de comando CFG
+    static constexpr uint32_t BAUD_SWITCH_MS = 50;     ///< CFG-PRT transmitido antes de trocar o baud
+    static constexpr uint8_t READ_CHUNK = 64;          ///< Bytes por leitura do ring buffer
+    static constexpr uint32_t RX_OFFSET_DRIFT_PPM = 100; ///< Subida do mínimo por época (deriva)
+    static constexpr int64_t RX_OFFSET_RESET_US = 500000; ///< Salto que reinicia o mínimo (iTOW)
+
+    //=========================================================================
+    // PROTOCOLO UBX
+    //=========================================================================
+    static constexpr uint8_t CLS_NAV = 0x01;           ///< Classe NAV
+    static constexpr uint8_t CLS_ACK = 0x05;           ///< Classe ACK
+    static constexpr uint8_t CLS_CFG = 0x06;           ///< Classe CFG
+    static constexpr uint8_t ID_NAV_PVT = 0x07;
+    static constexpr uint8_t ID_NAV_DOP = 0x04;
+    static constexpr uint8_t ID_ACK_NAK = 0x00;
+    static constexpr uint8_t ID_ACK_ACK = 0x01;
+    static constexpr uint8_t ID_CFG_PRT = 0x00;
+    static constexpr uint8_t ID_CFG_MSG = 0x01;
+    static constexpr uint8_t ID_CFG_RATE = 0x08;
+    static constexpr uint16_t NAV_PVT_LEN = 92;        ///< Payload NAV-PVT (protocolo 15+)
+    static constexpr uint16_t NAV_DOP_LEN = 18;        ///< Payload NAV-DOP
 };
 
 #endif
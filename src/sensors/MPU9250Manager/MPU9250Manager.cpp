@@ -5,20 +5,40 @@
 
 #include "MPU9250Manager.h"
 #include <math.h>
-#include <new>
+#include <esp_timer.h>
+
+//=============================================================================
+// VARIÁVEIS ESTÁTICAS (ISR)
+//=============================================================================
+
+TaskHandle_t MPU9250Manager::_irqTask = NULL;
+volatile uint32_t MPU9250Manager::_irqCount = 0;
+volatile int64_t MPU9250Manager::_irqTimeUs = 0;
+volatile int64_t MPU9250Manager::_notifyTimeUs = 0;
+volatile uint8_t MPU9250Manager::_irqEvery = 1;
+
+/// Spinlock para o timestamp de 64 bits compartilhado com a ISR
+static portMUX_TYPE imuMux = portMUX_INITIALIZER_UNLOCKED;
 
 MPU9250Manager::MPU9250Manager(uint8_t addr)
     : _mpu(addr), _addr(addr), _online(false), _magOnline(false), _calibrated(false),
       _failCount(0), _lastRead(0),
       _accelX(0), _accelY(0), _accelZ(0),
       _gyroX(0), _gyroY(0), _gyroZ(0),
-      _magX(0), _magY(0), _magZ(0),
-      _magOffX(0), _magOffY(0), _magOffZ(0),
+      _magX(0), _magY(0), _magZ(0), _dieTemp(NAN),
+      _busUsLast(0), _busUsMax(0), _busUsTotal(0), _busSamples(0),
+      _cfgFifoHz(IMU_FIFO_RATE_HZ), _cfgOutputHz(IMU_OUTPUT_RATE_HZ),
+      _fifoRate(0), _decim(1), _decimN(0),
+      _fifoSamples(0), _outputSamples(0), _fifoOverflows(0),
+      _intPin(-1), _sampleTimeUs(0), _blockT0Us(0), _lastIrqCount(0), _spuriousIrqs(0),
+      _magOffX(0), _magOffY(0), _magOffZ(0), _savePending(false),
+      _clearPending(false), _erasePending(false),
       _filterIdx(0) 
 {
     memset(_bufAX, 0, sizeof(_bufAX));
     memset(_bufAY, 0, sizeof(_bufAY));
     memset(_bufAZ, 0, sizeof(_bufAZ));
+    _resetDecimator();
     
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 3; j++) {
@@ -40,6 +60,7 @@ bool MPU9250Manager::begin() {
     
     _online = true;
     DEBUG_PRINTLN("[MPU9250Manager] IMU Online.");
+    setSampleRate(_cfgFifoHz, _cfgOutputHz);
 
     if (_mpu.initMagnetometer()) {
         _magOnline = true;
@@ -59,14 +80,225 @@ bool MPU9250Manager::begin() {
 }
 
 void MPU9250Manager::update() {
+    // CLEAR_MAG vem de outra task: a calibração só muda aqui, entre leituras
+    if (__atomic_exchange_n(&_clearPending, false, __ATOMIC_ACQ_REL)) _resetMagCalibration();
+
     if (!_online) return;
 
-    if (millis() - _lastRead < 20) return;
-    _lastRead = millis();
+    // FIFO: drena o que acumulou desde a última chamada. Leitura direta:
+    // acc + temp + gyro em uma rajada de 14 bytes por chamada
+    uint32_t t0 = micros();
+    bool ok;
+    if (_fifoRate > 0) {
+        ok = _drainFifo();
+    } else {
+        _lastRead = millis();
 
-    xyzFloat g = _mpu.getGValues();
-    xyzFloat gyr = _mpu.getGyrValues();
-    
+        xyzFloat g, gyr;
+        ok = _mpu.readAll(g, gyr, _dieTemp);
+        if (ok) {
+            _sampleTimeUs = esp_timer_get_time();
+            _publish(g, gyr);
+        }
+    }
+
+    // Mag em uma rajada de 8 bytes (ST1..ST2), só com DRDY do AK8963
+    xyzFloat mag;
+    bool magOk = ok && _magOnline && _mpu.readMag(mag);
+    _noteBusTime(micros() - t0);
+
+    if (!ok) {
+        if (_failCount < 255) _failCount++;
+        return;
+    }
+    _failCount = 0;
+
+    if (magOk) {
+        // Calibração contínua sobre a leitura bruta
+        if (_magCal.addSample(mag.x, mag.y, mag.z)) _applyMagCalibration(_magCal.getResult());
+
+        float mx = mag.x - _magOffX;
+        float my = mag.y - _magOffY;
+        float mz = mag.z - _magOffZ;
+        _applySoftIronCorrection(mx, my, mz);
+        _magX = mx;
+        _magY = my;
+        _magZ = mz;
+    }
+}
+
+bool MPU9250Manager::setSampleRate(uint16_t fifoHz, uint16_t outputHz) {
+    _cfgFifoHz = fifoHz;
+    _cfgOutputHz = outputHz;
+    _fifoRate = 0;
+    _decim = 1;
+    _resetDecimator();
+    if (!_online) return false;
+
+    if (fifoHz == 0) {
+        _mpu.disableFifo();
+        _configureInterrupt();
+        DEBUG_PRINTLN("[MPU9250Manager] FIFO desativado (leitura direta 50 Hz).");
+        return true;
+    }
+
+    _fifoRate = _mpu.enableFifo(fifoHz);
+    if (_fifoRate == 0) {
+        DEBUG_PRINTLN("[MPU9250Manager] ERRO: Falha ao configurar FIFO.");
+        _mpu.disableFifo();
+        return false;
+    }
+
+    if (outputHz == 0 || outputHz > _fifoRate) outputHz = _fifoRate;
+    uint16_t decim = _fifoRate / outputHz;
+    _decim = (decim > 255) ? 255 : (uint8_t)decim;
+    _configureInterrupt();
+
+    // Quadros que cabem no FIFO = prazo máximo entre duas drenagens
+    uint16_t frames = MPU9250::FIFO_SIZE / MPU9250::FIFO_FRAME;
+    DEBUG_PRINTF("[MPU9250Manager] FIFO %u Hz -> %u Hz (decimacao %u, drenar a cada <%lu ms)\n",
+                 _fifoRate, _fifoRate / _decim, _decim,
+                 (unsigned long)frames * 1000UL / _fifoRate);
+    return true;
+}
+
+/// Contagem e instante do último pulso, lidos juntos
+static uint32_t irqSnapshot(volatile uint32_t& count, volatile int64_t& timeUs,
+                            int64_t& t) {
+    portENTER_CRITICAL(&imuMux);
+    t = timeUs;
+    uint32_t n = count;
+    portEXIT_CRITICAL(&imuMux);
+    return n;
+}
+
+bool MPU9250Manager::_drainFifo() {
+    // Pulsos antes e depois do FIFO_COUNT: o de um quadro que chega
+    // durante a leitura cai entre as duas capturas
+    int64_t tBefore, tAfter;
+    uint32_t before = irqSnapshot(_irqCount, _irqTimeUs, tBefore);
+    int16_t count = _mpu.fifoCount();
+    uint32_t after = irqSnapshot(_irqCount, _irqTimeUs, tAfter);
+    if (count < 0) return false;
+
+    // Sem espaço para outro quadro: amostras descartadas pelo sensor
+    if (count + MPU9250::FIFO_FRAME > MPU9250::FIFO_SIZE) {
+        _fifoOverflows++;
+        _mpu.resetFifo();
+        _resetDecimator();
+        _lastIrqCount = after;
+        return true;
+    }
+
+    uint8_t buf[FIFO_CHUNK * MPU9250::FIFO_FRAME];
+    uint16_t frames = count / MPU9250::FIFO_FRAME;
+
+    // O pulso só data o quadro mais novo (erro <= 1 período) se a contagem
+    // bate com o FIFO_COUNT. Bordas falsas no GPIO36/39 (errata 3.11 do
+    // ESP32, com ADC ou WiFi ativos) ou pulsos perdidos: instante atual.
+    uint32_t lo = before - _lastIrqCount;
+    uint32_t hi = after - _lastIrqCount;
+    int64_t tLast;
+    if (frames == lo) tLast = tBefore;
+    else if (frames == hi) tLast = tAfter;
+    else tLast = esp_timer_get_time();
+    if (lo > frames) _spuriousIrqs += lo - frames;
+    _lastIrqCount = (frames >= lo && frames <= hi) ? _lastIrqCount + frames : after;
+
+    uint32_t periodUs = 1000000UL / _fifoRate;
+    int64_t t = tLast - (int64_t)frames * periodUs;
+
+    while (frames > 0) {
+        uint8_t n = (frames > FIFO_CHUNK) ? FIFO_CHUNK : (uint8_t)frames;
+        if (!_mpu.readFifo(buf, n)) {
+            // Leitura parcial desalinha os quadros seguintes
+            _mpu.resetFifo();
+            _resetDecimator();
+            _lastIrqCount = _irqCount;
+            return false;
+        }
+        for (uint8_t i = 0; i < n; i++) {
+            xyzFloat g, gyr;
+            _mpu.parseFrame(buf + i * MPU9250::FIFO_FRAME, g, gyr, _dieTemp);
+            t += periodUs;
+            _decimate(g, gyr, t);
+        }
+        frames -= n;
+    }
+    return true;
+}
+
+void MPU9250Manager::_decimate(const xyzFloat& g, const xyzFloat& gyr, int64_t tUs) {
+    // Média de blocos de _decim amostras (passa-baixa + decimação)
+    if (_decimN == 0) _blockT0Us = tUs;
+    _sumA[0] += g.x;   _sumA[1] += g.y;   _sumA[2] += g.z;
+    _sumG[0] += gyr.x; _sumG[1] += gyr.y; _sumG[2] += gyr.z;
+    _fifoSamples++;
+
+    if (++_decimN < _decim) return;
+
+    float k = 1.0f / _decimN;
+    _sampleTimeUs = (_blockT0Us + tUs) / 2;
+    _publish(xyzFloat(_sumA[0] * k, _sumA[1] * k, _sumA[2] * k),
+             xyzFloat(_sumG[0] * k, _sumG[1] * k, _sumG[2] * k));
+    _resetDecimator();
+}
+
+bool MPU9250Manager::enableInterrupt(int8_t pin, TaskHandle_t task) {
+    _intPin = pin;
+    _irqTask = task;
+    if (pin >= 0) {
+        pinMode(pin, INPUT);
+        attachInterrupt(digitalPinToInterrupt(pin), _onDataReady, RISING);
+    }
+
+    bool on = _configureInterrupt();
+    if (on) {
+        DEBUG_PRINTF("[MPU9250Manager] INT no GPIO%d: task acordada a cada %u amostras\n",
+                     pin, _decim);
+    } else {
+        DEBUG_PRINTLN("[MPU9250Manager] INT inativa: task drena por timeout.");
+    }
+    return on;
+}
+
+bool MPU9250Manager::_configureInterrupt() {
+    // Uma notificação por amostra de saída; o FIFO guarda o lote
+    _irqEvery = _decim;
+    if (!_online) return false;
+
+    bool on = (_fifoRate > 0) && (_intPin >= 0) && (_irqTask != NULL);
+    return _mpu.enableDataReadyInterrupt(on) && on;
+}
+
+int64_t MPU9250Manager::getNotifyTimeUs() const {
+    portENTER_CRITICAL(&imuMux);
+    int64_t t = _notifyTimeUs;
+    portEXIT_CRITICAL(&imuMux);
+    return t;
+}
+
+void IRAM_ATTR MPU9250Manager::_onDataReady() {
+    portENTER_CRITICAL_ISR(&imuMux);
+    _irqTimeUs = esp_timer_get_time();
+    uint32_t n = ++_irqCount;
+    bool notify = (n % _irqEvery) == 0;
+    if (notify) _notifyTimeUs = _irqTimeUs;
+    portEXIT_CRITICAL_ISR(&imuMux);
+
+    if (_irqTask != NULL && notify) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(_irqTask, &xHigherPriorityTaskWoken);
+        if (xHigherPriorityTaskWoken) portYIELD_FROM_ISR();
+    }
+}
+
+void MPU9250Manager::_resetDecimator() {
+    _decimN = 0;
+    for (int i = 0; i < 3; i++) _sumA[i] = _sumG[i] = 0;
+}
+
+void MPU9250Manager::_publish(const xyzFloat& g, const xyzFloat& gyr) {
     _accelX = _applyFilter(g.x, _bufAX);
     _accelY = _applyFilter(g.y, _bufAY);
     _accelZ = _applyFilter(g.z, _bufAZ);
@@ -76,21 +308,18 @@ void MPU9250Manager::update() {
     _gyroX = gyr.x;
     _gyroY = gyr.y;
     _gyroZ = gyr.z;
+    _outputSamples++;
+}
 
-    if (_magOnline) {
-        xyzFloat mag = _mpu.getMagValues();
-        
-        if (mag.x != 0 || mag.y != 0 || mag.z != 0) {
-            float mx = mag.x - _magOffX;
-            float my = mag.y - _magOffY;
-            float mz = mag.z - _magOffZ;
-            _applySoftIronCorrection(mx, my, mz);
-            _magX = mx;
-            _magY = my;
-            _magZ = mz;
-            _failCount = 0;
-        }
-    }
+void MPU9250Manager::_noteBusTime(uint32_t us) {
+    _busUsLast = us;
+    if (us > _busUsMax) _busUsMax = us;
+    _busUsTotal += us;
+    _busSamples++;
+}
+
+uint32_t MPU9250Manager::getBusTimeAvgUs() const {
+    return _busSamples ? (uint32_t)(_busUsTotal / _busSamples) : 0;
 }
 
 void MPU9250Manager::reset() {
@@ -103,68 +332,65 @@ void MPU9250Manager::reset() {
 bool MPU9250Manager::calibrateMagnetometer() {
     if (!_magOnline) return false;
 
-    DEBUG_PRINTLN("[MPU9250Manager] Calibracao do Magnetometro (20s)");
-    DEBUG_PRINTLN("  Gire o sensor lentamente em figura 8");
-    
-    const int maxSamples = 500;
-    using SampleArray = float[3];
-    SampleArray* samples = new (std::nothrow) SampleArray[maxSamples];
+    _magCal.requestRestart();
+    DEBUG_PRINTLN("[MPU9250Manager] Calibracao continua reiniciada.");
+    DEBUG_PRINTLN("  Gire o sensor lentamente em figura 8 (STATUS mostra o progresso)");
+    return true;
+}
 
-    if (!samples) {
-        DEBUG_PRINTLN("[MPU9250Manager] ERRO: Memoria insuficiente.");
-        return false;
+void MPU9250Manager::_applyMagCalibration(const MagCalibrator::Result& r) {
+    // Mesma calibração dentro do ruído: nada a trocar nem gravar
+    if (_calibrated) {
+        float dx = r.offset[0] - _magOffX;
+        float dy = r.offset[1] - _magOffY;
+        float dz = r.offset[2] - _magOffZ;
+        float dm = 0;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) dm = fmaxf(dm, fabsf(r.matrix[i][j] - _softIronMatrix[i][j]));
+        }
+        if (dx * dx + dy * dy + dz * dz < APPLY_CENTER_UT * APPLY_CENTER_UT && dm < APPLY_MATRIX) return;
     }
 
-    int numSamples = 0;
-    
-    float minX = 9999, minY = 9999, minZ = 9999;
-    float maxX = -9999, maxY = -9999, maxZ = -9999;
-    
-    uint32_t start = millis();
+    _magOffX = r.offset[0];
+    _magOffY = r.offset[1];
+    _magOffZ = r.offset[2];
+    memcpy(_softIronMatrix, r.matrix, sizeof(_softIronMatrix));
+    _calibrated = true;
 
-    while (millis() - start < 20000 && numSamples < maxSamples) {
-        xyzFloat mag = _mpu.getMagValues();
-        
-        if (mag.x != 0 || mag.y != 0) {
-            samples[numSamples][0] = mag.x;
-            samples[numSamples][1] = mag.y;
-            samples[numSamples][2] = mag.z;
-            numSamples++;
-            
-            if(mag.x < minX) minX = mag.x;
-            if(mag.x > maxX) maxX = mag.x;
-            if(mag.y < minY) minY = mag.y;
-            if(mag.y > maxY) maxY = mag.y;
-            if(mag.z < minZ) minZ = mag.z;
-            if(mag.z > maxZ) maxZ = mag.z;
-            
-            if (numSamples % 50 == 0) {
-                DEBUG_PRINTF("  Amostras: %d / %d\n", numSamples, maxSamples);
-            }
-        }
-        delay(40);
+    // Gravação (e log) ficam para persistCalibration(), fora desta task.
+    // Com uma gravação ainda pendente, a anterior vence; a próxima
+    // convergência traz a diferença de volta.
+    if (!__atomic_load_n(&_savePending, __ATOMIC_ACQUIRE)) {
+        _pendingCal = r;
+        __atomic_store_n(&_savePending, true, __ATOMIC_RELEASE);
     }
+}
 
-    if (numSamples < 200) {
-        DEBUG_PRINTLN("[MPU9250Manager] Falha: Poucas amostras.");
-        delete[] samples;
+bool MPU9250Manager::persistCalibration() {
+    if (__atomic_exchange_n(&_erasePending, false, __ATOMIC_ACQ_REL)) {
+        // Gravação pendente é de antes do CLEAR_MAG: descartada
+        __atomic_store_n(&_savePending, false, __ATOMIC_RELEASE);
+        _prefs.begin(PREFS_NAME, false);
+        _prefs.clear();
+        _prefs.end();
+        DEBUG_PRINTLN("[MPU9250Manager] Calibracao apagada.");
         return false;
     }
 
-    _magOffX = (maxX + minX) / 2.0f;
-    _magOffY = (maxY + minY) / 2.0f;
-    _magOffZ = (maxZ + minZ) / 2.0f;
-    
-    DEBUG_PRINTF("[MPU9250Manager] Hard Iron: X=%.1f, Y=%.1f, Z=%.1f\n", 
-                 _magOffX, _magOffY, _magOffZ);
-    
-    _calculateSoftIronMatrix(samples, numSamples);
-    delete[] samples;
-    _saveOffsets();
-    _calibrated = true;
-    
-    DEBUG_PRINTLN("[MPU9250Manager] Calibracao completa.");
-    return true;
+    if (!__atomic_load_n(&_savePending, __ATOMIC_ACQUIRE)) return false;
+
+    const MagCalibrator::Result& r = _pendingCal;
+    DEBUG_PRINTF("[MPU9250Manager] Mag calibrado (continuo): Hard Iron=(%.1f, %.1f, %.1f), "
+                 "campo %.1f uT, eixos %.2f, residuo %.2f%%\n",
+                 r.offset[0], r.offset[1], r.offset[2], r.fieldUt, r.axisRatio, r.residualPct);
+
+    bool saved = false;
+#if MAG_CAL_AUTO_SAVE
+    saved = _saveOffsets(r.offset, r.matrix);
+    if (!saved) DEBUG_PRINTLN("[MPU9250Manager] ERRO: Falha ao gravar calibracao na NVS.");
+#endif
+    __atomic_store_n(&_savePending, false, __ATOMIC_RELEASE);
+    return saved;
 }
 
 void MPU9250Manager::_applySoftIronCorrection(float& mx, float& my, float& mz) {
@@ -185,55 +411,6 @@ void MPU9250Manager::_applySoftIronCorrection(float& mx, float& my, float& mz) {
     mz = mz_corr;
 }
 
-void MPU9250Manager::_calculateSoftIronMatrix(float samples[][3], int numSamples) {
-    float* centeredX = (float*)malloc(numSamples * sizeof(float));
-    float* centeredY = (float*)malloc(numSamples * sizeof(float));
-    float* centeredZ = (float*)malloc(numSamples * sizeof(float));
-    
-    if (!centeredX || !centeredY || !centeredZ) {
-        DEBUG_PRINTLN("[MPU9250Manager] ERRO: Memoria insuficiente para Soft Iron.");
-        if(centeredX) free(centeredX);
-        if(centeredY) free(centeredY);
-        if(centeredZ) free(centeredZ);
-        for (int i = 0; i < 3; i++) {
-            for (int j = 0; j < 3; j++) {
-                _softIronMatrix[i][j] = (i == j) ? 1.0f : 0.0f;
-            }
-        }
-        return;
-    }
-    
-    for (int i = 0; i < numSamples; i++) {
-        centeredX[i] = samples[i][0] - _magOffX;
-        centeredY[i] = samples[i][1] - _magOffY;
-        centeredZ[i] = samples[i][2] - _magOffZ;
-    }
-    
-    float varX = 0, varY = 0, varZ = 0;
-    for (int i = 0; i < numSamples; i++) {
-        varX += centeredX[i] * centeredX[i];
-        varY += centeredY[i] * centeredY[i];
-        varZ += centeredZ[i] * centeredZ[i];
-    }
-    
-    varX = sqrt(varX / numSamples);
-    varY = sqrt(varY / numSamples);
-    varZ = sqrt(varZ / numSamples);
-    
-    float avgScale = (varX + varY + varZ) / 3.0f;
-    float scaleX = (varX > 0.1f) ? (avgScale / varX) : 1.0f;
-    float scaleY = (varY > 0.1f) ? (avgScale / varY) : 1.0f;
-    float scaleZ = (varZ > 0.1f) ? (avgScale / varZ) : 1.0f;
-    
-    _softIronMatrix[0][0] = scaleX; _softIronMatrix[0][1] = 0;      _softIronMatrix[0][2] = 0;
-    _softIronMatrix[1][0] = 0;      _softIronMatrix[1][1] = scaleY; _softIronMatrix[1][2] = 0;
-    _softIronMatrix[2][0] = 0;      _softIronMatrix[2][1] = 0;      _softIronMatrix[2][2] = scaleZ;
-    
-    free(centeredX);
-    free(centeredY);
-    free(centeredZ);
-}
-
 float MPU9250Manager::_applyFilter(float val, float* buf) {
     buf[_filterIdx] = val;
     float sum = 0;
@@ -242,10 +419,11 @@ float MPU9250Manager::_applyFilter(float val, float* buf) {
 }
 
 void MPU9250Manager::clearOffsetsFromMemory() {
-    _prefs.begin(PREFS_NAME, false);
-    _prefs.clear();
-    _prefs.end();
-    
+    __atomic_store_n(&_clearPending, true, __ATOMIC_RELEASE);
+    DEBUG_PRINTLN("[MPU9250Manager] Apagando calibracao...");
+}
+
+void MPU9250Manager::_resetMagCalibration() {
     _magOffX = _magOffY = _magOffZ = 0;
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 3; j++) {
@@ -253,7 +431,8 @@ void MPU9250Manager::clearOffsetsFromMemory() {
         }
     }
     _calibrated = false;
-    DEBUG_PRINTLN("[MPU9250Manager] Calibracao apagada.");
+    _magCal.requestRestart();
+    __atomic_store_n(&_erasePending, true, __ATOMIC_RELEASE);
 }
 
 bool MPU9250Manager::_loadOffsets() {
@@ -278,24 +457,24 @@ bool MPU9250Manager::_loadOffsets() {
     return true;
 }
 
-bool MPU9250Manager::_saveOffsets() {
+bool MPU9250Manager::_saveOffsets(const float off[3], const float m[3][3]) {
     if (!_prefs.begin(PREFS_NAME, false)) return false;
     
     _prefs.putUInt("magic", MAGIC_KEY);
     
-    _prefs.putFloat("hx", _magOffX);
-    _prefs.putFloat("hy", _magOffY);
-    _prefs.putFloat("hz", _magOffZ);
+    _prefs.putFloat("hx", off[0]);
+    _prefs.putFloat("hy", off[1]);
+    _prefs.putFloat("hz", off[2]);
     
-    _prefs.putFloat("s00", _softIronMatrix[0][0]);
-    _prefs.putFloat("s01", _softIronMatrix[0][1]);
-    _prefs.putFloat("s02", _softIronMatrix[0][2]);
-    _prefs.putFloat("s10", _softIronMatrix[1][0]);
-    _prefs.putFloat("s11", _softIronMatrix[1][1]);
-    _prefs.putFloat("s12", _softIronMatrix[1][2]);
-    _prefs.putFloat("s20", _softIronMatrix[2][0]);
-    _prefs.putFloat("s21", _softIronMatrix[2][1]);
-    _prefs.putFloat("s22", _softIronMatrix[2][2]);
+    _prefs.putFloat("s00", m[0][0]);
+    _prefs.putFloat("s01", m[0][1]);
+    _prefs.putFloat("s02", m[0][2]);
+    _prefs.putFloat("s10", m[1][0]);
+    _prefs.putFloat("s11", m[1][1]);
+    _prefs.putFloat("s12", m[1][2]);
+    _prefs.putFloat("s20", m[2][0]);
+    _prefs.putFloat("s21", m[2][1]);
+    _prefs.putFloat("s22", m[2][2]);
     
     _prefs.end();
     return true;
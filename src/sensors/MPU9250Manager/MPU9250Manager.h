@@ -8,12 +8,17 @@
  *          - Magnetômetro AK8963 (±4800µT)
  *          - Calibração Hard Iron (offset de bias)
  *          - Calibração Soft Iron (correção de distorção elipsoidal)
+ *          - Calibração contínua em segundo plano (MagCalibrator: ajuste de
+ *            elipsoide em memória fixa, matriz 3x3 completa)
+ *          - Leitura em rajada: acc + temp + gyro em 14 bytes, mag em 8
+ *          - FIFO de alta taxa (até 1 kHz) com decimação por média de blocos
+ *          - Pino INT (data-ready) acordando uma task dedicada, com timestamp
  *          - Filtro de média móvel para acelerômetro
  *          - Persistência de calibração em NVS
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 2.1.0
+ * @version 2.7.1
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -28,20 +33,26 @@
  * ### Soft Iron  
  * Distorção do campo causada por materiais que alteram a forma
  * do campo (elipsóide → esfera). Corrigido com matriz 3x3.
+ *
+ * ### Calibração contínua
+ * Cada leitura bruta do AK8963 alimenta o MagCalibrator dentro de update().
+ * Ao convergir, centro e matriz passam a valer na hora; se diferem da
+ * calibração atual, ficam pendentes para persistCalibration() gravar na
+ * NVS fora da task do IMU.
  * 
  * ## Uso
  * @code{.cpp}
  * MPU9250Manager imu(0x68);
  * imu.begin();
- * imu.calibrateMagnetometer();  // 20 segundos, girar em figura 8
+ * imu.calibrateMagnetometer();  // Janela nova; girar em figura 8
  * 
  * // No loop:
  * imu.update();
+ * imu.persistCalibration();     // Em task de prioridade menor
  * float heading = atan2(imu.getMagY(), imu.getMagX()) * RAD_TO_DEG;
  * @endcode
  * 
  * @note Endereço I2C padrão: 0x68 (AD0=LOW) ou 0x69 (AD0=HIGH)
- * @warning Calibração aloca ~6KB no heap temporariamente
  */
 
 #ifndef MPU9250MANAGER_H
@@ -52,6 +63,7 @@
 #include <Preferences.h>
 #include "MPU9250.h"
 #include "config.h"
+#include "sensors/MagCalibrator/MagCalibrator.h"
 
 /**
  * @class MPU9250Manager
@@ -77,10 +89,32 @@ public:
     bool begin();
     
     /**
-     * @brief Atualiza leituras dos sensores (chamar a cada 20ms+)
+     * @brief Atualiza leituras dos sensores
+     * @details Com FIFO ativo, drena todas as amostras acumuladas e as
+     *          decima para a taxa de saída; sem FIFO, uma leitura por chamada
+     *          (ritmo do SensorScheduler ou do pino INT).
      * @note Aplica filtro no acelerômetro e correção no magnetômetro
+     * @warning Com FIFO, chamar antes que ele encha (36 quadros; 180ms a 200Hz)
      */
     void update();
+
+    /**
+     * @brief Configura amostragem em FIFO e decimação
+     * @param fifoHz Taxa de amostragem no FIFO (4-1000 Hz; 0 = leitura direta)
+     * @param outputHz Taxa de saída após decimação (média de blocos)
+     * @return true se aplicada (guardada para reset() mesmo se offline)
+     */
+    bool setSampleRate(uint16_t fifoHz, uint16_t outputHz);
+
+    /**
+     * @brief Liga o pino INT (data-ready) a uma task dedicada
+     * @param pin GPIO do INT (-1 = sem fio; a task drena por timeout)
+     * @param task Task notificada a cada amostra de saída (lote de decimação)
+     * @return true se a interrupção ficou ativa (requer FIFO)
+     * @note A ISR também registra o esp_timer do último data-ready, usado
+     *       para datar cada quadro drenado
+     */
+    bool enableInterrupt(int8_t pin, TaskHandle_t task);
     
     /**
      * @brief Reinicializa o sensor após falha
@@ -112,6 +146,9 @@ public:
     float getMagZ() const { return _magZ; }      ///< Campo magnético Z
     ///@}
 
+    /** @brief Temperatura do die (°C), lida na mesma rajada do acc/gyro */
+    float getDieTemperature() const { return _dieTemp; }
+
     //=========================================================================
     // STATUS
     //=========================================================================
@@ -121,33 +158,68 @@ public:
     bool isCalibrated() const { return _calibrated; }   ///< Calibração carregada?
     uint8_t getFailCount() const { return _failCount; } ///< Contador de falhas
 
+    /** @name Tempo de barramento por amostra (µs, leituras dentro de update()) */
+    ///@{
+    uint32_t getBusTimeLastUs() const { return _busUsLast; } ///< Última amostra
+    uint32_t getBusTimeMaxUs() const { return _busUsMax; }   ///< Pior caso
+    uint32_t getBusTimeAvgUs() const;                        ///< Média desde o boot
+    ///@}
+
+    /** @name FIFO e decimação */
+    ///@{
+    uint16_t getFifoRate() const { return _fifoRate; }            ///< Hz (0 = leitura direta)
+    uint16_t getOutputRate() const { return _fifoRate / _decim; } ///< Hz após decimação
+    uint32_t getFifoSamples() const { return _fifoSamples; }      ///< Amostras lidas do FIFO
+    uint32_t getOutputSamples() const { return _outputSamples; }  ///< Amostras publicadas
+    uint32_t getFifoOverflows() const { return _fifoOverflows; }  ///< FIFO cheio (amostras perdidas)
+    ///@}
+
+    /** @name Interrupção e timestamps */
+    ///@{
+    int8_t getInterruptPin() const { return _intPin; }                  ///< GPIO do INT (-1 = nenhum)
+    uint32_t getInterruptCount() const { return _irqCount; }            ///< Pulsos de data-ready
+    uint32_t getSpuriousInterrupts() const { return _spuriousIrqs; }    ///< Pulsos além do FIFO_COUNT
+    int64_t getSampleTimeUs() const { return _sampleTimeUs; }           ///< esp_timer da saída atual (µs)
+    int64_t getNotifyTimeUs() const;                                    ///< esp_timer da última notificação à task
+    ///@}
+
     //=========================================================================
     // CALIBRAÇÃO DO MAGNETÔMETRO
     //=========================================================================
     
     /**
-     * @brief Executa calibração completa (Hard + Soft Iron)
+     * @brief Reinicia a calibração contínua (Hard + Soft Iron)
      * 
-     * @return true se calibração bem sucedida (>200 amostras)
-     * @return false se falhou ou memória insuficiente
+     * @return true se o magnetômetro está online
      * 
-     * @details Processo de 20 segundos:
-     *          1. Coleta ~500 amostras enquanto usuário gira sensor
-     *          2. Calcula Hard Iron (centro da elipse)
-     *          3. Calcula Soft Iron (matriz de correção)
-     *          4. Salva na NVS para persistência
+     * @details Não bloqueia: descarta a janela atual do MagCalibrator, que
+     *          converge em segundo plano conforme o sensor gira. A
+     *          calibração em uso continua valendo até lá.
      * 
-     * @note Aloca ~6KB temporariamente no heap
-     * @warning Girar sensor lentamente em figura 8 durante calibração
+     * @warning Girar sensor lentamente em figura 8 até STATUS mostrar a
+     *          convergência
      */
     bool calibrateMagnetometer();
     
+    /**
+     * @brief Grava na NVS a calibração convergida pendente, ou apaga a
+     *        calibração salva se clearOffsetsFromMemory() foi aplicado
+     * @return true se gravou
+     * @note Chamar fora da task do IMU (escrita em flash leva ms)
+     */
+    bool persistCalibration();
     
     /**
-     * @brief Apaga calibração salva na NVS
+     * @brief Apaga a calibração em uso e a salva na NVS
+     * @details Só marca o pedido: a task do IMU volta à identidade no
+     *          próximo update() e persistCalibration() apaga a NVS depois
+     * @note Pode ser chamado de qualquer task
      */
     void clearOffsetsFromMemory();
 
+    /** @brief Ajuste contínuo (janela, cobertura, resíduo) */
+    const MagCalibrator& getMagCalibrator() const { return _magCal; }
+
 private:
     //=========================================================================
     // HARDWARE
@@ -170,12 +242,59 @@ private:
     float _accelX, _accelY, _accelZ;  ///< Acelerômetro filtrado (g)
     float _gyroX, _gyroY, _gyroZ;     ///< Giroscópio (°/s)
     float _magX, _magY, _magZ;        ///< Magnetômetro calibrado (µT)
+    float _dieTemp;                   ///< Temperatura do die (°C)
+
+    //=========================================================================
+    // TEMPO DE BARRAMENTO
+    //=========================================================================
+    uint32_t _busUsLast;    ///< Duração da última amostra (µs)
+    uint32_t _busUsMax;     ///< Maior duração observada (µs)
+    uint64_t _busUsTotal;   ///< Soma para a média (µs)
+    uint32_t _busSamples;   ///< Amostras medidas
+
+    //=========================================================================
+    // FIFO E DECIMAÇÃO
+    //=========================================================================
+    static constexpr uint8_t FIFO_CHUNK = 18;  ///< Quadros por rajada (252 bytes)
+    uint16_t _cfgFifoHz;        ///< Taxa FIFO configurada (reaplicada no reset)
+    uint16_t _cfgOutputHz;      ///< Taxa de saída configurada
+    uint16_t _fifoRate;         ///< Taxa FIFO efetiva (0 = leitura direta)
+    uint8_t _decim;             ///< Amostras FIFO por amostra de saída
+    uint8_t _decimN;            ///< Amostras acumuladas no bloco atual
+    float _sumA[3];             ///< Soma do bloco (acelerômetro)
+    float _sumG[3];             ///< Soma do bloco (giroscópio)
+    uint32_t _fifoSamples;      ///< Amostras lidas do FIFO
+    uint32_t _outputSamples;    ///< Amostras publicadas
+    uint32_t _fifoOverflows;    ///< Ocorrências de FIFO cheio
+
+    //=========================================================================
+    // INTERRUPÇÃO E TIMESTAMPS
+    //=========================================================================
+    int8_t _intPin;             ///< GPIO do INT (-1 = nenhum)
+    int64_t _sampleTimeUs;      ///< Timestamp da saída atual (centro do bloco)
+    int64_t _blockT0Us;         ///< Timestamp do primeiro quadro do bloco
+    uint32_t _lastIrqCount;     ///< Pulsos já casados com quadros drenados
+    uint32_t _spuriousIrqs;     ///< Pulsos sem quadro no FIFO (bordas falsas)
+
+    static TaskHandle_t _irqTask;           ///< Task notificada pela ISR
+    static volatile uint32_t _irqCount;     ///< Pulsos de data-ready
+    static volatile int64_t _irqTimeUs;     ///< esp_timer do último pulso
+    static volatile int64_t _notifyTimeUs;  ///< esp_timer do pulso que notificou a task
+    static volatile uint8_t _irqEvery;      ///< Pulsos por notificação
 
     //=========================================================================
     // CALIBRAÇÃO DO MAGNETÔMETRO
     //=========================================================================
     float _magOffX, _magOffY, _magOffZ;  ///< Hard Iron offsets (bias)
     float _softIronMatrix[3][3];          ///< Soft Iron correction matrix
+    MagCalibrator _magCal;                ///< Ajuste de elipsoide contínuo
+    MagCalibrator::Result _pendingCal;    ///< Calibração aguardando gravação
+    volatile bool _savePending;           ///< _pendingCal preenchida (IMU -> NVS)
+    volatile bool _clearPending;          ///< CLEAR_MAG pedido (-> IMU)
+    volatile bool _erasePending;          ///< Calibração zerada, apagar NVS (IMU -> NVS)
+
+    static constexpr float APPLY_CENTER_UT = 1.0f;  ///< Mudança mínima do centro para trocar
+    static constexpr float APPLY_MATRIX = 0.02f;    ///< Idem, maior elemento da matriz
 
     //=========================================================================
     // FILTRO DE MÉDIA MÓVEL (ACELERÔMETRO)
@@ -197,11 +316,19 @@ private:
     // MÉTODOS PRIVADOS
     //=========================================================================
     bool _loadOffsets();    ///< Carrega calibração da NVS
-    bool _saveOffsets();    ///< Salva calibração na NVS
+    bool _saveOffsets(const float off[3], const float m[3][3]);  ///< Salva calibração na NVS
     float _applyFilter(float val, float* buf);  ///< Aplica média móvel
+    void _noteBusTime(uint32_t us);             ///< Acumula tempo de barramento
+    bool _drainFifo();                          ///< Lê todos os quadros do FIFO
+    void _decimate(const xyzFloat& g, const xyzFloat& gyr, int64_t tUs);  ///< Acumula bloco
+    bool _configureInterrupt();                 ///< Aplica INT conforme FIFO/pino/task
+    static void _onDataReady();                 ///< ISR do pino INT (IRAM_ATTR)
+    void _resetDecimator();                     ///< Zera o bloco atual
+    void _publish(const xyzFloat& g, const xyzFloat& gyr);   ///< Atualiza saídas
     
     void _applySoftIronCorrection(float& mx, float& my, float& mz);  ///< Corrige distorção
-    void _calculateSoftIronMatrix(float samples[][3], int numSamples);  ///< Calcula matriz
+    void _applyMagCalibration(const MagCalibrator::Result& r);      ///< Adota solução convergida
+    void _resetMagCalibration();                                     ///< Volta à identidade (task do IMU)
 };
 
 #endif
\ No newline at end of file
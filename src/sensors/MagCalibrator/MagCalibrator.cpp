@@ -0,0 +1,299 @@
+/**
+ * @file MagCalibrator.cpp
+ * @brief Implementação do ajuste de elipsoide em streaming
+ */
+
+#include "MagCalibrator.h"
+#include <math.h>
+#include <string.h>
+
+MagCalibrator::MagCalibrator() : _restart(false) {
+    reset();
+}
+
+void MagCalibrator::reset() {
+    _resetWindow();
+    memset(&_result, 0, sizeof(_result));
+    _lastResidual = NAN;
+    _solves = _rejects = _convergences = _discarded = 0;
+}
+
+void MagCalibrator::_resetWindow() {
+    memset(_ata, 0, sizeof(_ata));
+    memset(_atb, 0, sizeof(_atb));
+    _ee = 0;
+    _n = 0;
+    _coverage = 0;
+    _hasCandidate = false;
+    for (int i = 0; i < 3; i++) {
+        _last[i] = 0;
+        _min[i] = INFINITY;
+        _max[i] = -INFINITY;
+    }
+}
+
+bool MagCalibrator::addSample(float x, float y, float z) {
+    if (_restart) {
+        _restart = false;
+        _resetWindow();
+    }
+    if (isnan(x) || isnan(y) || isnan(z)) return false;
+
+    // Amostras quase iguais (sensor parado) só pesariam uma direção
+    if (_n > 0) {
+        float dx = x - _last[0], dy = y - _last[1], dz = z - _last[2];
+        if (dx * dx + dy * dy + dz * dz < MAG_CAL_MIN_STEP_UT * MAG_CAL_MIN_STEP_UT) return false;
+    }
+    _last[0] = x; _last[1] = y; _last[2] = z;
+
+    double u = x / SCALE_UT, v = y / SCALE_UT, w = z / SCALE_UT;
+    double uu = u * u, vv = v * v, ww = w * w;
+    double e = uu + vv + ww;
+    double d[N] = { uu + vv - 2 * ww, uu - 2 * vv + ww, 2 * u * v, 2 * u * w, 2 * v * w,
+                    2 * u, 2 * v, 2 * w, 1.0 };
+
+    double* p = _ata;
+    for (int i = 0; i < N; i++) {
+        _atb[i] += d[i] * e;
+        for (int j = i; j < N; j++) *p++ += d[i] * d[j];
+    }
+    _ee += e * e;
+    _n++;
+
+    _min[0] = fminf(_min[0], x); _max[0] = fmaxf(_max[0], x);
+    _min[1] = fminf(_min[1], y); _max[1] = fmaxf(_max[1], y);
+    _min[2] = fminf(_min[2], z); _max[2] = fmaxf(_max[2], z);
+    _markCoverage(x, y, z);
+
+    if (_n >= MAX_WINDOW) {
+        // Campo mudou no meio da janela ou movimento insuficiente
+        _discarded++;
+        _resetWindow();
+        return false;
+    }
+    if (_n < MAG_CAL_MIN_SAMPLES || (_n % SOLVE_EVERY) != 0) return false;
+    if (getCoverage() < COVERAGE_REGIONS) return false;
+
+    Result r;
+    if (!_solve(r)) {
+        _rejects++;
+        _hasCandidate = false;
+        return false;
+    }
+
+    // Duas soluções seguidas precisam concordar
+    bool stable = false;
+    if (_hasCandidate) {
+        float dx = r.offset[0] - _candidate.offset[0];
+        float dy = r.offset[1] - _candidate.offset[1];
+        float dz = r.offset[2] - _candidate.offset[2];
+        stable = (dx * dx + dy * dy + dz * dz < STABLE_CENTER_UT * STABLE_CENTER_UT) &&
+                 fabsf(r.fieldUt - _candidate.fieldUt) < STABLE_FIELD * r.fieldUt;
+    }
+    if (!stable) {
+        _candidate = r;
+        _hasCandidate = true;
+        return false;
+    }
+
+    _result = r;
+    _convergences++;
+    _resetWindow();
+    return true;
+}
+
+void MagCalibrator::_markCoverage(float x, float y, float z) {
+    // Direção em torno do centro provisório (meio da faixa vista)
+    float dx = x - 0.5f * (_min[0] + _max[0]);
+    float dy = y - 0.5f * (_min[1] + _max[1]);
+    float dz = z - 0.5f * (_min[2] + _max[2]);
+    float ax = fabsf(dx), ay = fabsf(dy), az = fabsf(dz);
+    if (ax + ay + az < MAG_CAL_MIN_STEP_UT) return;
+
+    // Bits 0-5: semi-eixo dominante (+X -X +Y -Y +Z -Z)
+    uint8_t axis;
+    if (ax >= ay && ax >= az) axis = (dx >= 0) ? 0 : 1;
+    else if (ay >= az) axis = (dy >= 0) ? 2 : 3;
+    else axis = (dz >= 0) ? 4 : 5;
+
+    // Bits 6-13: octante
+    uint8_t oct = (dx >= 0 ? 1 : 0) | (dy >= 0 ? 2 : 0) | (dz >= 0 ? 4 : 0);
+    _coverage |= (uint16_t)((1u << axis) | (1u << (6 + oct)));
+}
+
+uint8_t MagCalibrator::getCoverage() const {
+    uint8_t n = 0;
+    for (uint16_t c = _coverage; c; c &= c - 1) n++;
+    return n;
+}
+
+bool MagCalibrator::_solve(Result& out) {
+    _solves++;
+
+    double a[N][N], p[N];
+    const double* s = _ata;
+    for (int i = 0; i < N; i++) {
+        for (int j = i; j < N; j++) a[i][j] = a[j][i] = *s++;
+        p[i] = _atb[i];
+    }
+    if (!_cholesky(a, p)) return false;
+
+    // Resíduo algébrico Σ(dᵀp - e)² = pᵀ·M·p - 2·pᵀ·b + Σe²
+    double pmp = 0, pb = 0;
+    s = _ata;
+    for (int i = 0; i < N; i++) {
+        pb += p[i] * _atb[i];
+        pmp += p[i] * p[i] * *s++;
+        for (int j = i + 1; j < N; j++) pmp += 2 * p[i] * p[j] * *s++;
+    }
+    double res = pmp - 2 * pb + _ee;
+    if (res < 0) res = 0;
+
+    // Quádrica mᵀ·Q·m + 2·vᵀ·m + J = 0 (traço de Q fixo em 3)
+    double q[3][3] = {
+        { 1 - p[0] - p[1], -p[2], -p[3] },
+        { -p[2], 1 - p[0] + 2 * p[1], -p[4] },
+        { -p[3], -p[4], 1 + 2 * p[0] - p[1] }
+    };
+    double g[3] = { -p[5], -p[6], -p[7] };
+
+    // Centro: Q·c = -v (inversa 3x3 por cofatores)
+    double c00 = q[1][1] * q[2][2] - q[1][2] * q[2][1];
+    double c01 = q[1][2] * q[2][0] - q[1][0] * q[2][2];
+    double c02 = q[1][0] * q[2][1] - q[1][1] * q[2][0];
+    double det = q[0][0] * c00 + q[0][1] * c01 + q[0][2] * c02;
+    if (!(fabs(det) > 1e-12)) return false;
+    double inv[3][3] = {
+        { c00, q[0][2] * q[2][1] - q[0][1] * q[2][2], q[0][1] * q[1][2] - q[0][2] * q[1][1] },
+        { c01, q[0][0] * q[2][2] - q[0][2] * q[2][0], q[0][2] * q[1][0] - q[0][0] * q[1][2] },
+        { c02, q[0][1] * q[2][0] - q[0][0] * q[2][1], q[0][0] * q[1][1] - q[0][1] * q[1][0] }
+    };
+    double c[3];
+    for (int i = 0; i < 3; i++) {
+        c[i] = -(inv[i][0] * g[0] + inv[i][1] * g[1] + inv[i][2] * g[2]) / det;
+    }
+
+    // (m - c)ᵀ·Q·(m - c) = k = cᵀ·Q·c - J
+    double k = p[8];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) k += c[i] * q[i][j] * c[j];
+    }
+    if (!(k > 0)) return false;
+
+    // Semi-eixos r_i = 1/sqrt(λ_i) de Q/k (coordenadas escaladas)
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) q[i][j] /= k;
+    }
+    double lambda[3], vec[3][3];
+    _eigenSym3(q, lambda, vec);
+    double r[3];
+    for (int i = 0; i < 3; i++) {
+        if (!(lambda[i] > 0)) return false;  // Hiperboloide: dados sem cobertura
+        r[i] = 1.0 / sqrt(lambda[i]);
+    }
+    double rMean = cbrt(r[0] * r[1] * r[2]);
+    double rMin = fmin(r[0], fmin(r[1], r[2]));
+    double rMax = fmax(r[0], fmax(r[1], r[2]));
+
+    // Erro relativo: e - dᵀp = k·(|u|² - 1) ≈ 2k·(|u| - 1)
+    out.residualPct = (float)(100.0 * sqrt(res / _n) / (2.0 * k));
+    out.fieldUt = (float)(rMean * SCALE_UT);
+    out.axisRatio = (float)(rMax / rMin);
+    out.samples = _n;
+    _lastResidual = out.residualPct;
+
+    // W = V·diag(R/r_i)·Vᵀ
+    for (int i = 0; i < 3; i++) {
+        out.offset[i] = (float)(c[i] * SCALE_UT);
+        for (int j = 0; j < 3; j++) {
+            double m = 0;
+            for (int e = 0; e < 3; e++) m += vec[i][e] * (rMean / r[e]) * vec[j][e];
+            out.matrix[i][j] = (float)m;
+        }
+    }
+
+    return out.residualPct <= MAG_CAL_MAX_RESIDUAL_PCT &&
+           out.fieldUt >= MIN_FIELD_UT && out.fieldUt <= MAX_FIELD_UT &&
+           out.axisRatio <= MAX_AXIS_RATIO;
+}
+
+bool MagCalibrator::_cholesky(double a[N][N], double b[N]) {
+    // a = L·Lᵀ (L no triângulo inferior de a)
+    for (int j = 0; j < N; j++) {
+        double d = a[j][j];
+        for (int k = 0; k < j; k++) d -= a[j][k] * a[j][k];
+        if (!(d > 1e-12 * a[j][j]) || !(d > 0)) return false;  // Singular: pouca variedade
+        d = sqrt(d);
+        a[j][j] = d;
+        for (int i = j + 1; i < N; i++) {
+            double s = a[i][j];
+            for (int k = 0; k < j; k++) s -= a[i][k] * a[j][k];
+            a[i][j] = s / d;
+        }
+    }
+
+    // L·y = b, Lᵀ·x = y
+    for (int i = 0; i < N; i++) {
+        double s = b[i];
+        for (int k = 0; k < i; k++) s -= a[i][k] * b[k];
+        b[i] = s / a[i][i];
+    }
+    for (int i = N - 1; i >= 0; i--) {
+        double s = b[i];
+        for (int k = i + 1; k < N; k++) s -= a[k][i] * b[k];
+        b[i] = s / a[i][i];
+    }
+    return true;
+}
+
+void MagCalibrator::_eigenSym3(double a[3][3], double w[3], double v[3][3]) {
+    // Jacobi cíclico: a converge para diag(w), colunas de v = autovetores
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) v[i][j] = (i == j) ? 1.0 : 0.0;
+    }
+    for (int sweep = 0; sweep < 16; sweep++) {
+        double off = fabs(a[0][1]) + fabs(a[0][2]) + fabs(a[1][2]);
+        if (off < 1e-15 * (fabs(a[0][0]) + fabs(a[1][1]) + fabs(a[2][2]))) break;
+
+        for (int p = 0; p < 2; p++) {
+            for (int q = p + 1; q < 3; q++) {
+                if (a[p][q] == 0.0) continue;
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+
+                for (int k = 0; k < 3; k++) {
+                    double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; k++) {
+                    double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; k++) {
+                    double vkp = v[k][p], vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < 3; i++) w[i] = a[i][i];
+}
+
+void MagCalibrator::printStatus() const {
+    DEBUG_PRINTF("  MagCal: janela %lu amostras, cobertura %u/%u, residuo %.2f%%, "
+                 "%lu solucoes (%lu rejeitadas), %lu janelas descartadas\n",
+                 (unsigned long)_n, getCoverage(), COVERAGE_REGIONS, _lastResidual,
+                 (unsigned long)_solves, (unsigned long)_rejects, (unsigned long)_discarded);
+    if (_convergences > 0) {
+        DEBUG_PRINTF("  MagCal: %lu convergencias; ultima centro (%.1f, %.1f, %.1f) uT, "
+                     "campo %.1f uT, eixos %.2f, residuo %.2f%%\n",
+                     (unsigned long)_convergences,
+                     _result.offset[0], _result.offset[1], _result.offset[2],
+                     _result.fieldUt, _result.axisRatio, _result.residualPct);
+    }
+}
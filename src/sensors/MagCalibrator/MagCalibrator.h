@@ -0,0 +1,164 @@
+/**
+ * @file MagCalibrator.h
+ * @brief Calibração contínua do magnetômetro por ajuste de elipsoide
+ *
+ * @details Ajuste incremental por mínimos quadrados, sem guardar amostras:
+ *          - Cada leitura bruta entra em estatísticas suficientes
+ *            (matriz normal 9x9 simétrica + vetor 9) em memória fixa
+ *          - Periodicamente resolve o sistema 9x9 (Cholesky) e extrai
+ *            centro (hard iron) e matriz 3x3 simétrica completa (soft iron)
+ *          - Qualidade = erro radial RMS (%), calculado das próprias
+ *            estatísticas, sem revisitar amostras
+ *          - Converge com amostras e cobertura suficientes, resíduo baixo
+ *            e duas soluções consecutivas concordando; então abre uma
+ *            janela nova (acompanha mudanças lentas de montagem)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Modelo
+ * Quádrica mᵀ·Q·m + 2·vᵀ·m + J = 0 com traço de Q fixo em 3, em forma
+ * linear nos 9 parâmetros p:
+ *
+ *   x² + y² + z² = p0·(x² + y² - 2z²) + p1·(x² - 2y² + z²)
+ *                + 2p2·xy + 2p3·xz + 2p4·yz + 2p5·x + 2p6·y + 2p7·z + p8
+ *
+ * Sem o termo "= 1" da forma clássica, não degenera quando a origem cai
+ * sobre o elipsoide (hard iron do tamanho do campo).
+ * - Centro c = -Q⁻¹·v
+ * - (m - c)ᵀ·(Q/k)·(m - c) = 1, com k = cᵀ·Q·c - J
+ * - Correção W = R·(Q/k)^½ (autodecomposição 3x3 de Jacobi), onde R é a
+ *   média geométrica dos semi-eixos: campo corrigido em µT, na esfera
+ *
+ * O firmware aplica m' = W·(m - c) (mesmo formato já persistido na NVS).
+ *
+ * ## Memória e custo
+ * | Item                   | Tamanho / custo                          |
+ * |------------------------|------------------------------------------|
+ * | Estatísticas           | 55 double (440 bytes), fixas             |
+ * | Amostra aceita         | 55 multiplica-acumula em double          |
+ * | Solução                | A cada SOLVE_EVERY amostras aceitas      |
+ *
+ * Coordenadas divididas por SCALE_UT antes do acúmulo (condicionamento);
+ * double porque a matriz normal de uma quádrica é mal condicionada.
+ *
+ * @note Só a task que lê o IMU chama addSample(); requestRestart() pode
+ *       vir de qualquer task
+ */
+
+#ifndef MAG_CALIBRATOR_H
+#define MAG_CALIBRATOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @class MagCalibrator
+ * @brief Ajuste de elipsoide em streaming com memória O(1)
+ */
+class MagCalibrator {
+public:
+    /**
+     * @struct Result
+     * @brief Calibração estimada
+     */
+    struct Result {
+        float offset[3];      ///< Hard iron (µT)
+        float matrix[3][3];   ///< Soft iron (simétrica, adimensional)
+        float fieldUt;        ///< Raio médio da esfera corrigida (µT)
+        float residualPct;    ///< Erro radial RMS (% do raio)
+        float axisRatio;      ///< Maior / menor semi-eixo
+        uint32_t samples;     ///< Amostras da janela que gerou a solução
+    };
+
+    MagCalibrator();
+
+    /** @brief Zera estatísticas e resultados */
+    void reset();
+
+    /**
+     * @brief Pede uma janela nova (aplicado na próxima addSample)
+     * @note Seguro a partir de outra task
+     */
+    void requestRestart() { _restart = true; }
+
+    /**
+     * @brief Considera uma leitura bruta (sem calibração)
+     * @param x,y,z Campo medido (µT)
+     * @return true se uma calibração nova convergiu (ver getResult())
+     */
+    bool addSample(float x, float y, float z);
+
+    /** @brief Última calibração convergida (válida se getConvergences() > 0) */
+    const Result& getResult() const { return _result; }
+
+    //=========================================================================
+    // ESTATÍSTICAS
+    //=========================================================================
+    uint32_t getWindowSamples() const { return _n; }          ///< Amostras aceitas na janela
+    uint8_t getCoverage() const;                              ///< Regiões cobertas (0..COVERAGE_REGIONS)
+    float getLastResidualPct() const { return _lastResidual; }///< Resíduo da última solução (%)
+    uint32_t getSolves() const { return _solves; }            ///< Sistemas resolvidos
+    uint32_t getRejects() const { return _rejects; }          ///< Soluções rejeitadas
+    uint32_t getConvergences() const { return _convergences; }///< Calibrações produzidas
+    uint32_t getDiscardedWindows() const { return _discarded; }///< Janelas sem convergir
+
+    /** @brief Imprime janela, cobertura e última solução */
+    void printStatus() const;
+
+    static constexpr uint8_t COVERAGE_REGIONS = 14;  ///< 6 semi-eixos + 8 octantes
+
+private:
+    //=========================================================================
+    // PARÂMETROS
+    //=========================================================================
+    static constexpr uint8_t N = 9;                 ///< Parâmetros da quádrica
+    static constexpr uint8_t PACKED = N * (N + 1) / 2;  ///< Triângulo da matriz normal
+    static constexpr float SCALE_UT = 100.0f;       ///< Escala das coordenadas (µT)
+    static constexpr uint16_t SOLVE_EVERY = 50;     ///< Amostras aceitas entre soluções
+    static constexpr uint32_t MAX_WINDOW = 4000;    ///< Janela descartada sem convergir
+    static constexpr float MIN_FIELD_UT = 15.0f;    ///< Raio plausível (campo terrestre)
+    static constexpr float MAX_FIELD_UT = 100.0f;
+    static constexpr float MAX_AXIS_RATIO = 2.0f;   ///< Distorção máxima aceita
+    static constexpr float STABLE_CENTER_UT = 1.0f; ///< Concordância entre soluções
+    static constexpr float STABLE_FIELD = 0.01f;    ///< Idem, raio relativo
+
+    //=========================================================================
+    // ESTATÍSTICAS SUFICIENTES (janela atual)
+    //=========================================================================
+    double _ata[PACKED];      ///< Σ d·dᵀ (triângulo superior por linhas)
+    double _atb[N];           ///< Σ d·e (e = |m|²)
+    double _ee;               ///< Σ e² (resíduo)
+    uint32_t _n;              ///< Amostras aceitas
+    float _last[3];           ///< Última amostra aceita (µT)
+    float _min[3], _max[3];   ///< Extremos (centro provisório da cobertura)
+    uint16_t _coverage;       ///< Bits das regiões visitadas
+
+    //=========================================================================
+    // SOLUÇÕES
+    //=========================================================================
+    Result _candidate;        ///< Solução anterior da janela (estabilidade)
+    bool _hasCandidate;       ///< _candidate válido?
+    Result _result;           ///< Última calibração convergida
+    float _lastResidual;      ///< Resíduo da última solução (%)
+    uint32_t _solves;         ///< Sistemas resolvidos
+    uint32_t _rejects;        ///< Soluções fora dos limites
+    uint32_t _convergences;   ///< Calibrações produzidas
+    uint32_t _discarded;      ///< Janelas descartadas
+    volatile bool _restart;   ///< Pedido de janela nova
+
+    //=========================================================================
+    // MÉTODOS PRIVADOS
+    //=========================================================================
+    void _resetWindow();                         ///< Zera só a janela
+    void _markCoverage(float x, float y, float z);  ///< Região da amostra
+    bool _solve(Result& out);                    ///< Resolve e valida
+    static bool _cholesky(double a[N][N], double b[N]);  ///< a·x = b (x em b)
+    static void _eigenSym3(double a[3][3], double w[3], double v[3][3]);  ///< Jacobi
+};
+
+#endif // MAG_CALIBRATOR_H
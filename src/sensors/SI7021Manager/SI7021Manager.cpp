@@ -11,7 +11,11 @@ SI7021Manager::SI7021Manager()
       _lastTemp(NAN),
       _lastHum(NAN),
       _failCount(0),
-      _lastRead(0) 
+      _lastRead(0),
+      _converting(false),
+      _convStart(0),
+      _resetting(false),
+      _resetStart(0)
 {}
 
 bool SI7021Manager::begin() {
@@ -19,6 +23,8 @@ bool SI7021Manager::begin() {
 
     _online = false;
     _failCount = 0;
+    _converting = false;
+    _resetting = false;
 
     // 1. Tentar iniciar o driver
     if (!_si7021.begin()) {
@@ -29,7 +35,7 @@ bool SI7021Manager::begin() {
     // 2. Leitura de teste imediata
     float t, h;
     delay(100); // Estabilização inicial
-    if (_si7021.readTemperature(t) && _si7021.readHumidity(h)) {
+    if (_si7021.readHumidity(h) && _si7021.readPreviousTemperature(t)) {
         _lastTemp = t;
         _lastHum = h;
         _online = true;
@@ -42,28 +48,70 @@ bool SI7021Manager::begin() {
 }
 
 void SI7021Manager::update() {
-    if (!_online) return;
+    if (!_online && !_resetting) return;
+
+    if (_converting) {
+        _collect();
+        return;
+    }
+
+    // Após o soft reset o sensor fica NACK por até RESET_MS
+    if (_resetting && millis() - _resetStart < SI7021::RESET_MS) return;
 
-    // Rate Limiting (respeita o READ_INTERVAL_MS)
-    if (millis() - _lastRead < READ_INTERVAL_MS) return;
     _lastRead = millis();
 
-    float t, h;
-    bool successT = _si7021.readTemperature(t);
-    bool successH = _si7021.readHumidity(h);
-
-    if (successT && successH) {
-        // Validação de Range
-        if (t >= TEMP_MIN && t <= TEMP_MAX && h >= HUM_MIN && h <= HUM_MAX) {
-            _lastTemp = t;
-            _lastHum = h;
-            _failCount = 0;
-            return; // Sucesso
-        } else {
-            DEBUG_PRINTLN("[SI7021Manager] Dados fora do range válido.");
-        }
+    // Fase 1: dispara RH (converte a temperatura junto) e retorna
+    if (_si7021.startHumidity()) {
+        _converting = true;
+        _convStart = millis();
     } else {
-        DEBUG_PRINTLN("[SI7021Manager] Falha de leitura I2C.");
+        _handleFailure("Falha de leitura I2C.");
+    }
+}
+
+void SI7021Manager::_collect() {
+    unsigned long elapsed = millis() - _convStart;
+    if (elapsed < SI7021::CONVERSION_MS) return;
+
+    // Fase 2: coleta RH; NACK = ainda convertendo, tenta no próximo ciclo
+    float h, t;
+    SI7021::Result r = _si7021.fetchHumidity(h);
+    if (r == SI7021::Result::PENDING) {
+        if (elapsed < CONVERSION_TIMEOUT_MS) return;
+        _converting = false;
+        _handleFailure("Timeout de conversao.");
+        return;
+    }
+    _converting = false;
+
+    if (r != SI7021::Result::OK || !_si7021.readPreviousTemperature(t)) {
+        _handleFailure("Falha de leitura I2C.");
+        return;
+    }
+
+    // Validação de Range
+    if (t >= TEMP_MIN && t <= TEMP_MAX && h >= HUM_MIN && h <= HUM_MAX) {
+        _lastTemp = t;
+        _lastHum = h;
+        _failCount = 0;
+        if (_resetting) {
+            _resetting = false;
+            _online = true;
+            DEBUG_PRINTF("[SI7021Manager] Recuperado. T=%.2f C, RH=%.2f %%\n", t, h);
+        }
+        return; // Sucesso
+    }
+    _handleFailure("Dados fora do range válido.");
+}
+
+void SI7021Manager::_handleFailure(const char* why) {
+    DEBUG_PRINTF("[SI7021Manager] %s\n", why);
+
+    // Primeira conversão após o reset falhou: desiste, como o begin()
+    if (_resetting) {
+        _resetting = false;
+        DEBUG_PRINTLN("[SI7021Manager] ERRO: Sem resposta apos reset.");
+        return;
     }
 
     // Gerenciamento de Falhas
@@ -75,11 +123,14 @@ void SI7021Manager::update() {
 }
 
 void SI7021Manager::reset() {
-    _si7021.reset();
+    // Fase 1: só o comando; a espera e a leitura de teste ficam para o
+    // update() dos próximos ciclos, fora da sessão I2C de quem chamou
     _failCount = 0;
     _online = false;
-    
-    // Tenta reconectar imediatamente
-    delay(50);
-    begin();
-}
\ No newline at end of file
+    _converting = false;
+    _lastTemp = NAN;
+    _lastHum = NAN;
+    _resetting = _si7021.softReset();
+    _resetStart = millis();
+    if (!_resetting) DEBUG_PRINTLN("[SI7021Manager] ERRO: Reset sem ACK.");
+}
@@ -8,10 +8,12 @@
  *          - Validação de leituras contra limites físicos
  *          - Auto-recuperação em caso de falha
  *          - Rate limiting para preservar vida útil do sensor
+ *          - Medição em duas fases sem espera ativa (dispara / coleta)
+ *          - Reset em duas fases sem espera ativa (reset / primeira conversão)
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 1.1.0
+ * @version 1.4.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -59,17 +61,33 @@ public:
      * @brief Inicializa o sensor SI7021
      * @return true se sensor detectado no endereço 0x40
      * @return false se falha na comunicação I2C
+     * @note Bloqueia ~150 ms (reset + leitura de teste): só no boot.
+     *       Em voo, a reinicialização é reset()
      */
     bool begin();
     
     /**
-     * @brief Atualiza leituras do sensor
-     * @note Respeita intervalo mínimo de 2 segundos entre leituras
+     * @brief Avança a medição sem bloquear
+     * @details Sem conversão em curso, dispara a de RH; com conversão, a
+     *          coleta (>= SI7021::CONVERSION_MS depois do disparo).
+     *          A temperatura vem da mesma conversão (comando 0xE0).
+     *          Depois de reset(), espera SI7021::RESET_MS e dispara a
+     *          primeira conversão; o sensor volta a online quando ela é coletada.
+     * @note Período definido pelo SensorScheduler (SensorRates::humidityMs);
+     *       a coleta é uma continuação do mesmo job
      */
     void update();
+
+    /** @brief Conversão disparada aguardando coleta? */
+    bool isConverting() const { return _converting; }
+
+    /** @brief Reset enviado aguardando SI7021::RESET_MS? */
+    bool isResetting() const { return _resetting && !_converting; }
     
     /**
-     * @brief Reinicia o sensor após falha
+     * @brief Reinicia o sensor após falha, sem bloquear
+     * @details Só envia o soft reset (0xFE) e marca o sensor offline; o
+     *          update() dos ciclos seguintes refaz a primeira conversão.
      */
     void reset();
 
@@ -93,6 +111,9 @@ public:
     /** @brief Última leitura de temperatura válida? */
     bool isTempValid() const { return _online && !isnan(_lastTemp); }
 
+    /** @brief Contador de falhas consecutivas */
+    uint8_t getFailCount() const { return _failCount; }
+
 private:
     //=========================================================================
     // HARDWARE
@@ -106,7 +127,11 @@ private:
     float _lastTemp;             ///< Última temperatura válida (°C)
     float _lastHum;              ///< Última umidade válida (%)
     uint8_t _failCount;          ///< Contador de falhas consecutivas
-    unsigned long _lastRead;     ///< Timestamp última leitura
+    unsigned long _lastRead;     ///< Timestamp último disparo
+    bool _converting;            ///< Conversão de RH em andamento?
+    unsigned long _convStart;    ///< Timestamp do disparo da conversão
+    bool _resetting;             ///< Reset enviado, aguardando a primeira conversão
+    unsigned long _resetStart;   ///< Timestamp do soft reset
 
     //=========================================================================
     // CONSTANTES DE VALIDAÇÃO
@@ -116,7 +141,13 @@ private:
     static constexpr float HUM_MIN = 0.0f;      ///< Umidade mínima (%)
     static constexpr float HUM_MAX = 100.0f;    ///< Umidade máxima (%)
     
-    static constexpr unsigned long READ_INTERVAL_MS = 2000;  ///< Intervalo entre leituras
+    static constexpr unsigned long CONVERSION_TIMEOUT_MS = 500; ///< Conversão sem resposta = falha
+
+    //=========================================================================
+    // MÉTODOS PRIVADOS
+    //=========================================================================
+    void _collect();                       ///< Coleta RH + temperatura da conversão
+    void _handleFailure(const char* why);  ///< Conta falha e reseta após 5
 };
 
 #endif // SI7021MANAGER_H
\ No newline at end of file
@@ -6,6 +6,26 @@
 #include "SensorManager.h"
 #include <math.h>
 
+/**
+ * @brief Entrada da tabela de amostragem
+ */
+struct JobSpec {
+    const char* name;            ///< Nome nas estatísticas
+    uint16_t phaseMs;            ///< Fase fixa ou PHASE_AUTO
+    uint32_t costUs;             ///< Pior caso com a sessão I2C (100 kHz)
+    bool reserved;               ///< Ticks exclusivos
+};
+
+// Índice = SensorManager::SensorJob; ordem = ordem de execução no tick
+static const JobSpec JOB_TABLE[SensorManager::SENSOR_JOBS] = {
+    { "IMU",     0,                          6000, true  },  // Lote de 4 quadros do FIFO
+    { "BMP280",  SensorScheduler::PHASE_AUTO, 1500, false },  // Rajada de 6 B
+    { "SI7021",  SensorScheduler::PHASE_AUTO, 1000, false },  // Disparo ou coleta
+    { "CCS811",  SensorScheduler::PHASE_AUTO, 2500, false },  // Status + 8 B + compensação
+    { "GPS",     SensorScheduler::PHASE_AUTO, 2000, false },  // UART + frames UBX
+    { "BATERIA", SensorScheduler::PHASE_AUTO,  200, false },  // Uma amostra do ADC
+};
+
 SensorManager::SensorManager()
     : _mpu9250(MPU9250_ADDRESS),
       _bmp280(),
@@ -16,58 +36,72 @@ SensorManager::SensorManager()
       _lastHealthCheck(0),
       _consecutiveFailures(0),
       _temperature(NAN),
-      _i2cMutex(NULL)
+      _fastTask(false),
+      _lastBaroMs(0),
+      _lastNotifyUs(0),
+      _ahrsSamples(0),
+      _ahrsTimeUs(0),
+      _busRecoveries(0),
+      _scheduler(SENSOR_TICK_MS),
+      _rates(&PREFLIGHT_CONFIG.sensorRates),
+      _reschedule(true)
 {
-    _i2cMutex = xSemaphoreCreateMutex();
-}
-
-bool SensorManager::_lockI2C() {
-    if (_i2cMutex == NULL) return false;
-    return (xSemaphoreTake(_i2cMutex, pdMS_TO_TICKS(50)) == pdTRUE);
-}
-
-void SensorManager::_unlockI2C() {
-    if (_i2cMutex != NULL) {
-        xSemaphoreGive(_i2cMutex);
+    static const SensorScheduler::JobFn fns[SENSOR_JOBS] = {
+        _jobImu, _jobBaro, _jobHumidity, _jobAir, nullptr, nullptr
+    };
+    for (uint8_t i = 0; i < SENSOR_JOBS; i++) {
+        const JobSpec& j = JOB_TABLE[i];
+        _scheduler.add(j.name, fns[i], fns[i] ? this : nullptr, 0, j.phaseMs, j.costUs, j.reserved);
     }
 }
 
 bool SensorManager::begin() {
-    if (!_lockI2C()) {
-        DEBUG_PRINTLN("[SensorManager] Erro: I2C ocupado ao iniciar!");
-        return false;
-    }
-
     DEBUG_PRINTLN("[SensorManager] Inicializando sensores...");
     
     _sensorCount = 0;
+    _busRecoveries = I2CBus::instance().getRecoveryCount();
+
+    // Lote do FIFO passa do timeout padrão do barramento
+    I2CBus::instance().setDeviceTimeout(MPU9250_ADDRESS, I2C_TIMEOUT_LONG_MS);
     
     // MPU9250
-    if (_mpu9250.begin()) {
-        _sensorCount++;
-        DEBUG_PRINTLN("[SensorManager] MPU9250Manager: ONLINE (9-axis)");
+    {
+        I2CBus::Session bus(I2CBus::Priority::FAST, MPU9250_ADDRESS);
+        if (bus && _mpu9250.begin()) {
+            _sensorCount++;
+            DEBUG_PRINTLN("[SensorManager] MPU9250Manager: ONLINE (9-axis)");
+        }
     }
+    _ahrs.begin(IMU_OUTPUT_RATE_HZ);
     
     // BMP280
-    if (_bmp280.begin()) {
-        _sensorCount++;
-        DEBUG_PRINTLN("[SensorManager] BMP280Manager: ONLINE");
+    {
+        I2CBus::Session bus(I2CBus::Priority::FAST, BMP280::I2C_ADDR_PRIMARY);
+        if (bus && _bmp280.begin()) {
+            _sensorCount++;
+            DEBUG_PRINTLN("[SensorManager] BMP280Manager: ONLINE");
+        }
     }
     
     // SI7021
-    if (_si7021.begin()) {
-        _sensorCount++;
-        DEBUG_PRINTLN("[SensorManager] SI7021Manager: ONLINE");
+    {
+        I2CBus::Session bus(I2CBus::Priority::FAST, SI7021::I2C_ADDR);
+        if (bus && _si7021.begin()) {
+            _sensorCount++;
+            DEBUG_PRINTLN("[SensorManager] SI7021Manager: ONLINE");
+        }
     }
+    _publishSi7021();
     
     // CCS811
-    if (_ccs811.begin()) {
-        _sensorCount++;
-        DEBUG_PRINTLN("[SensorManager] CCS811Manager: ONLINE");
+    {
+        I2CBus::Session bus(I2CBus::Priority::FAST, CCS811::ADDR_5A);
+        if (bus && _ccs811.begin()) {
+            _sensorCount++;
+            DEBUG_PRINTLN("[SensorManager] CCS811Manager: ONLINE");
+        }
     }
 
-    _unlockI2C(); 
-
     restoreCCS811Baseline();
     DEBUG_PRINTF("[SensorManager] %d/4 sensores detectados\n", _sensorCount);
     
@@ -75,36 +109,165 @@ bool SensorManager::begin() {
 }
 
 void SensorManager::updateFast() {
-    if (_lockI2C()) {
+    if (!_fastTask) return;
+    _scheduler.noteBurst(micros());
+    _updateMpu();
+
+    // Barômetro no ciclo mais próximo do seu período (meio ciclo de folga)
+    uint16_t baroMs = _rates->baroMs;
+    uint32_t now = millis();
+    if (baroMs > 0 && now - _lastBaroMs + IMU_PERIOD_MS / 2 >= baroMs) {
+        _lastBaroMs = now;
+        _sampleBaro();
+    }
+}
+
+uint32_t SensorManager::takeFastReleaseUs(uint32_t nowUs) {
+    int64_t t = _mpu9250.getNotifyTimeUs();
+    if (t == _lastNotifyUs) return nowUs;  // Acordou por timeout
+    _lastNotifyUs = t;
+    return (uint32_t)t;
+}
+
+void SensorManager::_updateMpu() {
+    {
+        I2CBus::Session bus(I2CBus::Priority::IMU, MPU9250_ADDRESS);
+        if (!bus) return;
+        uint8_t fails = _mpu9250.getFailCount();
         _mpu9250.update();
-        _bmp280.update();
-        _updateTemperatureRedundancy();
-        _unlockI2C();
+        if (_mpu9250.getFailCount() > fails) bus.fail();
     }
+    _updateAttitude();
 }
 
-void SensorManager::updateSlow() {
-    static uint32_t lastSlowUpdate = 0;
-    if (millis() - lastSlowUpdate < 2000) return;
-    lastSlowUpdate = millis();
+void SensorManager::_updateAttitude() {
+    uint32_t outputs = _mpu9250.getOutputSamples();
+    if (outputs == _ahrsSamples) return;
+    _ahrsSamples = outputs;
 
-    if (_lockI2C()) {
-        _si7021.update();
-        _unlockI2C();
+    // Passos pelo timestamp da amostra: cobre decimação, FIFO resetado e
+    // ciclos atrasados (o AHRS reinicializa se a lacuna for longa)
+    int64_t t = _mpu9250.getSampleTimeUs();
+    uint32_t steps = 1;
+    if (_ahrsTimeUs != 0) {
+        const int64_t periodUs = IMU_PERIOD_MS * 1000L;
+        int64_t n = (t - _ahrsTimeUs + periodUs / 2) / periodUs;
+        if (n > 1) steps = (n > 1000) ? 1000 : (uint32_t)n;
     }
-    
-    delay(10);
-    
-    if (_lockI2C()) {
-        _ccs811.update();
-        _autoApplyEnvironmentalCompensation();
-        _unlockI2C();
+    _ahrsTimeUs = t;
+
+    // AK8963: X e Y trocados e Z invertido em relação ao acc/gyro
+    _ahrs.update(_mpu9250.getGyroX(), _mpu9250.getGyroY(), _mpu9250.getGyroZ(),
+                 _mpu9250.getAccelX(), _mpu9250.getAccelY(), _mpu9250.getAccelZ(),
+                 _mpu9250.getMagY(), _mpu9250.getMagX(), -_mpu9250.getMagZ(),
+                 _mpu9250.isMagOnline() && _mpu9250.isCalibrated(), steps);
+}
+
+void SensorManager::attachFastTask(TaskHandle_t task) {
+    I2CBus::Session bus(I2CBus::Priority::IMU, MPU9250_ADDRESS);
+    if (bus) {
+        _mpu9250.enableInterrupt(MPU9250_INT_PIN, task);
+        _lastNotifyUs = _mpu9250.getNotifyTimeUs();
+        _fastTask = true;
+        _reschedule = true;
+    }
+}
+
+void SensorManager::attachJob(SensorJob job, SensorScheduler::JobFn fn, void* ctx) {
+    _scheduler.setJob((uint8_t)job, fn, ctx);
+}
+
+void SensorManager::setRates(const SensorRates& rates) {
+    _rates = &rates;
+    _reschedule = true;
+}
+
+//=============================================================================
+// AMOSTRAGEM
+//=============================================================================
+
+void SensorManager::_applySchedule() {
+    const SensorRates& r = *_rates;
+
+    // Com a FastTask, IMU e BMP280 saem da tabela e viram a rajada a evitar
+    _scheduler.setPeriod((uint8_t)SensorJob::IMU, _fastTask ? 0 : IMU_PERIOD_MS);
+    _scheduler.setPeriod((uint8_t)SensorJob::BARO, _fastTask ? 0 : r.baroMs);
+    _scheduler.setBurst(_fastTask ? IMU_PERIOD_MS * 1000UL : 0,
+                        JOB_TABLE[(uint8_t)SensorJob::IMU].costUs +
+                        JOB_TABLE[(uint8_t)SensorJob::BARO].costUs);
+
+    _scheduler.setPeriod((uint8_t)SensorJob::HUMIDITY, r.humidityMs);
+    _scheduler.setPeriod((uint8_t)SensorJob::AIR, r.airMs);
+    _scheduler.setPeriod((uint8_t)SensorJob::GPS, r.gpsMs);
+    _scheduler.setPeriod((uint8_t)SensorJob::POWER, r.powerMs);
+    _scheduler.place();
+}
+
+uint16_t SensorManager::_jobImu(void* ctx) {
+    static_cast<SensorManager*>(ctx)->_updateMpu();
+    return 0;
+}
+
+uint16_t SensorManager::_jobBaro(void* ctx) {
+    static_cast<SensorManager*>(ctx)->_sampleBaro();
+    return 0;
+}
+
+uint16_t SensorManager::_jobHumidity(void* ctx) {
+    return static_cast<SensorManager*>(ctx)->_sampleHumidity();
+}
+
+uint16_t SensorManager::_jobAir(void* ctx) {
+    static_cast<SensorManager*>(ctx)->_sampleAir();
+    return 0;
+}
+
+void SensorManager::_sampleBaro() {
+    {
+        I2CBus::Session bus(I2CBus::Priority::FAST, _bmp280.getAddress());
+        if (bus) {
+            uint8_t fails = _bmp280.getFailCount();
+            _bmp280.update();
+            if (_bmp280.getFailCount() > fails) bus.fail();
+        }
     }
+    _updateTemperatureRedundancy();
 }
 
+uint16_t SensorManager::_sampleHumidity() {
+    // Duas fases: o disparo (ou o reset) pede a continuação do job
+    I2CBus::Session bus(I2CBus::Priority::SLOW, SI7021::I2C_ADDR);
+    if (!bus) return 0;
+    uint8_t fails = _si7021.getFailCount();
+    _si7021.update();
+    if (_si7021.getFailCount() > fails) bus.fail();
+    _publishSi7021();
+    if (_si7021.isConverting()) return SI7021::CONVERSION_MS;
+    return _si7021.isResetting() ? SI7021::RESET_MS : 0;
+}
+
+void SensorManager::_sampleAir() {
+    I2CBus::Session bus(I2CBus::Priority::SLOW, _ccs811.getAddress());
+    if (!bus) return;
+    uint8_t fails = _ccs811.getFailCount();
+    _ccs811.update();
+    _autoApplyEnvironmentalCompensation();
+    if (_ccs811.getFailCount() > fails) bus.fail();
+}
+
+//=============================================================================
+// SAÚDE
+//=============================================================================
+
 void SensorManager::updateHealth() {
     uint32_t currentTime = millis();
 
+    uint32_t recoveries = I2CBus::instance().getRecoveryCount();
+    if (recoveries != _busRecoveries) {
+        _busRecoveries = recoveries;
+        _reinitAfterRecovery();
+    }
+
     if (currentTime - _lastHealthCheck >= HEALTH_CHECK_INTERVAL) {
         _lastHealthCheck = currentTime;
         _performHealthCheck();
@@ -119,9 +282,15 @@ void SensorManager::updateHealth() {
 }
 
 void SensorManager::update() {
-    updateFast();
-    updateSlow();
+    if (_reschedule) {
+        _reschedule = false;
+        _applySchedule();
+    }
+    _scheduler.tick();
     updateHealth();
+
+    // Calibração do mag convergida na task do IMU: NVS só aqui
+    _mpu9250.persistCalibration();
 }
 
 void SensorManager::_performHealthCheck() {
@@ -131,14 +300,13 @@ void SensorManager::_performHealthCheck() {
         return;
     }
     
-    if (_lockI2C()) {
-        if (!_mpu9250.isOnline() && _mpu9250.getFailCount() >= 5) {
-            _mpu9250.reset();
-        }
-        if (!_bmp280.isOnline() && _bmp280.getFailCount() >= 5) {
-             _bmp280.forceReinit();
-        }
-        _unlockI2C();
+    if (!_mpu9250.isOnline() && _mpu9250.getFailCount() >= 5) {
+        I2CBus::Session bus(I2CBus::Priority::FAST, MPU9250_ADDRESS);
+        if (bus) _mpu9250.reset();
+    }
+    if (!_bmp280.isOnline() && _bmp280.getFailCount() >= 5) {
+        I2CBus::Session bus(I2CBus::Priority::FAST, _bmp280.getAddress());
+        if (bus) _bmp280.forceReinit();
     }
 }
 
@@ -147,69 +315,45 @@ void SensorManager::reset() {
 }
 
 void SensorManager::resetAll() {
-    if (_lockI2C()) {
-        DEBUG_PRINTLN("[SensorManager] >>> RECUPERANDO BARRAMENTO I2C <<<");
-        
-        Wire.end();
-        delay(50);
-        
-        // Bit-Banging para destravar SDA (9 Clocks)
-        pinMode(SENSOR_I2C_SDA, OUTPUT);
-        pinMode(SENSOR_I2C_SCL, OUTPUT);
-        digitalWrite(SENSOR_I2C_SDA, HIGH);
-        digitalWrite(SENSOR_I2C_SCL, HIGH);
-        
-        for(int i = 0; i < 9; i++) {
-            digitalWrite(SENSOR_I2C_SCL, LOW);
-            delayMicroseconds(10);
-            digitalWrite(SENSOR_I2C_SCL, HIGH);
-            delayMicroseconds(10);
-        }
-        
-        // Stop
-        digitalWrite(SENSOR_I2C_SDA, LOW);
-        delayMicroseconds(10);
-        digitalWrite(SENSOR_I2C_SCL, HIGH);
-        delayMicroseconds(10);
-        digitalWrite(SENSOR_I2C_SDA, HIGH);
-        delay(50);
-        
-        // Reinicia Wire
-        Wire.begin(SENSOR_I2C_SDA, SENSOR_I2C_SCL);
-        Wire.setClock(100000);
-        
-        DEBUG_PRINTLN("[SensorManager] Barramento reiniciado. Reconfigurando sensores...");
-        
-        _mpu9250.reset();
-        _bmp280.forceReinit();
-        _si7021.reset();
-        _ccs811.reset();
-        
-        _unlockI2C();
-    }
+    // Recuperação não bloqueante: o I2CBus avança um passo por service() e
+    // os sensores são reconfigurados em updateHealth() quando ela termina
+    I2CBus::instance().requestRecovery();
     _consecutiveFailures = 0;
     _temperature = NAN;
 }
 
+void SensorManager::_reinitAfterRecovery() {
+    DEBUG_PRINTLN("[SensorManager] Barramento reiniciado. Reconfigurando sensores...");
+    {
+        I2CBus::Session bus(I2CBus::Priority::FAST, MPU9250_ADDRESS);
+        if (bus) _mpu9250.reset();
+    }
+    {
+        I2CBus::Session bus(I2CBus::Priority::FAST, _bmp280.getAddress());
+        if (bus) _bmp280.forceReinit();
+    }
+    {
+        // Só envia o soft reset; o job de umidade refaz a primeira conversão
+        I2CBus::Session bus(I2CBus::Priority::FAST, SI7021::I2C_ADDR);
+        if (bus) _si7021.reset();
+    }
+    _publishSi7021();
+    {
+        I2CBus::Session bus(I2CBus::Priority::FAST, _ccs811.getAddress());
+        if (bus) _ccs811.reset();
+    }
+}
+
 bool SensorManager::recalibrateMagnetometer() {
     if (!_mpu9250.isOnline() || !_mpu9250.isMagOnline()) return false;
-    
-    DEBUG_PRINTLN("[SensorManager] INICIANDO RECALIBRACAO... (3s)");
-    delay(3000); // Tempo para o usuário se preparar
-    
-    bool success = false;
-    if (_lockI2C()) {
-        success = _mpu9250.calibrateMagnetometer();
-        _unlockI2C();
-    }
-    return success;
+
+    // Só reinicia o ajuste contínuo: as leituras seguem pela task do IMU
+    return _mpu9250.calibrateMagnetometer();
 }
 
 void SensorManager::clearMagnetometerCalibration() {
-    if (_lockI2C()) {
-        _mpu9250.clearOffsetsFromMemory();
-        _unlockI2C();
-    }
+    // Sem I2C: a task do IMU zera a calibração e update() apaga a NVS
+    _mpu9250.clearOffsetsFromMemory();
 }
 
 void SensorManager::_autoApplyEnvironmentalCompensation() {
@@ -226,27 +370,30 @@ void SensorManager::_autoApplyEnvironmentalCompensation() {
 }
 
 bool SensorManager::saveCCS811Baseline() {
-    bool success = false;
-    if (_lockI2C()) {
-        success = _ccs811.saveBaseline();
-        _unlockI2C();
-    }
-    return success;
+    I2CBus::Session bus(I2CBus::Priority::BACKGROUND, _ccs811.getAddress());
+    return bus && _ccs811.saveBaseline();
 }
 
 bool SensorManager::restoreCCS811Baseline() {
-    bool success = false;
-    if (_lockI2C()) {
-        success = _ccs811.restoreBaseline();
-        _unlockI2C();
-    }
-    return success;
+    I2CBus::Session bus(I2CBus::Priority::BACKGROUND, _ccs811.getAddress());
+    return bus && _ccs811.restoreBaseline();
 }
 
 
+void SensorManager::_publishSi7021() {
+    SiSample s;
+    s.temperature = _si7021.getTemperature();
+    s.valid = _si7021.isTempValid();
+    _siSample.publish(s);
+}
+
 void SensorManager::_updateTemperatureRedundancy() {
-    if (_si7021.isOnline() && _si7021.isTempValid()) {
-        _temperature = _si7021.getTemperature();
+    // Roda na FastTask: o SI7021 é da SensorsTask, só pelo instantâneo
+    SiSample si;
+    if (!_siSample.read(si)) return;   // Publicação em curso: fica a anterior
+
+    if (si.valid) {
+        _temperature = si.temperature;
     } else if (_bmp280.isOnline() && _bmp280.isTempValid()) {
         _temperature = _bmp280.getTemperature();
     } else {
@@ -256,7 +403,30 @@ void SensorManager::_updateTemperatureRedundancy() {
 
 void SensorManager::printDetailedStatus() const {
     DEBUG_PRINTLN("--- STATUS DETALHADO (SensorManager) ---");
-    DEBUG_PRINTF("MPU9250: %s\n", _mpu9250.isOnline() ? "ONLINE" : "OFFLINE");
+    DEBUG_PRINTF("MPU9250: %s (T die: %.1f C)\n", _mpu9250.isOnline() ? "ONLINE" : "OFFLINE",
+                 _mpu9250.getDieTemperature());
+    DEBUG_PRINTF("  I2C/leitura: ultima %lu us, media %lu us, max %lu us\n",
+                 (unsigned long)_mpu9250.getBusTimeLastUs(),
+                 (unsigned long)_mpu9250.getBusTimeAvgUs(),
+                 (unsigned long)_mpu9250.getBusTimeMaxUs());
+    if (_fastTask) {
+        DEBUG_PRINTF("  FastTask: INT GPIO%d, %lu pulsos (%lu falsos), t amostra %lld us, BMP280 a cada %u ms\n",
+                     _mpu9250.getInterruptPin(),
+                     (unsigned long)_mpu9250.getInterruptCount(),
+                     (unsigned long)_mpu9250.getSpuriousInterrupts(),
+                     (long long)_mpu9250.getSampleTimeUs(), _rates->baroMs);
+    }
+    if (_mpu9250.getFifoRate() > 0) {
+        DEBUG_PRINTF("  FIFO: %u Hz -> %u Hz, %lu amostras, %lu overflows\n",
+                     _mpu9250.getFifoRate(), _mpu9250.getOutputRate(),
+                     (unsigned long)_mpu9250.getFifoSamples(),
+                     (unsigned long)_mpu9250.getFifoOverflows());
+    }
+    if (_mpu9250.isMagOnline()) {
+        DEBUG_PRINTF("  Mag: %s\n", _mpu9250.isCalibrated() ? "calibrado" : "sem calibracao");
+        _mpu9250.getMagCalibrator().printStatus();
+    }
+    _ahrs.printStatus();
     DEBUG_PRINTF("BMP280:  %s (T: %.1f C)\n", _bmp280.isOnline() ? "ONLINE" : "OFFLINE", _bmp280.getTemperature());
     DEBUG_PRINTF("SI7021:  %s (RH: %.1f %%)\n", _si7021.isOnline() ? "ONLINE" : "OFFLINE", _si7021.getHumidity());
     
@@ -269,4 +439,5 @@ void SensorManager::printDetailedStatus() const {
                  
     DEBUG_PRINTF("Temp Final: %.2f C\n", _temperature);
     DEBUG_PRINTLN("----------------------------------------");
+    _scheduler.printStatus();
 }
@@ -3,13 +3,13 @@
  * @brief Gerenciador centralizado de sensores com orquestração I2C
  * 
  * @details Este módulo atua como orquestrador central para todos os sensores
- *          do sistema AgroSat-IoT. Coordena o acesso thread-safe ao barramento
- *          I2C através de mutex FreeRTOS e delega operações para managers
- *          específicos de cada sensor.
+ *          do sistema AgroSat-IoT. Cada acesso de sensor é uma sessão do
+ *          I2CBus (prioridade por tipo de leitura) e delega operações para
+ *          managers específicos de cada sensor.
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 2.0.0
+ * @version 3.3.3
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -22,15 +22,38 @@
  * | SI7021   | Umidade/Temperatura   | I2C       | 0x40     |
  * | CCS811   | Qualidade do Ar       | I2C       | 0x5A     |
  * 
- * ## Ciclos de Atualização
- * - **updateFast()**: MPU9250 + BMP280 (50-100Hz)
- * - **updateSlow()**: SI7021 + CCS811 (1Hz)
- * - **updateHealth()**: Verificação de saúde (0.03Hz)
+ * ## Tasks
+ * | Task        | Prioridade | Sensores                    | Chamada      |
+ * |-------------|------------|-----------------------------|--------------|
+ * | FastTask    | 3          | MPU9250 + BMP280            | updateFast() |
+ * | SensorsTask | 2          | SI7021, CCS811, GPS, bateria | update()    |
+ *
+ * Sem FastTask (attachFastTask() falhou), IMU e BMP280 voltam a ser jobs
+ * da SensorsTask. O AHRS (AttitudeEstimator) roda logo após cada leitura
+ * do IMU, na task que a fez; o ajuste contínuo do magnetômetro também, mas
+ * a gravação da calibração convergida na NVS fica para update().
+ *
+ * ## Amostragem (SensorScheduler, tick de SENSOR_TICK_MS)
+ * | Job     | Período              | Custo   | Observação                  |
+ * |---------|----------------------|---------|-----------------------------|
+ * | IMU     | 1000/IMU_OUTPUT_RATE | 6 ms    | Reservado; desligado com FastTask |
+ * | BMP280  | SensorRates::baroMs  | 1.5 ms  | Desligado com FastTask      |
+ * | SI7021  | humidityMs           | 1 ms    | Coleta como continuação     |
+ * | CCS811  | airMs                | 2.5 ms  | + compensação ambiental     |
+ * | GPS     | gpsMs                | 2 ms    | Registrado pelo TelemetryManager |
+ * | BATERIA | powerMs              | 0.2 ms  | Registrado pelo TelemetryManager |
+ *
+ * Fases automáticas: jobs lentos caem em ticks distintos e fora dos ticks
+ * do IMU; com a FastTask, a guarda de rajada adia quem não cabe antes do
+ * próximo lote. Períodos mudam com o modo (ModeConfig::sensorRates).
  * 
  * @see MPU9250Manager, BMP280Manager, SI7021Manager, CCS811Manager
  * 
- * @note Requer FreeRTOS para funcionamento correto dos mutexes
- * @warning Não chamar update() de múltiplas tasks sem proteção
+ * @note Requer I2CBus::begin() antes do begin()
+ * @warning updateFast() e update() rodam em tasks diferentes sem trava
+ *          comum: cada sensor só é lido por uma delas, e os acessos ao
+ *          barramento são sessões exclusivas do I2CBus. A temperatura
+ *          redundante (FastTask) lê o SI7021 pelo instantâneo _siSample
  */
 
 #ifndef SENSORMANAGER_H
@@ -39,7 +62,10 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
+#include "core/I2CBus/I2CBus.h"
+#include "core/SeqSnapshot/SeqSnapshot.h"
+#include "sensors/SensorScheduler/SensorScheduler.h"
+#include "sensors/AttitudeEstimator/AttitudeEstimator.h"
 
 // Includes dos Managers Específicos
 #include "sensors/MPU9250Manager/MPU9250Manager.h"
@@ -63,28 +89,70 @@ public:
      * @brief Inicializa todos os sensores do sistema
      * @return true se pelo menos um sensor foi inicializado
      * @return false se nenhum sensor respondeu
-     * @note Deve ser chamado após Wire.begin()
+     * @note Deve ser chamado após I2CBus::begin()
      */
     bool begin();
 
+    /**
+     * @enum SensorJob
+     * @brief Jobs da tabela de amostragem (índice no SensorScheduler)
+     */
+    enum class SensorJob : uint8_t {
+        IMU = 0,     ///< MPU9250 sem FastTask
+        BARO,        ///< BMP280 sem FastTask
+        HUMIDITY,    ///< SI7021
+        AIR,         ///< CCS811
+        GPS,         ///< UART do GPS (attachJob)
+        POWER        ///< ADC da bateria (attachJob)
+    };
+    static constexpr uint8_t SENSOR_JOBS = 6;  ///< Número de jobs
+
     //=========================================================================
     // CICLOS DE ATUALIZAÇÃO
     //=========================================================================
     
     /**
-     * @brief Atualiza sensores de alta frequência (IMU + Barômetro)
-     * @details Lê MPU9250 e BMP280 com proteção de mutex I2C.
-     * @note Ideal para chamadas a 50-100Hz
+     * @brief Um ciclo da FastTask: IMU e, quando vence, o BMP280
+     * @details Drena o FIFO do MPU9250 em sessão IMU do I2CBus e marca a
+     *          rajada para a guarda do escalonador. O BMP280 roda no ciclo
+     *          em que SensorRates::baroMs venceu (múltiplo do período do IMU).
+     * @note Só tem efeito após attachFastTask()
      */
     void updateFast();
-    
+
     /**
-     * @brief Atualiza sensores de baixa frequência (Ambiente)
-     * @details Lê SI7021 e CCS811 com proteção de mutex I2C.
-     * @note Ideal para chamadas a 1Hz
+     * @brief Passa IMU e barômetro para a FastTask (acordada pelo pino INT)
+     * @param task Handle da FastTask
+     * @note A partir daqui, os jobs IMU e BMP280 do escalonador são desligados
      */
-    void updateSlow();
-    
+    void attachFastTask(TaskHandle_t task);
+
+    /** @brief IMU e barômetro estão na FastTask? */
+    bool hasFastTask() const { return _fastTask; }
+
+    /** @brief Período nominal do ciclo rápido (saída do IMU) */
+    uint16_t getFastPeriodMs() const { return IMU_PERIOD_MS; }
+
+    /**
+     * @brief Liberação do ciclo rápido atual
+     * @param nowUs Início do ciclo (micros)
+     * @return Data-ready que notificou a FastTask, ou nowUs se ela acordou
+     *         por timeout
+     */
+    uint32_t takeFastReleaseUs(uint32_t nowUs);
+
+    /**
+     * @brief Registra a função de um job externo (GPS, bateria)
+     * @note Chamar antes de a SensorsTask começar
+     */
+    void attachJob(SensorJob job, SensorScheduler::JobFn fn, void* ctx);
+
+    /**
+     * @brief Troca os períodos de amostragem (modo de operação)
+     * @details Aplicado no próximo tick da SensorsTask.
+     */
+    void setRates(const SensorRates& rates);
+
     /**
      * @brief Executa verificação de saúde dos sensores
      * @details Verifica conectividade e reinicia sensores com falha.
@@ -92,10 +160,14 @@ public:
     void updateHealth();
     
     /**
-     * @brief Wrapper que executa todos os ciclos de atualização
+     * @brief Um tick da SensorsTask: jobs vencidos + saúde
+     * @note Chamar a cada SENSOR_TICK_MS
      */
     void update();
 
+    /** @brief Escalonador (estatísticas de jitter/estouro) */
+    const SensorScheduler& getScheduler() const { return _scheduler; }
+
     //=========================================================================
     // CONTROLE E RESET
     //=========================================================================
@@ -107,6 +179,8 @@ public:
     
     /**
      * @brief Força reinicialização de todos os sensores
+     * @details Agenda a recuperação do barramento no I2CBus (não bloqueia);
+     *          os sensores são reconfigurados quando ela termina.
      */
     void resetAll();
 
@@ -115,15 +189,17 @@ public:
     //=========================================================================
     
     /**
-     * @brief Executa calibração completa do magnetômetro (Hard + Soft Iron)
-     * @return true se calibração bem sucedida (>200 amostras)
-     * @return false se falhou ou poucas amostras
-     * @note Processo leva ~20 segundos - girar sensor em figura 8
+     * @brief Reinicia a calibração contínua do magnetômetro (Hard + Soft Iron)
+     * @return true se o magnetômetro está online
+     * @note Não bloqueia: girar o sensor em figura 8; converge em segundo
+     *       plano e grava na NVS pela SensorsTask (ver STATUS)
      */
     bool recalibrateMagnetometer();
     
     /**
-     * @brief Apaga calibração salva na NVS
+     * @brief Apaga a calibração do magnetômetro (em uso e na NVS)
+     * @note Não bloqueia: a task do IMU zera a calibração no próximo ciclo
+     *       e a SensorsTask apaga a NVS em update()
      */
     void clearMagnetometerCalibration();
     
@@ -177,6 +253,15 @@ public:
     float getMagY() const { return _mpu9250.getMagY(); }
     float getMagZ() const { return _mpu9250.getMagZ(); }      ///< Campo mag Z (µT)
     ///@}
+
+    /** @name Atitude (AHRS a bordo, atualizado a cada amostra do IMU) */
+    ///@{
+    bool isAttitudeValid() const { return _ahrs.isReady(); }  ///< Atitude inicializada?
+    float getRoll() const { return _ahrs.getRoll(); }         ///< Rolagem (°)
+    float getPitch() const { return _ahrs.getPitch(); }       ///< Arfagem (°)
+    float getYaw() const { return _ahrs.getYaw(); }           ///< Guinada (°)
+    const AttitudeEstimator& getAttitude() const { return _ahrs; }  ///< Quaternião, bias, ciclos
+    ///@}
     
     /** @name Dados do BMP280 (Barômetro) */
     ///@{
@@ -207,6 +292,7 @@ private:
     BMP280Manager _bmp280;      ///< Manager do barômetro
     SI7021Manager _si7021;      ///< Manager do higrômetro
     CCS811Manager _ccs811;      ///< Manager do sensor de CO2
+    AttitudeEstimator _ahrs;    ///< AHRS alimentado pelo MPU9250
     
     //=========================================================================
     // VARIÁVEIS DE CONTROLE
@@ -216,8 +302,26 @@ private:
     unsigned long _lastHealthCheck;     ///< Timestamp último health check
     uint8_t _consecutiveFailures;       ///< Contador de falhas consecutivas
     float _temperature;                 ///< Temperatura para redundância
+    bool _fastTask;                     ///< IMU e BMP280 na FastTask?
+    uint32_t _lastBaroMs;               ///< Última leitura do BMP280 na FastTask
+    int64_t _lastNotifyUs;              ///< Notificação do INT já consumida
+    uint32_t _ahrsSamples;              ///< Amostras do IMU já passadas ao AHRS
+    int64_t _ahrsTimeUs;                ///< Timestamp da última amostra do AHRS
+    uint32_t _busRecoveries;            ///< Recuperações do I2CBus já tratadas
+
+    /** @brief Temperatura do SI7021 para a redundância da FastTask */
+    struct SiSample {
+        float temperature;              ///< °C
+        bool valid;                     ///< Online e leitura válida
+    };
+    SeqSnapshot<SiSample> _siSample;    ///< Escrito por quem lê o SI7021 (SensorsTask)
 
-    SemaphoreHandle_t _i2cMutex;        ///< Mutex para acesso I2C
+    //=========================================================================
+    // AMOSTRAGEM
+    //=========================================================================
+    SensorScheduler _scheduler;         ///< Tabela de jobs
+    const SensorRates* volatile _rates; ///< Períodos do modo atual
+    volatile bool _reschedule;          ///< Reaplicar períodos no próximo tick
 
     //=========================================================================
     // CONSTANTES
@@ -225,16 +329,27 @@ private:
     static constexpr unsigned long ENV_COMPENSATION_INTERVAL = 60000;  ///< 60s
     static constexpr unsigned long HEALTH_CHECK_INTERVAL = 30000;      ///< 30s
     static constexpr uint8_t MAX_CONSECUTIVE_FAILURES = 10;            ///< Limite de falhas
+    static constexpr uint16_t IMU_PERIOD_MS = 1000 / IMU_OUTPUT_RATE_HZ; ///< Ciclo do IMU (FastTask ou job)
 
     //=========================================================================
     // MÉTODOS PRIVADOS
     //=========================================================================
     void _autoApplyEnvironmentalCompensation();  ///< Aplica compensação automática
     void _updateTemperatureRedundancy();         ///< Atualiza temp redundante
+    void _publishSi7021();                       ///< Publica _siSample
     void _performHealthCheck();                  ///< Executa verificação de saúde
-    
-    bool _lockI2C();    ///< Adquire mutex I2C com timeout
-    void _unlockI2C();  ///< Libera mutex I2C
+    void _updateMpu();                           ///< Lê o IMU em sessão IMU + AHRS
+    void _updateAttitude();                      ///< Passo do AHRS por amostra nova
+    void _sampleBaro();                          ///< BMP280 em sessão FAST
+    uint16_t _sampleHumidity();                  ///< SI7021; ms até a coleta
+    void _sampleAir();                           ///< CCS811 em sessão SLOW
+    void _applySchedule();                       ///< Períodos + fases (SensorsTask)
+
+    static uint16_t _jobImu(void* ctx);          ///< Job IMU
+    static uint16_t _jobBaro(void* ctx);         ///< Job BMP280
+    static uint16_t _jobHumidity(void* ctx);     ///< Job SI7021
+    static uint16_t _jobAir(void* ctx);          ///< Job CCS811
+    void _reinitAfterRecovery();                 ///< Reconfigura após recuperar o bus
 };
 
 #endif // SENSORMANAGER_H
\ No newline at end of file
@@ -0,0 +1,226 @@
+/**
+ * @file SensorScheduler.cpp
+ * @brief Implementação do escalonador de amostragem por sensor
+ */
+
+#include "SensorScheduler.h"
+
+static uint16_t gcd16(uint16_t a, uint16_t b) {
+    while (b != 0) {
+        uint16_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+SensorScheduler::SensorScheduler(uint16_t tickMs)
+    : _count(0), _tickMs(tickMs ? tickMs : 1), _tick(0), _epochUs(0), _started(false),
+      _tickOverruns(0), _burstPeriodUs(0), _burstCostUs(0), _lastBurstUs(0),
+      _burstSeen(false)
+{
+    memset(_jobs, 0, sizeof(_jobs));
+}
+
+//=============================================================================
+// CONFIGURAÇÃO
+//=============================================================================
+
+int8_t SensorScheduler::add(const char* name, JobFn fn, void* ctx, uint16_t periodMs,
+                            uint16_t phaseMs, uint32_t costUs, bool reserved) {
+    if (_count >= MAX_JOBS) return -1;
+    Job& j = _jobs[_count];
+    memset(&j, 0, sizeof(j));
+    j.name = name;
+    j.fn = fn;
+    j.ctx = ctx;
+    j.periodTicks = periodMs ? _toTicks(periodMs) : 0;
+    j.phaseMs = phaseMs;
+    j.costUs = costUs;
+    j.reserved = reserved;
+    return (int8_t)_count++;
+}
+
+void SensorScheduler::setJob(uint8_t id, JobFn fn, void* ctx) {
+    if (id >= _count) return;
+    _jobs[id].fn = fn;
+    _jobs[id].ctx = ctx;
+}
+
+void SensorScheduler::setPeriod(uint8_t id, uint16_t periodMs) {
+    if (id >= _count) return;
+    Job& j = _jobs[id];
+    j.periodTicks = periodMs ? _toTicks(periodMs) : 0;
+    if (j.periodTicks == 0) {
+        j.pending = false;
+        j.follow = false;
+    }
+}
+
+void SensorScheduler::setBurst(uint32_t periodUs, uint32_t costUs) {
+    _burstPeriodUs = periodUs;
+    _burstCostUs = costUs;
+}
+
+void SensorScheduler::place() {
+    bool placed[MAX_JOBS] = {false};
+
+    // Fases fixas primeiro (reservados incluídos)
+    for (uint8_t i = 0; i < _count; i++) {
+        Job& j = _jobs[i];
+        if (j.periodTicks == 0 || j.phaseMs == PHASE_AUTO) continue;
+        j.phaseTicks = ((j.phaseMs + _tickMs / 2) / _tickMs) % j.periodTicks;
+        placed[i] = true;
+    }
+
+    // Automáticas na ordem da tabela: menor carga esperada nos ticks em comum
+    for (uint8_t i = 0; i < _count; i++) {
+        Job& j = _jobs[i];
+        if (j.periodTicks == 0 || placed[i]) continue;
+
+        uint16_t best = 0;
+        uint64_t bestScore = UINT64_MAX;
+        for (uint16_t p = 0; p < j.periodTicks; p++) {
+            uint64_t score = 0;
+            for (uint8_t k = 0; k < _count; k++) {
+                if (!placed[k]) continue;
+                const Job& o = _jobs[k];
+                uint16_t g = gcd16(j.periodTicks, o.periodTicks);
+                if ((p % g) != (o.phaseTicks % g)) continue;
+                score += o.reserved ? (uint64_t)RESERVED_WEIGHT
+                                    : (uint64_t)(o.costUs + 1) * g * 1000ULL / o.periodTicks;
+            }
+            if (score < bestScore) {
+                bestScore = score;
+                best = p;
+            }
+        }
+        j.phaseTicks = best;
+        placed[i] = true;
+    }
+}
+
+//=============================================================================
+// EXECUÇÃO
+//=============================================================================
+
+void SensorScheduler::tick() {
+    uint32_t startUs = micros();
+    if (!_started) {
+        _started = true;
+        _epochUs = startUs;
+        _tick = 0;
+    }
+    uint32_t nominalUs = _epochUs + _tick * (uint32_t)_tickMs * 1000UL;
+
+    // Slots vencidos e continuações
+    for (uint8_t i = 0; i < _count; i++) {
+        Job& j = _jobs[i];
+        if (j.fn == nullptr) continue;
+        if (j.periodTicks > 0 && (_tick % j.periodTicks) == j.phaseTicks) {
+            if (j.pending && !j.resume) j.stats.skipped++;
+            j.pending = true;
+            j.resume = false;
+            j.follow = false;
+            j.defers = 0;
+            j.dueUs = nominalUs;
+        } else if (j.follow && (int32_t)(_tick - j.followTick) >= 0) {
+            j.follow = false;
+            if (!j.pending) {
+                j.pending = true;
+                j.resume = true;
+                j.defers = 0;
+            }
+        }
+    }
+
+    // Execução na ordem da tabela
+    for (uint8_t i = 0; i < _count; i++) {
+        Job& j = _jobs[i];
+        if (!j.pending) continue;
+        uint32_t now = micros();
+        if (!j.reserved && j.defers < MAX_DEFER_TICKS && _nearBurst(now, j.costUs)) {
+            j.defers++;
+            j.stats.deferred++;
+            continue;
+        }
+        _run(j, now);
+    }
+
+    if (micros() - startUs > (uint32_t)_tickMs * 1000UL) _tickOverruns++;
+    _tick++;
+}
+
+void SensorScheduler::_run(Job& j, uint32_t nowUs) {
+    j.pending = false;
+    if (!j.resume) {
+        int32_t jitter = (int32_t)(nowUs - j.dueUs);
+        uint32_t absJitter = (jitter < 0) ? (uint32_t)(-jitter) : (uint32_t)jitter;
+        j.stats.jitterLastUs = jitter;
+        if (absJitter > j.stats.jitterMaxUs) j.stats.jitterMaxUs = absJitter;
+        j.stats.jitterTotalUs += absJitter;
+        j.stats.samples++;
+    }
+
+    uint16_t againMs = j.fn(j.ctx);
+
+    uint32_t cost = micros() - nowUs;
+    j.stats.runs++;
+    j.stats.costLastUs = cost;
+    if (cost > j.stats.costMaxUs) j.stats.costMaxUs = cost;
+    if (cost > j.costUs) j.stats.overruns++;
+
+    if (againMs > 0) {
+        j.follow = true;
+        j.followTick = _tick + (againMs + _tickMs - 1) / _tickMs;
+    }
+}
+
+bool SensorScheduler::_nearBurst(uint32_t nowUs, uint32_t costUs) const {
+    if (_burstPeriodUs == 0 || !_burstSeen) return false;
+    uint32_t sinceUs = nowUs - _lastBurstUs;
+    if (sinceUs > 2 * _burstPeriodUs) return false;   // Rajadas paradas: sem previsão
+
+    // Rajada em curso ou começando antes de o job terminar
+    uint32_t phase = sinceUs % _burstPeriodUs;
+    return (phase < _burstCostUs) || (phase + costUs > _burstPeriodUs);
+}
+
+uint16_t SensorScheduler::_toTicks(uint16_t ms) const {
+    uint16_t ticks = (ms + _tickMs / 2) / _tickMs;
+    return ticks ? ticks : 1;
+}
+
+//=============================================================================
+// ESTATÍSTICAS
+//=============================================================================
+
+void SensorScheduler::resetStats() {
+    for (uint8_t i = 0; i < _count; i++) {
+        memset(&_jobs[i].stats, 0, sizeof(Stats));
+    }
+    _tickOverruns = 0;
+}
+
+void SensorScheduler::printStatus() const {
+    DEBUG_PRINTF("=== AMOSTRAGEM (tick %u ms) ===\n", _tickMs);
+    for (uint8_t i = 0; i < _count; i++) {
+        const Job& j = _jobs[i];
+        const Stats& s = j.stats;
+        if (j.periodTicks == 0 || j.fn == nullptr) {
+            DEBUG_PRINTF("  %-8s: desligado\n", j.name);
+            continue;
+        }
+        DEBUG_PRINTF("  %-8s: %u ms fase %u ms%s, %lu exec, jitter med %lu us max %lu us, "
+                     "custo max %lu/%lu us, %lu estouros, %lu adiadas, %lu perdidas\n",
+                     j.name, (unsigned)(j.periodTicks * _tickMs),
+                     (unsigned)(j.phaseTicks * _tickMs), j.reserved ? " (reservado)" : "",
+                     (unsigned long)s.runs,
+                     (unsigned long)(s.samples ? s.jitterTotalUs / s.samples : 0),
+                     (unsigned long)s.jitterMaxUs, (unsigned long)s.costMaxUs,
+                     (unsigned long)j.costUs, (unsigned long)s.overruns,
+                     (unsigned long)s.deferred, (unsigned long)s.skipped);
+    }
+    DEBUG_PRINTF("Ticks estourados: %lu\n", (unsigned long)_tickOverruns);
+    DEBUG_PRINTLN("===============================");
+}
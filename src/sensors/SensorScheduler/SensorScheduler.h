@@ -0,0 +1,195 @@
+/**
+ * @file SensorScheduler.h
+ * @brief Escalonador de amostragem por sensor (período, fase, custo)
+ *
+ * @details Tabela de jobs executada pela SensorsTask a cada tick
+ *          (SENSOR_TICK_MS):
+ *          - Cada job declara período, fase e custo de pior caso
+ *          - Fase automática espalha os jobs pelos ticks (ponderado pelo
+ *            custo), fora dos ticks de jobs reservados (rajada do IMU)
+ *          - Guarda de rajada: com o IMU na FastTask, job que não termina
+ *            antes da próxima rajada prevista é adiado um tick
+ *          - Continuação: o job pode pedir nova chamada N ms depois
+ *            (coleta do SI7021, média do ADC) sem esperar o período
+ *          - Estatísticas por job: jitter do início, estouro de custo,
+ *            adiamentos e slots perdidos
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Distribuição
+ * Dois jobs de períodos P e Q (em ticks) e fases p e q coincidem em algum
+ * tick sse `(p - q) % mdc(P, Q) == 0`. place() escolhe, para cada job com
+ * fase automática, a fase que minimiza a carga esperada nos ticks
+ * compartilhados (custo x mdc / período de cada job já posicionado).
+ * Ticks de jobs reservados pesam como conflito proibitivo.
+ *
+ * ## Jitter
+ * `início real - instante nominal do tick em que o job venceu`. Inclui o
+ * atraso da task, o tempo dos jobs anteriores no mesmo tick e adiamentos
+ * da guarda. Continuações não entram no jitter.
+ *
+ * @note Não é thread-safe: tick(), place() e set*() na mesma task
+ *       (exceto noteBurst(), que só grava um timestamp)
+ */
+
+#ifndef SENSOR_SCHEDULER_H
+#define SENSOR_SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @class SensorScheduler
+ * @brief Executa jobs periódicos de sensores em ticks fixos
+ */
+class SensorScheduler {
+public:
+    /**
+     * @brief Job de amostragem
+     * @param ctx Contexto registrado com o job
+     * @return 0, ou ms até uma continuação desta amostra
+     */
+    typedef uint16_t (*JobFn)(void* ctx);
+
+    static constexpr uint16_t PHASE_AUTO = 0xFFFF;  ///< Fase escolhida por place()
+    static constexpr uint8_t MAX_JOBS = 8;          ///< Jobs registráveis
+
+    /**
+     * @struct Stats
+     * @brief Estatística de um job
+     */
+    struct Stats {
+        uint32_t runs;          ///< Execuções (inclui continuações)
+        uint32_t overruns;      ///< Execuções acima do custo declarado
+        uint32_t deferred;      ///< Ticks adiados pela guarda de rajada
+        uint32_t skipped;       ///< Slots perdidos (ainda pendente no seguinte)
+        int32_t jitterLastUs;   ///< Último atraso do início
+        uint32_t jitterMaxUs;   ///< Maior |atraso| do início
+        uint32_t jitterTotalUs; ///< Soma de |atraso| (média = total / amostras)
+        uint32_t samples;       ///< Execuções no slot (sem continuações)
+        uint32_t costLastUs;    ///< Duração da última execução
+        uint32_t costMaxUs;     ///< Maior duração medida
+    };
+
+    /**
+     * @brief Construtor
+     * @param tickMs Período da task que chama tick()
+     */
+    explicit SensorScheduler(uint16_t tickMs);
+
+    //=========================================================================
+    // CONFIGURAÇÃO
+    //=========================================================================
+
+    /**
+     * @brief Registra um job
+     * @param name Nome nas estatísticas (literal)
+     * @param fn Função do job (nullptr = registrado, sem executar)
+     * @param ctx Contexto repassado a fn
+     * @param periodMs Período (arredondado para ticks; 0 = desligado)
+     * @param phaseMs Fase em ms ou PHASE_AUTO
+     * @param costUs Custo de pior caso declarado
+     * @param reserved Ticks do job exclusivos (rajada do IMU)
+     * @return Índice do job ou -1 se a tabela está cheia
+     */
+    int8_t add(const char* name, JobFn fn, void* ctx, uint16_t periodMs,
+               uint16_t phaseMs, uint32_t costUs, bool reserved = false);
+
+    /** @brief Troca a função de um job já registrado */
+    void setJob(uint8_t id, JobFn fn, void* ctx);
+
+    /** @brief Troca o período (0 = desligado); chamar place() depois */
+    void setPeriod(uint8_t id, uint16_t periodMs);
+
+    /** @brief Recalcula as fases automáticas */
+    void place();
+
+    /**
+     * @brief Configura a guarda de rajada externa (FastTask)
+     * @param periodUs Intervalo entre rajadas (0 = sem guarda)
+     * @param costUs Duração de uma rajada
+     */
+    void setBurst(uint32_t periodUs, uint32_t costUs);
+
+    /** @brief Registra o início de uma rajada (chamado pela FastTask) */
+    void noteBurst(uint32_t nowUs) { _lastBurstUs = nowUs; _burstSeen = true; }
+
+    //=========================================================================
+    // EXECUÇÃO
+    //=========================================================================
+
+    /** @brief Executa os jobs vencidos neste tick */
+    void tick();
+
+    //=========================================================================
+    // ESTATÍSTICAS
+    //=========================================================================
+
+    /** @brief Jobs registrados */
+    uint8_t getJobCount() const { return _count; }
+
+    /** @brief Estatística de um job */
+    const Stats& getStats(uint8_t id) const { return _jobs[id].stats; }
+
+    /** @brief Fase efetiva de um job (ticks) */
+    uint16_t getPhaseTicks(uint8_t id) const { return _jobs[id].phaseTicks; }
+
+    /** @brief Ticks cujo trabalho passou de um tick */
+    uint32_t getTickOverruns() const { return _tickOverruns; }
+
+    /** @brief Zera as estatísticas */
+    void resetStats();
+
+    /** @brief Imprime a tabela de jobs */
+    void printStatus() const;
+
+private:
+    /**
+     * @struct Job
+     * @brief Entrada da tabela
+     */
+    struct Job {
+        const char* name;        ///< Nome nas estatísticas
+        JobFn fn;                ///< Função (nullptr = ocioso)
+        void* ctx;               ///< Contexto de fn
+        uint16_t periodTicks;    ///< Período (0 = desligado)
+        uint16_t phaseMs;        ///< Fase pedida (PHASE_AUTO = automática)
+        uint16_t phaseTicks;     ///< Fase efetiva
+        uint32_t costUs;         ///< Custo declarado
+        bool reserved;           ///< Ticks exclusivos
+        bool pending;            ///< Venceu e ainda não rodou
+        bool resume;             ///< Pendente é continuação
+        bool follow;             ///< Continuação agendada
+        uint8_t defers;          ///< Adiamentos seguidos do pendente
+        uint32_t followTick;     ///< Tick da continuação
+        uint32_t dueUs;          ///< Instante nominal do slot pendente
+        Stats stats;             ///< Estatísticas
+    };
+
+    Job _jobs[MAX_JOBS];         ///< Tabela
+    uint8_t _count;              ///< Jobs registrados
+    uint16_t _tickMs;            ///< Período do tick
+    uint32_t _tick;              ///< Ticks desde o primeiro tick()
+    uint32_t _epochUs;           ///< Instante do primeiro tick()
+    bool _started;               ///< Primeiro tick() já aconteceu?
+    uint32_t _tickOverruns;      ///< Ticks acima de _tickMs
+
+    uint32_t _burstPeriodUs;     ///< Intervalo da rajada externa (0 = sem guarda)
+    uint32_t _burstCostUs;       ///< Duração da rajada
+    volatile uint32_t _lastBurstUs; ///< Início da última rajada
+    volatile bool _burstSeen;    ///< Alguma rajada registrada?
+
+    static constexpr uint8_t MAX_DEFER_TICKS = 2;    ///< Adiamentos seguidos antes de forçar
+    static constexpr uint32_t RESERVED_WEIGHT = 1000000000UL; ///< Peso de tick reservado
+
+    uint16_t _toTicks(uint16_t ms) const;             ///< ms -> ticks (arredondado)
+    bool _nearBurst(uint32_t nowUs, uint32_t costUs) const; ///< Rajada dentro do custo?
+    void _run(Job& job, uint32_t nowUs);              ///< Executa e contabiliza
+};
+
+#endif // SENSOR_SCHEDULER_H
@@ -0,0 +1,110 @@
+/**
+ * @file UbxParser.cpp
+ * @brief Implementação do enquadrador UBX
+ * @version 1.0.0
+ */
+
+#include "UbxParser.h"
+#include <string.h>
+
+UbxParser::UbxParser()
+    : _state(WAIT_SYNC_1), _class(0), _id(0), _length(0), _index(0),
+      _ckA(0), _ckB(0), _rxCkA(0), _frames(0), _checksumErrors(0),
+      _oversized(0), _skipped(0) {}
+
+bool UbxParser::feed(uint8_t c) {
+    switch (_state) {
+        case WAIT_SYNC_1:
+            if (c == SYNC_1) _state = WAIT_SYNC_2;
+            else _skipped++;
+            return false;
+
+        case WAIT_SYNC_2:
+            if (c == SYNC_2) {
+                _ckA = _ckB = 0;
+                _state = READ_CLASS;
+            } else if (c != SYNC_1) {
+                // 0xB5 repetido continua candidato a início de frame
+                _skipped += 2;
+                _state = WAIT_SYNC_1;
+            } else {
+                _skipped++;
+            }
+            return false;
+
+        case READ_CLASS:
+            _class = c;
+            _sum(c);
+            _state = READ_ID;
+            return false;
+
+        case READ_ID:
+            _id = c;
+            _sum(c);
+            _state = READ_LEN_1;
+            return false;
+
+        case READ_LEN_1:
+            _length = c;
+            _sum(c);
+            _state = READ_LEN_2;
+            return false;
+
+        case READ_LEN_2:
+            _length |= (uint16_t)c << 8;
+            _sum(c);
+            if (_length > MAX_PAYLOAD) {
+                // Não cabe: volta a procurar sincronismo (o checksum
+                // protege contra um 0xB5 0x62 dentro do payload pulado)
+                _oversized++;
+                _state = WAIT_SYNC_1;
+                return false;
+            }
+            _index = 0;
+            _state = (_length > 0) ? READ_PAYLOAD : READ_CK_A;
+            return false;
+
+        case READ_PAYLOAD:
+            _payload[_index++] = c;
+            _sum(c);
+            if (_index >= _length) _state = READ_CK_A;
+            return false;
+
+        case READ_CK_A:
+            _rxCkA = c;
+            _state = READ_CK_B;
+            return false;
+
+        case READ_CK_B:
+            _state = WAIT_SYNC_1;
+            if (_rxCkA == _ckA && c == _ckB) {
+                _frames++;
+                return true;
+            }
+            _checksumErrors++;
+            return false;
+    }
+    _state = WAIT_SYNC_1;
+    return false;
+}
+
+size_t UbxParser::build(uint8_t* out, uint8_t msgClass, uint8_t msgId,
+                        const uint8_t* payload, uint16_t len) {
+    out[0] = SYNC_1;
+    out[1] = SYNC_2;
+    out[2] = msgClass;
+    out[3] = msgId;
+    out[4] = (uint8_t)(len & 0xFF);
+    out[5] = (uint8_t)(len >> 8);
+    if (len > 0) memcpy(&out[6], payload, len);
+
+    // Fletcher-8 de classe até o fim do payload
+    uint8_t ckA = 0, ckB = 0;
+    for (size_t i = 2; i < 6 + (size_t)len; i++) {
+        ckA += out[i];
+        ckB += ckA;
+    }
+    out[6 + len] = ckA;
+    out[7 + len] = ckB;
+    return (size_t)len + FRAME_OVERHEAD;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file UbxParser.h
+ * @brief Enquadrador em streaming do protocolo binário UBX (u-blox)
+ *
+ * @details Recebe a UART byte a byte e entrega frames completos:
+ *          - Máquina de estados sem cópia intermediária (payload direto
+ *            no buffer fixo)
+ *          - Checksum Fletcher-8 acumulado enquanto os bytes chegam
+ *          - Ressincroniza sozinho em 0xB5 0x62 após lixo, NMEA residual
+ *            ou frame corrompido
+ *          - Monta frames de saída (comandos CFG) com o mesmo checksum
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Frame UBX
+ * | Campo    | Bytes | Descrição                                  |
+ * |----------|-------|--------------------------------------------|
+ * | Sync     | 2     | 0xB5 0x62                                  |
+ * | Classe   | 1     | 0x01 NAV, 0x05 ACK, 0x06 CFG...            |
+ * | ID       | 1     | Mensagem dentro da classe                  |
+ * | Tamanho  | 2     | Payload, little-endian                     |
+ * | Payload  | N     | Campos little-endian de layout fixo        |
+ * | CK_A/B   | 2     | Fletcher-8 de classe até o fim do payload  |
+ *
+ * Frames com payload acima de MAX_PAYLOAD são descartados sem bufferizar
+ * (contados em getOversized()).
+ *
+ * @note Uma instância por UART; não é thread-safe
+ */
+
+#ifndef UBX_PARSER_H
+#define UBX_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @class UbxParser
+ * @brief Enquadrador UBX com buffer fixo
+ */
+class UbxParser {
+public:
+    static constexpr uint8_t SYNC_1 = 0xB5;          ///< Primeiro byte de sincronismo
+    static constexpr uint8_t SYNC_2 = 0x62;          ///< Segundo byte de sincronismo
+    static constexpr uint16_t MAX_PAYLOAD = 100;     ///< Maior payload aceito (NAV-PVT = 92)
+    static constexpr uint8_t FRAME_OVERHEAD = 8;     ///< Sync + cabeçalho + checksum
+
+    UbxParser();
+
+    /** @brief Descarta um frame parcial (ex.: troca de baudrate) */
+    void reset() { _state = WAIT_SYNC_1; }
+
+    /**
+     * @brief Consome um byte recebido
+     * @param c Byte da UART
+     * @return true se completou um frame com checksum válido
+     * @note O frame fica disponível até a próxima chamada de feed()
+     */
+    bool feed(uint8_t c);
+
+    //=========================================================================
+    // ÚLTIMO FRAME
+    //=========================================================================
+    uint8_t msgClass() const { return _class; }        ///< Classe do frame
+    uint8_t msgId() const { return _id; }              ///< ID do frame
+    uint16_t length() const { return _length; }        ///< Tamanho do payload
+    const uint8_t* payload() const { return _payload; }///< Payload (little-endian)
+
+    //=========================================================================
+    // ESTATÍSTICAS
+    //=========================================================================
+    uint32_t getFrames() const { return _frames; }             ///< Frames válidos
+    uint32_t getChecksumErrors() const { return _checksumErrors; } ///< Checksum errado
+    uint32_t getOversized() const { return _oversized; }       ///< Payload > MAX_PAYLOAD
+    uint32_t getSkippedBytes() const { return _skipped; }      ///< Bytes fora de frame
+
+    //=========================================================================
+    // UTILITÁRIOS
+    //=========================================================================
+
+    /**
+     * @brief Monta um frame completo para envio
+     * @param out Buffer de saída (>= len + FRAME_OVERHEAD)
+     * @param msgClass Classe
+     * @param msgId ID
+     * @param payload Payload (pode ser nullptr se len == 0)
+     * @param len Tamanho do payload
+     * @return Bytes escritos em out
+     */
+    static size_t build(uint8_t* out, uint8_t msgClass, uint8_t msgId,
+                        const uint8_t* payload, uint16_t len);
+
+    /** @brief Lê U1 em p[off] */
+    static uint8_t u1(const uint8_t* p, uint16_t off) { return p[off]; }
+
+    /** @brief Lê U2 little-endian em p[off] */
+    static uint16_t u2(const uint8_t* p, uint16_t off) {
+        return (uint16_t)(p[off] | (p[off + 1] << 8));
+    }
+
+    /** @brief Lê U4 little-endian em p[off] */
+    static uint32_t u4(const uint8_t* p, uint16_t off) {
+        return (uint32_t)p[off] | ((uint32_t)p[off + 1] << 8) |
+               ((uint32_t)p[off + 2] << 16) | ((uint32_t)p[off + 3] << 24);
+    }
+
+    /** @brief Lê I4 little-endian em p[off] */
+    static int32_t i4(const uint8_t* p, uint16_t off) { return (int32_t)u4(p, off); }
+
+private:
+    /** @brief Estados do enquadrador */
+    enum State : uint8_t {
+        WAIT_SYNC_1,
+        WAIT_SYNC_2,
+        READ_CLASS,
+        READ_ID,
+        READ_LEN_1,
+        READ_LEN_2,
+        READ_PAYLOAD,
+        READ_CK_A,
+        READ_CK_B
+    };
+
+    State _state;             ///< Estado atual
+    uint8_t _class;           ///< Classe do frame em curso
+    uint8_t _id;              ///< ID do frame em curso
+    uint16_t _length;         ///< Tamanho declarado do payload
+    uint16_t _index;          ///< Bytes de payload recebidos
+    uint8_t _ckA, _ckB;       ///< Fletcher-8 acumulado
+    uint8_t _rxCkA;           ///< CK_A recebido
+    uint8_t _payload[MAX_PAYLOAD]; ///< Payload do frame
+
+    uint32_t _frames;         ///< Frames válidos
+    uint32_t _checksumErrors; ///< Frames com checksum errado
+    uint32_t _oversized;      ///< Frames grandes demais
+    uint32_t _skipped;        ///< Bytes descartados procurando sincronismo
+
+    /** @brief Acumula um byte no checksum */
+    void _sum(uint8_t c) { _ckA += c; _ckB += _ckA; }
+};
+
+#endif // UBX_PARSER_H
@@ -0,0 +1,284 @@
+/**
+ * @file BinaryLogFormat.h
+ * @brief Formato binário de log de telemetria (frames com CRC-32 em blocos)
+ *
+ * @details Define o layout on-disk do log binário de telemetria, usado como
+ *          alternativa ao CSV quando SD_TELEMETRY_BINARY está habilitado:
+ *          - Cabeçalho de arquivo versionado (512 bytes reservados)
+ *          - Blocos de 4 KB alinhados, cada um com cabeçalho próprio
+ *          - Cada registro é um frame (sync, tipo, tamanho, sequência, CRC-32)
+ *          - Cabeçalho do bloco gravado ao fechar o bloco (índice + CRC total)
+ *
+ *          Este header não depende do framework Arduino: é compartilhado
+ *          com as ferramentas de host em tools/ (exportador para CSV).
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Layout do Arquivo
+ * ```
+ * offset 0      FileHeader (32 bytes) + padding até 512
+ * offset 512    Bloco 0: BlockHeader (40 bytes) + 31 frames
+ * offset 4608   Bloco 1: BlockHeader (40 bytes) + 31 frames
+ * ...           Bloco N (aberto: cabeçalho zerado, frames parciais)
+ *
+ * Frame (127 bytes):
+ * | sync | tipo | length | seq | TelemetryRecord (115) | crc32 |
+ * |  1   |  1   |   2    |  4  |         115           |   4   |
+ * ```
+ *
+ * ## Escrita e Recuperação
+ * Cada registro custa uma única escrita (frame + byte 0x00 de fim). O
+ * BlockHeader só é gravado quando o bloco enche ("selado"). Após um reset,
+ * os blocos selados são percorridos a partir do checkpoint e os frames do
+ * bloco aberto são validados um a um (CRC + sequência contínua): o trabalho
+ * é O(cauda), e um frame rasgado descarta apenas a si mesmo.
+ *
+ * ## Comparação com CSV
+ * | Formato | Bytes/registro | Conversões %f | Integridade          |
+ * |---------|----------------|---------------|----------------------|
+ * | CSV     | ~235           | 26            | CRC-16 por linha     |
+ * | Binário | 127            | 0             | CRC-32 por frame     |
+ *
+ * @note Todos os campos são little-endian (nativo do ESP32 e x86)
+ * @see tools/binlog_export.cpp para conversão offline em CSV
+ */
+
+#ifndef BINARY_LOG_FORMAT_H
+#define BINARY_LOG_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace BinLog {
+
+//=============================================================================
+// CONSTANTES DO FORMATO
+//=============================================================================
+constexpr uint32_t FILE_MAGIC     = 0x4C425341UL; ///< "ASBL" em little-endian
+constexpr uint32_t BLOCK_MAGIC    = 0x4B4C4244UL; ///< "DBLK" em little-endian
+constexpr uint16_t FORMAT_VERSION = 2;            ///< Versão do layout (2 = frames)
+constexpr uint32_t HEADER_AREA    = 512;          ///< Área reservada ao cabeçalho
+constexpr uint32_t BLOCK_SIZE     = 4096;         ///< Tamanho de cada bloco
+constexpr uint8_t  FRAME_SYNC     = 0xA5;         ///< Primeiro byte de cada frame
+
+/**
+ * @enum RecordType
+ * @brief Tipo de registro armazenado no arquivo
+ */
+enum RecordType : uint8_t {
+    RECORD_TELEMETRY = 1    ///< TelemetryRecord
+};
+
+/**
+ * @enum RecordFlags
+ * @brief Flags por registro (campo TelemetryRecord::flags)
+ */
+enum RecordFlags : uint8_t {
+    FLAG_GPS_FIX   = 0x01,  ///< Fix GPS válido
+    FLAG_RTC_VALID = 0x02   ///< Timestamp veio do RTC (senão, millis()/1000)
+};
+
+//=============================================================================
+// ESTRUTURAS ON-DISK
+//=============================================================================
+
+/**
+ * @struct FileHeader
+ * @brief Cabeçalho do arquivo (início da área de 512 bytes)
+ */
+struct __attribute__((packed)) FileHeader {
+    uint32_t magic;          ///< FILE_MAGIC
+    uint16_t version;        ///< FORMAT_VERSION
+    uint16_t headerArea;     ///< HEADER_AREA
+    uint32_t blockSize;      ///< BLOCK_SIZE
+    uint16_t recordSize;     ///< sizeof(TelemetryRecord)
+    uint8_t  recordType;     ///< RecordType
+    uint8_t  reserved;       ///< Zero
+    uint16_t teamId;         ///< TEAM_ID
+    uint16_t reserved2;      ///< Zero
+    int32_t  utcOffsetSec;   ///< Offset do horário local (coluna ISO8601)
+    uint32_t createdUnix;    ///< Criação do arquivo (Unix UTC)
+    uint32_t crc32;          ///< CRC-32 dos campos anteriores
+};
+
+/**
+ * @struct BlockHeader
+ * @brief Cabeçalho de cada bloco de 4 KB (gravado ao selar o bloco)
+ */
+struct __attribute__((packed)) BlockHeader {
+    uint32_t magic;          ///< BLOCK_MAGIC
+    uint32_t blockIndex;     ///< Índice do bloco no arquivo
+    uint32_t firstRecordSeq; ///< Sequência global do primeiro registro
+    uint32_t firstTimestamp; ///< Timestamp do primeiro registro
+    uint32_t lastTimestamp;  ///< Timestamp do último registro
+    uint16_t payloadLen;     ///< Bytes de frames válidos
+    uint16_t recordCount;    ///< Frames válidos
+    uint32_t payloadCrc32;   ///< CRC-32 dos payloadLen bytes de frames
+    uint32_t reserved[2];    ///< Zero (expansão futura)
+    uint32_t headerCrc32;    ///< CRC-32 dos campos anteriores
+};
+
+/**
+ * @struct FrameHeader
+ * @brief Início de cada frame de registro
+ * @note O frame termina com CRC-32 de FrameHeader + payload
+ */
+struct __attribute__((packed)) FrameHeader {
+    uint8_t  sync;           ///< FRAME_SYNC
+    uint8_t  type;           ///< RecordType
+    uint16_t length;         ///< Bytes de payload
+    uint32_t seq;            ///< Sequência global do registro
+};
+
+/**
+ * @struct TelemetryRecord
+ * @brief Registro de telemetria empacotado (mesma ordem das colunas do CSV)
+ * @note Floats são gravados crus (NAN preservado); o exportador aplica a
+ *       mesma substituição NAN/INF -> 0 que o CSV do dispositivo
+ */
+struct __attribute__((packed)) TelemetryRecord {
+    uint32_t unixTime;           ///< UnixTimestamp
+    uint32_t missionTime;        ///< MissionTime
+    float    batteryVoltage;     ///< BatVoltage (V)
+    float    batteryPercentage;  ///< BatPercent (%)
+    float    temperature;        ///< TempFinal (°C)
+    float    temperatureBMP;     ///< TempBMP (°C)
+    float    temperatureSI;      ///< TempSI (°C)
+    float    pressure;           ///< Pressure (hPa)
+    float    altitude;           ///< Altitude (m)
+    int32_t  latitudeE7;         ///< Lat (graus * 1e7)
+    int32_t  longitudeE7;        ///< Lng (graus * 1e7)
+    float    gpsAltitude;        ///< GpsAlt (m)
+    uint8_t  satellites;         ///< Sats
+    uint8_t  flags;              ///< RecordFlags
+    float    gyro[3];            ///< GyroX/Y/Z (°/s)
+    float    accel[3];           ///< AccelX/Y/Z (g)
+    float    mag[3];             ///< MagX/Y/Z (µT)
+    float    humidity;           ///< Humidity (%)
+    float    co2;                ///< CO2 (ppm)
+    float    tvoc;               ///< TVOC (ppb)
+    uint8_t  systemStatus;       ///< Status
+    uint16_t errorCount;         ///< Errors
+    uint32_t uptime;             ///< Uptime
+    uint16_t resetCount;         ///< ResetCnt
+    uint32_t minFreeHeap;        ///< MinHeap
+    float    cpuTemp;            ///< CpuTemp (°C)
+};
+
+static_assert(sizeof(FileHeader) == 32, "FileHeader deve ter 32 bytes");
+static_assert(sizeof(BlockHeader) == 40, "BlockHeader deve ter 40 bytes");
+static_assert(sizeof(FrameHeader) == 8, "FrameHeader deve ter 8 bytes");
+static_assert(sizeof(TelemetryRecord) == 115, "TelemetryRecord deve ter 115 bytes");
+
+constexpr uint32_t BLOCK_PAYLOAD = BLOCK_SIZE - sizeof(BlockHeader);  ///< 4056 bytes
+constexpr uint32_t FRAME_SIZE =
+    sizeof(FrameHeader) + sizeof(TelemetryRecord) + sizeof(uint32_t); ///< 127 bytes
+constexpr uint16_t RECORDS_PER_BLOCK = BLOCK_PAYLOAD / FRAME_SIZE;    ///< 31 frames
+
+//=============================================================================
+// FUNÇÕES AUXILIARES
+//=============================================================================
+
+/**
+ * @brief CRC-32 (IEEE 802.3 / zlib) encadeável, tabela de 16 entradas
+ * @param crc CRC anterior (0 para começar)
+ * @param data Dados
+ * @param length Tamanho em bytes
+ * @return CRC acumulado; crc32(crc32(0, a), b) == crc32(0, a||b)
+ */
+inline uint32_t crc32(uint32_t crc, const void* data, size_t length) {
+    static const uint32_t table[16] = {
+        0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+        0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+        0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+        0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+    };
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    while (length--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+/** @brief Offset do bloco idx no arquivo */
+inline uint32_t blockOffset(uint32_t idx) {
+    return HEADER_AREA + idx * BLOCK_SIZE;
+}
+
+/** @brief Calcula o CRC do cabeçalho de bloco (todos os campos menos o último) */
+inline uint32_t blockHeaderCrc(const BlockHeader& h) {
+    return crc32(0, &h, sizeof(BlockHeader) - sizeof(uint32_t));
+}
+
+/** @brief Cabeçalho de bloco íntegro e coerente? */
+inline bool isValidBlockHeader(const BlockHeader& h) {
+    return h.magic == BLOCK_MAGIC &&
+           h.payloadLen <= BLOCK_PAYLOAD &&
+           h.recordCount <= RECORDS_PER_BLOCK &&
+           h.payloadLen == h.recordCount * FRAME_SIZE &&
+           h.headerCrc32 == blockHeaderCrc(h);
+}
+
+/**
+ * @brief Monta um frame de telemetria
+ * @param out Buffer com pelo menos FRAME_SIZE bytes
+ * @param seq Sequência global do registro
+ * @param rec Registro empacotado
+ */
+inline void encodeFrame(uint8_t* out, uint32_t seq, const TelemetryRecord& rec) {
+    FrameHeader fh;
+    fh.sync = FRAME_SYNC;
+    fh.type = RECORD_TELEMETRY;
+    fh.length = sizeof(TelemetryRecord);
+    fh.seq = seq;
+    memcpy(out, &fh, sizeof(fh));
+    memcpy(out + sizeof(fh), &rec, sizeof(rec));
+    uint32_t crc = crc32(0, out, sizeof(fh) + sizeof(rec));
+    memcpy(out + sizeof(fh) + sizeof(rec), &crc, sizeof(crc));
+}
+
+/**
+ * @brief Valida e decodifica um frame de telemetria
+ * @param in FRAME_SIZE bytes lidos do arquivo
+ * @param seq [out] Sequência do registro
+ * @param rec [out] Registro
+ * @return true se sync, tipo, tamanho e CRC conferem
+ */
+inline bool decodeFrame(const uint8_t* in, uint32_t& seq, TelemetryRecord& rec) {
+    FrameHeader fh;
+    memcpy(&fh, in, sizeof(fh));
+    if (fh.sync != FRAME_SYNC || fh.type != RECORD_TELEMETRY ||
+        fh.length != sizeof(TelemetryRecord)) {
+        return false;
+    }
+    uint32_t crc;
+    memcpy(&crc, in + sizeof(fh) + sizeof(rec), sizeof(crc));
+    if (crc != crc32(0, in, sizeof(fh) + sizeof(rec))) return false;
+
+    seq = fh.seq;
+    memcpy(&rec, in + sizeof(fh), sizeof(rec));
+    return true;
+}
+
+/** @brief Cabeçalho de arquivo íntegro e compatível? */
+inline bool isValidFileHeader(const FileHeader& h) {
+    return h.magic == FILE_MAGIC &&
+           h.version == FORMAT_VERSION &&
+           h.headerArea == HEADER_AREA &&
+           h.blockSize == BLOCK_SIZE &&
+           h.recordSize == sizeof(TelemetryRecord) &&
+           h.crc32 == crc32(0, &h, sizeof(FileHeader) - sizeof(uint32_t));
+}
+
+} // namespace BinLog
+
+#endif // BINARY_LOG_FORMAT_H
@@ -0,0 +1,220 @@
+/**
+ * @file ColumnarArchive.cpp
+ * @brief Implementação do gravador colunar de telemetria
+ */
+
+#include "ColumnarArchive.h"
+#include <Preferences.h>
+#include <unistd.h>
+
+static const char *NVS_NAMESPACE = "storage";
+static const char *NVS_CHECKPOINT_KEY = "col_end";
+
+// Checkpoint: fim do último grupo gravado e índice do próximo
+struct ColumnarCheckpoint {
+  uint32_t end;
+  uint32_t groupIndex;
+};
+
+ColumnarArchive::ColumnarArchive(const char *path)
+    : _path(path), _opened(false), _end(0), _groupIndex(0), _count(0),
+      _firstAddMs(0) {}
+
+bool ColumnarArchive::begin(uint32_t createdUnix) {
+  // Grupo em RAM sobrevive a uma remontagem do SD
+  _opened = false;
+  if (!SD.exists(_path))
+    return _create(createdUnix);
+
+  File file = SD.open(_path, FILE_READ);
+  if (!file)
+    return false;
+
+  uint32_t size = file.size();
+  ColArch::FileHeader hdr;
+  if (size < sizeof(hdr)) {
+    // Criação interrompida
+    file.close();
+    return _create(createdUnix);
+  }
+  if (file.read((uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr) ||
+      !ColArch::isValidFileHeader(hdr)) {
+    file.close();
+    Serial.printf("[ColumnarArchive] %s em outro formato/layout.\n", _path);
+    return false;
+  }
+
+  // Checkpoint costuma coincidir com o fim: nada a varrer
+  ColumnarCheckpoint cp = {0, 0};
+  Preferences prefs;
+  if (prefs.begin(NVS_NAMESPACE, true)) {
+    prefs.getBytes(NVS_CHECKPOINT_KEY, &cp, sizeof(cp));
+    prefs.end();
+  }
+
+  _groupIndex = 0;
+  if (cp.end >= sizeof(hdr) && cp.end <= size) {
+    _groupIndex = cp.groupIndex;
+    _end = _scanGroups(file, cp.end, size);
+    // Checkpoint fora de uma fronteira de grupo: varredura completa
+    if (_end < size && _end == cp.end) {
+      _groupIndex = 0;
+      _end = _scanGroups(file, sizeof(hdr), size);
+    }
+  } else {
+    _end = _scanGroups(file, sizeof(hdr), size);
+  }
+  file.close();
+
+  if (_end < size) {
+    char fullPath[48];
+    snprintf(fullPath, sizeof(fullPath), "%s%s", SD_MOUNT_POINT, _path);
+    if (truncate(fullPath, _end) == 0)
+      Serial.printf("[ColumnarArchive] Grupo incompleto descartado (%lu "
+                    "bytes).\n",
+                    (unsigned long)(size - _end));
+    else
+      Serial.printf("[ColumnarArchive] Aviso: falha ao truncar %s\n", _path);
+  }
+
+  _opened = true;
+  _storeCheckpoint();
+  return true;
+}
+
+bool ColumnarArchive::rotate(const char *backupPath, uint32_t createdUnix) {
+  if (SD.exists(_path) && !SD.rename(_path, backupPath)) {
+    _opened = false;
+    return false;
+  }
+  return _create(createdUnix);
+}
+
+bool ColumnarArchive::add(uint32_t seq, const BinLog::TelemetryRecord &rec) {
+  if (_count >= SD_COLUMNAR_GROUP)
+    return false;
+  if (_count == 0)
+    _firstAddMs = millis();
+  _records[_count] = rec;
+  _seqs[_count] = seq;
+  _count++;
+  return true;
+}
+
+bool ColumnarArchive::isDue() const {
+  return _count >= SD_COLUMNAR_GROUP ||
+         (_count > 0 && millis() - _firstAddMs >= SD_COLUMNAR_MAX_AGE_MS);
+}
+
+bool ColumnarArchive::flush() {
+  if (_count == 0)
+    return true;
+  if (!_opened)
+    return false;
+
+  File file = SD.open(_path, "r+");
+  if (!file)
+    return false;
+
+  // Cabeçalho e diretório zerados primeiro, definitivos por último:
+  // reset no meio deixa magic zerado (grupo descartado no begin())
+  ColArch::GroupHeader g;
+  ColArch::ChunkEntry dir[ColArch::COLUMN_COUNT];
+  memset(&g, 0, sizeof(g));
+  memset(dir, 0, sizeof(dir));
+  bool ok = file.seek(_end) &&
+            file.write((const uint8_t *)&g, sizeof(g)) == sizeof(g) &&
+            file.write((const uint8_t *)dir, sizeof(dir)) == sizeof(dir);
+
+  uint32_t values[SD_COLUMNAR_GROUP];
+  uint32_t offset = ColArch::GROUP_PREFIX;
+  for (uint8_t col = 0; ok && col < ColArch::COLUMN_COUNT; col++) {
+    for (uint16_t i = 0; i < _count; i++)
+      values[i] = ColArch::fieldValue(col, _seqs[i], _records[i]);
+    size_t n = ColArch::encodeChunk(col, values, _count, _chunk, sizeof(_chunk));
+    ok = n > 0 && file.write(_chunk, n) == n;
+    dir[col].offset = offset;
+    dir[col].size = n;
+    dir[col].crc32 = BinLog::crc32(0, _chunk, n);
+    offset += n;
+  }
+
+  if (ok) {
+    g.groupIndex = _groupIndex;
+    g.firstSeq = _seqs[0];
+    g.recordCount = _count;
+    g.columnCount = ColArch::COLUMN_COUNT;
+    g.firstUnix = _records[0].unixTime;
+    g.lastUnix = _records[_count - 1].unixTime;
+    g.groupBytes = offset;
+    g.dirCrc32 = BinLog::crc32(0, dir, sizeof(dir));
+    g.magic = ColArch::GROUP_MAGIC;
+    g.crc32 = BinLog::crc32(0, &g, sizeof(g) - sizeof(uint32_t));
+
+    file.flush();
+    ok = file.seek(_end + sizeof(g)) &&
+         file.write((const uint8_t *)dir, sizeof(dir)) == sizeof(dir);
+    file.flush();
+    ok = ok && file.seek(_end) &&
+         file.write((const uint8_t *)&g, sizeof(g)) == sizeof(g);
+  }
+  file.close();
+
+  // Falha: grupo fica em RAM e sobrescreve a mesma região na próxima vez
+  if (!ok)
+    return false;
+
+  _end += offset;
+  _groupIndex++;
+  _count = 0;
+  _storeCheckpoint();
+  return true;
+}
+
+bool ColumnarArchive::_create(uint32_t createdUnix) {
+  ColArch::FileHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.magic = ColArch::FILE_MAGIC;
+  hdr.version = ColArch::FORMAT_VERSION;
+  hdr.columnCount = ColArch::COLUMN_COUNT;
+  hdr.groupRecords = SD_COLUMNAR_GROUP;
+  hdr.layoutCrc32 = ColArch::layoutCrc();
+  hdr.createdUnix = createdUnix;
+  hdr.crc32 = BinLog::crc32(0, &hdr, sizeof(hdr) - sizeof(uint32_t));
+
+  File file = SD.open(_path, FILE_WRITE);
+  if (!file)
+    return false;
+  bool ok = file.write((const uint8_t *)&hdr, sizeof(hdr)) == sizeof(hdr);
+  file.close();
+  if (!ok)
+    return false;
+
+  _end = sizeof(hdr);
+  _groupIndex = 0;
+  _opened = true;
+  _storeCheckpoint();
+  return true;
+}
+
+uint32_t ColumnarArchive::_scanGroups(File &file, uint32_t from,
+                                      uint32_t size) {
+  uint32_t pos = from;
+  ColArch::GroupHeader g;
+  while (pos + sizeof(g) <= size && file.seek(pos) &&
+         file.read((uint8_t *)&g, sizeof(g)) == sizeof(g) &&
+         ColArch::isValidGroupHeader(g) && g.groupBytes <= size - pos) {
+    pos += g.groupBytes;
+    _groupIndex = g.groupIndex + 1;
+  }
+  return pos;
+}
+
+void ColumnarArchive::_storeCheckpoint() {
+  ColumnarCheckpoint cp = {_end, _groupIndex};
+  Preferences prefs;
+  if (prefs.begin(NVS_NAMESPACE, false)) {
+    prefs.putBytes(NVS_CHECKPOINT_KEY, &cp, sizeof(cp));
+    prefs.end();
+  }
+}
@@ -0,0 +1,132 @@
+/**
+ * @file ColumnarArchive.h
+ * @brief Gravador do arquivo colunar de telemetria (telemetry.col)
+ *
+ * @details Cópia opcional da telemetria organizada por coluna, para
+ *          análise pós-voo que lê poucos campos de missões inteiras:
+ *          - Registros acumulados em RAM (SD_COLUMNAR_GROUP por grupo)
+ *          - Grupo gravado pela StorageTask ociosa, um chunk por coluna
+ *          - Grupo parcial gravado após SD_COLUMNAR_MAX_AGE_MS
+ *          - Fim lógico e índice do grupo em checkpoint na NVS
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## RAM
+ * | Buffer      | Tamanho                               |
+ * |-------------|---------------------------------------|
+ * | Registros   | SD_COLUMNAR_GROUP x 115 bytes          |
+ * | Seq         | SD_COLUMNAR_GROUP x 4 bytes            |
+ * | Chunk       | maxChunkBytes(SD_COLUMNAR_GROUP)       |
+ *
+ * @note Formato em ColumnarFormat.h; leitura no PC em tools/colarch_reader.h
+ * @warning Registros do grupo em RAM se perdem em um reset
+ */
+
+#ifndef COLUMNAR_ARCHIVE_H
+#define COLUMNAR_ARCHIVE_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "ColumnarFormat.h"
+
+/**
+ * @class ColumnarArchive
+ * @brief Acumula registros e grava grupos colunares no SD
+ */
+class ColumnarArchive {
+public:
+    /**
+     * @brief Construtor
+     * @param path Arquivo colunar no SD
+     */
+    explicit ColumnarArchive(const char* path);
+
+    //=========================================================================
+    // CICLO DE VIDA
+    //=========================================================================
+
+    /**
+     * @brief Abre (ou cria) o arquivo e descarta grupo rasgado na cauda
+     * @param createdUnix Timestamp gravado em arquivo novo
+     * @return true se pronto para gravar
+     */
+    bool begin(uint32_t createdUnix);
+
+    /**
+     * @brief Renomeia o arquivo e começa outro
+     * @param backupPath Nome final do arquivo rotacionado
+     * @note Grupo em RAM é mantido e vai para o arquivo novo
+     */
+    bool rotate(const char* backupPath, uint32_t createdUnix);
+
+    //=========================================================================
+    // GRAVAÇÃO
+    //=========================================================================
+
+    /**
+     * @brief Acrescenta um registro ao grupo em RAM (sem I/O)
+     * @return false se o grupo está cheio (flush() pendente)
+     */
+    bool add(uint32_t seq, const BinLog::TelemetryRecord& rec);
+
+    /** @brief Grupo cheio ou velho o bastante para gravar? */
+    bool isDue() const;
+
+    /**
+     * @brief Grava o grupo em RAM (chunks, diretório e cabeçalho)
+     * @return true se nada pendente ou gravado com sucesso
+     */
+    bool flush();
+
+    //=========================================================================
+    // STATUS
+    //=========================================================================
+
+    /** @brief Arquivo aberto? */
+    bool isOpen() const { return _opened; }
+
+    /** @brief Bytes válidos no arquivo */
+    uint32_t size() const { return _end; }
+
+    /** @brief Registros aguardando gravação */
+    uint16_t pending() const { return _count; }
+
+    /** @brief Caminho do arquivo ativo */
+    const char* path() const { return _path; }
+
+private:
+    //=========================================================================
+    // ESTADO
+    //=========================================================================
+    const char* _path;              ///< Arquivo ativo
+    bool _opened;                   ///< begin() concluído?
+    uint32_t _end;                  ///< Fim do último grupo completo
+    uint32_t _groupIndex;           ///< Índice do próximo grupo
+    uint16_t _count;                ///< Registros em _records
+    unsigned long _firstAddMs;      ///< millis() do primeiro registro do grupo
+
+    BinLog::TelemetryRecord _records[SD_COLUMNAR_GROUP]; ///< Grupo em RAM
+    uint32_t _seqs[SD_COLUMNAR_GROUP];                   ///< Seq por registro
+    uint8_t _chunk[ColArch::maxChunkBytes(SD_COLUMNAR_GROUP)]; ///< Chunk codificado
+
+    //=========================================================================
+    // MÉTODOS PRIVADOS
+    //=========================================================================
+
+    /** @brief Cria arquivo com FileHeader */
+    bool _create(uint32_t createdUnix);
+
+    /** @brief Acha o fim do último grupo íntegro a partir de from */
+    uint32_t _scanGroups(File& file, uint32_t from, uint32_t size);
+
+    /** @brief Grava fim lógico e índice do grupo na NVS */
+    void _storeCheckpoint();
+};
+
+#endif // COLUMNAR_ARCHIVE_H
@@ -0,0 +1,517 @@
+/**
+ * @file ColumnarFormat.h
+ * @brief Arquivo colunar de telemetria: layout, codificadores e decodificador
+ *
+ * @details Define o arquivo "telemetry.col" gravado pelo ColumnarArchive:
+ *          - Registros agrupados (grupos de até SD_COLUMNAR_GROUP registros)
+ *          - Cada campo do BinLog::TelemetryRecord vira um chunk por grupo
+ *          - Inteiros: delta + zigzag + varint (LEB128)
+ *          - Floats: XOR com o valor anterior (estilo Gorilla, em bits)
+ *          - Diretório de chunks por grupo: ler uma coluna custa o
+ *            tamanho dela mais um cabeçalho fixo por grupo
+ *
+ *          Este header não depende do framework Arduino: é compartilhado
+ *          com as ferramentas de host em tools/ (leitor colunar).
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Layout do Arquivo
+ * ```
+ * offset 0      FileHeader (32 bytes)
+ * offset 32     Grupo 0: GroupHeader (36) + ChunkEntry[colunas] (12 cada)
+ *                        + chunks na ordem de COLUMNS
+ * ...           Grupo 1, 2, ... (GroupHeader::groupBytes até o próximo)
+ * ```
+ *
+ * ## Chunk Float (bits MSB primeiro)
+ * | Caso                        | Bits                                    |
+ * |-----------------------------|-----------------------------------------|
+ * | Primeiro valor              | 32 bits do float                        |
+ * | XOR == 0                    | `0`                                     |
+ * | Cabe na janela anterior     | `10` + bits significativos da janela    |
+ * | Janela nova                 | `11` + zeros à esquerda (5) + tam-1 (5) + bits |
+ *
+ * O cabeçalho do grupo é gravado por último: grupo rasgado por reset tem
+ * magic zerado e encerra a leitura.
+ *
+ * @note Todos os campos são little-endian (nativo do ESP32 e x86)
+ * @see tools/colarch_reader.h para leitura de colunas no PC
+ */
+
+#ifndef COLUMNAR_FORMAT_H
+#define COLUMNAR_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "BinaryLogFormat.h"
+
+namespace ColArch {
+
+//=============================================================================
+// CONSTANTES DO FORMATO
+//=============================================================================
+constexpr uint32_t FILE_MAGIC     = 0x4C4F4341UL; ///< "ACOL" em little-endian
+constexpr uint32_t GROUP_MAGIC    = 0x50524741UL; ///< "AGRP" em little-endian
+constexpr uint8_t  FORMAT_VERSION = 1;            ///< Versão do arquivo
+constexpr uint8_t  NO_OFFSET      = 0xFF;         ///< Coluna fora do registro (Seq)
+
+/**
+ * @enum ColumnType
+ * @brief Codificação e interpretação de uma coluna
+ */
+enum ColumnType : uint8_t {
+    COL_UNSIGNED = 0,   ///< Inteiro sem sinal (delta + zigzag + varint)
+    COL_SIGNED,         ///< Inteiro com sinal (delta + zigzag + varint)
+    COL_DEGREES_E7,     ///< Graus * 1e7 em int32 (codificado como COL_SIGNED)
+    COL_FLOAT           ///< float IEEE-754 (XOR)
+};
+
+/**
+ * @struct Column
+ * @brief Campo do TelemetryRecord armazenado como coluna
+ */
+struct Column {
+    const char* name;   ///< Nome da coluna no CSV de telemetria
+    uint8_t offset;     ///< Offset no TelemetryRecord (NO_OFFSET = Seq)
+    uint8_t size;       ///< Bytes do campo (1, 2 ou 4)
+    uint8_t type;       ///< ColumnType
+};
+
+#define COLARCH_FIELD(name, field, type) \
+    { name, (uint8_t)offsetof(BinLog::TelemetryRecord, field), \
+      (uint8_t)sizeof(((BinLog::TelemetryRecord*)0)->field), type }
+#define COLARCH_AXIS(name, field, axis) \
+    { name, (uint8_t)(offsetof(BinLog::TelemetryRecord, field) + 4 * (axis)), \
+      4, COL_FLOAT }
+
+/** @brief Colunas na ordem dos chunks (nomes do cabeçalho CSV) */
+static const Column COLUMNS[] = {
+    { "Seq", NO_OFFSET, 4, COL_UNSIGNED },
+    COLARCH_FIELD("UnixTimestamp", unixTime, COL_UNSIGNED),
+    COLARCH_FIELD("MissionTime", missionTime, COL_UNSIGNED),
+    COLARCH_FIELD("BatVoltage", batteryVoltage, COL_FLOAT),
+    COLARCH_FIELD("BatPercent", batteryPercentage, COL_FLOAT),
+    COLARCH_FIELD("TempFinal", temperature, COL_FLOAT),
+    COLARCH_FIELD("TempBMP", temperatureBMP, COL_FLOAT),
+    COLARCH_FIELD("TempSI", temperatureSI, COL_FLOAT),
+    COLARCH_FIELD("Pressure", pressure, COL_FLOAT),
+    COLARCH_FIELD("Altitude", altitude, COL_FLOAT),
+    COLARCH_FIELD("Lat", latitudeE7, COL_DEGREES_E7),
+    COLARCH_FIELD("Lng", longitudeE7, COL_DEGREES_E7),
+    COLARCH_FIELD("GpsAlt", gpsAltitude, COL_FLOAT),
+    COLARCH_FIELD("Sats", satellites, COL_UNSIGNED),
+    COLARCH_FIELD("Flags", flags, COL_UNSIGNED),
+    COLARCH_AXIS("GyroX", gyro, 0),
+    COLARCH_AXIS("GyroY", gyro, 1),
+    COLARCH_AXIS("GyroZ", gyro, 2),
+    COLARCH_AXIS("AccelX", accel, 0),
+    COLARCH_AXIS("AccelY", accel, 1),
+    COLARCH_AXIS("AccelZ", accel, 2),
+    COLARCH_AXIS("MagX", mag, 0),
+    COLARCH_AXIS("MagY", mag, 1),
+    COLARCH_AXIS("MagZ", mag, 2),
+    COLARCH_FIELD("Humidity", humidity, COL_FLOAT),
+    COLARCH_FIELD("CO2", co2, COL_FLOAT),
+    COLARCH_FIELD("TVOC", tvoc, COL_FLOAT),
+    COLARCH_FIELD("Status", systemStatus, COL_UNSIGNED),
+    COLARCH_FIELD("Errors", errorCount, COL_UNSIGNED),
+    COLARCH_FIELD("Uptime", uptime, COL_UNSIGNED),
+    COLARCH_FIELD("ResetCnt", resetCount, COL_UNSIGNED),
+    COLARCH_FIELD("MinHeap", minFreeHeap, COL_UNSIGNED),
+    COLARCH_FIELD("CpuTemp", cpuTemp, COL_FLOAT),
+};
+
+#undef COLARCH_FIELD
+#undef COLARCH_AXIS
+
+constexpr uint8_t COLUMN_COUNT = sizeof(COLUMNS) / sizeof(COLUMNS[0]);
+
+//=============================================================================
+// ESTRUTURAS ON-DISK
+//=============================================================================
+
+/**
+ * @struct FileHeader
+ * @brief Cabeçalho do arquivo (offset 0)
+ */
+struct __attribute__((packed)) FileHeader {
+    uint32_t magic;          ///< FILE_MAGIC
+    uint8_t  version;        ///< FORMAT_VERSION
+    uint8_t  columnCount;    ///< COLUMN_COUNT
+    uint16_t groupRecords;   ///< Registros por grupo configurados
+    uint32_t layoutCrc32;    ///< layoutCrc(): colunas com que foi gravado
+    uint32_t createdUnix;    ///< Criação (0 = RTC indisponível)
+    uint8_t  reserved[12];   ///< Zero
+    uint32_t crc32;          ///< CRC-32 dos 28 bytes anteriores
+};
+
+/**
+ * @struct GroupHeader
+ * @brief Cabeçalho de um grupo de registros
+ */
+struct __attribute__((packed)) GroupHeader {
+    uint32_t magic;          ///< GROUP_MAGIC (0 = grupo incompleto)
+    uint32_t groupIndex;     ///< Índice do grupo no arquivo
+    uint32_t firstSeq;       ///< Seq do primeiro registro
+    uint16_t recordCount;    ///< Registros no grupo
+    uint8_t  columnCount;    ///< Entradas no diretório
+    uint8_t  reserved;       ///< Zero
+    uint32_t firstUnix;      ///< Timestamp do primeiro registro
+    uint32_t lastUnix;       ///< Timestamp do último registro
+    uint32_t groupBytes;     ///< Cabeçalho + diretório + chunks
+    uint32_t dirCrc32;       ///< CRC-32 do diretório
+    uint32_t crc32;          ///< CRC-32 dos 32 bytes anteriores
+};
+
+/**
+ * @struct ChunkEntry
+ * @brief Entrada do diretório (uma por coluna)
+ */
+struct __attribute__((packed)) ChunkEntry {
+    uint32_t offset;         ///< Início do chunk (a partir do GroupHeader)
+    uint32_t size;           ///< Bytes do chunk
+    uint32_t crc32;          ///< CRC-32 do chunk
+};
+
+static_assert(sizeof(FileHeader) == 32, "FileHeader deve ter 32 bytes");
+static_assert(sizeof(GroupHeader) == 36, "GroupHeader deve ter 36 bytes");
+static_assert(sizeof(ChunkEntry) == 12, "ChunkEntry deve ter 12 bytes");
+
+/** @brief Offset do diretório + chunks: cabeçalho do grupo e diretório */
+constexpr uint32_t GROUP_PREFIX =
+    sizeof(GroupHeader) + COLUMN_COUNT * sizeof(ChunkEntry);
+
+/** @brief Pior caso de um chunk com n valores (float: 44 bits/valor) */
+constexpr size_t maxChunkBytes(uint16_t n) { return (size_t)n * 6 + 8; }
+
+//=============================================================================
+// FUNÇÕES AUXILIARES
+//=============================================================================
+
+/** @brief CRC-32 dos nomes, tamanhos e tipos das colunas */
+inline uint32_t layoutCrc() {
+    uint32_t crc = 0;
+    for (uint8_t i = 0; i < COLUMN_COUNT; i++) {
+        crc = BinLog::crc32(crc, COLUMNS[i].name, strlen(COLUMNS[i].name));
+        crc = BinLog::crc32(crc, &COLUMNS[i].size, 1);
+        crc = BinLog::crc32(crc, &COLUMNS[i].type, 1);
+    }
+    return crc;
+}
+
+/** @brief Cabeçalho de arquivo válido para este layout? */
+inline bool isValidFileHeader(const FileHeader& h) {
+    return h.magic == FILE_MAGIC && h.version == FORMAT_VERSION &&
+           h.columnCount == COLUMN_COUNT && h.layoutCrc32 == layoutCrc() &&
+           h.crc32 == BinLog::crc32(0, &h, sizeof(h) - sizeof(uint32_t));
+}
+
+/** @brief Cabeçalho de grupo completo e íntegro? */
+inline bool isValidGroupHeader(const GroupHeader& g) {
+    return g.magic == GROUP_MAGIC && g.columnCount == COLUMN_COUNT &&
+           g.recordCount > 0 && g.groupBytes >= GROUP_PREFIX &&
+           g.crc32 == BinLog::crc32(0, &g, sizeof(g) - sizeof(uint32_t));
+}
+
+/** @brief Valor bruto (até 32 bits) da coluna col no registro */
+inline uint32_t fieldValue(uint8_t col, uint32_t seq,
+                           const BinLog::TelemetryRecord& rec) {
+    const Column& c = COLUMNS[col];
+    if (c.offset == NO_OFFSET)
+        return seq;
+    uint32_t v = 0;
+    memcpy(&v, (const uint8_t*)&rec + c.offset, c.size);
+    return v;
+}
+
+/** @brief Grava o valor bruto da coluna col no registro (Seq ignorado) */
+inline void setFieldValue(uint8_t col, uint32_t raw,
+                          BinLog::TelemetryRecord& rec) {
+    const Column& c = COLUMNS[col];
+    if (c.offset != NO_OFFSET)
+        memcpy((uint8_t*)&rec + c.offset, &raw, c.size);
+}
+
+/** @brief Inteiro com sinal estendido a partir do tamanho do campo */
+inline int64_t signedValue(const Column& c, uint32_t raw) {
+    if (c.type == COL_UNSIGNED)
+        return raw;
+    if (c.size == 1)
+        return (int8_t)raw;
+    if (c.size == 2)
+        return (int16_t)raw;
+    return (int32_t)raw;
+}
+
+/** @brief Valor numérico para análise (graus, float, inteiro) */
+inline double toDouble(uint8_t col, uint32_t raw) {
+    const Column& c = COLUMNS[col];
+    if (c.type == COL_FLOAT) {
+        float f;
+        memcpy(&f, &raw, sizeof(f));
+        return f;
+    }
+    if (c.type == COL_DEGREES_E7)
+        return (int32_t)raw / 1e7;
+    return (double)signedValue(c, raw);
+}
+
+//=============================================================================
+// FLUXO DE BITS (MSB PRIMEIRO)
+//=============================================================================
+
+/**
+ * @class BitWriter
+ * @brief Escrita de bits em buffer limitado
+ */
+class BitWriter {
+public:
+    BitWriter(uint8_t* out, size_t size) : _out(out), _size(size), _pos(0),
+                                           _acc(0), _bits(0), _overflow(false) {}
+
+    /** @brief Acrescenta os n bits menos significativos de v (n <= 32) */
+    void put(uint32_t v, uint8_t n) {
+        while (n > 0) {
+            uint8_t take = (n > 8) ? 8 : n;
+            n -= take;
+            _acc = (_acc << take) | ((v >> n) & ((1u << take) - 1));
+            _bits += take;
+            if (_bits >= 8) {
+                _bits -= 8;
+                _emit((uint8_t)(_acc >> _bits));
+            }
+        }
+    }
+
+    /** @brief Completa o último byte com zeros; retorna bytes (0 = estouro) */
+    size_t finish() {
+        if (_bits > 0) {
+            _emit((uint8_t)(_acc << (8 - _bits)));
+            _bits = 0;
+        }
+        return _overflow ? 0 : _pos;
+    }
+
+private:
+    void _emit(uint8_t b) {
+        if (_pos < _size)
+            _out[_pos++] = b;
+        else
+            _overflow = true;
+    }
+
+    uint8_t* _out;
+    size_t _size;
+    size_t _pos;
+    uint32_t _acc;
+    uint8_t _bits;
+    bool _overflow;
+};
+
+/**
+ * @class BitReader
+ * @brief Leitura de bits com verificação de limite
+ */
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : _data(data), _size(size), _bitPos(0) {}
+
+    /** @brief Lê n bits (n <= 32); false se o chunk acabou */
+    bool get(uint8_t n, uint32_t& v) {
+        if (_bitPos + n > _size * 8)
+            return false;
+        v = 0;
+        for (uint8_t i = 0; i < n; i++, _bitPos++) {
+            uint8_t bit = (_data[_bitPos >> 3] >> (7 - (_bitPos & 7))) & 1;
+            v = (v << 1) | bit;
+        }
+        return true;
+    }
+
+private:
+    const uint8_t* _data;
+    size_t _size;
+    size_t _bitPos;
+};
+
+//=============================================================================
+// CODIFICAÇÃO
+//=============================================================================
+
+/** @brief Zeros à esquerda de um valor de 32 bits não nulo */
+inline uint8_t leadingZeros(uint32_t v) {
+    uint8_t n = 0;
+    while (!(v & 0x80000000UL)) {
+        v <<= 1;
+        n++;
+    }
+    return n;
+}
+
+/** @brief Zeros à direita de um valor de 32 bits não nulo */
+inline uint8_t trailingZeros(uint32_t v) {
+    uint8_t n = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Codifica n valores brutos de uma coluna
+ * @param col Índice em COLUMNS
+ * @param out Destino (maxChunkBytes(n) sempre basta)
+ * @return Bytes do chunk (0 se não coube em outSize)
+ */
+inline size_t encodeChunk(uint8_t col, const uint32_t* values, uint16_t n,
+                          uint8_t* out, size_t outSize) {
+    const Column& c = COLUMNS[col];
+
+    if (c.type != COL_FLOAT) {
+        // Delta + zigzag + varint (LEB128)
+        size_t pos = 0;
+        int64_t prev = 0;
+        for (uint16_t i = 0; i < n; i++) {
+            int64_t v = signedValue(c, values[i]);
+            int64_t d = v - prev;
+            prev = v;
+            uint64_t z = ((uint64_t)d << 1) ^ (uint64_t)(d >> 63);
+            do {
+                if (pos >= outSize)
+                    return 0;
+                uint8_t b = z & 0x7F;
+                z >>= 7;
+                out[pos++] = z ? (b | 0x80) : b;
+            } while (z);
+        }
+        return pos;
+    }
+
+    // XOR com o anterior, reaproveitando a janela de bits significativos
+    BitWriter w(out, outSize);
+    uint32_t prev = 0;
+    uint8_t lead = 0xFF, trail = 0;
+    for (uint16_t i = 0; i < n; i++) {
+        uint32_t v = values[i];
+        if (i == 0) {
+            w.put(v, 32);
+            prev = v;
+            continue;
+        }
+        uint32_t x = v ^ prev;
+        prev = v;
+        if (x == 0) {
+            w.put(0, 1);
+            continue;
+        }
+        uint8_t l = leadingZeros(x);
+        uint8_t t = trailingZeros(x);
+        if (lead != 0xFF && l >= lead && t >= trail) {
+            w.put(2, 2);
+            w.put(x >> trail, 32 - lead - trail);
+        } else {
+            if (l > 31)
+                l = 31;
+            uint8_t len = 32 - l - t;
+            w.put(3, 2);
+            w.put(l, 5);
+            w.put(len - 1, 5);
+            w.put(x >> t, len);
+            lead = l;
+            trail = t;
+        }
+    }
+    return w.finish();
+}
+
+/**
+ * @class ChunkDecoder
+ * @brief Decodifica um chunk valor a valor (sem alocação)
+ */
+class ChunkDecoder {
+public:
+    ChunkDecoder(uint8_t col, const uint8_t* data, size_t size)
+        : _col(col), _data(data), _size(size), _pos(0), _bits(data, size),
+          _first(true), _prevInt(0), _prev(0), _lead(0), _trail(0) {}
+
+    /**
+     * @brief Próximo valor bruto da coluna
+     * @return false se o chunk terminou ou está corrompido
+     */
+    bool next(uint32_t& raw) {
+        if (COLUMNS[_col].type != COL_FLOAT) {
+            uint64_t z = 0;
+            uint8_t shift = 0;
+            uint8_t b;
+            do {
+                if (_pos >= _size || shift > 63)
+                    return false;
+                b = _data[_pos++];
+                z |= (uint64_t)(b & 0x7F) << shift;
+                shift += 7;
+            } while (b & 0x80);
+            int64_t d = (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+            _prevInt += d;
+            raw = (uint32_t)_prevInt;
+            return true;
+        }
+
+        uint32_t v;
+        if (_first) {
+            if (!_bits.get(32, v))
+                return false;
+            _first = false;
+            _prev = raw = v;
+            return true;
+        }
+        if (!_bits.get(1, v))
+            return false;
+        if (v == 0) {
+            raw = _prev;
+            return true;
+        }
+        if (!_bits.get(1, v))
+            return false;
+        if (v == 1) {
+            uint32_t l, len;
+            if (!_bits.get(5, l) || !_bits.get(5, len))
+                return false;
+            len += 1;
+            if (l + len > 32)
+                return false;
+            _lead = l;
+            _trail = 32 - l - len;
+        }
+        uint32_t x;
+        if (!_bits.get(32 - _lead - _trail, x))
+            return false;
+        _prev ^= x << _trail;
+        raw = _prev;
+        return true;
+    }
+
+private:
+    uint8_t _col;
+    const uint8_t* _data;
+    size_t _size;
+    size_t _pos;         ///< Posição em bytes (inteiros)
+    BitReader _bits;     ///< Fluxo de bits (floats)
+    bool _first;
+    int64_t _prevInt;
+    uint32_t _prev;
+    uint8_t _lead;
+    uint8_t _trail;
+};
+
+} // namespace ColArch
+
+#endif // COLUMNAR_FORMAT_H
@@ -0,0 +1,226 @@
+/**
+ * @file FallbackLog.cpp
+ * @brief Implementação do log circular na flash interna
+ */
+
+#include "FallbackLog.h"
+#include "BinaryLogFormat.h"
+#include <Preferences.h>
+
+static const char *NVS_NAMESPACE = "storage";
+static const char *NVS_CURSOR_KEY = "fb_cursor";
+
+FallbackLog::FallbackLog()
+    : _mounted(false), _hasSegments(false), _firstSeg(0), _lastSeg(0),
+      _lastSize(0), _stored(0), _droppedSegments(0), _bufSinceMs(0),
+      _bufLen(0) {
+  _cursor.segment = 0;
+  _cursor.offset = 0;
+}
+
+bool FallbackLog::begin() {
+  if (_mounted)
+    return true;
+
+  // Partição "spiffs" da tabela padrão; formatada se não montar
+  if (!LittleFS.begin(true)) {
+    Serial.println("[FallbackLog] ERRO: LittleFS indisponivel.");
+    return false;
+  }
+  if (!LittleFS.exists(FALLBACK_DIR))
+    LittleFS.mkdir(FALLBACK_DIR);
+
+  Preferences prefs;
+  if (prefs.begin(NVS_NAMESPACE, true)) {
+    if (prefs.getBytes(NVS_CURSOR_KEY, &_cursor, sizeof(_cursor)) !=
+        sizeof(_cursor))
+      _cursor.segment = _cursor.offset = 0;
+    prefs.end();
+  }
+
+  // Segmentos existentes: sequência em hexadecimal no nome
+  _hasSegments = false;
+  File dir = LittleFS.open(FALLBACK_DIR);
+  if (dir) {
+    for (File entry = dir.openNextFile(); entry; entry = dir.openNextFile()) {
+      const char *name = entry.name();
+      const char *slash = strrchr(name, '/');
+      if (slash != nullptr)
+        name = slash + 1;
+      char *end;
+      uint32_t seq = strtoul(name, &end, 16);
+      entry.close();
+      if (end == name || strcmp(end, ".seg") != 0)
+        continue;
+      if (!_hasSegments || seq < _firstSeg)
+        _firstSeg = seq;
+      if (!_hasSegments || seq > _lastSeg)
+        _lastSeg = seq;
+      _hasSegments = true;
+    }
+    dir.close();
+  }
+
+  if (_hasSegments) {
+    if (_cursor.segment < _firstSeg || _cursor.segment > _lastSeg) {
+      _cursor.segment = _firstSeg;
+      _cursor.offset = 0;
+    }
+    Serial.printf("[FallbackLog] %lu segmento(s) pendente(s) na flash.\n",
+                  (unsigned long)(_lastSeg - _firstSeg + 1));
+  }
+
+  // A cauda do último segmento pode estar rasgada: novos registros sempre
+  // começam um segmento novo após o boot
+  _lastSize = FALLBACK_SEGMENT_BYTES;
+  _mounted = true;
+  return true;
+}
+
+bool FallbackLog::append(Kind kind, const void *data, size_t len) {
+  if (!_mounted || len == 0 || len > MAX_RECORD)
+    return false;
+
+  size_t need = sizeof(RecordHeader) + len;
+  if (_bufLen + need > sizeof(_buffer) && !flush(true))
+    return false;
+
+  RecordHeader h;
+  h.magic = RECORD_MAGIC;
+  h.kind = kind;
+  h.len = (uint16_t)len;
+  h.crc32 = _recordCrc(kind, h.len, (const uint8_t *)data);
+
+  if (_bufLen == 0)
+    _bufSinceMs = millis();
+  memcpy(_buffer + _bufLen, &h, sizeof(h));
+  memcpy(_buffer + _bufLen + sizeof(h), data, len);
+  _bufLen += need;
+  _stored++;
+  return true;
+}
+
+bool FallbackLog::flush(bool force) {
+  if (_bufLen == 0)
+    return true;
+  if (!force && millis() - _bufSinceMs < FALLBACK_FLUSH_MS)
+    return true;
+
+  if (!_hasSegments || _lastSize + _bufLen > FALLBACK_SEGMENT_BYTES)
+    _startSegment();
+
+  char path[24];
+  _segmentPath(_lastSeg, path, sizeof(path));
+  File file = LittleFS.open(path, FILE_APPEND);
+  bool ok = file && file.write(_buffer, _bufLen) == _bufLen;
+  if (file)
+    file.close();
+  if (!ok) {
+    // Buffer retido travaria o anel (e a migração): descartado
+    Serial.printf("[FallbackLog] ERRO: Falha ao gravar %s, %u bytes perdidos\n",
+                  path, (unsigned)_bufLen);
+    _bufLen = 0;
+    return false;
+  }
+
+  _lastSize += _bufLen;
+  _bufLen = 0;
+  return true;
+}
+
+uint16_t FallbackLog::migrate(RecordSink sink, void *ctx,
+                              uint16_t maxRecords) {
+  if (!_mounted)
+    return 0;
+  flush(true);
+
+  uint16_t done = 0;
+  uint8_t data[MAX_RECORD];
+  while (_hasSegments && done < maxRecords) {
+    char path[24];
+    _segmentPath(_cursor.segment, path, sizeof(path));
+    File file = LittleFS.open(path, FILE_READ);
+
+    // Segmento ausente conta como esgotado
+    bool exhausted = !file || !file.seek(_cursor.offset);
+    while (!exhausted && done < maxRecords) {
+      RecordHeader h;
+      if (file.read((uint8_t *)&h, sizeof(h)) != sizeof(h) ||
+          h.magic != RECORD_MAGIC || h.len > MAX_RECORD ||
+          file.read(data, h.len) != h.len ||
+          _recordCrc(h.kind, h.len, data) != h.crc32) {
+        // Fim do segmento ou registro rasgado
+        exhausted = true;
+        break;
+      }
+      if (!sink((Kind)h.kind, data, h.len, ctx)) {
+        file.close();
+        _storeCursor();
+        return done;
+      }
+      _cursor.offset += sizeof(h) + h.len;
+      done++;
+    }
+    if (file)
+      file.close();
+    if (!exhausted)
+      break;
+    _dropFirst();
+  }
+
+  _storeCursor();
+  return done;
+}
+
+void FallbackLog::_segmentPath(uint32_t seq, char *out, size_t size) {
+  snprintf(out, size, "%s/%08lx.seg", FALLBACK_DIR, (unsigned long)seq);
+}
+
+void FallbackLog::_startSegment() {
+  if (_hasSegments) {
+    _lastSeg++;
+  } else {
+    // Anel vazio: continua a numeração de onde o cursor parou
+    _firstSeg = _lastSeg = _cursor.segment;
+    _cursor.offset = 0;
+    _hasSegments = true;
+  }
+  _lastSize = 0;
+
+  while (_lastSeg - _firstSeg + 1 > FALLBACK_SEGMENTS) {
+    Serial.printf("[FallbackLog] Anel cheio: segmento %08lx descartado.\n",
+                  (unsigned long)_firstSeg);
+    _droppedSegments++;
+    _dropFirst();
+  }
+}
+
+void FallbackLog::_dropFirst() {
+  char path[24];
+  _segmentPath(_firstSeg, path, sizeof(path));
+  LittleFS.remove(path);
+
+  _firstSeg++;
+  if (_cursor.segment < _firstSeg) {
+    _cursor.segment = _firstSeg;
+    _cursor.offset = 0;
+  }
+  if (_firstSeg > _lastSeg)
+    _hasSegments = false;
+  _storeCursor();
+}
+
+void FallbackLog::_storeCursor() {
+  Preferences prefs;
+  if (prefs.begin(NVS_NAMESPACE, false)) {
+    prefs.putBytes(NVS_CURSOR_KEY, &_cursor, sizeof(_cursor));
+    prefs.end();
+  }
+}
+
+uint32_t FallbackLog::_recordCrc(uint8_t kind, uint16_t len,
+                                 const uint8_t *data) {
+  uint32_t crc = BinLog::crc32(0, &kind, sizeof(kind));
+  crc = BinLog::crc32(crc, &len, sizeof(len));
+  return BinLog::crc32(crc, data, len);
+}
@@ -0,0 +1,187 @@
+/**
+ * @file FallbackLog.h
+ * @brief Log circular na flash interna (LittleFS) enquanto o SD está fora
+ *
+ * @details Assume a gravação quando o SD Card falha ou não monta:
+ *          - Registros no mesmo formato do SD (campos CSV ou
+ *            BinLog::TelemetryRecord), com CRC-32 por registro
+ *          - Anel de FALLBACK_SEGMENTS arquivos de FALLBACK_SEGMENT_BYTES:
+ *            tamanho limitado, o segmento mais antigo é descartado
+ *          - Escritas agrupadas em RAM (FALLBACK_BUFFER_BYTES ou
+ *            FALLBACK_FLUSH_MS): menos ciclos de programação da flash
+ *          - Migração para o SD em lotes, do mais antigo para o mais novo,
+ *            com cursor persistido na NVS (reset não duplica registros)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Formato
+ * Segmento "/fb/<seq hex>.seg", sequência crescente a cada segmento novo:
+ * | Campo  | Tipo     | Descrição                           |
+ * |--------|----------|-------------------------------------|
+ * | magic  | uint8_t  | RECORD_MAGIC                        |
+ * | kind   | uint8_t  | Kind (destino no SD)                |
+ * | len    | uint16_t | Bytes de dados                      |
+ * | crc32  | uint32_t | CRC-32 de kind, len e dados         |
+ * | dados  | len      | Campos CSV / TelemetryRecord / linha |
+ *
+ * Seq e CRC-16 das linhas CSV são atribuídos na migração, pelo log de
+ * destino: a sequência no SD continua sem lacunas.
+ *
+ * @note Registro rasgado (reset durante o flush) encerra o segmento
+ * @warning Até FALLBACK_FLUSH_MS de registros ficam só em RAM
+ */
+
+#ifndef FALLBACK_LOG_H
+#define FALLBACK_LOG_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "config.h"
+
+/**
+ * @class FallbackLog
+ * @brief Anel de segmentos no LittleFS com migração para o SD
+ */
+class FallbackLog {
+public:
+    /**
+     * @enum Kind
+     * @brief Destino do registro no SD
+     */
+    enum Kind : uint8_t {
+        KIND_TELEMETRY_CSV = 1,  ///< Campos CSV -> telemetry.csv
+        KIND_TELEMETRY_BIN,      ///< BinLog::TelemetryRecord -> telemetry.bin
+        KIND_MISSION_CSV,        ///< Campos CSV -> mission.csv
+        KIND_SYSTEM              ///< "[ts] mensagem" -> system.log
+    };
+
+    /**
+     * @brief Recebe um registro na migração
+     * @return false para interromper (registro fica para a próxima vez)
+     */
+    typedef bool (*RecordSink)(Kind kind, const uint8_t* data, size_t len,
+                               void* ctx);
+
+    static constexpr size_t MAX_RECORD = 512;  ///< Maior registro aceito
+
+    /**
+     * @brief Construtor
+     */
+    FallbackLog();
+
+    //=========================================================================
+    // CICLO DE VIDA
+    //=========================================================================
+
+    /**
+     * @brief Monta o LittleFS (formata se corrompido) e localiza o anel
+     * @return true se a partição está pronta
+     * @note Idempotente: chamadas seguintes não remontam
+     */
+    bool begin();
+
+    //=========================================================================
+    // GRAVAÇÃO (SD indisponível)
+    //=========================================================================
+
+    /**
+     * @brief Acrescenta um registro ao buffer em RAM
+     * @return true se aceito (flush automático ao encher)
+     */
+    bool append(Kind kind, const void* data, size_t len);
+
+    /**
+     * @brief Grava o buffer no segmento corrente
+     * @param force false = só se o buffer tiver mais de FALLBACK_FLUSH_MS
+     * @return true se nada pendente ou gravado com sucesso
+     */
+    bool flush(bool force);
+
+    //=========================================================================
+    // MIGRAÇÃO (SD recuperado)
+    //=========================================================================
+
+    /**
+     * @brief Entrega até maxRecords registros, do mais antigo
+     * @return Registros entregues e aceitos pelo sink
+     * @note Segmento esvaziado é removido; cursor salvo na NVS
+     */
+    uint16_t migrate(RecordSink sink, void* ctx, uint16_t maxRecords);
+
+    /** @brief Há registros na flash ou no buffer? */
+    bool hasPending() const { return _bufLen > 0 || _hasSegments; }
+
+    //=========================================================================
+    // STATUS
+    //=========================================================================
+
+    /** @brief LittleFS montado? */
+    bool isMounted() const { return _mounted; }
+
+    /** @brief Registros aceitos desde o boot */
+    uint32_t getStoredRecords() const { return _stored; }
+
+    /** @brief Segmentos descartados pelo anel (dados perdidos) */
+    uint16_t getDroppedSegments() const { return _droppedSegments; }
+
+private:
+    /**
+     * @struct RecordHeader
+     * @brief Cabeçalho de cada registro no segmento
+     */
+    struct __attribute__((packed)) RecordHeader {
+        uint8_t magic;       ///< RECORD_MAGIC
+        uint8_t kind;        ///< Kind
+        uint16_t len;        ///< Bytes de dados
+        uint32_t crc32;      ///< CRC-32 de kind, len e dados
+    };
+
+    /** @brief Posição de migração persistida */
+    struct Cursor {
+        uint32_t segment;    ///< Segmento em migração
+        uint32_t offset;     ///< Próximo registro no segmento
+    };
+
+    static constexpr uint8_t RECORD_MAGIC = 0xFB;  ///< Sync do registro
+
+    //=========================================================================
+    // ESTADO
+    //=========================================================================
+    bool _mounted;                  ///< LittleFS pronto?
+    bool _hasSegments;              ///< Algum segmento na flash?
+    uint32_t _firstSeg;             ///< Segmento mais antigo
+    uint32_t _lastSeg;              ///< Segmento corrente (escrita)
+    uint32_t _lastSize;             ///< Bytes já gravados em _lastSeg
+    Cursor _cursor;                 ///< Próximo registro a migrar
+    uint32_t _stored;               ///< Registros aceitos
+    uint16_t _droppedSegments;      ///< Segmentos descartados
+    unsigned long _bufSinceMs;      ///< Primeiro registro do buffer
+    size_t _bufLen;                 ///< Bytes em _buffer
+    uint8_t _buffer[FALLBACK_BUFFER_BYTES]; ///< Registros ainda não gravados
+
+    //=========================================================================
+    // MÉTODOS PRIVADOS
+    //=========================================================================
+
+    /** @brief Caminho do segmento seq */
+    static void _segmentPath(uint32_t seq, char* out, size_t size);
+
+    /** @brief Abre segmento novo; descarta o mais antigo se o anel encheu */
+    void _startSegment();
+
+    /** @brief Remove o segmento mais antigo e avança o cursor */
+    void _dropFirst();
+
+    /** @brief Grava cursor na NVS */
+    void _storeCursor();
+
+    /** @brief CRC-32 de kind, len e dados */
+    static uint32_t _recordCrc(uint8_t kind, uint16_t len, const uint8_t* data);
+};
+
+#endif // FALLBACK_LOG_H
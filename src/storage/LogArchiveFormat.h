@@ -0,0 +1,228 @@
+/**
+ * @file LogArchiveFormat.h
+ * @brief Contêiner de logs rotacionados comprimidos (LZSS) e decodificador
+ *
+ * @details Define o layout dos arquivos "<log>.<timestamp>.bak.lzs" gerados
+ *          em segundo plano pelo LogArchiver a partir dos .bak:
+ *          - Cabeçalho autodescritivo (parâmetros do codec + nome original)
+ *          - Fluxo LZSS em bits (janela de 2 KB, estilo heatshrink)
+ *          - Trailer com tamanho e CRC-32 do original
+ *
+ *          Este header não depende do framework Arduino: é compartilhado
+ *          com as ferramentas de host em tools/ (descompressor).
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Layout do Arquivo
+ * ```
+ * offset 0      Header (64 bytes)
+ * offset 64     Fluxo LZSS (packedSize bytes, último byte completado com 0)
+ * fim - 16      Trailer (16 bytes)
+ * ```
+ *
+ * ## Fluxo LZSS (bits MSB primeiro)
+ * | Token       | Bits                                                  |
+ * |-------------|-------------------------------------------------------|
+ * | Literal     | `1` + byte (8)                                        |
+ * | Referência  | `0` + (distância-1) (windowBits) + (tam-minMatch) (lengthBits) |
+ *
+ * A decodificação termina ao produzir rawSize bytes (bits de
+ * preenchimento ignorados). RAM fixa: janela de 2^windowBits bytes.
+ *
+ * @note Todos os campos são little-endian (nativo do ESP32 e x86)
+ * @see tools/lzlog_extract.cpp para descompressão no PC
+ */
+
+#ifndef LOG_ARCHIVE_FORMAT_H
+#define LOG_ARCHIVE_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "BinaryLogFormat.h"
+
+namespace LogArchive {
+
+//=============================================================================
+// CONSTANTES DO FORMATO
+//=============================================================================
+constexpr uint32_t MAGIC          = 0x5A4C5341UL; ///< "ASLZ" em little-endian
+constexpr uint32_t TRAILER_MAGIC  = 0x444E4541UL; ///< "AEND" em little-endian
+constexpr uint8_t  FORMAT_VERSION = 1;            ///< Versão do contêiner
+constexpr uint8_t  WINDOW_BITS    = 11;           ///< Janela de 2048 bytes
+constexpr uint8_t  LENGTH_BITS    = 5;            ///< Referências de até 34 bytes
+constexpr uint8_t  MIN_MATCH      = 3;            ///< Menor referência codificada
+
+constexpr uint16_t WINDOW_SIZE = 1u << WINDOW_BITS;                        ///< 2048
+constexpr uint16_t MAX_MATCH   = MIN_MATCH + (1u << LENGTH_BITS) - 1;      ///< 34
+
+//=============================================================================
+// ESTRUTURAS ON-DISK
+//=============================================================================
+
+/**
+ * @struct Header
+ * @brief Cabeçalho do contêiner
+ */
+struct __attribute__((packed)) Header {
+    uint32_t magic;          ///< MAGIC
+    uint8_t  version;        ///< FORMAT_VERSION
+    uint8_t  windowBits;     ///< Bits de distância (janela = 2^windowBits)
+    uint8_t  lengthBits;     ///< Bits de comprimento
+    uint8_t  minMatch;       ///< Menor referência codificada
+    uint32_t createdUnix;    ///< Momento da compressão (0 = RTC indisponível)
+    char     sourceName[48]; ///< Nome do arquivo original (sem '/')
+    uint32_t crc32;          ///< CRC-32 dos campos anteriores
+};
+
+/**
+ * @struct Trailer
+ * @brief Fim do contêiner (gravado após o último byte do fluxo)
+ */
+struct __attribute__((packed)) Trailer {
+    uint32_t magic;          ///< TRAILER_MAGIC
+    uint32_t rawSize;        ///< Bytes do arquivo original
+    uint32_t rawCrc32;       ///< CRC-32 do arquivo original
+    uint32_t packedSize;     ///< Bytes do fluxo LZSS
+};
+
+static_assert(sizeof(Header) == 64, "Header deve ter 64 bytes");
+static_assert(sizeof(Trailer) == 16, "Trailer deve ter 16 bytes");
+
+//=============================================================================
+// FUNÇÕES AUXILIARES
+//=============================================================================
+
+using BinLog::crc32;
+
+/** @brief Calcula o CRC do cabeçalho (todos os campos menos o último) */
+inline uint32_t headerCrc(const Header& h) {
+    return crc32(0, &h, sizeof(Header) - sizeof(uint32_t));
+}
+
+/** @brief Cabeçalho íntegro e com parâmetros suportados por Decoder? */
+inline bool isValidHeader(const Header& h) {
+    return h.magic == MAGIC &&
+           h.version == FORMAT_VERSION &&
+           h.windowBits == WINDOW_BITS &&
+           h.lengthBits == LENGTH_BITS &&
+           h.minMatch == MIN_MATCH &&
+           h.crc32 == headerCrc(h);
+}
+
+/**
+ * @class Decoder
+ * @brief Decodificador LZSS em fluxo com RAM fixa (janela + buffer de saída)
+ */
+class Decoder {
+public:
+    /**
+     * @brief Recebe os bytes decodificados
+     * @return false para abortar a decodificação
+     */
+    typedef bool (*Sink)(const uint8_t* data, size_t len, void* ctx);
+
+    /**
+     * @brief Prepara uma nova decodificação
+     * @param rawSize Bytes esperados (Trailer::rawSize)
+     * @param sink Destino dos bytes (nullptr = apenas CRC)
+     * @param ctx Repassado ao sink
+     */
+    void begin(uint32_t rawSize, Sink sink, void* ctx) {
+        _rawSize = rawSize;
+        _produced = 0;
+        _crc = 0;
+        _bits = 0;
+        _bitCount = 0;
+        _outLen = 0;
+        _sink = sink;
+        _ctx = ctx;
+        _failed = false;
+    }
+
+    /**
+     * @brief Consome bytes do fluxo comprimido
+     * @return false se o fluxo é inválido ou o sink abortou
+     */
+    bool feed(const uint8_t* in, size_t len) {
+        for (size_t i = 0; i < len && !_failed && _produced < _rawSize; i++) {
+            _bits = (_bits << 8) | in[i];
+            _bitCount += 8;
+            while (_produced < _rawSize && _bitCount > 0 && !_failed) {
+                bool literal = (_bits >> (_bitCount - 1)) & 1;
+                uint8_t need = literal ? 9 : 1 + WINDOW_BITS + LENGTH_BITS;
+                if (_bitCount < need) break;
+                _bitCount -= need;
+                uint32_t token = (_bits >> _bitCount) & ((1UL << (need - 1)) - 1);
+                if (literal) {
+                    _put((uint8_t)token);
+                    continue;
+                }
+                uint32_t dist = (token >> LENGTH_BITS) + 1;
+                uint32_t count = (token & ((1u << LENGTH_BITS) - 1)) + MIN_MATCH;
+                if (dist > _produced) {
+                    _failed = true;
+                    break;
+                }
+                while (count-- && _produced < _rawSize) {
+                    _put(_window[(_produced - dist) & (WINDOW_SIZE - 1)]);
+                }
+            }
+        }
+        return !_failed;
+    }
+
+    /**
+     * @brief Entrega a saída pendente ao sink
+     * @return true se rawSize bytes foram produzidos sem erro
+     */
+    bool finish() {
+        _flush();
+        return !_failed && _produced == _rawSize;
+    }
+
+    /** @brief Bytes decodificados até agora */
+    uint32_t produced() const { return _produced; }
+
+    /** @brief CRC-32 dos bytes decodificados */
+    uint32_t crc() const { return _crc; }
+
+private:
+    static constexpr size_t OUT_SIZE = 256;  ///< Saída acumulada por chamada ao sink
+
+    uint8_t _window[WINDOW_SIZE];  ///< Últimos bytes produzidos
+    uint8_t _out[OUT_SIZE];        ///< Saída pendente
+    size_t _outLen;                ///< Bytes em _out
+    uint32_t _rawSize;             ///< Bytes esperados
+    uint32_t _produced;            ///< Bytes produzidos
+    uint32_t _crc;                 ///< CRC-32 da saída
+    uint32_t _bits;                ///< Bits ainda não consumidos
+    uint8_t _bitCount;             ///< Bits válidos em _bits
+    Sink _sink;                    ///< Destino da saída
+    void* _ctx;                    ///< Contexto do sink
+    bool _failed;                  ///< Fluxo inválido ou sink abortou
+
+    void _put(uint8_t b) {
+        _window[_produced & (WINDOW_SIZE - 1)] = b;
+        _produced++;
+        _out[_outLen++] = b;
+        if (_outLen == OUT_SIZE) _flush();
+    }
+
+    void _flush() {
+        if (_outLen == 0) return;
+        _crc = crc32(_crc, _out, _outLen);
+        if (_sink != nullptr && !_sink(_out, _outLen, _ctx)) _failed = true;
+        _outLen = 0;
+    }
+};
+
+} // namespace LogArchive
+
+#endif // LOG_ARCHIVE_FORMAT_H
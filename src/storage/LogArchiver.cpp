@@ -0,0 +1,306 @@
+/**
+ * @file LogArchiver.cpp
+ * @brief Implementação da compressão em segundo plano dos logs rotacionados
+ */
+
+#include "LogArchiver.h"
+
+using namespace LogArchive;
+
+// Nome termina com suffix?
+static bool endsWith(const char *name, const char *suffix) {
+  size_t n = strlen(name);
+  size_t s = strlen(suffix);
+  return n > s && strcmp(name + n - s, suffix) == 0;
+}
+
+LogArchiver::LogArchiver()
+    : _phase(PHASE_IDLE), _rawSize(0), _rawDone(0), _rawCrc(0),
+      _verifyOffset(0), _cpuUs(0), _totalUs(0), _sinkUs(0), _dst(nullptr),
+      _lastScanMs(0), _scanDue(false), _skippedCount(0), _failures(0) {
+  _path[0] = '\0';
+  _tmpPath[0] = '\0';
+  memset(&_last, 0, sizeof(_last));
+}
+
+bool LogArchiver::step(uint32_t nowUnix) {
+  if (_phase == PHASE_IDLE) {
+    if (!_scanDue && millis() - _lastScanMs < SD_ARCHIVE_SCAN_MS)
+      return false;
+    _scanDue = false;
+    _lastScanMs = millis();
+    if (_findNext() && !_start(nowUnix))
+      _fail();
+    return false;
+  }
+
+  uint32_t startUs = micros();
+  bool ok = true;
+  if (_phase == PHASE_COMPRESS)
+    ok = _compressSlice();
+  else if (_phase == PHASE_VERIFY)
+    ok = _verifySlice();
+  _totalUs += micros() - startUs;
+
+  if (!ok) {
+    _fail();
+    return false;
+  }
+  return _phase == PHASE_COMMIT && _commit();
+}
+
+void LogArchiver::abort() {
+  if (_phase != PHASE_IDLE)
+    SD.remove(_tmpPath);
+  _phase = PHASE_IDLE;
+}
+
+void LogArchiver::_fail() {
+  Serial.printf("[LogArchiver] ERRO: Falha ao comprimir %s; ignorado ate o "
+                "SD ser remontado\n",
+                _path);
+  abort();
+  _failures++;
+  if (_skippedIndex(_path) >= 0)
+    return;
+  // Lista cheia: o mais antigo volta a ser tentado
+  if (_skippedCount == SD_ARCHIVE_MAX_SKIPPED) {
+    memmove(_skipped[0], _skipped[1], sizeof(_skipped[0]) * (_skippedCount - 1));
+    _skippedCount--;
+  }
+  strncpy(_skipped[_skippedCount], _path, sizeof(_skipped[0]) - 1);
+  _skipped[_skippedCount][sizeof(_skipped[0]) - 1] = '\0';
+  _skippedCount++;
+}
+
+int LogArchiver::_skippedIndex(const char *path) const {
+  for (uint8_t i = 0; i < _skippedCount; i++) {
+    if (strcmp(_skipped[i], path) == 0)
+      return i;
+  }
+  return -1;
+}
+
+bool LogArchiver::_findNext() {
+  File root = SD.open("/");
+  if (!root)
+    return false;
+
+  char stale[72] = "";
+  char path[64];
+  bool found = false;
+  bool seen[SD_ARCHIVE_MAX_SKIPPED] = {};
+  for (File entry = root.openNextFile(); entry; entry = root.openNextFile()) {
+    const char *name = entry.name();
+    if (name[0] == '/')
+      name++;
+    // Colunar rotacionado já é comprimido por coluna: fica como está
+    bool columnar =
+        strncmp(name, SD_COLUMNAR_FILE + 1, sizeof(SD_COLUMNAR_FILE) - 2) == 0;
+    if (endsWith(name, SD_ARCHIVE_SUFFIX ".tmp")) {
+      // Compressão interrompida por reset/falha: recomeça do zero
+      snprintf(stale, sizeof(stale), "/%s", name);
+    } else if (!columnar && endsWith(name, ".bak") &&
+               strlen(name) < sizeof(Header::sourceName)) {
+      snprintf(path, sizeof(path), "/%s", name);
+      int skipped = _skippedIndex(path);
+      if (skipped >= 0) {
+        seen[skipped] = true;
+      } else if (!found) {
+        strcpy(_path, path);
+        found = true;
+      }
+    }
+    entry.close();
+  }
+  root.close();
+
+  if (stale[0] != '\0')
+    SD.remove(stale);
+
+  // Ignorados que a retenção já removeu saem da lista
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < _skippedCount; i++) {
+    if (!seen[i])
+      continue;
+    if (kept != i)
+      memcpy(_skipped[kept], _skipped[i], sizeof(_skipped[0]));
+    kept++;
+  }
+  _skippedCount = kept;
+  return found;
+}
+
+bool LogArchiver::_start(uint32_t nowUnix) {
+  File src = SD.open(_path, FILE_READ);
+  if (!src)
+    return false;
+  _rawSize = src.size();
+  src.close();
+
+  snprintf(_tmpPath, sizeof(_tmpPath), "%s%s.tmp", _path, SD_ARCHIVE_SUFFIX);
+  File dst = SD.open(_tmpPath, FILE_WRITE);
+  if (!dst)
+    return false;
+
+  Header h;
+  memset(&h, 0, sizeof(h));
+  h.magic = MAGIC;
+  h.version = FORMAT_VERSION;
+  h.windowBits = WINDOW_BITS;
+  h.lengthBits = LENGTH_BITS;
+  h.minMatch = MIN_MATCH;
+  h.createdUnix = nowUnix;
+  strncpy(h.sourceName, _path + 1, sizeof(h.sourceName) - 1);
+  h.crc32 = headerCrc(h);
+  bool ok = dst.write((const uint8_t *)&h, sizeof(h)) == sizeof(h);
+  dst.close();
+  if (!ok) {
+    SD.remove(_tmpPath);
+    return false;
+  }
+
+  _encoder.begin(_sink, this);
+  _rawDone = 0;
+  _rawCrc = 0;
+  _cpuUs = 0;
+  _totalUs = 0;
+  _phase = PHASE_COMPRESS;
+  Serial.printf("[LogArchiver] Comprimindo %s (%lu bytes)\n", _path,
+                (unsigned long)_rawSize);
+  return true;
+}
+
+bool LogArchiver::_compressSlice() {
+  File src = SD.open(_path, FILE_READ);
+  File dst = SD.open(_tmpPath, FILE_APPEND);
+  bool ok = src && dst && src.seek(_rawDone);
+
+  _dst = &dst;
+  _sinkUs = 0;
+  uint32_t encodeUs = 0;
+  uint8_t chunk[512];
+  uint32_t budget = SD_ARCHIVE_SLICE_BYTES;
+  while (ok && budget > 0 && _rawDone < _rawSize) {
+    size_t want = sizeof(chunk);
+    if (want > budget)
+      want = budget;
+    if (want > _rawSize - _rawDone)
+      want = _rawSize - _rawDone;
+    int n = src.read(chunk, want);
+    if (n <= 0) {
+      ok = false;
+      break;
+    }
+    uint32_t t = micros();
+    _rawCrc = crc32(_rawCrc, chunk, n);
+    ok = _encoder.write(chunk, n);
+    encodeUs += micros() - t;
+    _rawDone += n;
+    budget -= n;
+  }
+
+  if (ok && _rawDone >= _rawSize) {
+    uint32_t t = micros();
+    ok = _encoder.finish();
+    encodeUs += micros() - t;
+
+    Trailer tr;
+    tr.magic = TRAILER_MAGIC;
+    tr.rawSize = _rawSize;
+    tr.rawCrc32 = _rawCrc;
+    tr.packedSize = _encoder.packedSize();
+    ok = ok && dst.write((const uint8_t *)&tr, sizeof(tr)) == sizeof(tr);
+    if (ok) {
+      _decoder.begin(_rawSize, nullptr, nullptr);
+      _verifyOffset = sizeof(Header);
+      _phase = PHASE_VERIFY;
+    }
+  }
+  _cpuUs += encodeUs > _sinkUs ? encodeUs - _sinkUs : 0;
+  _dst = nullptr;
+
+  if (dst)
+    dst.close();
+  if (src)
+    src.close();
+  return ok;
+}
+
+bool LogArchiver::_verifySlice() {
+  File file = SD.open(_tmpPath, FILE_READ);
+  if (!file)
+    return false;
+  bool ok = file.seek(_verifyOffset);
+
+  uint32_t streamEnd = sizeof(Header) + _encoder.packedSize();
+  uint8_t chunk[512];
+  uint32_t budget = SD_ARCHIVE_SLICE_BYTES;
+  while (ok && budget > 0 && _verifyOffset < streamEnd) {
+    size_t want = sizeof(chunk);
+    if (want > budget)
+      want = budget;
+    if (want > streamEnd - _verifyOffset)
+      want = streamEnd - _verifyOffset;
+    int n = file.read(chunk, want);
+    if (n <= 0) {
+      ok = false;
+      break;
+    }
+    ok = _decoder.feed(chunk, n);
+    _verifyOffset += n;
+    budget -= n;
+  }
+
+  if (ok && _verifyOffset >= streamEnd) {
+    Trailer tr;
+    ok = _decoder.finish() && _decoder.crc() == _rawCrc &&
+         file.read((uint8_t *)&tr, sizeof(tr)) == sizeof(tr) &&
+         tr.magic == TRAILER_MAGIC && tr.rawSize == _rawSize &&
+         tr.rawCrc32 == _rawCrc;
+    if (ok)
+      _phase = PHASE_COMMIT;
+    else
+      Serial.printf("[LogArchiver] ERRO: Verificacao de %s falhou\n",
+                    _tmpPath);
+  }
+  file.close();
+  return ok;
+}
+
+bool LogArchiver::_commit() {
+  char finalPath[72];
+  snprintf(finalPath, sizeof(finalPath), "%s%s", _path, SD_ARCHIVE_SUFFIX);
+
+  // .lzs de uma tentativa anterior interrompida antes de remover o .bak
+  if (SD.exists(finalPath))
+    SD.remove(finalPath);
+  if (!SD.rename(_tmpPath, finalPath)) {
+    _fail();
+    return false;
+  }
+  _phase = PHASE_IDLE;
+  _scanDue = true;
+
+  // Original só sai depois do contêiner verificado estar no lugar. O .idx
+  // fica: offsets do original ainda servem à consulta do .lzs, e a
+  // retenção o remove junto com a unidade
+  SD.remove(_path);
+
+  strncpy(_last.path, finalPath, sizeof(_last.path) - 1);
+  _last.path[sizeof(_last.path) - 1] = '\0';
+  _last.rawBytes = _rawSize;
+  _last.packedBytes =
+      sizeof(Header) + _encoder.packedSize() + sizeof(Trailer);
+  _last.cpuUs = _cpuUs;
+  _last.totalUs = _totalUs;
+  return true;
+}
+
+bool LogArchiver::_sink(const uint8_t *data, size_t len, void *ctx) {
+  LogArchiver *self = static_cast<LogArchiver *>(ctx);
+  uint32_t t = micros();
+  bool ok = self->_dst != nullptr && self->_dst->write(data, len) == len;
+  self->_sinkUs += micros() - t;
+  return ok;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file LogArchiver.h
+ * @brief Compressão em segundo plano dos logs rotacionados (.bak -> .bak.lzs)
+ *
+ * @details Tarefa cooperativa executada pela StorageTask ociosa
+ *          (StorageManager::service()), uma fatia por chamada:
+ *          1. Busca o próximo "*.bak" na raiz do SD
+ *          2. Comprime SD_ARCHIVE_SLICE_BYTES por fatia em "<bak>.lzs.tmp"
+ *          3. Verifica o contêiner descomprimindo-o (CRC-32 do original)
+ *          4. Renomeia para "<bak>.lzs" e só então remove o .bak (o .idx
+ *             fica para a consulta por intervalo)
+ *
+ *          Arquivos são reabertos a cada fatia: nenhum handle fica aberto
+ *          entre chamadas. Um .bak que falha (abrir, comprimir, verificar
+ *          ou publicar) entra numa lista de ignorados e a busca passa ao
+ *          próximo; a lista é esquecida quando o SD é remontado.
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.2.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * @note RAM fixa (~16 KB em membros), sem alocação dinâmica
+ * @see LogArchiveFormat.h para o formato do contêiner
+ */
+
+#ifndef LOG_ARCHIVER_H
+#define LOG_ARCHIVER_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "LogArchiveFormat.h"
+#include "LzssEncoder.h"
+
+/**
+ * @class LogArchiver
+ * @brief Comprime e verifica arquivos .bak em fatias limitadas
+ */
+class LogArchiver {
+public:
+    /**
+     * @struct Result
+     * @brief Estatísticas do último arquivo concluído
+     */
+    struct Result {
+        char path[64];           ///< Contêiner gerado (.lzs)
+        uint32_t rawBytes;       ///< Tamanho do .bak original
+        uint32_t packedBytes;    ///< Tamanho do contêiner
+        uint32_t cpuUs;          ///< Tempo de compressão (sem E/S do SD)
+        uint32_t totalUs;        ///< Tempo total das fatias (E/S e verificação)
+    };
+
+    /**
+     * @brief Construtor
+     */
+    LogArchiver();
+
+    /**
+     * @brief Executa uma fatia de trabalho
+     * @param nowUnix Timestamp gravado no cabeçalho (0 = RTC indisponível)
+     * @return true se um arquivo acabou de ser concluído (ver lastResult())
+     */
+    bool step(uint32_t nowUnix);
+
+    /** @brief Abandona o arquivo em andamento (o .bak permanece) */
+    void abort();
+
+    /** @brief Há arquivo em compressão/verificação? */
+    bool isActive() const { return _phase != PHASE_IDLE; }
+
+    /** @brief .bak em processamento (nullptr se ocioso) */
+    const char* currentPath() const { return isActive() ? _path : nullptr; }
+
+    /** @brief Estatísticas do último arquivo concluído */
+    const Result& lastResult() const { return _last; }
+
+    /** @brief Arquivos abandonados por falha desde o boot */
+    uint32_t getFailures() const { return _failures; }
+
+    /** @brief .bak com falha que a busca está pulando */
+    uint8_t getSkippedCount() const { return _skippedCount; }
+
+    /** @brief Volta a tentar os .bak com falha (SD remontado) */
+    void retryFailed() { _skippedCount = 0; }
+
+private:
+    /**
+     * @enum Phase
+     * @brief Etapa do arquivo corrente
+     */
+    enum Phase : uint8_t {
+        PHASE_IDLE,        ///< Nenhum arquivo em andamento
+        PHASE_COMPRESS,    ///< Comprimindo o .bak
+        PHASE_VERIFY,      ///< Descomprimindo o .tmp para conferir
+        PHASE_COMMIT       ///< Pronto para renomear
+    };
+
+    //=========================================================================
+    // ESTADO
+    //=========================================================================
+    Phase _phase;                  ///< Etapa corrente
+    char _path[64];                ///< .bak em processamento
+    char _tmpPath[72];             ///< Contêiner em construção
+    uint32_t _rawSize;             ///< Tamanho do .bak
+    uint32_t _rawDone;             ///< Bytes do .bak já comprimidos
+    uint32_t _rawCrc;              ///< CRC-32 do .bak até _rawDone
+    uint32_t _verifyOffset;        ///< Posição de leitura da verificação
+    uint32_t _cpuUs;               ///< Acumulado de Result::cpuUs
+    uint32_t _totalUs;             ///< Acumulado de Result::totalUs
+    uint32_t _sinkUs;              ///< E/S dentro do encoder na fatia corrente
+    File* _dst;                    ///< Destino do encoder na fatia corrente
+    unsigned long _lastScanMs;     ///< Última busca por .bak
+    bool _scanDue;                 ///< Buscar já (arquivo acabou de ser concluído)
+    Result _last;                  ///< Último arquivo concluído
+    char _skipped[SD_ARCHIVE_MAX_SKIPPED][64];  ///< .bak com falha (não retentados)
+    uint8_t _skippedCount;         ///< Entradas válidas em _skipped
+    uint32_t _failures;            ///< Arquivos abandonados por falha
+
+    LzssEncoder _encoder;          ///< Compressor (estado entre fatias)
+    LogArchive::Decoder _decoder;  ///< Verificação do contêiner
+
+    //=========================================================================
+    // MÉTODOS PRIVADOS
+    //=========================================================================
+
+    /** @brief Escolhe o próximo .bak fora de _skipped e remove .tmp abandonado */
+    bool _findNext();
+
+    /** @brief Posição de path em _skipped (-1 se ausente) */
+    int _skippedIndex(const char* path) const;
+
+    /** @brief Abandona o arquivo corrente e o põe em _skipped */
+    void _fail();
+
+    /** @brief Cria o .tmp com o cabeçalho e prepara o encoder */
+    bool _start(uint32_t nowUnix);
+
+    /** @brief Comprime uma fatia; grava o trailer ao fim do .bak */
+    bool _compressSlice();
+
+    /** @brief Descomprime uma fatia do .tmp e confere CRC/tamanho ao fim */
+    bool _verifySlice();
+
+    /** @brief Publica o .lzs e remove o .bak */
+    bool _commit();
+
+    /** @brief Saída do encoder: grava no .tmp aberto na fatia */
+    static bool _sink(const uint8_t* data, size_t len, void* ctx);
+};
+
+#endif // LOG_ARCHIVER_H
@@ -0,0 +1,147 @@
+/**
+ * @file LzssEncoder.cpp
+ * @brief Implementação do compressor LZSS em fluxo
+ */
+
+#include "LzssEncoder.h"
+
+#include <string.h>
+
+using namespace LogArchive;
+
+void LzssEncoder::begin(Sink sink, void *ctx) {
+  _sink = sink;
+  _ctx = ctx;
+  _failed = false;
+  _start = 0;
+  _fill = 0;
+  _outLen = 0;
+  _bits = 0;
+  _bitCount = 0;
+  _packed = 0;
+  for (uint16_t &h : _head)
+    h = NIL;
+  for (uint16_t &p : _prev)
+    p = NIL;
+}
+
+bool LzssEncoder::write(const uint8_t *data, size_t len) {
+  while (len > 0 && !_failed) {
+    // _encode() deixa menos de MAX_MATCH bytes pendentes: _start >= WINDOW
+    if (_fill == BUF_SIZE)
+      _slide();
+
+    size_t n = BUF_SIZE - _fill;
+    if (n > len)
+      n = len;
+    memcpy(_buf + _fill, data, n);
+    _fill += n;
+    data += n;
+    len -= n;
+
+    _encode(false);
+  }
+  return !_failed;
+}
+
+bool LzssEncoder::finish() {
+  _encode(true);
+  if (_bitCount > 0)
+    _putBits(0, 8 - _bitCount);
+  _flush();
+  return !_failed;
+}
+
+void LzssEncoder::_encode(bool final) {
+  while (_start < _fill && !_failed &&
+         (final || _fill - _start >= MAX_MATCH)) {
+    uint16_t avail = _fill - _start;
+    if (avail > MAX_MATCH)
+      avail = MAX_MATCH;
+
+    uint16_t bestLen = 0;
+    uint16_t bestDist = 0;
+    if (avail >= MIN_MATCH) {
+      const uint8_t *cur = _buf + _start;
+      uint16_t cand = _head[_hash(_start)];
+      for (uint8_t chain = MAX_CHAIN;
+           chain > 0 && cand != NIL && _start - cand <= WINDOW; chain--) {
+        const uint8_t *ref = _buf + cand;
+        if (ref[bestLen] == cur[bestLen]) {
+          uint16_t len = 0;
+          while (len < avail && ref[len] == cur[len])
+            len++;
+          if (len > bestLen) {
+            bestLen = len;
+            bestDist = _start - cand;
+            if (len == avail)
+              break;
+          }
+        }
+        // Entrada sobrescrita por posição mais nova: fim da cadeia útil
+        uint16_t next = _prev[cand & (WINDOW - 1)];
+        if (next == NIL || next >= cand)
+          break;
+        cand = next;
+      }
+      _insert(_start);
+    }
+
+    if (bestLen >= MIN_MATCH) {
+      _putBits(((uint32_t)(bestDist - 1) << LENGTH_BITS) |
+                   (bestLen - MIN_MATCH),
+               1 + WINDOW_BITS + LENGTH_BITS);
+      for (uint16_t i = 1; i < bestLen; i++) {
+        if (_start + i + MIN_MATCH <= _fill)
+          _insert(_start + i);
+      }
+      _start += bestLen;
+    } else {
+      _putBits(0x100 | _buf[_start], 9);
+      _start++;
+    }
+  }
+}
+
+void LzssEncoder::_slide() {
+  memmove(_buf, _buf + WINDOW, BUF_SIZE - WINDOW);
+  _start -= WINDOW;
+  _fill -= WINDOW;
+  for (uint16_t &h : _head)
+    h = (h != NIL && h >= WINDOW) ? h - WINDOW : NIL;
+  for (uint16_t &p : _prev)
+    p = (p != NIL && p >= WINDOW) ? p - WINDOW : NIL;
+}
+
+void LzssEncoder::_insert(uint16_t pos) {
+  uint16_t h = _hash(pos);
+  _prev[pos & (WINDOW - 1)] = _head[h];
+  _head[h] = pos;
+}
+
+uint16_t LzssEncoder::_hash(uint16_t pos) const {
+  const uint8_t *p = _buf + pos;
+  uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+  return (uint16_t)((uint32_t)(v * 2654435761UL) >> (32 - HASH_BITS));
+}
+
+void LzssEncoder::_putBits(uint32_t value, uint8_t count) {
+  _bits = (_bits << count) | value;
+  _bitCount += count;
+  while (_bitCount >= 8) {
+    _bitCount -= 8;
+    _out[_outLen++] = (uint8_t)(_bits >> _bitCount);
+    if (_outLen == OUT_SIZE)
+      _flush();
+  }
+}
+
+void LzssEncoder::_flush() {
+  if (_outLen == 0 || _failed)
+    return;
+  if (!_sink(_out, _outLen, _ctx))
+    _failed = true;
+  else
+    _packed += _outLen;
+  _outLen = 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file LzssEncoder.h
+ * @brief Compressor LZSS em fluxo com RAM fixa (formato LogArchive)
+ *
+ * @details Codificador do fluxo descrito em LogArchiveFormat.h:
+ *          - Entrada em pedaços arbitrários (write), saída via callback
+ *          - Busca por cadeias de hash limitadas (MAX_CHAIN candidatos)
+ *          - Nenhuma alocação dinâmica: ~12 KB em membros
+ *
+ *          Não depende do framework Arduino.
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Memória
+ * | Buffer  | Tamanho | Função                                   |
+ * |---------|---------|------------------------------------------|
+ * | _buf    | 4 KB    | Janela (2 KB) + entrada ainda não codificada |
+ * | _head   | 4 KB    | Última posição de cada hash de 3 bytes   |
+ * | _prev   | 4 KB    | Posição anterior com o mesmo hash        |
+ * | _out    | 256 B   | Saída acumulada por chamada ao sink      |
+ */
+
+#ifndef LZSS_ENCODER_H
+#define LZSS_ENCODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "LogArchiveFormat.h"
+
+/**
+ * @class LzssEncoder
+ * @brief Compressor LZSS com janela deslizante e cadeias de hash
+ */
+class LzssEncoder {
+public:
+    /**
+     * @brief Recebe os bytes comprimidos
+     * @return false para abortar a compressão
+     */
+    typedef bool (*Sink)(const uint8_t* data, size_t len, void* ctx);
+
+    /**
+     * @brief Prepara um novo fluxo
+     * @param sink Destino dos bytes comprimidos
+     * @param ctx Repassado ao sink
+     */
+    void begin(Sink sink, void* ctx);
+
+    /**
+     * @brief Comprime mais bytes do arquivo original
+     * @return false se o sink falhou
+     */
+    bool write(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Codifica a cauda, completa o último byte e esvazia a saída
+     * @return false se o sink falhou
+     */
+    bool finish();
+
+    /** @brief Bytes comprimidos entregues ao sink */
+    uint32_t packedSize() const { return _packed; }
+
+private:
+    static constexpr uint16_t WINDOW = LogArchive::WINDOW_SIZE;    ///< 2048
+    static constexpr uint16_t BUF_SIZE = 2 * WINDOW;               ///< Janela + entrada
+    static constexpr uint8_t HASH_BITS = 11;                       ///< 2048 listas
+    static constexpr uint16_t NIL = 0xFFFF;                        ///< Posição vazia
+    static constexpr uint8_t MAX_CHAIN = 16;                       ///< Candidatos por busca
+    static constexpr size_t OUT_SIZE = 256;                        ///< Buffer de saída
+
+    uint8_t _buf[BUF_SIZE];            ///< Janela deslizante + entrada
+    uint16_t _head[1u << HASH_BITS];   ///< Última posição por hash
+    uint16_t _prev[WINDOW];            ///< Encadeamento (posição & (WINDOW-1))
+    uint16_t _start;                   ///< Próxima posição a codificar
+    uint16_t _fill;                    ///< Bytes válidos em _buf
+
+    uint8_t _out[OUT_SIZE];            ///< Saída pendente
+    size_t _outLen;                    ///< Bytes em _out
+    uint32_t _bits;                    ///< Bits ainda não completados em byte
+    uint8_t _bitCount;                 ///< Bits válidos em _bits
+    uint32_t _packed;                  ///< Bytes entregues ao sink
+
+    Sink _sink;                        ///< Destino da saída
+    void* _ctx;                        ///< Contexto do sink
+    bool _failed;                      ///< Sink abortou
+
+    /** @brief Codifica enquanto houver lookahead completo (ou tudo se final) */
+    void _encode(bool final);
+
+    /** @brief Descarta a metade antiga de _buf e ajusta as cadeias */
+    void _slide();
+
+    /** @brief Insere a posição pos nas cadeias de hash */
+    void _insert(uint16_t pos);
+
+    /** @brief Hash dos 3 bytes em pos */
+    uint16_t _hash(uint16_t pos) const;
+
+    /** @brief Acrescenta count bits (MSB primeiro) à saída */
+    void _putBits(uint32_t value, uint8_t count);
+
+    /** @brief Entrega _out ao sink */
+    void _flush();
+};
+
+#endif // LZSS_ENCODER_H
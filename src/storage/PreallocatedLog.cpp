@@ -0,0 +1,259 @@
+/**
+ * @file PreallocatedLog.cpp
+ * @brief Implementação do log pré-alocado com fim lógico persistente
+ */
+
+#include "PreallocatedLog.h"
+#include <Preferences.h>
+#include <unistd.h>
+
+static const char *NVS_NAMESPACE = "storage";
+
+PreallocatedLog::PreallocatedLog(const char *path, const char *nvsKey,
+                                 LineValidator validator)
+    : _path(path), _nvsKey(nvsKey), _validator(validator),
+      _capacity(SD_MAX_FILE_SIZE), _end(0), _checkpoint(0), _seq(0),
+      _recovered(0), _tornTail(false), _opened(false), _spareReady(false),
+      _spareMisses(0), _stats(nullptr) {
+  snprintf(_sparePath, sizeof(_sparePath), "%s%s", path, SD_SPARE_SUFFIX);
+}
+
+bool PreallocatedLog::open() {
+  _opened = false;
+  _spareReady = false;
+  _recovered = 0;
+  _tornTail = false;
+
+  // Sequência segue do checkpoint mesmo com arquivo novo (troca de cartão)
+  Checkpoint cp = _loadCheckpoint();
+  _seq = cp.seq;
+
+  if (!SD.exists(_path)) {
+    _storeCheckpoint(0);
+    if (!_allocate(_path, 0))
+      return false;
+  }
+
+  File file = SD.open(_path, "r+");
+  if (!file)
+    return false;
+
+  uint32_t size = file.size();
+  if (size < _capacity) {
+    // Arquivo gravado por append (versão anterior): fim lógico = tamanho
+    file.close();
+    _end = size;
+    _storeCheckpoint(size);
+    if (!_allocate(_path, size))
+      return false;
+    _opened = true;
+    return true;
+  }
+
+  if (cp.offset >= _capacity)
+    cp.offset = 0;
+
+  if (_validator != nullptr) {
+    // Checkpoint de outro cartão/arquivo: recomeçar do início. A sequência
+    // só cresce (registros já numerados podem ser recontados, nunca
+    // repetidos com número menor)
+    if (cp.offset > 0 && !_endsValidLine(file, cp.offset)) {
+      Serial.printf("[PreallocatedLog] Checkpoint invalido em %s, varrendo "
+                    "desde o inicio.\n",
+                    _path);
+      cp.offset = 0;
+    }
+    _end = _scanTextEnd(file, cp.offset);
+    _seq += _recovered;
+  } else {
+    _end = cp.offset;
+  }
+  file.close();
+
+  _checkpoint = cp.offset;
+  _opened = true;
+  return true;
+}
+
+bool PreallocatedLog::append(const uint8_t *data, size_t len) {
+  uint32_t t = micros();
+  File file = SD.open(_path, "r+");
+  _lap(StorageStats::OP_OPEN, t);
+  if (!file)
+    return false;
+
+  // 0x00 após os dados: marca o fim lógico para a varredura pós-reset
+  bool ok = file.seek(_end) && file.write(data, len) == len &&
+            file.write((uint8_t)0) == 1;
+  _lap(StorageStats::OP_WRITE, t);
+  // flush explícito (o close faria o mesmo): separa o tempo de cada etapa
+  file.flush();
+  _lap(StorageStats::OP_FLUSH, t);
+  file.close();
+  _lap(StorageStats::OP_CLOSE, t);
+
+  if (ok)
+    _end += len;
+  return ok;
+}
+
+bool PreallocatedLog::appendRecords(const uint8_t *data, size_t len,
+                                    uint32_t count) {
+  if (!append(data, len))
+    return false;
+  _seq += count;
+  return true;
+}
+
+bool PreallocatedLog::rotate(const char *backupPath) {
+  // Conservador: reset no meio da rotação só força varredura completa
+  _storeCheckpoint(0);
+
+  // Rotacionado fica apenas com os dados válidos
+  char fullPath[48];
+  snprintf(fullPath, sizeof(fullPath), "%s%s", SD_MOUNT_POINT, _path);
+  if (truncate(fullPath, _end) != 0) {
+    Serial.printf("[PreallocatedLog] Aviso: falha ao truncar %s\n", _path);
+  }
+
+  if (!SD.rename(_path, backupPath)) {
+    _opened = false;
+    return false;
+  }
+
+  if (!_spareReady || !SD.rename(_sparePath, _path)) {
+    // Sem reserva pronta: alocação síncrona (caminho lento)
+    _spareMisses++;
+    if (!_allocate(_path, 0)) {
+      _opened = false;
+      return false;
+    }
+  }
+
+  _end = 0;
+  _spareReady = false;
+  _opened = true;
+  return true;
+}
+
+bool PreallocatedLog::prepareSpare(bool allocate) {
+  if (_spareReady)
+    return false;
+
+  if (SD.exists(_sparePath)) {
+    File file = SD.open(_sparePath, FILE_READ);
+    uint32_t size = file ? file.size() : 0;
+    if (file)
+      file.close();
+    if (size >= _capacity) {
+      _spareReady = true;
+      return false;
+    }
+  }
+
+  if (!allocate)
+    return false;
+  _spareReady = _allocate(_sparePath, 0);
+  return true;
+}
+
+void PreallocatedLog::saveCheckpoint(bool force) {
+  if (!_opened || _end == _checkpoint)
+    return;
+  if (force || _end < _checkpoint ||
+      _end - _checkpoint >= SD_CHECKPOINT_INTERVAL)
+    _storeCheckpoint(_end);
+}
+
+bool PreallocatedLog::_allocate(const char *path, uint32_t from) {
+  File file =
+      SD.exists(path) ? SD.open(path, "r+") : SD.open(path, FILE_WRITE);
+  if (!file)
+    return false;
+
+  // Estender com um único seek+write: o FatFs aloca a cadeia inteira agora
+  bool ok = file.seek(_capacity - 1) && file.write((uint8_t)0) == 1 &&
+            file.seek(from) && file.write((uint8_t)0) == 1;
+  file.close();
+  return ok;
+}
+
+uint32_t PreallocatedLog::_scanTextEnd(File &file, uint32_t from) {
+  if (!file.seek(from))
+    return from;
+
+  char line[MAX_LINE];
+  size_t lineLen = 0;
+  uint32_t lineStart = from;
+  uint8_t chunk[512];
+
+  while (lineStart < _capacity) {
+    size_t got = file.read(chunk, sizeof(chunk));
+    if (got == 0)
+      break;
+
+    for (size_t i = 0; i < got; i++) {
+      // 0x00 no início de linha = marcador de fim; em qualquer outro ponto
+      // (ou linha longa demais) o último registro foi interrompido
+      if (chunk[i] == 0 || lineLen >= MAX_LINE) {
+        _tornTail = (lineLen > 0);
+        return lineStart;
+      }
+
+      line[lineLen++] = (char)chunk[i];
+      if (chunk[i] == '\n') {
+        if (!_validator(line, lineLen, lineStart)) {
+          _tornTail = true;
+          return lineStart;
+        }
+        if (lineStart > 0)
+          _recovered++;
+        lineStart += lineLen;
+        lineLen = 0;
+      }
+    }
+  }
+  return lineStart;
+}
+
+bool PreallocatedLog::_endsValidLine(File &file, uint32_t offset) {
+  char line[MAX_LINE];
+  uint32_t start = offset > MAX_LINE ? offset - MAX_LINE : 0;
+  size_t len = offset - start;
+
+  if (!file.seek(start) || file.read((uint8_t *)line, len) != len)
+    return false;
+  if (line[len - 1] != '\n')
+    return false;
+
+  // Início da linha: byte após o '\n' anterior (ou início do arquivo)
+  size_t i = len - 1;
+  while (i > 0 && line[i - 1] != '\n')
+    i--;
+  if (i == 0 && start > 0)
+    return false;
+
+  return _validator(line + i, len - i, start + i);
+}
+
+void PreallocatedLog::_storeCheckpoint(uint32_t offset) {
+  Checkpoint cp = {offset, _seq};
+  Preferences prefs;
+  if (prefs.begin(NVS_NAMESPACE, false)) {
+    prefs.putBytes(_nvsKey, &cp, sizeof(cp));
+    prefs.end();
+  }
+  _checkpoint = offset;
+}
+
+PreallocatedLog::Checkpoint PreallocatedLog::_loadCheckpoint() {
+  Checkpoint cp = {0, 0};
+  Preferences prefs;
+  if (!prefs.begin(NVS_NAMESPACE, true))
+    return cp;
+  // Formato antigo (só offset) não é lido como blob: varredura completa
+  if (prefs.getBytes(_nvsKey, &cp, sizeof(cp)) != sizeof(cp))
+    cp.offset = cp.seq = 0;
+  prefs.end();
+  return cp;
+}
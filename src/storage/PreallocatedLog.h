@@ -0,0 +1,239 @@
+/**
+ * @file PreallocatedLog.h
+ * @brief Arquivo de log pré-alocado com marcador lógico de fim de dados
+ *
+ * @details Elimina a alocação de clusters FAT no meio de uma escrita:
+ *          - Arquivo ativo é criado já com SD_MAX_FILE_SIZE bytes
+ *          - Escritas sobrescrevem a área alocada (sem crescer o arquivo)
+ *          - Fim lógico mantido em RAM + checkpoint periódico na NVS
+ *          - Arquivo reserva (".next") pré-alocado fora do caminho crítico
+ *          - Rotação = truncar + renomear ativo, promover a reserva
+ *          - Sequência global de registros (contínua entre rotações)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.1.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Por que pré-alocar
+ * Um append que cruza a fronteira de cluster obriga o FatFs a procurar
+ * cluster livre e atualizar as duas cópias da FAT. Em cartões SD isso
+ * gera picos de centenas de ms que atrasam a StorageTask. Estendendo o
+ * arquivo de uma só vez (seek + 1 byte), a cadeia inteira é alocada em
+ * uma operação, normalmente contígua.
+ *
+ * ## Recuperação do Fim Lógico
+ * | Etapa | Ação                                                  |
+ * |-------|-------------------------------------------------------|
+ * | 1     | Lê checkpoint da NVS (fim lógico + sequência)         |
+ * | 2     | Texto: valida a linha que termina no checkpoint       |
+ * | 3     | Texto: avança linha a linha (CRC) até o primeiro erro |
+ * | 4     | Binário: StorageManager percorre blocos e frames      |
+ *
+ * Cada append grava um byte 0x00 logo após os dados: a varredura nunca
+ * alcança lixo antigo dos clusters pré-alocados. Se a varredura para em
+ * um byte diferente de 0x00, o último registro foi rasgado (reset no meio
+ * da escrita) e é descartado: a próxima escrita o sobrescreve. O custo é
+ * O(bytes após o checkpoint), nunca O(arquivo).
+ *
+ * @note Checkpoint menor que o fim real é sempre seguro (só varre mais)
+ * @warning Arquivos rotacionados são truncados ao fim lógico; o ativo
+ *          mantém o tamanho pré-alocado (ler até o primeiro 0x00)
+ */
+
+#ifndef PREALLOCATED_LOG_H
+#define PREALLOCATED_LOG_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "StorageStats.h"
+
+/**
+ * @class PreallocatedLog
+ * @brief Log de tamanho fixo no SD com fim lógico persistente
+ */
+class PreallocatedLog {
+public:
+    /**
+     * @brief Valida uma linha de texto (terminada em '\n')
+     * @param line Conteúdo da linha (não terminado em '\0')
+     * @param len Tamanho incluindo o '\n'
+     * @param offset Posição da linha no arquivo (0 = cabeçalho)
+     */
+    typedef bool (*LineValidator)(const char* line, size_t len, uint32_t offset);
+
+    /**
+     * @brief Construtor
+     * @param path Caminho do arquivo ativo
+     * @param nvsKey Chave NVS do checkpoint (máx. 15 caracteres)
+     * @param validator Validador de linhas (nullptr = log binário)
+     */
+    PreallocatedLog(const char* path, const char* nvsKey,
+                    LineValidator validator = nullptr);
+
+    /** @brief Cronometra open/write/flush/close dos appends (nullptr = não) */
+    void setStats(StorageStats* stats) { _stats = stats; }
+
+    //=========================================================================
+    // CICLO DE VIDA
+    //=========================================================================
+
+    /**
+     * @brief Garante o arquivo ativo pré-alocado e localiza o fim lógico
+     * @return true se o arquivo está pronto para escrita
+     * @note Arquivos antigos (menores que a capacidade) são adotados:
+     *       fim lógico = tamanho atual, depois estendidos
+     */
+    bool open();
+
+    /**
+     * @brief Grava dados no fim lógico (logs de texto)
+     * @return true se gravado (fim lógico avança)
+     */
+    bool append(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Grava um registro (linha) no fim lógico
+     * @return true se gravado (fim lógico e sequência avançam)
+     * @see seq() para o número que o registro deve carregar
+     */
+    bool appendRecord(const uint8_t* data, size_t len) {
+        return appendRecords(data, len, 1);
+    }
+
+    /**
+     * @brief Grava registros consecutivos em uma única escrita
+     * @param count Registros contidos em data (seq avança count)
+     */
+    bool appendRecords(const uint8_t* data, size_t len, uint32_t count);
+
+    /**
+     * @brief Fecha o arquivo ativo e promove a reserva
+     * @param backupPath Nome final do arquivo rotacionado
+     * @return true se um novo arquivo ativo está disponível
+     */
+    bool rotate(const char* backupPath);
+
+    //=========================================================================
+    // MANUTENÇÃO (fora do caminho de escrita)
+    //=========================================================================
+
+    /**
+     * @brief Pré-aloca o arquivo reserva, se ainda não existir
+     * @param allocate false = só adota uma reserva completa já existente
+     *        (orçamento de espaço esgotado)
+     * @return true se houve trabalho (alocação executada)
+     */
+    bool prepareSpare(bool allocate = true);
+
+    /**
+     * @brief Persiste o fim lógico na NVS se avançou o suficiente
+     * @param force Gravar mesmo abaixo de SD_CHECKPOINT_INTERVAL
+     */
+    void saveCheckpoint(bool force = false);
+
+    //=========================================================================
+    // ESTADO
+    //=========================================================================
+
+    /** @brief Cabe len bytes (mais o marcador 0x00) antes da capacidade? */
+    bool fits(size_t len) const { return _end + len < _capacity; }
+
+    /** @brief Fim lógico atual (bytes válidos) */
+    uint32_t end() const { return _end; }
+
+    /** @brief Atualiza fim lógico (log binário grava no lugar) */
+    void setEnd(uint32_t end) { _end = end; }
+
+    /** @brief Sequência do próximo registro */
+    uint32_t seq() const { return _seq; }
+
+    /** @brief Atualiza sequência (log binário numera seus frames) */
+    void setSeq(uint32_t seq) { _seq = seq; }
+
+    /** @brief Registros válidos encontrados após o checkpoint no open() */
+    uint32_t getRecoveredRecords() const { return _recovered; }
+
+    /** @brief open() descartou um registro rasgado no fim? */
+    bool hadTornTail() const { return _tornTail; }
+
+    /** @brief Resultado da recuperação feita fora da classe (binário) */
+    void setRecovery(uint32_t records, bool tornTail) {
+        _recovered = records;
+        _tornTail = tornTail;
+    }
+
+    /** @brief Capacidade pré-alocada em bytes */
+    uint32_t capacity() const { return _capacity; }
+
+    /** @brief Caminho do arquivo ativo */
+    const char* path() const { return _path; }
+
+    /** @brief Arquivo aberto e fim lógico conhecido? */
+    bool isOpen() const { return _opened; }
+
+    /** @brief Reserva pré-alocada pronta para a próxima rotação? */
+    bool isSpareReady() const { return _spareReady; }
+
+    /** @brief Rotações sem reserva pronta (alocação síncrona) */
+    uint16_t getSpareMisses() const { return _spareMisses; }
+
+private:
+    //=========================================================================
+    // ESTADO
+    //=========================================================================
+    const char* _path;           ///< Arquivo ativo
+    const char* _nvsKey;         ///< Chave do checkpoint na NVS
+    LineValidator _validator;    ///< Validador de linhas (texto)
+    char _sparePath[40];         ///< Arquivo reserva (path + ".next")
+    uint32_t _capacity;          ///< Tamanho pré-alocado
+    uint32_t _end;               ///< Fim lógico (bytes válidos)
+    uint32_t _checkpoint;        ///< Último fim lógico salvo na NVS
+    uint32_t _seq;               ///< Sequência do próximo registro
+    uint32_t _recovered;         ///< Registros após o checkpoint (open)
+    bool _tornTail;              ///< Registro rasgado descartado (open)
+    bool _opened;                ///< open() concluído?
+    bool _spareReady;            ///< Reserva já verificada/alocada?
+    uint16_t _spareMisses;       ///< Rotações sem reserva pronta
+    StorageStats* _stats;        ///< Latência das operações (opcional)
+
+    static constexpr size_t MAX_LINE = 640;  ///< Maior linha aceita
+
+    /** @brief Checkpoint persistido: fim lógico e sequência nesse ponto */
+    struct Checkpoint {
+        uint32_t offset;
+        uint32_t seq;
+    };
+
+    //=========================================================================
+    // MÉTODOS PRIVADOS
+    //=========================================================================
+
+    /** @brief Registra a operação em _stats (se configurado) */
+    void _lap(StorageStats::Op op, uint32_t& t) {
+        if (_stats != nullptr) _stats->lap(op, t);
+    }
+
+    /** @brief Cria/estende arquivo até a capacidade, 0x00 no offset from */
+    bool _allocate(const char* path, uint32_t from);
+
+    /**
+     * @brief Avança linha a linha a partir de from
+     * @return Fim válido; _recovered e _tornTail descrevem a cauda
+     */
+    uint32_t _scanTextEnd(File& file, uint32_t from);
+
+    /** @brief A linha que termina em offset é válida? */
+    bool _endsValidLine(File& file, uint32_t offset);
+
+    /** @brief Grava checkpoint (offset + _seq) na NVS */
+    void _storeCheckpoint(uint32_t offset);
+
+    /** @brief Lê checkpoint da NVS (zerado se ausente) */
+    Checkpoint _loadCheckpoint();
+};
+
+#endif // PREALLOCATED_LOG_H
@@ -0,0 +1,342 @@
+/**
+ * @file RetentionManager.cpp
+ * @brief Implementação da retenção por espaço livre no SD
+ */
+
+#include "RetentionManager.h"
+
+// Logs gerenciados (nome sem '/') e suas classes
+static const struct {
+  const char *name;
+  RetentionManager::LogClass cls;
+} MANAGED_LOGS[] = {
+    {SD_LOG_FILE + 1, RetentionManager::CLASS_TELEMETRY},
+    {SD_BINARY_LOG_FILE + 1, RetentionManager::CLASS_TELEMETRY},
+    {SD_COLUMNAR_FILE + 1, RetentionManager::CLASS_TELEMETRY},
+    {SD_MISSION_FILE + 1, RetentionManager::CLASS_MISSION},
+    {SD_SYSTEM_LOG + 1, RetentionManager::CLASS_SYSTEM},
+};
+
+static const uint8_t QUOTA_PCT[RetentionManager::CLASS_COUNT] = {
+    SD_QUOTA_TELEMETRY_PCT, SD_QUOTA_MISSION_PCT, SD_QUOTA_SYSTEM_PCT};
+
+// Tamanho do nome-base do log que prefixa name (0 = não gerenciado)
+static size_t managedBase(const char *name, RetentionManager::LogClass &cls) {
+  if (name[0] == '/')
+    name++;
+  for (const auto &log : MANAGED_LOGS) {
+    size_t n = strlen(log.name);
+    if (strncmp(name, log.name, n) == 0 &&
+        (name[n] == '\0' || name[n] == '.')) {
+      cls = log.cls;
+      return n;
+    }
+  }
+  cls = RetentionManager::CLASS_NONE;
+  return 0;
+}
+
+RetentionManager::RetentionManager()
+    : _budget(0), _level(LEVEL_OK), _scanned(false), _lastScanMs(0),
+      _removeHook(nullptr), _removeCtx(nullptr) {
+  memset(_classBytes, 0, sizeof(_classBytes));
+  memset(_queued, 0, sizeof(_queued));
+  memset(_complete, 0, sizeof(_complete));
+  memset(&_last, 0, sizeof(_last));
+}
+
+void RetentionManager::begin() {
+  _scanned = false;
+  if (!_scan())
+    return;
+
+  // Dados de terceiros (e folga de clusters) ficam fora do orçamento
+  uint64_t total = SD.totalBytes();
+  uint64_t used = SD.usedBytes();
+  uint64_t ours = usedBytes();
+  uint64_t foreign = used > ours ? used - ours : 0;
+  _budget = total > foreign ? total - foreign : 0;
+  if (SD_RETENTION_CAPACITY_MB > 0 &&
+      _budget > (uint64_t)SD_RETENTION_CAPACITY_MB << 20)
+    _budget = (uint64_t)SD_RETENTION_CAPACITY_MB << 20;
+
+  _scanned = true;
+  _updateLevel();
+  Serial.printf(
+      "[RetentionManager] Orcamento %lu MB, logs %lu MB (livre %u%%)\n",
+      (unsigned long)(_budget >> 20), (unsigned long)(ours >> 20),
+      freePercent());
+}
+
+bool RetentionManager::step() {
+  if (!_scanned)
+    return false;
+
+  // Reconciliação periódica ou fila de candidatos esgotada
+  bool rescan = millis() - _lastScanMs >= SD_RETENTION_RESCAN_MS;
+  for (uint8_t c = 0; c < CLASS_COUNT; c++) {
+    if (_queued[c] == 0 && !_complete[c])
+      rescan = true;
+  }
+  if (rescan && !_scan())
+    return false;
+
+  bool pruned = false;
+  LogClass cls = _selectClass();
+  if (cls != CLASS_NONE)
+    pruned = _prune(cls);
+  _updateLevel();
+  return pruned;
+}
+
+void RetentionManager::noteAdded(LogClass cls, uint32_t bytes) {
+  if (cls >= CLASS_COUNT)
+    return;
+  _classBytes[cls] += bytes;
+  _updateLevel();
+}
+
+void RetentionManager::noteRemoved(LogClass cls, uint32_t bytes) {
+  if (cls >= CLASS_COUNT)
+    return;
+  _classBytes[cls] = _classBytes[cls] > bytes ? _classBytes[cls] - bytes : 0;
+  _updateLevel();
+}
+
+void RetentionManager::noteRotated(const char *backupPath) {
+  Candidate c;
+  if (!_parseBackup(backupPath, c))
+    return;
+  LogClass cls;
+  managedBase(backupPath, cls);
+
+  // Mais novo de todos: só entra se a fila já contém a classe inteira
+  if (_complete[cls] && _queued[cls] < MAX_CANDIDATES)
+    _queue[cls][_queued[cls]++] = c;
+  else
+    _complete[cls] = false;
+}
+
+uint64_t RetentionManager::usedBytes() const {
+  uint64_t used = 0;
+  for (uint8_t c = 0; c < CLASS_COUNT; c++)
+    used += _classBytes[c];
+  return used;
+}
+
+RetentionManager::LogClass RetentionManager::classOf(const char *path) {
+  LogClass cls;
+  managedBase(path, cls);
+  return cls;
+}
+
+const char *RetentionManager::levelName(Level level) {
+  switch (level) {
+  case LEVEL_OK:
+    return "OK";
+  case LEVEL_LOW:
+    return "BAIXO";
+  case LEVEL_CRITICAL:
+    return "CRITICO";
+  default:
+    return "CHEIO";
+  }
+}
+
+const char *RetentionManager::className(LogClass cls) {
+  switch (cls) {
+  case CLASS_TELEMETRY:
+    return "telemetria";
+  case CLASS_MISSION:
+    return "missao";
+  case CLASS_SYSTEM:
+    return "sistema";
+  default:
+    return "-";
+  }
+}
+
+bool RetentionManager::_scan() {
+  File root = SD.open("/");
+  if (!root)
+    return false;
+
+  memset(_classBytes, 0, sizeof(_classBytes));
+  memset(_queued, 0, sizeof(_queued));
+  for (uint8_t c = 0; c < CLASS_COUNT; c++)
+    _complete[c] = true;
+
+  for (File entry = root.openNextFile(); entry; entry = root.openNextFile()) {
+    if (entry.isDirectory()) {
+      entry.close();
+      continue;
+    }
+    char path[72];
+    const char *name = entry.name();
+    snprintf(path, sizeof(path), "/%s", name[0] == '/' ? name + 1 : name);
+    uint32_t size = entry.size();
+    entry.close();
+
+    LogClass cls;
+    if (managedBase(path, cls) == 0)
+      continue;
+    _classBytes[cls] += size;
+
+    Candidate c;
+    if (_parseBackup(path, c))
+      _enqueue(cls, c);
+  }
+  root.close();
+
+  _lastScanMs = millis();
+  return true;
+}
+
+void RetentionManager::_enqueue(LogClass cls, const Candidate &c) {
+  Candidate *q = _queue[cls];
+  uint8_t &n = _queued[cls];
+
+  // "<bak>" e "<bak>.lzs" (compressão no commit) são a mesma unidade
+  for (uint8_t i = 0; i < n; i++) {
+    if (strcmp(q[i].path, c.path) == 0)
+      return;
+  }
+
+  uint8_t pos = n;
+  while (pos > 0 && _isOlder(c, q[pos - 1]))
+    pos--;
+  if (pos >= MAX_CANDIDATES) {
+    _complete[cls] = false;
+    return;
+  }
+  if (n == MAX_CANDIDATES) {
+    _complete[cls] = false;
+    n--;
+  }
+  memmove(&q[pos + 1], &q[pos], (n - pos) * sizeof(Candidate));
+  q[pos] = c;
+  n++;
+}
+
+RetentionManager::LogClass RetentionManager::_selectClass() {
+  // 1. Classe mais acima da própria cota
+  LogClass chosen = CLASS_NONE;
+  uint64_t worst = 0;
+  for (uint8_t c = 0; c < CLASS_COUNT; c++) {
+    uint64_t quota = _budget * QUOTA_PCT[c] / 100;
+    if (_queued[c] > 0 && _classBytes[c] > quota &&
+        _classBytes[c] - quota > worst) {
+      worst = _classBytes[c] - quota;
+      chosen = (LogClass)c;
+    }
+  }
+  if (chosen != CLASS_NONE || freeBytes() >= SD_RETENTION_RESERVE_BYTES)
+    return chosen;
+
+  // 2. Reserva violada: o rotacionado mais antigo entre as classes
+  for (uint8_t c = 0; c < CLASS_COUNT; c++) {
+    if (_queued[c] > 0 &&
+        (chosen == CLASS_NONE || _isOlder(_queue[c][0], _queue[chosen][0])))
+      chosen = (LogClass)c;
+  }
+  return chosen;
+}
+
+bool RetentionManager::_prune(LogClass cls) {
+  Candidate *q = _queue[cls];
+  uint8_t &n = _queued[cls];
+  if (n == 0)
+    return false;
+
+  Candidate c = q[0];
+  memmove(&q[0], &q[1], (n - 1) * sizeof(Candidate));
+  n--;
+
+  // Mais antigo primeiro, mesmo em compressão: quem o usa é avisado antes
+  if (_removeHook != nullptr)
+    _removeHook(c.path, _removeCtx);
+
+  char path[80];
+  uint32_t freed = _removeFile(c.path);
+  snprintf(path, sizeof(path), "%s%s", c.path, SD_INDEX_SUFFIX);
+  freed += _removeFile(path);
+  snprintf(path, sizeof(path), "%s%s", c.path, SD_ARCHIVE_SUFFIX);
+  freed += _removeFile(path);
+
+  // Candidato já removido por fora: nada a relatar
+  if (freed == 0)
+    return false;
+
+  noteRemoved(cls, freed);
+  strncpy(_last.path, c.path, sizeof(_last.path) - 1);
+  _last.path[sizeof(_last.path) - 1] = '\0';
+  _last.bytes = freed;
+  _last.cls = cls;
+  return true;
+}
+
+void RetentionManager::_updateLevel() {
+  // Antes da primeira varredura não há orçamento conhecido
+  if (!_scanned) {
+    _level = LEVEL_OK;
+    return;
+  }
+
+  uint64_t free = freeBytes();
+  if (free < SD_MAX_FILE_SIZE)
+    _level = LEVEL_FULL;
+  else if (free < 2ull * SD_MAX_FILE_SIZE)
+    _level = LEVEL_CRITICAL;
+  else if (free * 100 < _budget * SD_RETENTION_LOW_PCT)
+    _level = LEVEL_LOW;
+  else
+    _level = LEVEL_OK;
+}
+
+bool RetentionManager::_parseBackup(const char *path, Candidate &c) {
+  LogClass cls;
+  size_t base = managedBase(path, cls);
+  if (base == 0 || path[0] != '/')
+    return false;
+
+  // "/<log>.<timestamp>.bak" ou ".bak.lzs"; .idx e .tmp acompanham a unidade
+  const char *stamp = path + 1 + base + 1;
+  const char *bak = strstr(stamp, ".bak");
+  if (path[1 + base] != '.' || bak == nullptr || bak == stamp)
+    return false;
+  if (bak[4] != '\0' && strcmp(bak + 4, SD_ARCHIVE_SUFFIX) != 0)
+    return false;
+
+  size_t len = bak + 4 - path;
+  if (len >= sizeof(c.path))
+    return false;
+  memcpy(c.path, path, len);
+  c.path[len] = '\0';
+  c.stampPos = stamp - path;
+  c.stampLen = bak - stamp;
+  return true;
+}
+
+int RetentionManager::compareStamps(const char *a, size_t aLen, const char *b,
+                                    size_t bLen) {
+  // Timestamps de mesmo formato ordenam como texto; millis() (sem RTC) é
+  // mais curto que data/hora e numérico: o mais curto é o mais antigo
+  if (aLen != bLen)
+    return aLen < bLen ? -1 : 1;
+  return strncmp(a, b, aLen);
+}
+
+bool RetentionManager::_isOlder(const Candidate &a, const Candidate &b) {
+  return compareStamps(a.path + a.stampPos, a.stampLen, b.path + b.stampPos,
+                       b.stampLen) < 0;
+}
+
+uint32_t RetentionManager::_removeFile(const char *path) {
+  if (!SD.exists(path))
+    return 0;
+  File file = SD.open(path, FILE_READ);
+  uint32_t size = file ? file.size() : 0;
+  if (file)
+    file.close();
+  return SD.remove(path) ? size : 0;
+}
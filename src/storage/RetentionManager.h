@@ -0,0 +1,256 @@
+/**
+ * @file RetentionManager.h
+ * @brief Retenção por espaço livre no SD (cotas por classe de log)
+ *
+ * @details Contabilidade de ocupação mantida em RAM:
+ *          - Uma varredura da raiz no begin() (mais SD.usedBytes() uma vez,
+ *            para descontar dados de terceiros)
+ *          - Atualizada pelos eventos do StorageManager (reserva alocada,
+ *            rotação, compressão, append no system.log, remoção)
+ *          - Reconciliada por nova varredura só quando a fila de candidatos
+ *            esvazia ou a cada SD_RETENTION_RESCAN_MS
+ *
+ *          Nenhuma consulta à FAT (f_getfree) no caminho de escrita: o
+ *          StorageManager pergunta hasRoomFor() antes de alocar.
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.1.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Classes de Log
+ * | Classe    | Arquivos                                  | Cota (% do orçamento)  |
+ * |-----------|-------------------------------------------|------------------------|
+ * | Telemetry | telemetry.csv/.bin, reservas, .idx, .bak* | SD_QUOTA_TELEMETRY_PCT |
+ * | Mission   | mission.csv, reserva, .bak*               | SD_QUOTA_MISSION_PCT   |
+ * | System    | system.log, .bak*                         | SD_QUOTA_SYSTEM_PCT    |
+ *
+ * ## Política
+ * 1. Classe acima da cota: remove o rotacionado mais antigo dela
+ * 2. Livre abaixo de SD_RETENTION_RESERVE_BYTES: remove o rotacionado
+ *    mais antigo entre todas as classes
+ * 3. Arquivos ativos e reservas nunca são removidos
+ *
+ * Um rotacionado é removido como unidade: "<bak>", "<bak>.idx" e
+ * "<bak>.lzs". Idade vem do timestamp no nome (ver _backupPath()).
+ *
+ * ## Níveis
+ * | Nível    | Condição                              | Efeito                   |
+ * |----------|---------------------------------------|--------------------------|
+ * | OK       | livre >= SD_RETENTION_LOW_PCT         | -                        |
+ * | BAIXO    | livre < SD_RETENTION_LOW_PCT          | evento de saúde          |
+ * | CRITICO  | livre < 2 arquivos pré-alocados       | compressão suspensa      |
+ * | CHEIO    | livre < 1 arquivo pré-alocado         | rotação recusada         |
+ *
+ * @note Orçamento = min(cartão - dados de terceiros, SD_RETENTION_CAPACITY_MB)
+ */
+
+#ifndef RETENTION_MANAGER_H
+#define RETENTION_MANAGER_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+
+/**
+ * @class RetentionManager
+ * @brief Contabiliza o SD por classe e remove os rotacionados mais antigos
+ */
+class RetentionManager {
+public:
+    /**
+     * @brief Chamado antes de remover um rotacionado
+     * @param path Rotacionado (caminho até ".bak")
+     * @param ctx Contexto registrado em setRemoveHook()
+     */
+    typedef void (*RemoveHook)(const char* path, void* ctx);
+
+    /**
+     * @enum LogClass
+     * @brief Classe de log (cota própria)
+     */
+    enum LogClass : uint8_t {
+        CLASS_TELEMETRY = 0,   ///< Telemetria (CSV ou binária)
+        CLASS_MISSION,         ///< Dados dos ground nodes
+        CLASS_SYSTEM,          ///< system.log
+        CLASS_COUNT,           ///< Número de classes
+        CLASS_NONE = 0xFF      ///< Arquivo de terceiros (não gerenciado)
+    };
+
+    /**
+     * @enum Level
+     * @brief Situação do espaço livre no orçamento
+     */
+    enum Level : uint8_t {
+        LEVEL_OK = 0,          ///< Espaço folgado
+        LEVEL_LOW,             ///< Abaixo de SD_RETENTION_LOW_PCT
+        LEVEL_CRITICAL,        ///< Menos de duas alocações
+        LEVEL_FULL             ///< Menos de uma alocação
+    };
+
+    /**
+     * @struct Result
+     * @brief Último rotacionado removido
+     */
+    struct Result {
+        char path[64];         ///< Rotacionado removido (sem .lzs/.idx)
+        uint32_t bytes;        ///< Bytes liberados (todos os arquivos)
+        LogClass cls;          ///< Classe do arquivo
+    };
+
+    /**
+     * @brief Construtor
+     */
+    RetentionManager();
+
+    //=========================================================================
+    // CICLO DE VIDA
+    //=========================================================================
+
+    /**
+     * @brief Mede o cartão e varre a raiz (SD já montado)
+     * @note Única chamada a SD.usedBytes(): pode levar centenas de ms
+     */
+    void begin();
+
+    /**
+     * @brief Aplica a política: no máximo um rotacionado removido
+     * @return true se um arquivo foi removido (ver lastResult())
+     */
+    bool step();
+
+    /**
+     * @brief Registra quem precisa soltar um rotacionado antes da remoção
+     * @note O StorageManager aborta a compressão do arquivo escolhido
+     */
+    void setRemoveHook(RemoveHook hook, void* ctx) {
+        _removeHook = hook;
+        _removeCtx = ctx;
+    }
+
+    //=========================================================================
+    // CONTABILIDADE (eventos do StorageManager)
+    //=========================================================================
+
+    /** @brief Arquivo da classe cresceu ou foi criado */
+    void noteAdded(LogClass cls, uint32_t bytes);
+
+    /** @brief Arquivo da classe encolheu ou foi removido */
+    void noteRemoved(LogClass cls, uint32_t bytes);
+
+    /** @brief Novo rotacionado disponível para remoção */
+    void noteRotated(const char* backupPath);
+
+    //=========================================================================
+    // CONSULTA
+    //=========================================================================
+
+    /** @brief Cabe uma alocação de bytes no orçamento? */
+    bool hasRoomFor(uint32_t bytes) const { return freeBytes() >= bytes; }
+
+    /** @brief Bytes livres no orçamento */
+    uint64_t freeBytes() const {
+        uint64_t used = usedBytes();
+        return used < _budget ? _budget - used : 0;
+    }
+
+    /** @brief Bytes ocupados pelos logs gerenciados */
+    uint64_t usedBytes() const;
+
+    /** @brief Bytes ocupados por uma classe */
+    uint64_t classBytes(LogClass cls) const {
+        return cls < CLASS_COUNT ? _classBytes[cls] : 0;
+    }
+
+    /** @brief Orçamento total para os logs */
+    uint64_t budgetBytes() const { return _budget; }
+
+    /** @brief Espaço livre em % do orçamento */
+    uint8_t freePercent() const {
+        return _budget ? (uint8_t)(freeBytes() * 100 / _budget) : 0;
+    }
+
+    /** @brief Nível atual do espaço livre */
+    Level level() const { return _level; }
+
+    /** @brief Último rotacionado removido */
+    const Result& lastResult() const { return _last; }
+
+    /** @brief Classe de um caminho (CLASS_NONE = não gerenciado) */
+    static LogClass classOf(const char* path);
+
+    /** @brief Nome do nível para logs ("OK", "BAIXO", ...) */
+    static const char* levelName(Level level);
+
+    /** @brief Nome da classe para logs */
+    static const char* className(LogClass cls);
+
+    /**
+     * @brief Ordem cronológica dos timestamps de rotacionados
+     * @details Mesmo formato ordena como texto; millis() (sem RTC) é mais
+     *          curto que data/hora: o mais curto é o mais antigo.
+     * @return <0 se a for mais antigo, 0 se igual, >0 se mais novo
+     */
+    static int compareStamps(const char* a, size_t aLen, const char* b, size_t bLen);
+
+private:
+    /**
+     * @struct Candidate
+     * @brief Rotacionado removível (caminho até ".bak")
+     */
+    struct Candidate {
+        char path[64];         ///< "/<log>.<timestamp>.bak"
+        uint8_t stampPos;      ///< Início do timestamp em path
+        uint8_t stampLen;      ///< Tamanho do timestamp
+    };
+
+    static constexpr uint8_t MAX_CANDIDATES = 6;  ///< Mais antigos por classe
+
+    //=========================================================================
+    // ESTADO
+    //=========================================================================
+    uint64_t _budget;                          ///< Orçamento dos logs
+    uint64_t _classBytes[CLASS_COUNT];         ///< Ocupação por classe
+    Level _level;                              ///< Nível atual
+    bool _scanned;                             ///< begin() concluiu a varredura?
+    unsigned long _lastScanMs;                 ///< Última varredura (reconciliação)
+
+    Candidate _queue[CLASS_COUNT][MAX_CANDIDATES]; ///< Mais antigos primeiro
+    uint8_t _queued[CLASS_COUNT];              ///< Entradas em _queue
+    bool _complete[CLASS_COUNT];               ///< _queue contém todos?
+    Result _last;                              ///< Última remoção
+    RemoveHook _removeHook;                    ///< Aviso antes da remoção
+    void* _removeCtx;                          ///< Contexto de _removeHook
+
+    //=========================================================================
+    // MÉTODOS PRIVADOS
+    //=========================================================================
+
+    /** @brief Soma a raiz por classe e refaz as filas de candidatos */
+    bool _scan();
+
+    /** @brief Insere em ordem de idade; descarta o mais novo se cheia */
+    void _enqueue(LogClass cls, const Candidate& c);
+
+    /** @brief Classe a podar agora (CLASS_NONE = nada a fazer) */
+    LogClass _selectClass();
+
+    /** @brief Remove o candidato mais antigo da classe */
+    bool _prune(LogClass cls);
+
+    /** @brief Recalcula _level a partir do espaço livre */
+    void _updateLevel();
+
+    /** @brief Preenche stampPos/stampLen; false se não for rotacionado */
+    static bool _parseBackup(const char* path, Candidate& c);
+
+    /** @brief a é mais antigo que b? */
+    static bool _isOlder(const Candidate& a, const Candidate& b);
+
+    /** @brief Remove um arquivo se existir; bytes liberados */
+    static uint32_t _removeFile(const char* path);
+};
+
+#endif // RETENTION_MANAGER_H
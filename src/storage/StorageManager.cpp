@@ -1,7 +1,7 @@
 /**
  * @file StorageManager.cpp
  * @brief Gerenciador de Armazenamento (FIX: Buffer local para thread-safety)
- * @version 3.4.0
+ * @version 3.6.2
  */
 
 #include "StorageManager.h"
@@ -10,11 +10,43 @@
 
 SPIClass spiSD(HSPI);
 
+// Cabeçalhos CSV (mesmos bytes que file.println() gravava)
+static const char TELEMETRY_CSV_HEADER[] =
+    "ISO8601,UnixTimestamp,MissionTime,BatVoltage,BatPercent,"
+    "TempFinal,TempBMP,TempSI,Pressure,Altitude,"
+    "Lat,Lng,GpsAlt,Sats,Fix,"
+    "GyroX,GyroY,GyroZ,AccelX,AccelY,AccelZ,MagX,MagY,MagZ,"
+    "Humidity,CO2,TVOC,Status,Errors,Payload,"
+    "Uptime,ResetCnt,MinHeap,CpuTemp,Seq,CRC16\r\n";
+
+static const char MISSION_CSV_HEADER[] =
+    "ISO8601,UnixTimestamp,NodeID,SoilMoisture,AmbTemp,Humidity,"
+    "Irrigation,RSSI,SNR,PktsRx,PktsLost,LastRx,"
+    "NodeOriginTS,SatArrivalTS,SatTxTS,Seq,CRC16\r\n";
+
 StorageManager::StorageManager()
     : _available(false), _rtcManager(nullptr), _systemHealth(nullptr),
-      _lastInitAttempt(0), _totalWrites(0) {}
+      _lastInitAttempt(0), _totalWrites(0),
+      _telemetryLog(SD_LOG_FILE, "tlm_end", _isValidCsvLine),
+      _missionLog(SD_MISSION_FILE, "msn_end", _isValidCsvLine),
+      _binaryLog(SD_BINARY_LOG_FILE, "bin_end"),
+      _telemetryIndex(SD_LOG_FILE), _binaryIndex(SD_BINARY_LOG_FILE),
+      _spaceLevel(RetentionManager::LEVEL_OK), _droppedRecords(0),
+      _fallbackMigrated(0), _columnar(SD_COLUMNAR_FILE), _droppedAtFull(0),
+      _rotationRefused(false),
+      _binaryTelemetry(SD_TELEMETRY_BINARY), _binStateLoaded(false),
+      _binNextSeq(0), _lastStatsLog(0) {
+  memset(&_binBlock, 0, sizeof(_binBlock));
+  _telemetryLog.setStats(&_stats);
+  _missionLog.setStats(&_stats);
+  _binaryLog.setStats(&_stats);
+}
 
 bool StorageManager::begin() {
+  // Contingência montada antes do SD: registros não se perdem sem cartão
+  if (FALLBACK_ENABLED)
+    _fallback.begin();
+
   Serial.println("[StorageManager] Inicializando SD Card...");
 
   pinMode(SD_CS, OUTPUT);
@@ -36,10 +68,33 @@ bool StorageManager::begin() {
   }
 
   _available = true;
-  createTelemetryFile();
+  _binStateLoaded = false;
+  if (_binaryTelemetry)
+    createBinaryTelemetryFile();
+  else
+    createTelemetryFile();
   createMissionFile();
   createLogFile();
 
+  _reportRecovery(_binaryTelemetry ? _binaryLog : _telemetryLog);
+  _reportRecovery(_missionLog);
+
+  // Ocupação medida uma vez; depois acompanhada pelos eventos de arquivo
+  _retention.setRemoveHook(_releaseBackup, this);
+  _retention.begin();
+
+  if (SD_COLUMNAR_ARCHIVE) {
+    uint32_t now = (_rtcManager && _rtcManager->isInitialized())
+                       ? _rtcManager->getUnixTime()
+                       : 0;
+    // Layout de colunas mudou (firmware novo): arquiva o antigo e recomeça
+    if (!_columnar.begin(now) && SD.exists(SD_COLUMNAR_FILE)) {
+      String backupPath = _backupPath(SD_COLUMNAR_FILE);
+      if (_columnar.rotate(backupPath.c_str(), now))
+        _retention.noteRotated(backupPath.c_str());
+    }
+  }
+
   Serial.println("[StorageManager] SD Card inicializado com sucesso!");
   return true;
 }
@@ -52,6 +107,137 @@ void StorageManager::setSystemHealth(SystemHealth *systemHealth) {
   _systemHealth = systemHealth;
 }
 
+void StorageManager::setBinaryTelemetry(bool enable) {
+  _binaryTelemetry = enable;
+  _binStateLoaded = false;
+  if (!_available)
+    return;
+  if (enable)
+    createBinaryTelemetryFile();
+  else
+    createTelemetryFile();
+}
+
+void StorageManager::service() {
+  if (!_available) {
+    _fallback.flush(false);
+    return;
+  }
+
+  PreallocatedLog *logs[] = {_binaryTelemetry ? &_binaryLog : &_telemetryLog,
+                             &_missionLog};
+
+  // Remoção antes da pré-alocação: a reserva depende do espaço liberado
+  _serviceRetention();
+
+  // Lote migrado da flash interna ocupa a chamada
+  bool busy = _fallback.hasPending() && _serviceFallback();
+  if (!_available)
+    return;
+
+  // No máximo uma pré-alocação por chamada: a fila não espera muito
+  for (PreallocatedLog *log : logs) {
+    if (busy || !log->isOpen() || log->isSpareReady())
+      continue;
+    bool room = _retention.hasRoomFor(log->capacity());
+    if (log->prepareSpare(room)) {
+      if (log->isSpareReady())
+        _retention.noteAdded(RetentionManager::classOf(log->path()),
+                             log->capacity());
+      busy = true;
+      break;
+    }
+  }
+  for (PreallocatedLog *log : logs) {
+    log->saveCheckpoint();
+  }
+
+  if (!busy) {
+    _catchUpIndex();
+    if (SD_COLUMNAR_ARCHIVE && _columnar.isDue())
+      _flushColumns();
+    // .lzs.tmp ocupa até o tamanho do .bak: só com folga
+    if (SD_ARCHIVE_ENABLED &&
+        _retention.level() < RetentionManager::LEVEL_CRITICAL)
+      _serviceArchive();
+  }
+  (_binaryTelemetry ? _binaryIndex : _telemetryIndex).flush();
+  _serviceStats();
+}
+
+uint32_t StorageManager::queryTelemetry(uint32_t fromUnix, uint32_t toUnix,
+                                        TelemetryVisitor visit, void *ctx) {
+  if (!_available || visit == nullptr || fromUnix > toUnix)
+    return 0;
+
+  bool binary = _binaryTelemetry;
+  PreallocatedLog &log = binary ? _binaryLog : _telemetryLog;
+  uint32_t visited = 0;
+  bool more = true;
+
+  // 1. Rotacionados "<nome>.<timestamp>.bak[.lzs]", do mais antigo ao mais
+  // novo. A ordem do diretório não serve: a retenção libera entradas que a
+  // FAT reutiliza. Até QUERY_FILES por varredura do diretório.
+  char prefix[32];
+  snprintf(prefix, sizeof(prefix), "%s.", log.path() + 1);
+
+  QueryFile last;
+  const QueryFile *after = nullptr;
+  bool overflow = true;
+  while (more && overflow) {
+    uint8_t count = _collectBackups(prefix, after, overflow);
+    for (uint8_t i = 0; i < count && more; i++) {
+      char path[64];
+      snprintf(path, sizeof(path), "/%s%s.bak", prefix,
+               _queryFiles[i].stamp);
+      if (_queryFiles[i].packed) {
+        char idxPath[72];
+        char archivePath[72];
+        snprintf(idxPath, sizeof(idxPath), "%s%s", path, SD_INDEX_SUFFIX);
+        snprintf(archivePath, sizeof(archivePath), "%s%s", path,
+                 SD_ARCHIVE_SUFFIX);
+
+        // Inteiro antes do intervalo se o seguinte já começa antes de
+        // fromUnix: evita decodificar o arquivo só para descartá-lo
+        char nextIdx[72];
+        uint32_t nextStart;
+        if (i + 1 < count)
+          snprintf(nextIdx, sizeof(nextIdx), "/%s%s.bak%s", prefix,
+                   _queryFiles[i + 1].stamp, SD_INDEX_SUFFIX);
+        else if (!overflow)
+          snprintf(nextIdx, sizeof(nextIdx), "%s%s", log.path(),
+                   SD_INDEX_SUFFIX);
+        else
+          nextIdx[0] = '\0';
+        if (nextIdx[0] != '\0' &&
+            TimeIndex::lookup(nextIdx, fromUnix, nextStart))
+          continue;
+
+        more = _queryArchive(archivePath, idxPath, binary, fromUnix, toUnix,
+                             visit, ctx, visited);
+        continue;
+      }
+      File file = SD.open(path, FILE_READ);
+      if (!file)
+        continue;
+      uint32_t size = file.size();
+      file.close();
+      more = _queryFile(path, binary, size, fromUnix, toUnix, visit, ctx,
+                        visited);
+    }
+    if (count == 0)
+      break;
+    last = _queryFiles[count - 1];
+    after = &last;
+  }
+
+  // 2. Ativo, até o fim lógico
+  if (more && log.isOpen())
+    _queryFile(log.path(), binary, log.end(), fromUnix, toUnix, visit, ctx,
+               visited);
+  return visited;
+}
+
 void StorageManager::_attemptRecovery() {
   unsigned long now = millis();
   if (now - _lastInitAttempt < REINIT_INTERVAL)
@@ -60,11 +246,13 @@ void StorageManager::_attemptRecovery() {
 
   Serial.println("[StorageManager] Tentando recuperar SD Card (Hard Reset)...");
 
+  _archiver.abort();
   SD.end();
   spiSD.end();
   delay(100);
 
   if (begin()) {
+    _archiver.retryFailed();  // Falhas podem ter sido do cartão
     Serial.println("[StorageManager] RECUPERADO COM SUCESSO!");
     saveLog("Sistema de arquivos recuperado apos falha/remocao.");
   } else {
@@ -74,63 +262,141 @@ void StorageManager::_attemptRecovery() {
 }
 
 bool StorageManager::saveTelemetry(const TelemetryData &data) {
-  if (!_available) {
+  if (!_available)
     _attemptRecovery();
-    if (!_available)
-      return false;
-  }
 
-  _checkFileSize(SD_LOG_FILE);
-  File file = SD.open(SD_LOG_FILE, FILE_APPEND);
-  if (!file) {
-    Serial.println("[StorageManager] Erro de escrita (Telemetry). Marcando "
-                   "como indisponível.");
-    _available = false;
-    return false;
+  uint32_t startUs = micros();
+
+  if (_binaryTelemetry) {
+    BinLog::TelemetryRecord rec;
+    _packTelemetryRecord(data, rec);
+    if (_sdWritable()) {
+      if (_writeTelemetryRecord(rec)) {
+        _noteAppendLatency(startUs);
+        return true;
+      }
+      if (_dropIfRefused())
+        return false;
+      Serial.println("[StorageManager] Erro de escrita (Telemetry BIN). "
+                     "Marcando como indisponível.");
+      _available = false;
+    }
+    return _divert(FallbackLog::KIND_TELEMETRY_BIN, &rec, sizeof(rec));
   }
 
   // FIX: Buffer local para thread-safety
   char localBuffer[512];
   _formatTelemetryToCSV(data, localBuffer, sizeof(localBuffer));
 
-  uint16_t crc = _calculateCRC16((uint8_t *)localBuffer, strlen(localBuffer));
-  char lineWithCRC[600];
-  snprintf(lineWithCRC, sizeof(lineWithCRC), "%s,%04X", localBuffer, crc);
-
-  file.println(lineWithCRC);
-  file.close();
-
-  _totalWrites++;
-  return true;
+  if (_sdWritable()) {
+    if (_writeTelemetryCsv(localBuffer, data.timestamp, &data)) {
+      _noteAppendLatency(startUs);
+      return true;
+    }
+    if (_dropIfRefused())
+      return false;
+    Serial.println("[StorageManager] Erro de escrita (Telemetry). Marcando "
+                   "como indisponível.");
+    _available = false;
+  }
+  return _divert(FallbackLog::KIND_TELEMETRY_CSV, localBuffer,
+                 strlen(localBuffer));
 }
 
 bool StorageManager::saveMissionData(const MissionData &data) {
-  if (!_available) {
+  return saveMissionBatch(&data, 1);
+}
+
+bool StorageManager::saveMissionBatch(const MissionData *data, size_t count) {
+  if (count == 0)
+    return true;
+  if (!_available)
     _attemptRecovery();
-    if (!_available)
-      return false;
+
+  uint32_t startUs = micros();
+  char fields[512];
+  size_t done = 0;
+
+  while (done < count && _sdWritable()) {
+    // Linhas com Seq consecutivos: uma escrita enquanto couberem
+    size_t used = 0;
+    uint32_t framed = 0;
+    while (done + framed < count) {
+      _formatMissionToCSV(data[done + framed], fields, sizeof(fields));
+      size_t len = _frameLine(_missionLog, fields, _missionBatch + used,
+                              sizeof(_missionBatch) - used, framed);
+      if (len == 0)
+        break;
+      used += len;
+      framed++;
+    }
+
+    if (framed == 0 || !_appendLine(_missionLog, MISSION_CSV_HEADER,
+                                    _missionBatch, used, framed)) {
+      if (_dropIfRefused(count - done))
+        return false;
+      Serial.println("[StorageManager] Erro de escrita (Mission). Marcando "
+                     "como indisponível.");
+      _available = false;
+      break;
+    }
+    done += framed;
+    _totalWrites++;
   }
 
-  _checkFileSize(SD_MISSION_FILE);
-  File file = SD.open(SD_MISSION_FILE, FILE_APPEND);
-  if (!file) {
-    Serial.println("[StorageManager] Erro de escrita (Mission). Marcando como "
-                   "indisponível.");
-    _available = false;
-    return false;
+  if (done == count) {
+    _noteAppendLatency(startUs);
+    return true;
   }
 
-  // FIX: Buffer local para thread-safety
-  char localBuffer[512];
-  _formatMissionToCSV(data, localBuffer, sizeof(localBuffer));
+  bool ok = true;
+  for (; done < count; done++) {
+    _formatMissionToCSV(data[done], fields, sizeof(fields));
+    ok = _divert(FallbackLog::KIND_MISSION_CSV, fields, strlen(fields)) && ok;
+  }
+  return ok;
+}
 
-  uint16_t crc = _calculateCRC16((uint8_t *)localBuffer, strlen(localBuffer));
-  char lineWithCRC[400];
-  snprintf(lineWithCRC, sizeof(lineWithCRC), "%s,%04X", localBuffer, crc);
+bool StorageManager::_writeTelemetryRecord(
+    const BinLog::TelemetryRecord &rec) {
+  uint32_t from = _binaryLog.end();
+  if (!_appendBinaryRecord(rec))
+    return false;
+  uint32_t to = _binaryLog.end();
+  _binaryIndex.note(from, to - BinLog::FRAME_SIZE, to, rec.unixTime);
+  _archiveColumns(_binNextSeq - 1, rec);
+  return true;
+}
 
-  file.println(lineWithCRC);
-  file.close();
+bool StorageManager::_writeTelemetryCsv(const char *fields, uint32_t unixTime,
+                                        const TelemetryData *data) {
+  char lineWithCRC[600];
+  size_t len =
+      _frameLine(_telemetryLog, fields, lineWithCRC, sizeof(lineWithCRC));
+  if (len == 0 ||
+      !_appendLine(_telemetryLog, TELEMETRY_CSV_HEADER, lineWithCRC, len))
+    return false;
 
+  // Após rotação o offset não bate com a cobertura: indexado no catch-up
+  uint32_t to = _telemetryLog.end();
+  _telemetryIndex.note(to - len, to - len, to, unixTime);
+  _totalWrites++;
+
+  if (SD_COLUMNAR_ARCHIVE && data != nullptr) {
+    BinLog::TelemetryRecord rec;
+    _packTelemetryRecord(*data, rec);
+    _archiveColumns(_telemetryLog.seq() - 1, rec);
+  }
+  return true;
+}
+
+bool StorageManager::_writeMissionCsv(const char *fields) {
+  char lineWithCRC[400];
+  size_t len =
+      _frameLine(_missionLog, fields, lineWithCRC, sizeof(lineWithCRC));
+  if (len == 0 ||
+      !_appendLine(_missionLog, MISSION_CSV_HEADER, lineWithCRC, len))
+    return false;
   _totalWrites++;
   return true;
 }
@@ -151,66 +417,124 @@ uint16_t StorageManager::_calculateCRC16(const uint8_t *data, size_t length) {
 }
 
 bool StorageManager::saveLog(const String &message) {
-  if (!_available) {
+  if (!_available)
     _attemptRecovery();
-    if (!_available)
-      return false;
+
+  char ts[24];
+  if (_rtcManager && _rtcManager->isInitialized())
+    _rtcManager->formatDateTime(ts, sizeof(ts));
+  else
+    snprintf(ts, sizeof(ts), "%lu", millis());
+
+  // FIX: Buffer local para thread-safety
+  char localBuffer[512];
+  snprintf(localBuffer, sizeof(localBuffer), "[%s] %s", ts, message.c_str());
+
+  if (_sdWritable()) {
+    if (_appendSystemLine(localBuffer))
+      return true;
+    _available = false;
   }
+  return _divert(FallbackLog::KIND_SYSTEM, localBuffer, strlen(localBuffer));
+}
 
+bool StorageManager::_appendSystemLine(const char *line) {
   _checkFileSize(SD_SYSTEM_LOG);
+  uint32_t t = micros();
   File file = SD.open(SD_SYSTEM_LOG, FILE_APPEND);
-  if (!file) {
-    _available = false;
+  _stats.lap(StorageStats::OP_OPEN, t);
+  if (!file)
     return false;
-  }
-
-  String ts = (_rtcManager && _rtcManager->isInitialized())
-                  ? _rtcManager->getDateTime()
-                  : String(millis());
-
-  // FIX: Buffer local para thread-safety
-  char localBuffer[512];
-  snprintf(localBuffer, sizeof(localBuffer), "[%s] %s", ts.c_str(),
-           message.c_str());
 
-  uint16_t crc = _calculateCRC16((uint8_t *)localBuffer, strlen(localBuffer));
+  uint16_t crc = _calculateCRC16((const uint8_t *)line, strlen(line));
   char lineWithCRC[600];
-  snprintf(lineWithCRC, sizeof(lineWithCRC), "%s,%04X", localBuffer, crc);
+  snprintf(lineWithCRC, sizeof(lineWithCRC), "%s,%04X", line, crc);
 
+  t = micros();
   file.println(lineWithCRC);
+  _stats.lap(StorageStats::OP_WRITE, t);
+  file.flush();
+  _stats.lap(StorageStats::OP_FLUSH, t);
   file.close();
+  _stats.lap(StorageStats::OP_CLOSE, t);
+  _retention.noteAdded(RetentionManager::CLASS_SYSTEM, strlen(lineWithCRC) + 2);
   return true;
 }
 
 bool StorageManager::createTelemetryFile() {
-  if (SD.exists(SD_LOG_FILE))
-    return true;
-  File file = SD.open(SD_LOG_FILE, FILE_WRITE);
-  if (!file)
+  if (!_telemetryLog.open() ||
+      !_writeHeader(_telemetryLog, TELEMETRY_CSV_HEADER))
     return false;
-
-  file.print(F("ISO8601,UnixTimestamp,MissionTime,BatVoltage,BatPercent,"));
-  file.print(F("TempFinal,TempBMP,TempSI,Pressure,Altitude,"));
-  file.print(F("Lat,Lng,GpsAlt,Sats,Fix,"));
-  file.print(F("GyroX,GyroY,GyroZ,AccelX,AccelY,AccelZ,MagX,MagY,MagZ,"));
-  file.print(F("Humidity,CO2,TVOC,Status,Errors,Payload,"));
-  file.println(F("Uptime,ResetCnt,MinHeap,CpuTemp,CRC16"));
-  file.close();
+  _telemetryIndex.load(_telemetryLog.end());
   return true;
 }
 
-bool StorageManager::createMissionFile() {
-  if (SD.exists(SD_MISSION_FILE))
-    return true;
-  File file = SD.open(SD_MISSION_FILE, FILE_WRITE);
+bool StorageManager::createBinaryTelemetryFile() {
+  if (!_binaryLog.open())
+    return false;
+  _binStateLoaded = false;
+
+  File file = SD.open(SD_BINARY_LOG_FILE, "r+");
   if (!file)
     return false;
 
-  file.print(F("ISO8601,UnixTimestamp,NodeID,SoilMoisture,AmbTemp,Humidity,"));
-  file.print(F("Irrigation,RSSI,SNR,PktsRx,PktsLost,LastRx,"));
-  file.println(F("NodeOriginTS,SatArrivalTS,SatTxTS,CRC16"));
+  BinLog::FileHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  bool valid = file.read((uint8_t *)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+               BinLog::isValidFileHeader(hdr);
+
+  // Log de outra versão do formato: preservar como .bak em vez de sobrescrever
+  if (!valid && hdr.magic == BinLog::FILE_MAGIC) {
+    file.close();
+    Serial.printf("[StorageManager] %s em formato v%u, rotacionando.\n",
+                  SD_BINARY_LOG_FILE, hdr.version);
+    if (!_rotateLog(_binaryLog))
+      return false;
+    file = SD.open(SD_BINARY_LOG_FILE, "r+");
+    if (!file)
+      return false;
+  }
+
+  if (valid) {
+    _loadBinaryState(file);
+    file.close();
+    _binaryIndex.load(_binaryLog.end());
+    return true;
+  }
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.magic = BinLog::FILE_MAGIC;
+  hdr.version = BinLog::FORMAT_VERSION;
+  hdr.headerArea = BinLog::HEADER_AREA;
+  hdr.blockSize = BinLog::BLOCK_SIZE;
+  hdr.recordSize = sizeof(BinLog::TelemetryRecord);
+  hdr.recordType = BinLog::RECORD_TELEMETRY;
+  hdr.teamId = TEAM_ID;
+  hdr.utcOffsetSec = RTCManager::getUtcOffsetSeconds();
+  hdr.createdUnix = (_rtcManager && _rtcManager->isInitialized())
+                        ? _rtcManager->getUnixTime()
+                        : 0;
+  hdr.crc32 = BinLog::crc32(0, &hdr, sizeof(hdr) - sizeof(uint32_t));
+
+  // Área de cabeçalho completa + bloco 0 vazio (cabeçalho zerado e 0x00 no
+  // primeiro frame): o arquivo é pré-alocado e pode conter dados antigos
+  uint8_t area[BinLog::HEADER_AREA + sizeof(BinLog::BlockHeader) + 1];
+  memset(area, 0, sizeof(area));
+  memcpy(area, &hdr, sizeof(hdr));
+  bool ok = file.seek(0) && file.write(area, sizeof(area)) == sizeof(area);
+
+  if (ok) {
+    _binaryLog.setEnd(BinLog::HEADER_AREA);
+    _loadBinaryState(file);
+  }
   file.close();
-  return true;
+  if (ok)
+    _binaryIndex.load(_binaryLog.end());
+  return ok;
+}
+
+bool StorageManager::createMissionFile() {
+  return _missionLog.open() && _writeHeader(_missionLog, MISSION_CSV_HEADER);
 }
 
 bool StorageManager::createLogFile() {
@@ -236,28 +560,1144 @@ bool StorageManager::_checkFileSize(const char *path) {
   file.close();
 
   if (size > SD_MAX_FILE_SIZE) {
-    String timestamp = (_rtcManager && _rtcManager->isInitialized())
-                           ? _rtcManager->getDateTime()
-                           : String(millis());
-    timestamp.replace(" ", "_");
-    timestamp.replace(":", "-");
-
-    String backupPath = String(path) + "." + timestamp + ".bak";
+    String backupPath = _backupPath(path);
     SD.rename(path, backupPath.c_str());
+    _retention.noteRotated(backupPath.c_str());
 
     Serial.printf("[StorageManager] Arquivo rotacionado: %s\n",
                   backupPath.c_str());
 
-    if (strcmp(path, SD_LOG_FILE) == 0)
-      createTelemetryFile();
-    else if (strcmp(path, SD_MISSION_FILE) == 0)
-      createMissionFile();
-    else if (strcmp(path, SD_SYSTEM_LOG) == 0)
+    if (strcmp(path, SD_SYSTEM_LOG) == 0)
       createLogFile();
   }
   return true;
 }
 
+String StorageManager::_backupPath(const char *path) {
+  char ts[24];
+  if (_rtcManager && _rtcManager->isInitialized()) {
+    _rtcManager->formatDateTime(ts, sizeof(ts), '_');
+    for (char *p = ts; *p; p++)
+      if (*p == ':')
+        *p = '-';
+  } else {
+    snprintf(ts, sizeof(ts), "%lu", millis());
+  }
+  return String(path) + "." + ts + ".bak";
+}
+
+bool StorageManager::_rotateLog(PreallocatedLog &log) {
+  // Sem reserva e sem espaço: mantém o ativo cheio em vez de perdê-lo
+  bool hadSpare = log.isSpareReady();
+  _rotationRefused = !hadSpare && !_retention.hasRoomFor(log.capacity());
+  if (_rotationRefused)
+    return false;
+
+  uint32_t end = log.end();
+  String backupPath = _backupPath(log.path());
+  if (!log.rotate(backupPath.c_str())) {
+    Serial.printf("[StorageManager] ERRO: Falha ao rotacionar %s\n",
+                  log.path());
+    return false;
+  }
+  Serial.printf("[StorageManager] Arquivo rotacionado: %s\n",
+                backupPath.c_str());
+
+  // Truncate devolve a cauda pré-alocada; sem reserva houve alocação nova
+  RetentionManager::LogClass cls = RetentionManager::classOf(log.path());
+  _retention.noteRemoved(cls, log.capacity() - end);
+  if (!hadSpare)
+    _retention.noteAdded(cls, log.capacity());
+  _retention.noteRotated(backupPath.c_str());
+
+  // Índice acompanha o log; o do novo arquivo é reconstruído sob demanda
+  if (&log == &_telemetryLog)
+    _telemetryIndex.rotate(backupPath.c_str());
+  else if (&log == &_binaryLog)
+    _binaryIndex.rotate(backupPath.c_str());
+  return true;
+}
+
+bool StorageManager::_writeHeader(PreallocatedLog &log, const char *header) {
+  if (log.end() > 0)
+    return true;
+  return log.append((const uint8_t *)header, strlen(header));
+}
+
+size_t StorageManager::_frameLine(PreallocatedLog &log, const char *fields,
+                                  char *out, size_t outSize, uint32_t ahead) {
+  // Sequência vem do log aberto (open() a recupera do checkpoint)
+  if (!log.isOpen() && !log.open())
+    return 0;
+
+  int n = snprintf(out, outSize, "%s,%lu", fields,
+                   (unsigned long)(log.seq() + ahead));
+  if (n < 0 || (size_t)n + 8 > outSize)
+    return 0;
+
+  uint16_t crc = _calculateCRC16((const uint8_t *)out, n);
+  n += snprintf(out + n, outSize - n, ",%04X\r\n", crc);
+  return n;
+}
+
+bool StorageManager::_appendLine(PreallocatedLog &log, const char *header,
+                                 const char *line, size_t len,
+                                 uint32_t count) {
+  if (!log.fits(len) && !_rotateLog(log))
+    return false;
+
+  return _writeHeader(log, header) &&
+         log.appendRecords((const uint8_t *)line, len, count);
+}
+
+void StorageManager::_reportRecovery(const PreallocatedLog &log) {
+  if (!log.isOpen() || (log.getRecoveredRecords() == 0 && !log.hadTornTail()))
+    return;
+
+  char msg[128];
+  snprintf(msg, sizeof(msg),
+           "Recuperacao %s: %lu registros apos checkpoint, proxima seq %lu%s",
+           log.path(), (unsigned long)log.getRecoveredRecords(),
+           (unsigned long)log.seq(),
+           log.hadTornTail() ? ", registro rasgado descartado" : "");
+  Serial.printf("[StorageManager] %s\n", msg);
+  saveLog(msg);
+}
+
+bool StorageManager::_isValidCsvLine(const char *line, size_t len,
+                                     uint32_t offset) {
+  // Linhas gravadas com "\r\n"
+  if (len < 2 || line[len - 1] != '\n')
+    return false;
+  size_t n = len - 1;
+  if (line[n - 1] == '\r')
+    n--;
+
+  // Cabeçalho (offset 0) não tem CRC: apenas texto imprimível
+  if (offset == 0) {
+    for (size_t i = 0; i < n; i++) {
+      if (line[i] < 0x20 || line[i] > 0x7E)
+        return false;
+    }
+    return n > 0;
+  }
+
+  // Demais linhas: "...,XXXX" com CRC-16 do conteúdo anterior à vírgula
+  if (n < 6 || line[n - 5] != ',')
+    return false;
+  uint16_t crc = 0;
+  for (size_t i = n - 4; i < n; i++) {
+    char c = line[i];
+    uint8_t nibble;
+    if (c >= '0' && c <= '9')
+      nibble = c - '0';
+    else if (c >= 'A' && c <= 'F')
+      nibble = c - 'A' + 10;
+    else
+      return false;
+    crc = (crc << 4) | nibble;
+  }
+  return _calculateCRC16((const uint8_t *)line, n - 5) == crc;
+}
+
+void StorageManager::_noteAppendLatency(uint32_t startUs) {
+  uint32_t us = micros() - startUs;
+  _stats.record(StorageStats::OP_APPEND, us);
+  if (_systemHealth != nullptr)
+    _systemHealth->reportStorageLatency(us);
+}
+
+bool StorageManager::_appendBinaryRecord(const BinLog::TelemetryRecord &rec) {
+  // "r+" permite posicionar a escrita (FILE_APPEND ignora seek)
+  uint32_t t = micros();
+  File file = SD.open(SD_BINARY_LOG_FILE, "r+");
+  _stats.lap(StorageStats::OP_OPEN, t);
+  if (!file)
+    return false;
+
+  if (!_binStateLoaded)
+    _loadBinaryState(file);
+
+  // Bloco cheio (já selado): próximo slot de 4 KB
+  if (_binBlock.recordCount >= BinLog::RECORDS_PER_BLOCK) {
+    uint32_t next = _binBlock.blockIndex + 1;
+
+    // Slot seguinte além da área pré-alocada: rotacionar para a reserva
+    if (BinLog::blockOffset(next) + BinLog::BLOCK_SIZE >
+        _binaryLog.capacity()) {
+      file.close();
+      if (!_rotateLog(_binaryLog) || !createBinaryTelemetryFile())
+        return false;
+      t = micros();
+      file = SD.open(SD_BINARY_LOG_FILE, "r+");
+      _stats.lap(StorageStats::OP_OPEN, t);
+      if (!file)
+        return false;
+    } else {
+      memset(&_binBlock, 0, sizeof(_binBlock));
+      _binBlock.magic = BinLog::BLOCK_MAGIC;
+      _binBlock.blockIndex = next;
+      _binBlock.firstRecordSeq = _binNextSeq;
+    }
+  }
+
+  bool newBlock = (_binBlock.recordCount == 0);
+  if (newBlock)
+    _binBlock.firstTimestamp = rec.unixTime;
+
+  // Frame + 0x00 (fim lógico) em uma única escrita. Primeiro frame do bloco
+  // leva junto o cabeçalho zerado: o slot pode conter um bloco antigo
+  uint8_t buf[sizeof(BinLog::BlockHeader) + BinLog::FRAME_SIZE + 1];
+  uint8_t *frame = buf + sizeof(BinLog::BlockHeader);
+  BinLog::encodeFrame(frame, _binNextSeq, rec);
+  frame[BinLog::FRAME_SIZE] = 0;
+
+  uint32_t base = BinLog::blockOffset(_binBlock.blockIndex);
+  t = micros();
+  bool ok;
+  if (newBlock) {
+    memset(buf, 0, sizeof(BinLog::BlockHeader));
+    ok = file.seek(base) && file.write(buf, sizeof(buf)) == sizeof(buf);
+  } else {
+    size_t n = BinLog::FRAME_SIZE + 1;
+    ok = file.seek(base + sizeof(BinLog::BlockHeader) + _binBlock.payloadLen) &&
+         file.write(frame, n) == n;
+  }
+
+  if (ok) {
+    _binBlock.payloadLen += BinLog::FRAME_SIZE;
+    _binBlock.recordCount++;
+    _binBlock.lastTimestamp = rec.unixTime;
+    _binBlock.payloadCrc32 =
+        BinLog::crc32(_binBlock.payloadCrc32, frame, BinLog::FRAME_SIZE);
+
+    // Cabeçalho só é gravado com o bloco completo
+    if (_binBlock.recordCount == BinLog::RECORDS_PER_BLOCK)
+      ok = _sealBinaryBlock(file);
+  }
+  _stats.lap(StorageStats::OP_WRITE, t);
+  file.flush();
+  _stats.lap(StorageStats::OP_FLUSH, t);
+  file.close();
+  _stats.lap(StorageStats::OP_CLOSE, t);
+
+  if (!ok) {
+    // Estado em RAM pode divergir do cartão: recarregar na próxima escrita
+    _binStateLoaded = false;
+    return false;
+  }
+
+  _binaryLog.setEnd(base + sizeof(BinLog::BlockHeader) + _binBlock.payloadLen);
+  _binaryLog.setSeq(++_binNextSeq);
+  _totalWrites++;
+  return true;
+}
+
+bool StorageManager::_sealBinaryBlock(File &file) {
+  _binBlock.headerCrc32 = BinLog::blockHeaderCrc(_binBlock);
+  bool ok = file.seek(BinLog::blockOffset(_binBlock.blockIndex)) &&
+            file.write((const uint8_t *)&_binBlock, sizeof(_binBlock)) ==
+                sizeof(_binBlock);
+
+  // Slot seguinte vazio (cabeçalho zerado + 0x00 no primeiro frame): um
+  // reset antes do próximo registro não encontra dados antigos ali
+  uint8_t empty[sizeof(BinLog::BlockHeader) + 1];
+  uint32_t nextBase = BinLog::blockOffset(_binBlock.blockIndex + 1);
+  if (ok && nextBase + sizeof(empty) <= _binaryLog.capacity()) {
+    memset(empty, 0, sizeof(empty));
+    ok = file.seek(nextBase) && file.write(empty, sizeof(empty)) == sizeof(empty);
+  }
+  return ok;
+}
+
+bool StorageManager::_scanBinaryFrames(File &file, uint32_t idx, bool haveSeq,
+                                       uint32_t expectedSeq) {
+  memset(&_binBlock, 0, sizeof(_binBlock));
+  _binBlock.magic = BinLog::BLOCK_MAGIC;
+  _binBlock.blockIndex = idx;
+  _binBlock.firstRecordSeq = expectedSeq;
+
+  if (!file.seek(BinLog::blockOffset(idx) + sizeof(BinLog::BlockHeader)))
+    return false;
+
+  uint8_t frame[BinLog::FRAME_SIZE];
+  while (_binBlock.recordCount < BinLog::RECORDS_PER_BLOCK) {
+    uint32_t seq;
+    BinLog::TelemetryRecord rec;
+    if (file.read(frame, sizeof(frame)) != sizeof(frame))
+      return false;
+    if (!BinLog::decodeFrame(frame, seq, rec) ||
+        (haveSeq && seq != expectedSeq)) {
+      // 0x00 = fim lógico; qualquer outro byte = frame rasgado
+      return frame[0] != 0;
+    }
+
+    if (_binBlock.recordCount == 0) {
+      _binBlock.firstRecordSeq = seq;
+      _binBlock.firstTimestamp = rec.unixTime;
+    }
+    _binBlock.lastTimestamp = rec.unixTime;
+    _binBlock.payloadCrc32 =
+        BinLog::crc32(_binBlock.payloadCrc32, frame, sizeof(frame));
+    _binBlock.payloadLen += BinLog::FRAME_SIZE;
+    _binBlock.recordCount++;
+    haveSeq = true;
+    expectedSeq = seq + 1;
+  }
+  return false;
+}
+
+void StorageManager::_loadBinaryState(File &file) {
+  auto readHeader = [&file](uint32_t idx, BinLog::BlockHeader &hdr) -> bool {
+    return file.seek(BinLog::blockOffset(idx)) &&
+           file.read((uint8_t *)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+           BinLog::isValidBlockHeader(hdr) && hdr.blockIndex == idx;
+  };
+
+  _binStateLoaded = true;
+
+  uint32_t maxBlocks =
+      (_binaryLog.capacity() - BinLog::HEADER_AREA) / BinLog::BLOCK_SIZE;
+
+  // Partida: bloco anterior ao que continha o fim lógico no checkpoint (seu
+  // cabeçalho selado fornece a sequência esperada)
+  uint32_t start = 0;
+  uint32_t cp = _binaryLog.end();
+  if (cp > BinLog::HEADER_AREA)
+    start = min((cp - BinLog::HEADER_AREA) / BinLog::BLOCK_SIZE, maxBlocks - 1);
+  if (start > 0)
+    start--;
+
+  for (;;) {
+    bool haveSeq = false;
+    bool torn = false;
+    uint32_t expected = _binaryLog.seq();
+    uint32_t recovered = 0;
+    uint32_t idx = start;
+
+    // Blocos selados em sequência contínua; o primeiro não selado é o bloco
+    // aberto, cujos frames são validados um a um
+    for (; idx < maxBlocks; idx++) {
+      BinLog::BlockHeader hdr;
+      if (readHeader(idx, hdr) &&
+          (!haveSeq || hdr.firstRecordSeq == expected)) {
+        _binBlock = hdr;
+      } else {
+        torn = _scanBinaryFrames(file, idx, haveSeq, expected);
+        if (_binBlock.recordCount < BinLog::RECORDS_PER_BLOCK)
+          break;
+        // Bloco completo sem cabeçalho: reset durante a selagem
+        _sealBinaryBlock(file);
+      }
+      if (idx > start)
+        recovered += _binBlock.recordCount;
+      haveSeq = true;
+      expected = _binBlock.firstRecordSeq + _binBlock.recordCount;
+    }
+
+    // Bloco de partida vazio: checkpoint de outro arquivo/cartão
+    if (idx == start && start > 0 && _binBlock.recordCount == 0) {
+      Serial.println("[StorageManager] Checkpoint binario invalido, varrendo "
+                     "desde o inicio.");
+      start = 0;
+      continue;
+    }
+
+    if (idx < maxBlocks)
+      recovered += _binBlock.recordCount;
+    _binaryLog.setRecovery(recovered, torn);
+    break;
+  }
+
+  _binNextSeq = _binBlock.firstRecordSeq + _binBlock.recordCount;
+  _binaryLog.setSeq(_binNextSeq);
+  _binaryLog.setEnd(BinLog::blockOffset(_binBlock.blockIndex) +
+                    sizeof(BinLog::BlockHeader) + _binBlock.payloadLen);
+}
+
+void StorageManager::_packTelemetryRecord(const TelemetryData &data,
+                                          BinLog::TelemetryRecord &rec) {
+  memset(&rec, 0, sizeof(rec));
+
+  rec.unixTime = data.timestamp;
+  rec.missionTime = data.missionTime;
+  rec.batteryVoltage = data.batteryVoltage;
+  rec.batteryPercentage = data.batteryPercentage;
+  rec.temperature = data.temperature;
+  rec.temperatureBMP = data.temperatureBMP;
+  rec.temperatureSI = data.temperatureSI;
+  rec.pressure = data.pressure;
+  rec.altitude = data.altitude;
+  rec.latitudeE7 = (int32_t)lround(data.latitude * 1e7);
+  rec.longitudeE7 = (int32_t)lround(data.longitude * 1e7);
+  rec.gpsAltitude = data.gpsAltitude;
+  rec.satellites = data.satellites;
+
+  if (data.gpsFix)
+    rec.flags |= BinLog::FLAG_GPS_FIX;
+  if (_rtcManager != nullptr && _rtcManager->isInitialized())
+    rec.flags |= BinLog::FLAG_RTC_VALID;
+
+  rec.gyro[0] = data.gyroX;
+  rec.gyro[1] = data.gyroY;
+  rec.gyro[2] = data.gyroZ;
+  rec.accel[0] = data.accelX;
+  rec.accel[1] = data.accelY;
+  rec.accel[2] = data.accelZ;
+  rec.mag[0] = data.magX;
+  rec.mag[1] = data.magY;
+  rec.mag[2] = data.magZ;
+
+  rec.humidity = data.humidity;
+  rec.co2 = data.co2;
+  rec.tvoc = data.tvoc;
+  rec.systemStatus = data.systemStatus;
+  rec.errorCount = data.errorCount;
+  rec.uptime = data.uptime;
+  rec.resetCount = data.resetCount;
+  rec.minFreeHeap = data.minFreeHeap;
+  rec.cpuTemp = data.cpuTemp;
+}
+
+void StorageManager::_unpackTelemetryRecord(const BinLog::TelemetryRecord &rec,
+                                            TelemetryData &data) {
+  memset(&data, 0, sizeof(data));
+
+  data.timestamp = rec.unixTime;
+  data.missionTime = rec.missionTime;
+  data.batteryVoltage = rec.batteryVoltage;
+  data.batteryPercentage = rec.batteryPercentage;
+  data.temperature = rec.temperature;
+  data.temperatureBMP = rec.temperatureBMP;
+  data.temperatureSI = rec.temperatureSI;
+  data.pressure = rec.pressure;
+  data.altitude = rec.altitude;
+  data.latitude = rec.latitudeE7 / 1e7;
+  data.longitude = rec.longitudeE7 / 1e7;
+  data.gpsAltitude = rec.gpsAltitude;
+  data.satellites = rec.satellites;
+  data.gpsFix = (rec.flags & BinLog::FLAG_GPS_FIX) != 0;
+
+  data.gyroX = rec.gyro[0];
+  data.gyroY = rec.gyro[1];
+  data.gyroZ = rec.gyro[2];
+  data.accelX = rec.accel[0];
+  data.accelY = rec.accel[1];
+  data.accelZ = rec.accel[2];
+  data.magX = rec.mag[0];
+  data.magY = rec.mag[1];
+  data.magZ = rec.mag[2];
+
+  data.humidity = rec.humidity;
+  data.co2 = rec.co2;
+  data.tvoc = rec.tvoc;
+  data.systemStatus = rec.systemStatus;
+  data.errorCount = rec.errorCount;
+  data.uptime = rec.uptime;
+  data.resetCount = rec.resetCount;
+  data.minFreeHeap = rec.minFreeHeap;
+  data.cpuTemp = rec.cpuTemp;
+}
+
+bool StorageManager::_parseTelemetryCSV(const char *line, size_t len,
+                                        TelemetryData &data, uint32_t &seq) {
+  // Colunas de TELEMETRY_CSV_HEADER sem o CRC16 (34 em linhas sem Seq)
+  static const uint8_t FIELDS = 35;
+  char buf[640];
+  if (len >= sizeof(buf))
+    return false;
+  memcpy(buf, line, len);
+  buf[len] = '\0';
+
+  char *f[FIELDS];
+  uint8_t count = 0;
+  f[count++] = buf;
+  for (char *p = buf; *p != '\0'; p++) {
+    if (*p == ',') {
+      if (count == FIELDS)
+        return false;
+      *p = '\0';
+      f[count++] = p + 1;
+    }
+  }
+  if (count != FIELDS && count != FIELDS - 1)
+    return false;
+
+  auto u = [&f](uint8_t i) { return strtoul(f[i], nullptr, 10); };
+  auto d = [&f](uint8_t i) { return (float)strtod(f[i], nullptr); };
+
+  memset(&data, 0, sizeof(data));
+  data.timestamp = u(1);
+  data.missionTime = u(2);
+  data.batteryVoltage = d(3);
+  data.batteryPercentage = d(4);
+  data.temperature = d(5);
+  data.temperatureBMP = d(6);
+  data.temperatureSI = d(7);
+  data.pressure = d(8);
+  data.altitude = d(9);
+  data.latitude = strtod(f[10], nullptr);
+  data.longitude = strtod(f[11], nullptr);
+  data.gpsAltitude = d(12);
+  data.satellites = u(13);
+  data.gpsFix = u(14) != 0;
+  data.gyroX = d(15);
+  data.gyroY = d(16);
+  data.gyroZ = d(17);
+  data.accelX = d(18);
+  data.accelY = d(19);
+  data.accelZ = d(20);
+  data.magX = d(21);
+  data.magY = d(22);
+  data.magZ = d(23);
+  data.humidity = d(24);
+  data.co2 = d(25);
+  data.tvoc = d(26);
+  data.systemStatus = u(27);
+  data.errorCount = u(28);
+  data.uptime = u(30);
+  data.resetCount = u(31);
+  data.minFreeHeap = u(32);
+  data.cpuTemp = d(33);
+  seq = (count == FIELDS) ? u(34) : 0;
+  return true;
+}
+
+bool StorageManager::_readStoredTelemetry(File &file, bool binary,
+                                          uint32_t &offset,
+                                          uint32_t &recordOffset,
+                                          uint32_t &seq, TelemetryData &data) {
+  if (binary) {
+    recordOffset = _frameOffset(offset);
+
+    uint8_t frame[BinLog::FRAME_SIZE];
+    BinLog::TelemetryRecord rec;
+    if (!file.seek(recordOffset) ||
+        file.read(frame, sizeof(frame)) != sizeof(frame) ||
+        !BinLog::decodeFrame(frame, seq, rec))
+      return false;
+
+    offset = recordOffset + BinLog::FRAME_SIZE;
+    _unpackTelemetryRecord(rec, data);
+    return true;
+  }
+
+  char line[640];
+  for (;;) {
+    if (!file.seek(offset))
+      return false;
+    size_t got = file.read((uint8_t *)line, sizeof(line));
+    const char *nl = (const char *)memchr(line, '\n', got);
+    if (nl == nullptr)
+      return false;
+
+    size_t len = nl - line + 1;
+    if (!_isValidCsvLine(line, len, offset))
+      return false;
+
+    recordOffset = offset;
+    offset += len;
+    if (recordOffset > 0) {
+      // Sem ",CRC16\r\n" (o CRC já foi conferido)
+      size_t n = len - 1;
+      if (line[n - 1] == '\r')
+        n--;
+      return _parseTelemetryCSV(line, n - 5, data, seq);
+    }
+  }
+}
+
+uint32_t StorageManager::_frameOffset(uint32_t offset) {
+  // Frames ficam após o cabeçalho de cada bloco de 4 KB
+  if (offset < BinLog::HEADER_AREA)
+    offset = BinLog::HEADER_AREA;
+  uint32_t rel = (offset - BinLog::HEADER_AREA) % BinLog::BLOCK_SIZE;
+  uint32_t base = offset - rel;
+  if (rel < sizeof(BinLog::BlockHeader)) {
+    rel = sizeof(BinLog::BlockHeader);
+  } else if (rel + BinLog::FRAME_SIZE >
+             sizeof(BinLog::BlockHeader) +
+                 BinLog::RECORDS_PER_BLOCK * BinLog::FRAME_SIZE) {
+    base += BinLog::BLOCK_SIZE;
+    rel = sizeof(BinLog::BlockHeader);
+  }
+  return base + rel;
+}
+
+bool StorageManager::_queryFile(const char *path, bool binary, uint32_t end,
+                                uint32_t fromUnix, uint32_t toUnix,
+                                TelemetryVisitor visit, void *ctx,
+                                uint32_t &visited) {
+  char idxPath[72];
+  snprintf(idxPath, sizeof(idxPath), "%s%s", path, SD_INDEX_SUFFIX);
+
+  // O(log n) no índice; sem índice (arquivo antigo) começa do início
+  uint32_t offset = 0;
+  TimeIndex::lookup(idxPath, fromUnix, offset);
+
+  File file = SD.open(path, FILE_READ);
+  if (!file)
+    return true;
+
+  bool more = true;
+  uint32_t seq;
+  uint32_t recordOffset;
+  TelemetryData data;
+  while (offset < end && _readStoredTelemetry(file, binary, offset,
+                                              recordOffset, seq, data)) {
+    if (data.timestamp < fromUnix)
+      continue;
+    if (data.timestamp > toUnix)
+      break;
+    visited++;
+    if (!visit(data, seq, ctx)) {
+      more = false;
+      break;
+    }
+  }
+  file.close();
+  return more;
+}
+
+bool StorageManager::_queryArchive(const char *path, const char *idxPath,
+                                   bool binary, uint32_t fromUnix,
+                                   uint32_t toUnix, TelemetryVisitor visit,
+                                   void *ctx, uint32_t &visited) {
+  // O .idx do .bak continua válido: offsets são do arquivo original
+  uint32_t start = 0;
+  if (SD.exists(idxPath)) {
+    uint32_t first;
+    if (toUnix < UINT32_MAX && !TimeIndex::lookup(idxPath, toUnix + 1, first))
+      return true; // Começa depois do intervalo
+    TimeIndex::lookup(idxPath, fromUnix, start);
+  }
+
+  File file = SD.open(path, FILE_READ);
+  if (!file)
+    return true;
+
+  LogArchive::Header header;
+  LogArchive::Trailer trailer;
+  uint32_t size = file.size();
+  bool valid =
+      size >= sizeof(header) + sizeof(trailer) &&
+      file.read((uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+      LogArchive::isValidHeader(header) &&
+      file.seek(size - sizeof(trailer)) &&
+      file.read((uint8_t *)&trailer, sizeof(trailer)) == sizeof(trailer) &&
+      trailer.magic == LogArchive::TRAILER_MAGIC &&
+      sizeof(header) + trailer.packedSize + sizeof(trailer) == size &&
+      file.seek(sizeof(header));
+  if (!valid) {
+    file.close();
+    Serial.printf("[StorageManager] %s invalido, fora da consulta\n", path);
+    return true;
+  }
+
+  ArchiveCursor cursor;
+  cursor.binary = binary;
+  cursor.pos = 0;
+  cursor.next = binary ? _frameOffset(start) : start;
+  cursor.len = 0;
+  cursor.fromUnix = fromUnix;
+  cursor.toUnix = toUnix;
+  cursor.visit = visit;
+  cursor.ctx = ctx;
+  cursor.visited = &visited;
+  cursor.more = true;
+
+  // LZSS não tem ponto de reentrada: decodifica desde o início, mas só os
+  // registros a partir da entrada do índice são analisados
+  _queryDecoder.begin(trailer.rawSize, _archiveSink, &cursor);
+  uint8_t chunk[256];
+  uint32_t left = trailer.packedSize;
+  bool ok = true;
+  while (ok && left > 0) {
+    size_t n = left < sizeof(chunk) ? left : sizeof(chunk);
+    ok = file.read(chunk, n) == n && _queryDecoder.feed(chunk, n);
+    left -= n;
+  }
+  if (ok)
+    _queryDecoder.finish();
+  file.close();
+  return cursor.more;
+}
+
+bool StorageManager::_archiveSink(const uint8_t *data, size_t len,
+                                  void *ctx) {
+  ArchiveCursor &c = *static_cast<ArchiveCursor *>(ctx);
+  while (len > 0) {
+    // Antes do próximo registro: descartado sem análise
+    if (c.pos < c.next) {
+      uint32_t skip = c.next - c.pos;
+      if (skip > len)
+        skip = len;
+      c.pos += skip;
+      data += skip;
+      len -= skip;
+      continue;
+    }
+
+    size_t take = (c.binary ? BinLog::FRAME_SIZE : sizeof(c.buf)) - c.len;
+    if (take > len)
+      take = len;
+    if (!c.binary) {
+      const uint8_t *nl = (const uint8_t *)memchr(data, '\n', take);
+      if (nl != nullptr)
+        take = nl - data + 1;
+    }
+    memcpy(c.buf + c.len, data, take);
+    c.len += take;
+    c.pos += take;
+    data += take;
+    len -= take;
+
+    bool complete = c.binary ? c.len == BinLog::FRAME_SIZE
+                             : c.buf[c.len - 1] == '\n';
+    if (!complete) {
+      // Linha maior que o buffer: fim dos dados válidos
+      if (c.len == sizeof(c.buf))
+        return false;
+      continue;
+    }
+    if (!_takeArchived(c))
+      return false;
+    c.next = c.binary ? _frameOffset(c.next + BinLog::FRAME_SIZE) : c.pos;
+    c.len = 0;
+  }
+  return true;
+}
+
+bool StorageManager::_takeArchived(ArchiveCursor &c) {
+  uint32_t seq;
+  TelemetryData data;
+  if (c.binary) {
+    BinLog::TelemetryRecord rec;
+    if (!BinLog::decodeFrame(c.buf, seq, rec))
+      return false;
+    _unpackTelemetryRecord(rec, data);
+  } else {
+    const char *line = (const char *)c.buf;
+    if (!_isValidCsvLine(line, c.len, c.next))
+      return false;
+    if (c.next == 0)
+      return true; // Cabeçalho
+    // Sem ",CRC16\r\n" (o CRC já foi conferido)
+    size_t n = c.len - 1;
+    if (line[n - 1] == '\r')
+      n--;
+    if (!_parseTelemetryCSV(line, n - 5, data, seq))
+      return false;
+  }
+
+  if (data.timestamp < c.fromUnix)
+    return true;
+  if (data.timestamp > c.toUnix)
+    return false;
+  (*c.visited)++;
+  if (!c.visit(data, seq, c.ctx)) {
+    c.more = false;
+    return false;
+  }
+  return true;
+}
+
+uint8_t StorageManager::_collectBackups(const char *prefix,
+                                       const QueryFile *after,
+                                       bool &overflow) {
+  overflow = false;
+  File root = SD.open("/");
+  if (!root)
+    return 0;
+
+  size_t prefixLen = strlen(prefix);
+  uint8_t count = 0;
+  for (File entry = root.openNextFile(); entry; entry = root.openNextFile()) {
+    const char *name = entry.name();
+    if (name[0] == '/')
+      name++;
+    size_t n = strlen(name);
+    // "<stamp>.bak" ou, já comprimido, "<stamp>.bak.lzs"
+    size_t suffix = sizeof(".bak") - 1;
+    bool packed = n > sizeof(SD_ARCHIVE_SUFFIX) - 1 &&
+                  strcmp(name + n - (sizeof(SD_ARCHIVE_SUFFIX) - 1),
+                         SD_ARCHIVE_SUFFIX) == 0;
+    if (packed)
+      suffix += sizeof(SD_ARCHIVE_SUFFIX) - 1;
+    bool backup = strncmp(name, prefix, prefixLen) == 0 &&
+                  n > prefixLen + suffix &&
+                  strncmp(name + n - suffix, ".bak", 4) == 0;
+    entry.close();
+    if (!backup)
+      continue;
+
+    const char *stamp = name + prefixLen;
+    size_t stampLen = n - prefixLen - suffix;
+    if (stampLen >= sizeof(_queryFiles[0].stamp))
+      continue;
+    if (after != nullptr &&
+        RetentionManager::compareStamps(stamp, stampLen, after->stamp,
+                                        after->stampLen) <= 0)
+      continue;
+
+    // Inserção ordenada; cheio, fica só com os mais antigos
+    uint8_t pos = count;
+    while (pos > 0 &&
+           RetentionManager::compareStamps(stamp, stampLen,
+                                           _queryFiles[pos - 1].stamp,
+                                           _queryFiles[pos - 1].stampLen) < 0)
+      pos--;
+    // .bak e .bak.lzs juntos (compressão interrompida): vale o .bak
+    if (pos > 0 &&
+        RetentionManager::compareStamps(stamp, stampLen,
+                                        _queryFiles[pos - 1].stamp,
+                                        _queryFiles[pos - 1].stampLen) == 0) {
+      _queryFiles[pos - 1].packed &= packed;
+      continue;
+    }
+    if (count == QUERY_FILES) {
+      overflow = true;
+      if (pos == QUERY_FILES)
+        continue;
+      count--;
+    }
+    memmove(&_queryFiles[pos + 1], &_queryFiles[pos],
+            (count - pos) * sizeof(QueryFile));
+    memcpy(_queryFiles[pos].stamp, stamp, stampLen);
+    _queryFiles[pos].stamp[stampLen] = '\0';
+    _queryFiles[pos].stampLen = (uint8_t)stampLen;
+    _queryFiles[pos].packed = packed;
+    count++;
+  }
+  root.close();
+  return count;
+}
+
+void StorageManager::_catchUpIndex() {
+  bool binary = _binaryTelemetry;
+  PreallocatedLog &log = binary ? _binaryLog : _telemetryLog;
+  TimeIndex &index = binary ? _binaryIndex : _telemetryIndex;
+
+  uint32_t offset = index.coveredTo();
+  uint32_t end = log.end();
+  if (!log.isOpen() || offset >= end)
+    return;
+
+  File file = SD.open(log.path(), FILE_READ);
+  if (!file)
+    return;
+
+  // Orçamento por chamada: reconstrução completa se espalha por vários
+  // ciclos ociosos da StorageTask
+  uint32_t limit = offset + SD_INDEX_CATCHUP_BYTES;
+  uint32_t seq;
+  uint32_t recordOffset;
+  TelemetryData data;
+  while (offset < end && offset < limit) {
+    uint32_t from = offset;
+    if (!_readStoredTelemetry(file, binary, offset, recordOffset, seq, data)) {
+      index.skipTo(end);
+      break;
+    }
+    index.note(from, recordOffset, offset, data.timestamp);
+    if (index.coveredTo() != offset)
+      break;  // Pendentes cheios: flush antes de continuar
+  }
+  file.close();
+}
+
+void StorageManager::_serviceArchive() {
+  uint32_t nowUnix = (_rtcManager && _rtcManager->isInitialized())
+                         ? _rtcManager->getUnixTime()
+                         : 0;
+  if (!_archiver.step(nowUnix))
+    return;
+
+  const LogArchiver::Result &r = _archiver.lastResult();
+  RetentionManager::LogClass cls = RetentionManager::classOf(r.path);
+  _retention.noteRemoved(cls, r.rawBytes);
+  _retention.noteAdded(cls, r.packedBytes);
+
+  float mb = r.rawBytes / 1048576.0f;
+  char msg[192];
+  snprintf(msg, sizeof(msg),
+           "Compressao %s: %lu -> %lu bytes (%.1f%%), CPU %.0f ms/MB, "
+           "total %.0f ms/MB",
+           r.path, (unsigned long)r.rawBytes, (unsigned long)r.packedBytes,
+           r.rawBytes ? 100.0f * r.packedBytes / r.rawBytes : 0.0f,
+           mb > 0 ? r.cpuUs / 1000.0f / mb : 0.0f,
+           mb > 0 ? r.totalUs / 1000.0f / mb : 0.0f);
+  Serial.printf("[StorageManager] %s\n", msg);
+  saveLog(msg);
+}
+
+void StorageManager::_serviceRetention() {
+  char msg[160];
+  if (_retention.step()) {
+    const RetentionManager::Result &r = _retention.lastResult();
+    snprintf(msg, sizeof(msg),
+             "Retencao: removido %s (%lu bytes, %s), livre %u%%", r.path,
+             (unsigned long)r.bytes, RetentionManager::className(r.cls),
+             _retention.freePercent());
+    Serial.printf("[StorageManager] %s\n", msg);
+    saveLog(msg);
+  }
+
+  if (_systemHealth != nullptr)
+    _systemHealth->reportStorageSpace(_retention.freePercent());
+
+  RetentionManager::Level level = _retention.level();
+  if (level == _spaceLevel)
+    return;
+
+  int n = snprintf(msg, sizeof(msg), "Espaco SD: %s -> %s, livre %lu de %lu MB",
+                   RetentionManager::levelName(_spaceLevel),
+                   RetentionManager::levelName(level),
+                   (unsigned long)(_retention.freeBytes() >> 20),
+                   (unsigned long)(_retention.budgetBytes() >> 20));
+  if (_spaceLevel == RetentionManager::LEVEL_FULL && n > 0 &&
+      (size_t)n < sizeof(msg))
+    snprintf(msg + n, sizeof(msg) - n, ", %lu registros descartados",
+             (unsigned long)(_droppedRecords - _droppedAtFull));
+  if (level == RetentionManager::LEVEL_FULL)
+    _droppedAtFull = _droppedRecords;
+  _spaceLevel = level;
+
+  Serial.printf("[StorageManager] %s\n", msg);
+  saveLog(msg);
+}
+
+void StorageManager::_serviceStats() {
+  char msg[160];
+  uint32_t us;
+  uint32_t opUs[StorageStats::OP_APPEND];
+  if (_stats.takeStall(us, opUs)) {
+    snprintf(msg, sizeof(msg),
+             "Stall SD: registro em %lu ms (open %lu, write %lu, flush %lu, "
+             "close %lu us), %lu stalls",
+             (unsigned long)(us / 1000), (unsigned long)opUs[0],
+             (unsigned long)opUs[1], (unsigned long)opUs[2],
+             (unsigned long)opUs[3], (unsigned long)_stats.stalls());
+    Serial.printf("[StorageManager] %s\n", msg);
+    saveLog(msg);
+  }
+
+  uint32_t p95 = _stats.percentileUs(StorageStats::OP_APPEND, 95);
+  if (_systemHealth != nullptr)
+    _systemHealth->reportStorageStats(p95, _stats.stalls(),
+                                      _stats.maxBacklog(),
+                                      _stats.longestBacklogMs());
+
+  unsigned long now = millis();
+  if (now - _lastStatsLog < SD_STATS_LOG_MS ||
+      _stats.histogram(StorageStats::OP_APPEND).count == 0)
+    return;
+  _lastStatsLog = now;
+  snprintf(msg, sizeof(msg),
+           "Latencia SD: p50 %lu p95 %lu p99 %lu max %lu us, %lu stalls, "
+           "fila max %lu (%lu ms)",
+           (unsigned long)_stats.percentileUs(StorageStats::OP_APPEND, 50),
+           (unsigned long)p95,
+           (unsigned long)_stats.percentileUs(StorageStats::OP_APPEND, 99),
+           (unsigned long)_stats.histogram(StorageStats::OP_APPEND).maxUs,
+           (unsigned long)_stats.stalls(), (unsigned long)_stats.maxBacklog(),
+           (unsigned long)_stats.longestBacklogMs());
+  saveLog(msg);
+}
+
+void StorageManager::printStats() const {
+  Serial.println("=== STORAGE STATS ===");
+  Serial.println("op      count    media     p50     p95     p99     max (us)");
+  for (uint8_t i = 0; i < StorageStats::OP_COUNT; i++) {
+    StorageStats::Op op = (StorageStats::Op)i;
+    const StorageStats::Histogram &h = _stats.histogram(op);
+    Serial.printf("%-6s %6lu %8lu %7lu %7lu %7lu %7lu\n",
+                  StorageStats::opName(op), (unsigned long)h.count,
+                  (unsigned long)(h.count ? h.totalUs / h.count : 0),
+                  (unsigned long)_stats.percentileUs(op, 50),
+                  (unsigned long)_stats.percentileUs(op, 95),
+                  (unsigned long)_stats.percentileUs(op, 99),
+                  (unsigned long)h.maxUs);
+  }
+
+  // Distribuição do registro completo: só faixas com amostras
+  const StorageStats::Histogram &a = _stats.histogram(StorageStats::OP_APPEND);
+  for (uint8_t b = 0; b < StorageStats::BUCKETS; b++) {
+    if (a.buckets[b] == 0)
+      continue;
+    unsigned long lo = b ? (1UL << b) : 0;
+    if (b == StorageStats::BUCKETS - 1)
+      Serial.printf("  >= %lu us: %lu\n", lo, (unsigned long)a.buckets[b]);
+    else
+      Serial.printf("  %lu-%lu us: %lu\n", lo, (2UL << b) - 1,
+                    (unsigned long)a.buckets[b]);
+  }
+
+  Serial.printf("Stalls (>= %lu ms): %lu\n", (unsigned long)(SD_STALL_US / 1000),
+                (unsigned long)_stats.stalls());
+  Serial.printf("Fila StorageTask: max %lu sinais, maior backlog %lu ms, "
+                "%lu backlogs, %lu sinais perdidos\n",
+                (unsigned long)_stats.maxBacklog(),
+                (unsigned long)_stats.longestBacklogMs(),
+                (unsigned long)_stats.backlogEpisodes(),
+                (unsigned long)_stats.queueFull());
+  Serial.printf("Escritas: %lu, descartados por espaco: %lu\n",
+                (unsigned long)_totalWrites, (unsigned long)_droppedRecords);
+  Serial.printf("Compressao: %lu falhas, %u .bak ignorados\n",
+                (unsigned long)_archiver.getFailures(),
+                _archiver.getSkippedCount());
+  Serial.println("=====================");
+}
+
+bool StorageManager::_divert(FallbackLog::Kind kind, const void *data,
+                             size_t len) {
+  return FALLBACK_ENABLED && _fallback.append(kind, data, len);
+}
+
+bool StorageManager::_serviceFallback() {
+  uint16_t n =
+      _fallback.migrate(_migrateRecord, this, FALLBACK_MIGRATE_RECORDS);
+  _fallbackMigrated += n;
+
+  if (_available && !_fallback.hasPending() && _fallbackMigrated > 0) {
+    char msg[128];
+    snprintf(msg, sizeof(msg),
+             "Flash interna: %lu registros migrados para o SD, "
+             "%u segmentos descartados desde o boot",
+             (unsigned long)_fallbackMigrated, _fallback.getDroppedSegments());
+    _fallbackMigrated = 0;
+    Serial.printf("[StorageManager] %s\n", msg);
+    saveLog(msg);
+  }
+  return n > 0;
+}
+
+bool StorageManager::_migrateRecord(FallbackLog::Kind kind,
+                                    const uint8_t *data, size_t len,
+                                    void *ctx) {
+  StorageManager *self = static_cast<StorageManager *>(ctx);
+  char text[FallbackLog::MAX_RECORD + 1];
+  memcpy(text, data, len);
+  text[len] = '\0';
+
+  // Seq e CRC-16 atribuídos agora, pelo log de destino
+  bool ok = true;
+  switch (kind) {
+  case FallbackLog::KIND_TELEMETRY_CSV:
+  case FallbackLog::KIND_TELEMETRY_BIN:
+    ok = self->_migrateTelemetry(kind == FallbackLog::KIND_TELEMETRY_BIN, data,
+                                 len);
+    break;
+  case FallbackLog::KIND_MISSION_CSV:
+    ok = self->_writeMissionCsv(text);
+    break;
+  case FallbackLog::KIND_SYSTEM:
+    ok = self->_appendSystemLine(text);
+    break;
+  default:
+    // Tipo desconhecido: descartado
+    break;
+  }
+
+  // Sem espaço o registro é contado como descartado, não retentado
+  if (ok || self->_dropIfRefused())
+    return true;
+  Serial.println("[StorageManager] Erro de escrita na migracao. Marcando "
+                 "como indisponível.");
+  self->_available = false;
+  return false;
+}
+
+bool StorageManager::_migrateTelemetry(bool binary, const uint8_t *data,
+                                       size_t len) {
+  TelemetryData decoded;
+  BinLog::TelemetryRecord rec;
+  char fields[512];
+
+  if (binary) {
+    if (len != sizeof(rec))
+      return true;
+    memcpy(&rec, data, len);
+    if (_binaryTelemetry)
+      return _writeTelemetryRecord(rec);
+    _unpackTelemetryRecord(rec, decoded);
+  } else {
+    uint32_t seq;
+    if (!_binaryTelemetry) {
+      memcpy(fields, data, len);
+      fields[len] = '\0';
+      const char *comma = strchr(fields, ',');
+      uint32_t unixTime = comma ? strtoul(comma + 1, nullptr, 10) : 0;
+      // Linha original preservada; decodificada só para o colunar
+      bool parsed = SD_COLUMNAR_ARCHIVE &&
+                    _parseTelemetryCSV(fields, len, decoded, seq);
+      return _writeTelemetryCsv(fields, unixTime, parsed ? &decoded : nullptr);
+    }
+    if (!_parseTelemetryCSV((const char *)data, len, decoded, seq))
+      return true;
+  }
+
+  // Formato trocado desde a gravação: converte para o corrente
+  if (_binaryTelemetry) {
+    _packTelemetryRecord(decoded, rec);
+    return _writeTelemetryRecord(rec);
+  }
+  _formatTelemetryToCSV(decoded, fields, sizeof(fields));
+  return _writeTelemetryCsv(fields, decoded.timestamp, &decoded);
+}
+
+void StorageManager::_archiveColumns(uint32_t seq,
+                                     const BinLog::TelemetryRecord &rec) {
+  if (!SD_COLUMNAR_ARCHIVE || !_columnar.isOpen())
+    return;
+  // Grupo cheio sem a StorageTask ociosa: grava agora em vez de perder
+  if (!_columnar.add(seq, rec) && _flushColumns())
+    _columnar.add(seq, rec);
+}
+
+bool StorageManager::_flushColumns() {
+  // Cópia para análise: sem orçamento cede o espaço à telemetria primária
+  if (_retention.level() == RetentionManager::LEVEL_FULL)
+    return false;
+
+  uint32_t before = _columnar.size();
+  if (!_columnar.flush()) {
+    Serial.printf("[StorageManager] Aviso: falha ao gravar grupo em %s\n",
+                  _columnar.path());
+    return false;
+  }
+  _retention.noteAdded(RetentionManager::CLASS_TELEMETRY,
+                       _columnar.size() - before);
+
+  if (_columnar.size() >= SD_MAX_FILE_SIZE) {
+    uint32_t now = (_rtcManager && _rtcManager->isInitialized())
+                       ? _rtcManager->getUnixTime()
+                       : 0;
+    String backupPath = _backupPath(_columnar.path());
+    if (_columnar.rotate(backupPath.c_str(), now)) {
+      _retention.noteRotated(backupPath.c_str());
+      Serial.printf("[StorageManager] Arquivo rotacionado: %s\n",
+                    backupPath.c_str());
+    }
+  }
+  return true;
+}
+
+void StorageManager::_releaseBackup(const char *path, void *ctx) {
+  StorageManager *self = static_cast<StorageManager *>(ctx);
+  const char *busy = self->_archiver.currentPath();
+  if (busy != nullptr && strcmp(busy, path) == 0)
+    self->_archiver.abort();
+}
+
+bool StorageManager::_dropIfRefused(uint32_t records) {
+  if (!_rotationRefused)
+    return false;
+  _rotationRefused = false;
+  _droppedRecords += records;
+  return true;
+}
+
 void StorageManager::_formatTelemetryToCSV(const TelemetryData &data,
                                            char *buffer, size_t len) {
   if (buffer == nullptr || len < 100)
@@ -267,12 +1707,10 @@ void StorageManager::_formatTelemetryToCSV(const TelemetryData &data,
   // Helper para float seguro
   auto sf = [](float v) -> float { return (isnan(v) || isinf(v)) ? 0.0f : v; };
 
-  // Formatar ISO8601 a partir do RTC, se disponível
+  // ISO8601 da hora em cache do RTC (sem I2C), se disponível
   char iso8601[24];
   if (_rtcManager != nullptr && _rtcManager->isInitialized()) {
-    String dt = _rtcManager->getDateTime();
-    dt.replace(' ', 'T');
-    snprintf(iso8601, sizeof(iso8601), "%s", dt.c_str());
+    _rtcManager->formatDateTime(iso8601, sizeof(iso8601), 'T');
   } else {
     snprintf(iso8601, sizeof(iso8601), "%lu", data.timestamp);
   }
@@ -336,12 +1774,10 @@ void StorageManager::_formatMissionToCSV(const MissionData &data, char *buffer,
                                ? data.collectionTime
                                : (unsigned long)(millis() / 1000);
 
-  // Formatar ISO8601 a partir do RTC, se disponível
+  // ISO8601 da hora em cache do RTC (sem I2C), se disponível
   char iso8601[24];
   if (_rtcManager != nullptr && _rtcManager->isInitialized()) {
-    String dt = _rtcManager->getDateTime();
-    dt.replace(' ', 'T');
-    snprintf(iso8601, sizeof(iso8601), "%s", dt.c_str());
+    _rtcManager->formatDateTime(iso8601, sizeof(iso8601), 'T');
   } else {
     snprintf(iso8601, sizeof(iso8601), "%lu", unixTime);
   }
@@ -6,12 +6,19 @@
  *          - Logging de telemetria em formato CSV
  *          - Verificação de integridade via CRC-16 CCITT
  *          - Rotação automática de arquivos por tamanho
+ *          - Arquivos de log pré-alocados (sem alocação FAT por escrita)
+ *          - Índice temporal esparso e consultas por intervalo
+ *          - Compressão em segundo plano dos arquivos rotacionados
+ *          - Retenção por espaço livre com cotas por classe de log
  *          - Recuperação automática de falhas do SD
+ *          - Log de contingência na flash interna com o SD fora
+ *          - Cópia colunar opcional da telemetria para análise
+ *          - Histograma de latência do SD e detector de stall
  *          - Integração com RTC para timestamps precisos
  * 
  * @author AgroSat Team
  * @date 2025
- * @version 3.4.0
+ * @version 3.11.0
  * 
  * @copyright Copyright (c) 2025 AgroSat Project
  * @license MIT License
@@ -22,9 +29,30 @@
  * | telemetry.csv    | Dados de sensores           | CSV+CRC |
  * | mission.csv      | Dados de ground nodes       | CSV+CRC |
  * | system.log       | Logs do sistema             | TXT+CRC |
+ * | telemetry.bin    | Telemetria (opcional)       | Binário |
+ * | *.idx            | Índice timestamp -> offset  | Binário |
+ * | *.bak.lzs        | Rotacionado comprimido      | LZSS    |
+ * | telemetry.col    | Telemetria por coluna (opc.)| Colunar |
+ *
+ * ## Espaço Livre
+ * Escritas nunca alocam clusters (arquivos pré-alocados); só a rotação
+ * precisa de espaço, e a reserva é alocada antes, fora do caminho crítico.
+ * O RetentionManager remove os rotacionados mais antigos para manter a
+ * folga. Com o orçamento esgotado a rotação é recusada: registros são
+ * descartados e contados, sem remontar o SD.
+ *
+ * ## SD Indisponível
+ * Com o SD fora (não montou ou falhou uma escrita) os registros vão para
+ * o FallbackLog (LittleFS, anel limitado), no formato do SD. Com o SD de
+ * volta, service() migra lotes do mais antigo para o mais novo; até a
+ * flash esvaziar, registros novos seguem para ela (ordem preservada).
  * 
  * ## Integridade de Dados
  * - **CRC-16 CCITT**: Cada linha tem checksum anexado
+ * - **Seq**: Número de sequência global por registro (detecção de lacunas)
+ * - **CRC-32 por frame**: Log binário (ver BinaryLogFormat.h)
+ * - **Recuperação O(cauda)**: registro rasgado por reset é descartado no
+ *   begin(); a contagem recuperada vai para o system.log
  * 
  * ## Pinagem SD Card (HSPI)
  * | Pino ESP32 | Função SD |
@@ -45,6 +73,14 @@
 #include <SD.h>
 #include <SPI.h>
 #include "config.h"
+#include "BinaryLogFormat.h"
+#include "PreallocatedLog.h"
+#include "TimeIndex.h"
+#include "LogArchiver.h"
+#include "RetentionManager.h"
+#include "FallbackLog.h"
+#include "ColumnarArchive.h"
+#include "StorageStats.h"
 
 // Forward declarations
 class RTCManager;
@@ -56,6 +92,15 @@ class SystemHealth;
  */
 class StorageManager {
 public:
+    /**
+     * @brief Recebe cada registro de uma consulta por intervalo
+     * @param data Registro reconstruído
+     * @param seq Número de sequência gravado (0 em linhas antigas sem Seq)
+     * @param ctx Contexto do chamador
+     * @return false para encerrar a consulta
+     */
+    typedef bool (*TelemetryVisitor)(const TelemetryData& data, uint32_t seq, void* ctx);
+    
     /**
      * @brief Construtor padrão
      */
@@ -109,6 +154,17 @@ public:
      */
     bool saveMissionData(const MissionData& data);
     
+    /**
+     * @brief Salva um lote de registros de missão em uma única escrita
+     * @details Linhas com Seq consecutivos montadas em _missionBatch; só
+     *          um lote maior que MISSION_BATCH_BYTES gera mais escritas.
+     * @param data Registros na ordem de gravação
+     * @param count Quantidade de registros
+     * @return true se todos foram salvos (SD ou flash interna)
+     * @note Somente StorageTask (buffer do lote é membro)
+     */
+    bool saveMissionBatch(const MissionData* data, size_t count);
+    
     //=========================================================================
     // GERENCIAMENTO DE ARQUIVOS
     //=========================================================================
@@ -122,6 +178,54 @@ public:
     /** @brief Cria arquivo de log do sistema */
     bool createLogFile();
     
+    /** @brief Cria arquivo binário de telemetria com FileHeader */
+    bool createBinaryTelemetryFile();
+    
+    /**
+     * @brief Seleciona formato do log de telemetria
+     * @param enable true para binário (telemetry.bin), false para CSV
+     */
+    void setBinaryTelemetry(bool enable);
+    
+    /** @brief Telemetria sendo gravada em binário? */
+    bool isBinaryTelemetry() const { return _binaryTelemetry; }
+    
+    /**
+     * @brief Manutenção em segundo plano (StorageTask ociosa)
+     * @details Migra registros da flash interna, aplica a retenção
+     *          (remove rotacionados antigos), pré-aloca
+     *          arquivos reserva para a próxima rotação, grava checkpoints
+     *          do fim lógico na NVS, completa o índice temporal e comprime
+     *          uma fatia dos .bak. Nada disso ocorre dentro de
+     *          saveTelemetry()/saveMissionData(). Com o SD fora, só
+     *          grava o buffer da flash interna.
+     */
+    void service();
+    
+    //=========================================================================
+    // CONSULTA
+    //=========================================================================
+    
+    /**
+     * @brief Percorre a telemetria gravada entre dois timestamps
+     * @details Arquivos rotacionados (.bak ou .bak.lzs, do mais antigo
+     *          para o mais novo pelo timestamp do nome) e depois o ativo,
+     *          no formato de telemetria corrente. Em cada arquivo: busca
+     *          binária no .idx e leitura sequencial a partir da entrada.
+     *          Comprimidos são decodificados em fluxo desde o início; o
+     *          .idx mantido ao lado só pula a análise dos registros e os
+     *          arquivos fora do intervalo.
+     * @param fromUnix Início do intervalo (inclusive)
+     * @param toUnix Fim do intervalo (inclusive)
+     * @param visit Chamado para cada registro no intervalo
+     * @param ctx Repassado ao visitante
+     * @return Registros entregues ao visitante
+     * @note Somente StorageTask: rotação, recuperação e flush do .idx
+     *       rodam nela e invalidariam os File abertos aqui
+     */
+    uint32_t queryTelemetry(uint32_t fromUnix, uint32_t toUnix,
+                            TelemetryVisitor visit, void* ctx);
+    
     //=========================================================================
     // STATUS
     //=========================================================================
@@ -129,6 +233,36 @@ public:
     /** @brief SD Card disponível e montado? */
     bool isAvailable() const { return _available; }
     
+    /**
+     * @brief Orçamento de espaço esgotado (rotação recusada)?
+     * @note Registros são descartados sem marcar o SD como indisponível
+     */
+    bool isStorageFull() const {
+        return _available && _retention.level() == RetentionManager::LEVEL_FULL;
+    }
+    
+    /** @brief Registros descartados por falta de espaço */
+    uint32_t getDroppedRecords() const { return _droppedRecords; }
+    
+    //=========================================================================
+    // DESEMPENHO
+    //=========================================================================
+    
+    /** @brief Histogramas de latência, stalls e backlog da StorageTask */
+    const StorageStats& getStats() const { return _stats; }
+    
+    /**
+     * @brief Profundidade da fila ao tirar um sinal (StorageTask)
+     * @param waiting Sinais ainda na fila
+     */
+    void noteBacklog(uint32_t waiting) { _stats.noteBacklog(waiting); }
+    
+    /** @brief Sinal de gravação perdido com a fila cheia */
+    void noteQueueFull() { _stats.noteQueueFull(); }
+    
+    /** @brief Imprime histogramas e contadores na Serial (STORAGE_STATS) */
+    void printStats() const;
+    
 private:
     //=========================================================================
     // ESTADO
@@ -148,6 +282,82 @@ private:
     //=========================================================================
     uint16_t _totalWrites;       ///< Total de escritas
     
+    //=========================================================================
+    // LOTE DE MISSÃO
+    //=========================================================================
+    static constexpr size_t MISSION_BATCH_BYTES = 4096;  ///< Bytes por escrita
+    char _missionBatch[MISSION_BATCH_BYTES]; ///< Linhas enquadradas do lote
+    
+    //=========================================================================
+    // ARQUIVOS PRÉ-ALOCADOS
+    //=========================================================================
+    PreallocatedLog _telemetryLog;      ///< telemetry.csv
+    PreallocatedLog _missionLog;        ///< mission.csv
+    PreallocatedLog _binaryLog;         ///< telemetry.bin
+    TimeIndex _telemetryIndex;          ///< telemetry.csv.idx
+    TimeIndex _binaryIndex;             ///< telemetry.bin.idx
+    LogArchiver _archiver;              ///< *.bak -> *.bak.lzs
+    RetentionManager _retention;        ///< Cotas e remoção por espaço livre
+    FallbackLog _fallback;              ///< Flash interna com o SD fora
+    uint32_t _fallbackMigrated;         ///< Registros migrados na rodada atual
+    ColumnarArchive _columnar;          ///< telemetry.col (opcional)
+    
+    //=========================================================================
+    // DESEMPENHO
+    //=========================================================================
+    StorageStats _stats;                ///< Latência por operação no SD
+    unsigned long _lastStatsLog;        ///< Último resumo no system.log
+    
+    //=========================================================================
+    // ESPAÇO LIVRE
+    //=========================================================================
+    RetentionManager::Level _spaceLevel; ///< Último nível reportado
+    uint32_t _droppedRecords;           ///< Registros descartados (SD cheio)
+    uint32_t _droppedAtFull;            ///< _droppedRecords ao entrar em CHEIO
+    bool _rotationRefused;              ///< Última rotação recusada por espaço
+    
+    //=========================================================================
+    // CONSULTA
+    //=========================================================================
+    /**
+     * @struct QueryFile
+     * @brief Rotacionado a consultar (nome = "<log>.<stamp>.bak[.lzs]")
+     */
+    struct QueryFile {
+        char stamp[24];                 ///< Timestamp do nome
+        uint8_t stampLen;               ///< Tamanho de stamp
+        bool packed;                    ///< Só existe o .bak.lzs
+    };
+    static constexpr uint8_t QUERY_FILES = 32;  ///< Rotacionados por varredura
+    QueryFile _queryFiles[QUERY_FILES]; ///< Mais antigos primeiro
+    LogArchive::Decoder _queryDecoder;  ///< Leitura dos .bak.lzs
+    
+    /**
+     * @struct ArchiveCursor
+     * @brief Remonta registros da saída do Decoder (um .bak.lzs)
+     */
+    struct ArchiveCursor {
+        bool binary;                    ///< Frames binários ou linhas CSV
+        uint32_t pos;                   ///< Offset (original) do próximo byte
+        uint32_t next;                  ///< Início do registro em buf
+        uint16_t len;                   ///< Bytes acumulados em buf
+        uint8_t buf[640];               ///< Registro em montagem
+        uint32_t fromUnix;              ///< Início do intervalo
+        uint32_t toUnix;                ///< Fim do intervalo
+        TelemetryVisitor visit;         ///< Visitante da consulta
+        void* ctx;                      ///< Contexto do visitante
+        uint32_t* visited;              ///< Contador da consulta
+        bool more;                      ///< false = visitante parou
+    };
+    
+    //=========================================================================
+    // LOG BINÁRIO DE TELEMETRIA
+    //=========================================================================
+    bool _binaryTelemetry;              ///< Formato binário ativo?
+    bool _binStateLoaded;               ///< _binBlock reflete o arquivo?
+    BinLog::BlockHeader _binBlock;      ///< Cabeçalho do bloco corrente
+    uint32_t _binNextSeq;               ///< Sequência do próximo registro
+    
     //=========================================================================
     // MÉTODOS PRIVADOS
     //=========================================================================
@@ -157,6 +367,50 @@ private:
     
     /** @brief Verifica se arquivo excedeu tamanho máximo */
     bool _checkFileSize(const char* path);
+    
+    /** @brief Nome do arquivo rotacionado (path.timestamp.bak) */
+    String _backupPath(const char* path);
+    
+    /**
+     * @brief Rotaciona log pré-alocado para o arquivo reserva
+     * @note Sem reserva pronta e sem espaço para alocar, recusa e marca
+     *       _rotationRefused (o arquivo ativo fica intacto)
+     */
+    bool _rotateLog(PreallocatedLog& log);
+    
+    /**
+     * @brief Falha de escrita por espaço (não por defeito do SD)?
+     * @param records Registros perdidos com a escrita
+     * @return true se os registros foram contados como descartados
+     */
+    bool _dropIfRefused(uint32_t records = 1);
+    
+    /** @brief Grava cabeçalho CSV se o arquivo ativo estiver vazio */
+    bool _writeHeader(PreallocatedLog& log, const char* header);
+    
+    /**
+     * @brief Monta linha "campos,Seq,CRC16\r\n" com a sequência do log
+     * @param ahead Linhas já enquadradas no mesmo lote (Seq + ahead)
+     * @return Tamanho da linha (0 se o log não abriu ou não coube)
+     */
+    size_t _frameLine(PreallocatedLog& log, const char* fields,
+                      char* out, size_t outSize, uint32_t ahead = 0);
+    
+    /**
+     * @brief Grava linhas CSV no fim lógico (rotaciona se necessário)
+     * @param count Linhas contidas em line
+     */
+    bool _appendLine(PreallocatedLog& log, const char* header,
+                     const char* line, size_t len, uint32_t count = 1);
+    
+    /** @brief Valida linha CSV na varredura do fim lógico (CRC-16) */
+    static bool _isValidCsvLine(const char* line, size_t len, uint32_t offset);
+    
+    /** @brief Registra no system.log o resultado da recuperação do open() */
+    void _reportRecovery(const PreallocatedLog& log);
+    
+    /** @brief Reporta duração de uma escrita ao SystemHealth */
+    void _noteAppendLatency(uint32_t startUs);
 
     /** @brief Formata TelemetryData para linha CSV */
     void _formatTelemetryToCSV(const TelemetryData& data, char* buffer, size_t len);
@@ -164,13 +418,143 @@ private:
     /** @brief Formata MissionData para linha CSV */
     void _formatMissionToCSV(const MissionData& data, char* buffer, size_t len);
     
+    /** @brief Grava frame no log binário (bloco selado ao encher) */
+    bool _appendBinaryRecord(const BinLog::TelemetryRecord& rec);
+    
+    /** @brief Grava registro binário de telemetria e o indexa */
+    bool _writeTelemetryRecord(const BinLog::TelemetryRecord& rec);
+    
+    /**
+     * @brief Grava campos CSV de telemetria (Seq, CRC-16) e os indexa
+     * @param data Mesmo registro decodificado, para o colunar (opcional)
+     */
+    bool _writeTelemetryCsv(const char* fields, uint32_t unixTime,
+                            const TelemetryData* data = nullptr);
+    
+    /** @brief Grava campos CSV de missão (Seq, CRC-16) */
+    bool _writeMissionCsv(const char* fields);
+    
+    /** @brief Grava "[ts] mensagem" + CRC-16 no system.log */
+    bool _appendSystemLine(const char* line);
+    
+    //=========================================================================
+    // FLASH INTERNA
+    //=========================================================================
+    
+    /** @brief SD aceita escrita direta (nada na flash à frente)? */
+    bool _sdWritable() const { return _available && !_fallback.hasPending(); }
+    
+    /** @brief Desvia o registro para a flash interna */
+    bool _divert(FallbackLog::Kind kind, const void* data, size_t len);
+    
+    /**
+     * @brief Migra um lote da flash interna para o SD
+     * @return true se algum registro foi migrado
+     */
+    bool _serviceFallback();
+    
+    /** @brief Recebe registro migrado; false = SD falhou */
+    static bool _migrateRecord(FallbackLog::Kind kind, const uint8_t* data,
+                               size_t len, void* ctx);
+    
+    /** @brief Grava telemetria migrada no formato corrente (converte) */
+    bool _migrateTelemetry(bool binary, const uint8_t* data, size_t len);
+    
+    /** @brief Grava cabeçalho do bloco corrente e esvazia o slot seguinte */
+    bool _sealBinaryBlock(File& file);
+    
+    /**
+     * @brief Valida frames de um bloco não selado em _binBlock
+     * @return true se a varredura parou em um frame rasgado
+     */
+    bool _scanBinaryFrames(File& file, uint32_t idx, bool haveSeq,
+                           uint32_t expectedSeq);
+    
+    /** @brief Empacota TelemetryData no registro binário */
+    void _packTelemetryRecord(const TelemetryData& data, BinLog::TelemetryRecord& rec);
+    
+    /** @brief Restaura bloco aberto e sequência a partir do checkpoint */
+    void _loadBinaryState(File& file);
+    
+    /** @brief Reconstrói TelemetryData a partir do registro binário */
+    static void _unpackTelemetryRecord(const BinLog::TelemetryRecord& rec,
+                                       TelemetryData& data);
+    
+    /** @brief Reconstrói TelemetryData a partir de uma linha CSV */
+    static bool _parseTelemetryCSV(const char* line, size_t len,
+                                   TelemetryData& data, uint32_t& seq);
+    
+    /**
+     * @brief Lê o registro de telemetria a partir de offset
+     * @param offset [in/out] Posição de leitura; avança para após o registro
+     * @param recordOffset [out] Início do registro lido
+     * @return false no fim dos dados ou registro inválido
+     */
+    bool _readStoredTelemetry(File& file, bool binary, uint32_t& offset,
+                              uint32_t& recordOffset, uint32_t& seq,
+                              TelemetryData& data);
+    
+    /** @brief Primeiro frame binário em offset ou depois dele */
+    static uint32_t _frameOffset(uint32_t offset);
+    
+    /**
+     * @brief Lista os rotacionados mais antigos que vêm depois de after
+     * @param prefix Prefixo do nome ("<log>.")
+     * @param after Último timestamp já consultado (nullptr = do início)
+     * @param overflow [out] Ficaram rotacionados para a próxima varredura
+     * @return Entradas em _queryFiles, ordem cronológica
+     */
+    uint8_t _collectBackups(const char* prefix, const QueryFile* after,
+                            bool& overflow);
+    
+    /** @brief Consulta um arquivo de telemetria (false = visitante parou) */
+    bool _queryFile(const char* path, bool binary, uint32_t end,
+                    uint32_t fromUnix, uint32_t toUnix,
+                    TelemetryVisitor visit, void* ctx, uint32_t& visited);
+    
+    /**
+     * @brief Consulta um rotacionado comprimido (false = visitante parou)
+     * @param path Arquivo "<bak>.lzs"
+     * @param idxPath Índice do .bak original (pode não existir)
+     */
+    bool _queryArchive(const char* path, const char* idxPath, bool binary,
+                       uint32_t fromUnix, uint32_t toUnix,
+                       TelemetryVisitor visit, void* ctx, uint32_t& visited);
+    
+    /** @brief Sink do Decoder: entrega os registros completos (ArchiveCursor) */
+    static bool _archiveSink(const uint8_t* data, size_t len, void* ctx);
+    
+    /** @brief Registro completo em c.buf; false = encerrar o arquivo */
+    static bool _takeArchived(ArchiveCursor& c);
+    
+    /** @brief Indexa a cauda ainda não coberta do log ativo (limitado) */
+    void _catchUpIndex();
+    
+    /** @brief Uma fatia da compressão dos .bak; registra o resultado */
+    void _serviceArchive();
+    
+    /** @brief Passo da retenção; registra remoções e mudanças de nível */
+    void _serviceRetention();
+    
+    /** @brief Registra stall e resumo periódico; repassa ao SystemHealth */
+    void _serviceStats();
+    
+    /** @brief Acrescenta registro gravado ao grupo colunar em RAM */
+    void _archiveColumns(uint32_t seq, const BinLog::TelemetryRecord& rec);
+    
+    /** @brief Grava o grupo colunar; rotaciona o .col ao encher */
+    bool _flushColumns();
+    
+    /** @brief Aborta a compressão do rotacionado prestes a ser removido */
+    static void _releaseBackup(const char* path, void* ctx);
+    
     /**
      * @brief Calcula CRC-16 CCITT
      * @param data Ponteiro para dados
      * @param length Tamanho em bytes
      * @return CRC-16 calculado
      */
-    uint16_t _calculateCRC16(const uint8_t* data, size_t length);
+    static uint16_t _calculateCRC16(const uint8_t* data, size_t length);
 };
 
 #endif
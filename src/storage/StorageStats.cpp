@@ -0,0 +1,99 @@
+/**
+ * @file StorageStats.cpp
+ * @brief Implementação dos histogramas de latência do SD
+ */
+
+#include "StorageStats.h"
+
+StorageStats::StorageStats()
+    : _stalls(0), _stallPending(false), _stallUs(0), _maxBacklog(0),
+      _backlogSince(0), _longestBacklogMs(0), _backlogEpisodes(0),
+      _queueFull(0) {
+  memset(_hist, 0, sizeof(_hist));
+  memset(_lastUs, 0, sizeof(_lastUs));
+  memset(_stallOpUs, 0, sizeof(_stallOpUs));
+}
+
+void StorageStats::record(Op op, uint32_t us) {
+  if (op >= OP_COUNT)
+    return;
+
+  // Bucket = posição do bit mais alto (0 e 1 µs no primeiro)
+  uint8_t bucket = 0;
+  for (uint32_t v = us >> 1; v != 0 && bucket < BUCKETS - 1; v >>= 1)
+    bucket++;
+
+  Histogram &h = _hist[op];
+  h.count++;
+  h.totalUs += us;
+  if (us > h.maxUs)
+    h.maxUs = us;
+  h.buckets[bucket]++;
+
+  if (op != OP_APPEND) {
+    _lastUs[op] = us;
+    return;
+  }
+
+  // Registro lento: guarda a composição para o system.log
+  if (us >= SD_STALL_US) {
+    _stalls++;
+    _stallPending = true;
+    _stallUs = us;
+    memcpy(_stallOpUs, _lastUs, sizeof(_stallOpUs));
+  }
+  memset(_lastUs, 0, sizeof(_lastUs));
+}
+
+void StorageStats::noteBacklog(uint32_t waiting) {
+  if (waiting > _maxBacklog)
+    _maxBacklog = waiting;
+
+  uint32_t now = millis();
+  if (waiting > 0) {
+    if (_backlogSince == 0) {
+      _backlogSince = now ? now : 1;
+      _backlogEpisodes++;
+    }
+    return;
+  }
+  if (_backlogSince != 0) {
+    uint32_t ms = now - _backlogSince;
+    if (ms > _longestBacklogMs)
+      _longestBacklogMs = ms;
+    _backlogSince = 0;
+  }
+}
+
+uint32_t StorageStats::percentileUs(Op op, uint8_t pct) const {
+  const Histogram &h = _hist[op];
+  if (h.count == 0)
+    return 0;
+
+  uint64_t target = ((uint64_t)h.count * pct + 99) / 100;
+  uint64_t seen = 0;
+  for (uint8_t i = 0; i < BUCKETS; i++) {
+    seen += h.buckets[i];
+    if (seen >= target) {
+      // Limite superior da faixa, nunca acima do pior caso observado
+      uint32_t upper = (i == BUCKETS - 1) ? h.maxUs : (2UL << i) - 1;
+      return upper < h.maxUs ? upper : h.maxUs;
+    }
+  }
+  return h.maxUs;
+}
+
+bool StorageStats::takeStall(uint32_t &us, uint32_t opUs[OP_APPEND]) {
+  if (!_stallPending)
+    return false;
+  _stallPending = false;
+  us = _stallUs;
+  memcpy(opUs, _stallOpUs, sizeof(_stallOpUs));
+  return true;
+}
+
+const char *StorageStats::opName(Op op) {
+  static const char *const NAMES[OP_COUNT] = {"open", "write", "flush",
+                                              "close", "append"};
+  return op < OP_COUNT ? NAMES[op] : "?";
+}
@@ -0,0 +1,156 @@
+/**
+ * @file StorageStats.h
+ * @brief Latência das operações no SD (histograma log2) e detector de stall
+ *
+ * @details Instrumentação do caminho de escrita do StorageManager:
+ *          - Um histograma por operação (open, write, flush, close) e um
+ *            para o registro completo (append)
+ *          - Stall: registro que levou mais que SD_STALL_US, com a
+ *            duração de cada operação que o compôs
+ *          - Backlog: sinais acumulados na fila da StorageTask (profundidade
+ *            máxima e quanto tempo ela ficou sem esvaziar)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Buckets
+ * | Bucket | Faixa (µs)            |
+ * |--------|-----------------------|
+ * | 0      | 0 - 1                 |
+ * | i      | 2^i - 2^(i+1) - 1     |
+ * | 19     | >= 524288 (~0,5 s)    |
+ *
+ * Percentis são o limite superior do bucket (resolução de 2x), o bastante
+ * para separar um cartão saudável (ms) de um travando (centenas de ms).
+ *
+ * @note Gravado só pela StorageTask; leitura por outra task (STORAGE_STATS)
+ *       vê uma cópia possivelmente defasada em um registro
+ */
+
+#ifndef STORAGE_STATS_H
+#define STORAGE_STATS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @class StorageStats
+ * @brief Histogramas de latência do SD e contadores de stall/backlog
+ */
+class StorageStats {
+public:
+    /**
+     * @enum Op
+     * @brief Operação cronometrada
+     */
+    enum Op : uint8_t {
+        OP_OPEN = 0,    ///< SD.open()
+        OP_WRITE,       ///< seek + write
+        OP_FLUSH,       ///< file.flush()
+        OP_CLOSE,       ///< file.close()
+        OP_APPEND,      ///< Registro completo (open até close)
+        OP_COUNT        ///< Número de operações
+    };
+
+    static constexpr uint8_t BUCKETS = 20;  ///< Buckets log2 por histograma
+
+    /**
+     * @struct Histogram
+     * @brief Distribuição de uma operação desde o boot
+     */
+    struct Histogram {
+        uint32_t count;             ///< Amostras
+        uint32_t maxUs;             ///< Pior caso
+        uint64_t totalUs;           ///< Soma (média = totalUs / count)
+        uint32_t buckets[BUCKETS];  ///< Amostras por faixa log2
+    };
+
+    StorageStats();
+
+    //=========================================================================
+    // COLETA
+    //=========================================================================
+
+    /** @brief Registra uma duração em µs */
+    void record(Op op, uint32_t us);
+
+    /**
+     * @brief Registra o tempo desde t e reinicia t
+     * @param t [in/out] micros() do início; recebe o instante atual
+     */
+    void lap(Op op, uint32_t& t) {
+        uint32_t now = micros();
+        record(op, now - t);
+        t = now;
+    }
+
+    /**
+     * @brief Profundidade da fila da StorageTask ao tirar um sinal
+     * @param waiting Sinais ainda na fila (0 = backlog drenado)
+     */
+    void noteBacklog(uint32_t waiting);
+
+    /** @brief Sinal perdido com a fila cheia (task produtora) */
+    void noteQueueFull() { _queueFull++; }
+
+    //=========================================================================
+    // CONSULTA
+    //=========================================================================
+
+    /** @brief Histograma de uma operação */
+    const Histogram& histogram(Op op) const { return _hist[op]; }
+
+    /**
+     * @brief Percentil aproximado (limite superior do bucket)
+     * @param pct Percentil (1-100)
+     * @return µs (0 se sem amostras)
+     */
+    uint32_t percentileUs(Op op, uint8_t pct) const;
+
+    /** @brief Registros acima de SD_STALL_US desde o boot */
+    uint32_t stalls() const { return _stalls; }
+
+    /**
+     * @brief Consome o stall ainda não reportado
+     * @param us [out] Duração do registro
+     * @param opUs [out] Duração de open, write, flush e close nesse registro
+     * @return false se não há stall novo
+     */
+    bool takeStall(uint32_t& us, uint32_t opUs[OP_APPEND]);
+
+    /** @brief Maior número de sinais na fila da StorageTask */
+    uint32_t maxBacklog() const { return _maxBacklog; }
+
+    /** @brief Maior tempo com a fila sem esvaziar (ms) */
+    uint32_t longestBacklogMs() const { return _longestBacklogMs; }
+
+    /** @brief Vezes em que a fila ficou com sinais pendentes */
+    uint32_t backlogEpisodes() const { return _backlogEpisodes; }
+
+    /** @brief Sinais perdidos com a fila cheia */
+    uint32_t queueFull() const { return _queueFull; }
+
+    /** @brief Nome curto da operação (logs) */
+    static const char* opName(Op op);
+
+private:
+    Histogram _hist[OP_COUNT];      ///< Um por operação
+    uint32_t _lastUs[OP_APPEND];    ///< Última duração de cada operação
+
+    uint32_t _stalls;               ///< Registros acima de SD_STALL_US
+    bool _stallPending;             ///< Stall ainda não reportado
+    uint32_t _stallUs;              ///< Duração do último stall
+    uint32_t _stallOpUs[OP_APPEND]; ///< Operações do último stall
+
+    uint32_t _maxBacklog;           ///< Maior profundidade da fila
+    uint32_t _backlogSince;         ///< millis() do início do backlog (0 = vazio)
+    uint32_t _longestBacklogMs;     ///< Maior backlog contínuo
+    uint32_t _backlogEpisodes;      ///< Backlogs iniciados
+    volatile uint32_t _queueFull;   ///< Sinais perdidos (outra task escreve)
+};
+
+#endif // STORAGE_STATS_H
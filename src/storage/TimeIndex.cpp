@@ -0,0 +1,127 @@
+/**
+ * @file TimeIndex.cpp
+ * @brief Implementação do índice temporal esparso
+ */
+
+#include "TimeIndex.h"
+
+TimeIndex::TimeIndex(const char *dataPath)
+    : _coveredTo(0), _lastOffset(0), _hasEntries(false), _pendingCount(0) {
+  snprintf(_path, sizeof(_path), "%s%s", dataPath, SD_INDEX_SUFFIX);
+}
+
+void TimeIndex::load(uint32_t dataEnd) {
+  _coveredTo = 0;
+  _lastOffset = 0;
+  _hasEntries = false;
+  _pendingCount = 0;
+
+  File file = SD.open(_path, FILE_READ);
+  if (!file)
+    return;
+
+  uint32_t size = file.size();
+  Entry last;
+  bool valid = size > 0 && size % sizeof(Entry) == 0 &&
+               file.seek(size - sizeof(Entry)) &&
+               file.read((uint8_t *)&last, sizeof(last)) == sizeof(last) &&
+               last.offset < dataEnd;
+  file.close();
+
+  if (!valid) {
+    // Entrada rasgada ou dados perdidos na recuperação: reconstruir
+    if (size > 0) {
+      Serial.printf("[TimeIndex] %s inconsistente, reconstruindo.\n", _path);
+      SD.remove(_path);
+    }
+    return;
+  }
+
+  // Reindexa a partir do último registro indexado
+  _hasEntries = true;
+  _lastOffset = last.offset;
+  _coveredTo = last.offset;
+}
+
+void TimeIndex::rotate(const char *backupDataPath) {
+  flush();
+
+  char backupIdx[64];
+  snprintf(backupIdx, sizeof(backupIdx), "%s%s", backupDataPath,
+           SD_INDEX_SUFFIX);
+  if (SD.exists(_path) && !SD.rename(_path, backupIdx)) {
+    SD.remove(_path);
+  }
+
+  _coveredTo = 0;
+  _lastOffset = 0;
+  _hasEntries = false;
+  _pendingCount = 0;
+}
+
+void TimeIndex::note(uint32_t from, uint32_t offset, uint32_t to,
+                     uint32_t unixTime) {
+  if (from != _coveredTo)
+    return;
+
+  if (!_hasEntries || offset >= _lastOffset + SD_INDEX_STRIDE) {
+    // Sem espaço: cobertura para aqui e o catch-up retoma depois do flush
+    if (_pendingCount >= MAX_PENDING)
+      return;
+    _pending[_pendingCount].unixTime = unixTime;
+    _pending[_pendingCount].offset = offset;
+    _pendingCount++;
+    _lastOffset = offset;
+    _hasEntries = true;
+  }
+  _coveredTo = to;
+}
+
+bool TimeIndex::flush() {
+  if (_pendingCount == 0)
+    return true;
+
+  File file = SD.open(_path, FILE_APPEND);
+  if (!file)
+    return false;
+  size_t len = _pendingCount * sizeof(Entry);
+  bool ok = file.write((const uint8_t *)_pending, len) == len;
+  file.close();
+
+  if (ok)
+    _pendingCount = 0;
+  return ok;
+}
+
+bool TimeIndex::lookup(const char *idxPath, uint32_t unixTime,
+                       uint32_t &offset) {
+  File file = SD.open(idxPath, FILE_READ);
+  if (!file)
+    return false;
+
+  auto readAt = [&file](uint32_t i, Entry &e) -> bool {
+    return file.seek(i * sizeof(Entry)) &&
+           file.read((uint8_t *)&e, sizeof(e)) == sizeof(e);
+  };
+
+  // Última entrada estritamente anterior: registros do mesmo segundo podem
+  // estar antes de uma entrada com unixTime igual ao procurado
+  uint32_t lo = 0;
+  uint32_t hi = file.size() / sizeof(Entry);
+  bool found = false;
+  Entry e;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (!readAt(mid, e))
+      break;
+    if (e.unixTime < unixTime) {
+      offset = e.offset;
+      found = true;
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  file.close();
+  return found;
+}
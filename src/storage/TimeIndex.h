@@ -0,0 +1,142 @@
+/**
+ * @file TimeIndex.h
+ * @brief Índice temporal esparso de um log no SD (timestamp -> offset)
+ *
+ * @details Arquivo lateral "<log>.idx" com uma entrada a cada
+ *          SD_INDEX_STRIDE bytes de log:
+ *          - Entradas geradas em RAM no caminho de escrita (sem I/O)
+ *          - Gravadas no SD pela StorageTask ociosa (flush)
+ *          - Renomeado junto com o log na rotação
+ *          - Reconstruído sob demanda a partir do log (catch-up)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.1.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Formato
+ * | Campo    | Tipo     | Descrição                          |
+ * |----------|----------|------------------------------------|
+ * | unixTime | uint32_t | Timestamp do registro indexado     |
+ * | offset   | uint32_t | Início do registro no arquivo      |
+ *
+ * Busca: binária sobre o .idx (O(log n) leituras de 8 bytes), depois
+ * leitura sequencial de no máximo SD_INDEX_STRIDE bytes do log (mais os
+ * registros do segundo procurado que caem antes da entrada seguinte).
+ * A entrada devolvida é a última *anterior* ao segundo procurado: uma
+ * entrada no meio de um segundo repetido teria registros dele antes dela.
+ *
+ * ## Cobertura
+ * `coveredTo()` é o offset do log até onde todos os registros já foram
+ * considerados. Uma escrita só é indexada no caminho rápido se parte
+ * exatamente de coveredTo(); caso contrário (boot, rotação, buffer cheio)
+ * o StorageManager reindexa a cauda em segundo plano.
+ *
+ * @note Timestamps devem crescer dentro de um arquivo (RTC ajustado)
+ */
+
+#ifndef TIME_INDEX_H
+#define TIME_INDEX_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+
+/**
+ * @class TimeIndex
+ * @brief Índice esparso timestamp -> offset persistido ao lado do log
+ */
+class TimeIndex {
+public:
+    /**
+     * @struct Entry
+     * @brief Entrada do arquivo .idx
+     */
+    struct __attribute__((packed)) Entry {
+        uint32_t unixTime;   ///< Timestamp do registro
+        uint32_t offset;     ///< Offset do registro no log
+    };
+
+    /**
+     * @brief Construtor
+     * @param dataPath Caminho do log indexado (índice = dataPath + ".idx")
+     */
+    explicit TimeIndex(const char* dataPath);
+
+    //=========================================================================
+    // CICLO DE VIDA
+    //=========================================================================
+
+    /**
+     * @brief Retoma o índice existente para um log com fim lógico dataEnd
+     * @details Índice rasgado ou à frente dos dados é descartado e
+     *          reconstruído desde o início.
+     */
+    void load(uint32_t dataEnd);
+
+    /**
+     * @brief Acompanha a rotação do log
+     * @param backupDataPath Nome do log rotacionado (índice vira backup + ".idx")
+     */
+    void rotate(const char* backupDataPath);
+
+    //=========================================================================
+    // ATUALIZAÇÃO
+    //=========================================================================
+
+    /**
+     * @brief Considera um registro recém-gravado (somente RAM)
+     * @param from Fim lógico antes da escrita
+     * @param offset Início do registro (pode pular cabeçalho de bloco)
+     * @param to Fim lógico após a escrita
+     * @param unixTime Timestamp do registro
+     */
+    void note(uint32_t from, uint32_t offset, uint32_t to, uint32_t unixTime);
+
+    /** @brief Avança a cobertura sem indexar (região ilegível) */
+    void skipTo(uint32_t offset) { if (offset > _coveredTo) _coveredTo = offset; }
+
+    /**
+     * @brief Grava entradas pendentes no .idx
+     * @return true se nada pendente ou gravado com sucesso
+     */
+    bool flush();
+
+    /** @brief Offset do log até onde o índice está completo */
+    uint32_t coveredTo() const { return _coveredTo; }
+
+    /** @brief Caminho do arquivo .idx ativo */
+    const char* path() const { return _path; }
+
+    //=========================================================================
+    // CONSULTA
+    //=========================================================================
+
+    /**
+     * @brief Busca binária no .idx
+     * @param idxPath Arquivo de índice (ativo ou rotacionado)
+     * @param unixTime Timestamp procurado
+     * @param offset [out] Offset da última entrada com timestamp < unixTime
+     * @return true se encontrada; false = começar do início do log
+     * @note Todos os registros com timestamp >= unixTime estão em offset
+     *       ou depois, inclusive os repetidos do mesmo segundo
+     */
+    static bool lookup(const char* idxPath, uint32_t unixTime, uint32_t& offset);
+
+private:
+    //=========================================================================
+    // ESTADO
+    //=========================================================================
+    char _path[48];              ///< Arquivo .idx
+    uint32_t _coveredTo;         ///< Log considerado até este offset
+    uint32_t _lastOffset;        ///< Offset da última entrada
+    bool _hasEntries;            ///< Alguma entrada gravada/pendente?
+
+    static constexpr uint8_t MAX_PENDING = 8;  ///< Entradas aguardando flush
+    Entry _pending[MAX_PENDING]; ///< Entradas ainda não gravadas
+    uint8_t _pendingCount;       ///< Entradas em _pending
+};
+
+#endif // TIME_INDEX_H
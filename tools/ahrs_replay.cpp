@@ -0,0 +1,439 @@
+/**
+ * @file ahrs_replay.cpp
+ * @brief Reproduz um log de IMU no AHRS do firmware (float e Q7.24)
+ *
+ * @details Ferramenta de host (PC) que passa cada amostra de um CSV de IMU
+ *          pelo mesmo MahonyFilter do AttitudeEstimator, nas duas builds:
+ *          - Mesmos ganhos (AHRS_KP, AHRS_KI, AHRS_BIAS_LIMIT_DPS) e
+ *            mesmos limites de acelerômetro/magnetômetro do firmware
+ *            (AHRS_ACCEL_* e AHRS_MAG_*)
+ *          - Compara float x Q7.24 (maior divergência em graus)
+ *          - Com quaternião de referência no log, mede o erro de atitude
+ *            (RMS e máximo, após o tempo de convergência)
+ *          - Reporta o bias estimado e o tempo por atualização no host
+ *
+ *          Sem arquivo de entrada, reproduz um voo sintético gerado de forma
+ *          determinística (mesma sequência em qualquer host), com quaternião
+ *          de referência exato:
+ *          - Rotação contínua nos três eixos, bias constante e ruído no gyro
+ *          - Amostras perdidas (passos múltiplos)
+ *          - Aceleração dinâmica (rejeitada pelo limite de 1 g)
+ *          - Perturbação magnética (rejeitada pelo limite de campo)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.1.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Compilação
+ * @code{.sh}
+ * g++ -O2 -std=c++17 -o ahrs_replay tools/ahrs_replay.cpp
+ * @endcode
+ *
+ * ## Formato de entrada (uma amostra por linha, cabeçalho opcional)
+ * | Colunas            | Unidade | Observação                          |
+ * |--------------------|---------|-------------------------------------|
+ * | t                  | s       | Instante da amostra                 |
+ * | gx, gy, gz         | °/s     | Giroscópio                          |
+ * | ax, ay, az         | g       | Acelerômetro                        |
+ * | mx, my, mz         | µT      | Magnetômetro nos eixos do acc       |
+ * | q0, q1, q2, q3     | -       | Referência (opcional)               |
+ *
+ * @note Lacunas em t maiores que um período viram passos múltiplos, como
+ *       no firmware
+ * @note Código de saída 1 se o erro x referência ou a divergência
+ *       float x Q7.24 sair da tolerância
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../include/config/constants.h"
+#include "../src/sensors/AttitudeEstimator/MahonyFilter.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+constexpr float DEG = 57.2957795f;
+
+// Tolerâncias (graus, após o tempo de convergência)
+constexpr double TOL_RMS_DEG = 2.0;   ///< Erro RMS x referência
+constexpr double TOL_MAX_DEG = 4.0;   ///< Erro máximo x referência
+constexpr double TOL_DIV_DEG = 0.1;   ///< Divergência float x Q7.24
+
+// Voo sintético
+constexpr double SYN_DURATION_S = 120.0;
+constexpr double SYN_BIAS_DPS[3] = {0.6, -0.4, 0.9};  ///< Bias do gyro
+constexpr double SYN_GYRO_NOISE_DPS = 0.05;           ///< Desvio padrão
+constexpr double SYN_ACCEL_NOISE_G = 0.01;
+constexpr double SYN_MAG_NOISE_UT = 0.3;
+constexpr double SYN_MAG_EARTH_UT[3] = {18.0, 0.0, -14.0};  ///< Campo na Terra (X, Y, Z)
+constexpr double SYN_MAG_MAGNET_UT[3] = {90.0, -50.0, 30.0}; ///< Ímã, nos eixos do corpo
+
+/** @brief Uma linha do log */
+struct Sample {
+    float t;
+    float g[3], a[3], m[3];
+    float q[4];
+    bool hasRef;
+};
+
+/** @brief Um filtro em uma build, com tempo acumulado */
+template<typename T>
+struct Runner {
+    MahonyFilter<T> filter;
+    bool ready = false;
+    double ns = 0;
+    unsigned long updates = 0;
+
+    Runner() { filter.setGains(AHRS_KP, AHRS_KI, AHRS_BIAS_LIMIT_DPS / DEG); }
+
+    void step(const Sample& s, float dt, bool useAccel, bool useMag) {
+        if (!ready) {
+            if (!useAccel) return;
+            filter.initFromVectors(s.a[0], s.a[1], s.a[2], s.m[0], s.m[1], s.m[2], useMag);
+            ready = true;
+            return;
+        }
+        float an = std::sqrt(s.a[0] * s.a[0] + s.a[1] * s.a[1] + s.a[2] * s.a[2]);
+        float mn = std::sqrt(s.m[0] * s.m[0] + s.m[1] * s.m[1] + s.m[2] * s.m[2]);
+        float ia = useAccel ? 1.0f / an : 0.0f;
+        float im = useMag ? 1.0f / mn : 0.0f;
+
+        auto t0 = Clock::now();
+        filter.update(T(s.g[0] / DEG), T(s.g[1] / DEG), T(s.g[2] / DEG),
+                      T(s.a[0] * ia), T(s.a[1] * ia), T(s.a[2] * ia),
+                      T(s.m[0] * im), T(s.m[1] * im), T(s.m[2] * im),
+                      T(dt), useAccel, useAccel && useMag);
+        ns += std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        updates++;
+    }
+
+    void quat(float q[4]) const { filter.getQuaternion(q[0], q[1], q[2], q[3]); }
+};
+
+/** @brief Os dois filtros e a estatística da reprodução */
+struct Replay {
+    Runner<float> fl;
+    Runner<QFixed<24> > fx;
+    float period;
+    float settleS;
+    FILE* out = nullptr;
+
+    float lastT = NAN;
+    unsigned long samples = 0, refs = 0, skipped = 0;
+    unsigned long accelRejects = 0, magRejects = 0;
+    double divMax = 0, errSq = 0, errMax = 0, errSqQ = 0;
+
+    void feed(const Sample& s);
+};
+
+/** @brief Ângulo entre duas atitudes (graus) */
+double angleBetween(const float a[4], const float b[4]) {
+    double dot = std::fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+    if (dot > 1.0) dot = 1.0;
+    return 2.0 * std::acos(dot) * DEG;
+}
+
+void euler(const float q[4], float& roll, float& pitch, float& yaw) {
+    float sinp = 2.0f * (q[0] * q[2] - q[3] * q[1]);
+    if (sinp > 1.0f) sinp = 1.0f;
+    if (sinp < -1.0f) sinp = -1.0f;
+    roll = std::atan2(2.0f * (q[0] * q[1] + q[2] * q[3]), 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2])) * DEG;
+    pitch = std::asin(sinp) * DEG;
+    yaw = std::atan2(2.0f * (q[0] * q[3] + q[1] * q[2]), 1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3])) * DEG;
+}
+
+void Replay::feed(const Sample& s) {
+    samples++;
+
+    unsigned steps = 1;
+    if (!std::isnan(lastT)) {
+        long n = std::lround((s.t - lastT) / period);
+        if (n > 1) steps = (unsigned)n;
+    }
+    lastT = s.t;
+    skipped += steps - 1;
+
+    // Mesmo teste do AttitudeEstimator (módulo ao quadrado)
+    float an2 = s.a[0] * s.a[0] + s.a[1] * s.a[1] + s.a[2] * s.a[2];
+    float mn2 = s.m[0] * s.m[0] + s.m[1] * s.m[1] + s.m[2] * s.m[2];
+    bool useAccel = an2 >= AHRS_ACCEL_MIN_G * AHRS_ACCEL_MIN_G &&
+                    an2 <= AHRS_ACCEL_MAX_G * AHRS_ACCEL_MAX_G;
+    bool useMag = mn2 >= AHRS_MAG_MIN_UT * AHRS_MAG_MIN_UT &&
+                  mn2 <= AHRS_MAG_MAX_UT * AHRS_MAG_MAX_UT;
+    accelRejects += !useAccel;
+    magRejects += !useMag;
+
+    fl.step(s, period * steps, useAccel, useMag);
+    fx.step(s, period * steps, useAccel, useMag);
+    if (!fl.ready) return;
+
+    float qf[4], qq[4];
+    fl.quat(qf);
+    fx.quat(qq);
+    double div = angleBetween(qf, qq);
+    if (div > divMax) divMax = div;
+
+    if (s.hasRef && s.t >= settleS) {
+        double e = angleBetween(qf, s.q);
+        double eq = angleBetween(qq, s.q);
+        errSq += e * e;
+        errSqQ += eq * eq;
+        if (e > errMax) errMax = e;
+        if (eq > errMax) errMax = eq;
+        refs++;
+    }
+
+    if (out) {
+        float r, p, y, rq, pq, yq;
+        euler(qf, r, p, y);
+        euler(qq, rq, pq, yq);
+        fprintf(out, "%.4f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", s.t, r, p, y, rq, pq, yq);
+    }
+}
+
+bool parseLine(const char* line, Sample& s) {
+    int n = sscanf(line, "%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f", &s.t,
+                   &s.g[0], &s.g[1], &s.g[2], &s.a[0], &s.a[1], &s.a[2],
+                   &s.m[0], &s.m[1], &s.m[2], &s.q[0], &s.q[1], &s.q[2], &s.q[3]);
+    s.hasRef = (n == 14);
+    return n == 10 || n == 14;
+}
+
+//=============================================================================
+// VOO SINTÉTICO
+//=============================================================================
+
+/** @brief Gerador congruente de 32 bits: mesma sequência em qualquer host */
+struct Lcg {
+    uint32_t state = 12345;
+
+    double uniform() {
+        state = state * 1664525u + 1013904223u;
+        return ((state >> 8) + 0.5) / 16777216.0;
+    }
+    double gauss() {
+        return std::sqrt(-2.0 * std::log(uniform())) * std::cos(6.283185307179586 * uniform());
+    }
+};
+
+/** @brief Velocidade angular verdadeira no corpo (rad/s) */
+void trueRate(double t, double w[3]) {
+    const double twoPi = 6.283185307179586;
+    w[0] = (25.0 * std::sin(twoPi * 0.05 * t)) / DEG;
+    w[1] = (15.0 * std::sin(twoPi * 0.03 * t + 1.0)) / DEG;
+    w[2] = (12.0 + 20.0 * std::sin(twoPi * 0.02 * t)) / DEG;
+}
+
+/** @brief v_corpo = R(q)^T · v_Terra */
+void toBody(const double q[4], const double v[3], double out[3]) {
+    double q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    out[0] = (1 - 2 * (q2 * q2 + q3 * q3)) * v[0] + 2 * (q1 * q2 + q0 * q3) * v[1] + 2 * (q1 * q3 - q0 * q2) * v[2];
+    out[1] = 2 * (q1 * q2 - q0 * q3) * v[0] + (1 - 2 * (q1 * q1 + q3 * q3)) * v[1] + 2 * (q2 * q3 + q0 * q1) * v[2];
+    out[2] = 2 * (q1 * q3 + q0 * q2) * v[0] + 2 * (q2 * q3 - q0 * q1) * v[1] + (1 - 2 * (q1 * q1 + q2 * q2)) * v[2];
+}
+
+/** @brief q ← q ⊗ exp(w·dt/2) (rotação exata de um passo, em double) */
+void rotate(double q[4], const double w[3], double dt) {
+    double wn = std::sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+    double half = 0.5 * wn * dt;
+    double c = std::cos(half);
+    double k = wn > 0 ? std::sin(half) / wn : 0.5 * dt;
+    double d[4] = {c, w[0] * k, w[1] * k, w[2] * k};
+    double r[4] = {q[0] * d[0] - q[1] * d[1] - q[2] * d[2] - q[3] * d[3],
+                   q[0] * d[1] + q[1] * d[0] + q[2] * d[3] - q[3] * d[2],
+                   q[0] * d[2] - q[1] * d[3] + q[2] * d[0] + q[3] * d[1],
+                   q[0] * d[3] + q[1] * d[2] - q[2] * d[1] + q[3] * d[0]};
+    double n = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+    for (int i = 0; i < 4; i++) q[i] = r[i] / n;
+}
+
+/**
+ * @brief Gera o voo sintético e passa cada amostra a visit(Sample)
+ * @details Atitude verdadeira integrada a 1 kHz em double; a amostra no
+ *          período do IMU leva o quaternião verdadeiro como referência.
+ */
+template<typename Visit>
+void synthesize(float rateHz, Visit visit) {
+    const int sub = (int)std::lround(1000.0 / rateHz);
+    const double h = 1.0 / (rateHz * sub);
+    const double up[3] = {0.0, 0.0, 1.0};
+    Lcg rng;
+
+    // Atitude inicial: inclinado e fora do norte
+    double q[4] = {0.9, 0.2, -0.3, 0.25};
+    double n = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (double& c : q) c /= n;
+
+    const long total = std::lround(SYN_DURATION_S * rateHz);
+    for (long k = 0; k <= total; k++) {
+        double t = k / (double)rateHz;
+        double w[3], g[3], m[3];
+        trueRate(t, w);
+        toBody(q, up, g);
+        toBody(q, SYN_MAG_EARTH_UT, m);
+
+        // Lacuna de 5 amostras (passo múltiplo no filtro)
+        bool dropped = (k % 1500) >= 1495;
+
+        // Manobra de 40 a 43 s (0.85 g lateral, |a| ~1.3 g) e ímã perto do
+        // sensor de 70 a 72 s: as duas mudam a direção medida
+        if (t >= 40.0 && t < 43.0) {
+            double lateral[3] = {0.8, 0.3, 0.0};
+            double d[3];
+            toBody(q, lateral, d);
+            for (int i = 0; i < 3; i++) g[i] += d[i];
+        }
+        if (t >= 70.0 && t < 72.0) {
+            for (int i = 0; i < 3; i++) m[i] += SYN_MAG_MAGNET_UT[i];
+        }
+
+        Sample s;
+        s.t = (float)t;
+        for (int i = 0; i < 3; i++) {
+            s.g[i] = (float)(w[i] * DEG + SYN_BIAS_DPS[i] + SYN_GYRO_NOISE_DPS * rng.gauss());
+            s.a[i] = (float)(g[i] + SYN_ACCEL_NOISE_G * rng.gauss());
+            s.m[i] = (float)(m[i] + SYN_MAG_NOISE_UT * rng.gauss());
+        }
+        for (int i = 0; i < 4; i++) s.q[i] = (float)q[i];
+        s.hasRef = true;
+        if (!dropped) visit(s);
+
+        for (int j = 0; j < sub; j++) {
+            trueRate(t + j * h, w);
+            rotate(q, w, h);
+        }
+    }
+}
+
+void printUsage() {
+    fprintf(stderr, "Uso: ahrs_replay [-r Hz] [-s segundos] [-o saida.csv] [-g voo.csv] [imu.csv]\n"
+                    "  sem imu.csv, reproduz o voo sintetico e confere as tolerancias\n"
+                    "  -r  taxa nominal do log (padrao IMU_OUTPUT_RATE_HZ)\n"
+                    "  -s  tempo de convergencia ignorado no erro (padrao 10 s)\n"
+                    "  -o  grava t,roll,pitch,yaw (float) e roll,pitch,yaw (Q7.24)\n"
+                    "  -g  grava o voo sintetico no formato de entrada\n");
+}
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    printf("  [%s] %s\n", ok ? " OK " : "FALHA", what);
+    if (!ok) failures++;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    float rateHz = IMU_OUTPUT_RATE_HZ;
+    float settleS = 10.0f;
+    const char* input = nullptr;
+    const char* output = nullptr;
+    const char* generate = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rateHz = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            settleS = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            generate = argv[++i];
+        } else if (argv[i][0] == '-') {
+            printUsage();
+            return (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) ? 0 : 1;
+        } else {
+            input = argv[i];
+        }
+    }
+    if (rateHz <= 0) {
+        printUsage();
+        return 1;
+    }
+
+    Replay replay;
+    replay.period = 1.0f / rateHz;
+    replay.settleS = settleS;
+    replay.out = output ? fopen(output, "w") : nullptr;
+    if (replay.out) fprintf(replay.out, "t,roll,pitch,yaw,rollQ,pitchQ,yawQ\n");
+
+    unsigned long bad = 0;
+    if (input) {
+        FILE* in = fopen(input, "r");
+        if (!in) {
+            fprintf(stderr, "Erro: nao abriu %s\n", input);
+            return 1;
+        }
+        char line[512];
+        Sample s;
+        while (fgets(line, sizeof(line), in)) {
+            if (!parseLine(line, s)) {
+                // Cabeçalho ou linha truncada
+                if (replay.samples > 0) bad++;
+                continue;
+            }
+            replay.feed(s);
+        }
+        fclose(in);
+    } else {
+        FILE* gen = generate ? fopen(generate, "w") : nullptr;
+        if (gen) fprintf(gen, "t,gx,gy,gz,ax,ay,az,mx,my,mz,q0,q1,q2,q3\n");
+        printf("voo sintetico: %.0f s a %.0f Hz\n", SYN_DURATION_S, rateHz);
+        synthesize(rateHz, [&](const Sample& s) {
+            if (gen) {
+                fprintf(gen, "%.4f,%.5f,%.5f,%.5f,%.5f,%.5f,%.5f,%.4f,%.4f,%.4f,%.7f,%.7f,%.7f,%.7f\n",
+                        s.t, s.g[0], s.g[1], s.g[2], s.a[0], s.a[1], s.a[2],
+                        s.m[0], s.m[1], s.m[2], s.q[0], s.q[1], s.q[2], s.q[3]);
+            }
+            replay.feed(s);
+        });
+        if (gen) fclose(gen);
+    }
+    if (replay.out) fclose(replay.out);
+
+    float bx, by, bz, qbx, qby, qbz;
+    replay.fl.filter.getGyroBias(bx, by, bz);
+    replay.fx.filter.getGyroBias(qbx, qby, qbz);
+    const Runner<float>& fl = replay.fl;
+    const Runner<QFixed<24> >& fx = replay.fx;
+
+    printf("amostras %lu (passos perdidos %lu, linhas invalidas %lu)\n",
+           replay.samples, replay.skipped, bad);
+    printf("rejeitadas: acelerometro %lu, magnetometro %lu\n",
+           replay.accelRejects, replay.magRejects);
+    printf("float: %.0f ns/atualizacao, bias %.3f %.3f %.3f dps\n",
+           fl.updates ? fl.ns / fl.updates : 0.0, bx * DEG, by * DEG, bz * DEG);
+    printf("Q7.24: %.0f ns/atualizacao, bias %.3f %.3f %.3f dps\n",
+           fx.updates ? fx.ns / fx.updates : 0.0, qbx * DEG, qby * DEG, qbz * DEG);
+    printf("divergencia float x Q7.24: max %.4f graus\n", replay.divMax);
+
+    char what[96];
+    snprintf(what, sizeof(what), "divergencia float x Q7.24 <= %.2f graus", TOL_DIV_DEG);
+    check(replay.divMax <= TOL_DIV_DEG, what);
+
+    if (replay.refs > 0) {
+        double rms = std::sqrt(replay.errSq / replay.refs);
+        double rmsQ = std::sqrt(replay.errSqQ / replay.refs);
+        printf("erro x referencia (t >= %.0f s, %lu amostras): float RMS %.3f, "
+               "Q7.24 RMS %.3f, max %.3f graus\n",
+               settleS, replay.refs, rms, rmsQ, replay.errMax);
+        snprintf(what, sizeof(what), "erro RMS <= %.1f graus (float e Q7.24)", TOL_RMS_DEG);
+        check(rms <= TOL_RMS_DEG && rmsQ <= TOL_RMS_DEG, what);
+        snprintf(what, sizeof(what), "erro maximo <= %.1f graus", TOL_MAX_DEG);
+        check(replay.errMax <= TOL_MAX_DEG, what);
+    } else if (!input) {
+        check(false, "voo sintetico sem amostras de referencia");
+    }
+
+    printf(failures ? "FALHOU (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
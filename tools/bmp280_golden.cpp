@@ -0,0 +1,156 @@
+/**
+ * @file bmp280_golden.cpp
+ * @brief Teste de host do driver BMP280 contra valores de referência
+ *
+ * @details Roda o driver do firmware (lib/BMP280) sobre o barramento
+ *          simulado de tools/host:
+ *          - Compensação com o exemplo do datasheet Bosch (seção 3.12):
+ *            T = 25.08 °C, P = 100653.27 Pa
+ *          - readAll() em uma rajada de 6 bytes (2 transações) e igual às
+ *            leituras separadas read*()
+ *          - Altitude por tabela (Hermite) contra a fórmula barométrica em
+ *            double em toda a faixa 0.25 <= p/p0 <= 1.25 e fora dela (powf)
+ *          - Tempo por chamada no host: tabela x powf
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Compilação
+ * @code{.sh}
+ * g++ -O2 -std=c++17 -Itools/host -Ilib/BMP280/include -o bmp280_golden \
+ *     tools/bmp280_golden.cpp lib/BMP280/src/BMP280.cpp
+ * @endcode
+ *
+ * @note Código de saída 1 se algum valor sair da tolerância
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "BMP280.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+constexpr uint8_t ADDR = BMP280::I2C_ADDR_PRIMARY;
+constexpr double P0 = 101325.0;
+
+// Exemplo do datasheet (BST-BMP280-DS001, seção 3.12)
+constexpr int16_t CALIB[12] = {27504, 26435, -1000, (int16_t)36477, -10685, 3024,
+                               2855,  140,   -7,    15500,          -14600, 6000};
+constexpr int32_t ADC_T = 519888;
+constexpr int32_t ADC_P = 415148;
+constexpr double REF_T = 25.08;       ///< °C
+constexpr double REF_P = 100653.27;   ///< Pa
+
+// Tolerâncias
+constexpr double TOL_T = 0.01;        ///< °C (resolução 0.01)
+constexpr double TOL_P = 0.1;         ///< Pa (Q24.8 em float)
+constexpr double TOL_TABLE_M = 0.02;  ///< Tabela, 0.25 <= p/p0 <= 1.25
+constexpr double TOL_POWF_M = 0.005;  ///< Fora da tabela (powf)
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    std::printf("  [%s] %s\n", ok ? " OK " : "FALHA", what);
+    if (!ok) failures++;
+}
+
+double refAltitude(double p) {
+    return 44330.0 * (1.0 - std::pow(p / P0, 0.1903));
+}
+
+/** @brief Sensor simulado com a calibração e leituras do datasheet */
+void setupSensor() {
+    TwoWire::Device& d = Wire.attach(ADDR);
+    d.regs[0xD0] = 0x58;  // CHIP_ID
+    for (int i = 0; i < 12; i++) {
+        d.regs[0x88 + 2 * i] = (uint16_t)CALIB[i] & 0xFF;
+        d.regs[0x89 + 2 * i] = (uint16_t)CALIB[i] >> 8;
+    }
+    d.regs[0xF7] = ADC_P >> 12;
+    d.regs[0xF8] = (ADC_P >> 4) & 0xFF;
+    d.regs[0xF9] = (ADC_P & 0x0F) << 4;
+    d.regs[0xFA] = ADC_T >> 12;
+    d.regs[0xFB] = (ADC_T >> 4) & 0xFF;
+    d.regs[0xFC] = (ADC_T & 0x0F) << 4;
+}
+
+/** @brief Maior erro da altitude do driver contra a referência em [x0, x1] */
+double maxAltitudeError(double x0, double x1, double& worstX) {
+    double worst = 0;
+    for (double x = x0; x <= x1; x += 1e-5) {
+        float p = (float)(x * P0);
+        double e = std::fabs(BMP280::altitudeFromPressure(p, (float)P0) - refAltitude(p));
+        if (e > worst) {
+            worst = e;
+            worstX = x;
+        }
+    }
+    return worst;
+}
+
+} // namespace
+
+int main() {
+    setupSensor();
+    BMP280 bmp(Wire);
+
+    std::printf("Compensacao (datasheet Bosch 3.12)\n");
+    check(bmp.begin(ADDR), "begin() reconhece o CHIP_ID e le a calibracao");
+
+    float t, p, alt;
+    uint32_t txBefore = Wire.transactions;
+    uint32_t rxBefore = Wire.bytesRead;
+    bool ok = bmp.readAll(t, p, alt, (float)P0);
+    uint32_t txns = Wire.transactions - txBefore;
+    uint32_t bytes = Wire.bytesRead - rxBefore;
+    std::printf("  T = %.2f C, P = %.2f Pa, h = %.3f m (%u transacoes, %u bytes)\n",
+                t, p, alt, (unsigned)txns, (unsigned)bytes);
+    check(ok, "readAll()");
+    check(std::fabs(t - REF_T) <= TOL_T, "temperatura = 25.08 C");
+    check(std::fabs(p - REF_P) <= TOL_P, "pressao = 100653.27 Pa");
+    check(std::fabs(alt - refAltitude(p)) <= TOL_TABLE_M, "altitude da mesma pressao");
+    check(txns == 2 && bytes == 6, "uma rajada de 6 bytes");
+
+    float t2 = bmp.readTemperature();
+    float p2 = bmp.readPressure();
+    float alt2 = bmp.readAltitude((float)P0);
+    check(t2 == t && p2 == p && std::fabs(alt2 - alt) < 1e-3f,
+          "read*() separados iguais a readAll()");
+
+    std::printf("Altitude (tabela de 33 nos x formula em double)\n");
+    double worstX = 0;
+    double tableErr = maxAltitudeError(0.25, 1.25, worstX);
+    std::printf("  erro maximo %.4f m em p/p0 = %.4f\n", tableErr, worstX);
+    check(tableErr < TOL_TABLE_M, "tabela: erro < 0.02 m");
+
+    double lowX = 0, highX = 0;
+    double outErr = std::fmax(maxAltitudeError(0.20, 0.2499, lowX),
+                              maxAltitudeError(1.2501, 1.30, highX));
+    std::printf("  fora da tabela (powf): erro maximo %.4f m\n", outErr);
+    check(outErr < TOL_POWF_M, "fora da faixa: erro < 0.005 m");
+
+    // Tempo no host: só para comparar a ordem de grandeza
+    const int N = 2000000;
+    volatile float acc = 0;
+    Clock::time_point c0 = Clock::now();
+    for (int i = 0; i < N; i++)
+        acc = acc + BMP280::altitudeFromPressure(90000.0f + i * 0.005f, (float)P0);
+    Clock::time_point c1 = Clock::now();
+    for (int i = 0; i < N; i++)
+        acc = acc + 44330.0f * (1.0f - powf((90000.0f + i * 0.005f) / (float)P0, 0.1903f));
+    Clock::time_point c2 = Clock::now();
+    std::printf("  host: tabela %.1f ns, powf %.1f ns por chamada\n",
+                std::chrono::duration<double, std::nano>(c1 - c0).count() / N,
+                std::chrono::duration<double, std::nano>(c2 - c1).count() / N);
+
+    std::printf(failures ? "FALHOU (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+/**
+ * @file colarch_reader.h
+ * @brief Leitor de colunas do arquivo colunar de telemetria (host)
+ *
+ * @details Biblioteca header-only para o PC que lê "telemetry.col" (e os
+ *          rotacionados "telemetry.col.<timestamp>.bak") coluna a coluna:
+ *          - Por grupo, lê o cabeçalho e só as entradas do diretório e os
+ *            chunks das colunas pedidas (custo ~ tamanho dessas colunas)
+ *          - CRC-32 conferido por chunk; grupo divergente é pulado inteiro
+ *            (linhas continuam alinhadas entre colunas)
+ *          - Leitura termina no primeiro grupo incompleto (cauda rasgada)
+ *          - Mesmo decodificador do firmware (src/storage/ColumnarFormat.h)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Uso
+ * @code{.cpp}
+ * ColArch::Reader r;
+ * uint8_t cols[] = { (uint8_t)r.columnIndex("UnixTimestamp"),
+ *                    (uint8_t)r.columnIndex("Altitude") };
+ * if (r.open("telemetry.col"))
+ *     r.scan(cols, 2, [&](const uint32_t* raw) {
+ *         double alt = ColArch::toDouble(cols[1], raw[1]);
+ *     });
+ * @endcode
+ */
+
+#ifndef COLARCH_READER_H
+#define COLARCH_READER_H
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../src/storage/ColumnarFormat.h"
+
+namespace ColArch {
+
+/**
+ * @class Reader
+ * @brief Varredura de colunas selecionadas de um arquivo colunar
+ */
+class Reader {
+public:
+    /**
+     * @struct Stats
+     * @brief Contadores acumulados desde open()
+     */
+    struct Stats {
+        uint64_t bytesRead = 0;    ///< Bytes lidos do arquivo
+        uint32_t groups = 0;       ///< Grupos entregues
+        uint32_t records = 0;      ///< Linhas entregues
+        uint32_t badGroups = 0;    ///< Grupos pulados (CRC/decodificação)
+    };
+
+    Reader() = default;
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    ~Reader() { close(); }
+
+    /**
+     * @brief Abre o arquivo e valida o FileHeader
+     * @return false se não abriu ou é de outro formato/layout de colunas
+     */
+    bool open(const char* path) {
+        close();
+        _file = fopen(path, "rb");
+        if (!_file)
+            return false;
+        // Sem buffer do stdio: cada leitura traz só os bytes pedidos
+        setvbuf(_file, nullptr, _IONBF, 0);
+        fseek(_file, 0, SEEK_END);
+        _size = ftell(_file);
+        _stats = Stats();
+        if (!_read(0, &_header, sizeof(_header)) || !isValidFileHeader(_header)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /** @brief Fecha o arquivo */
+    void close() {
+        if (_file)
+            fclose(_file);
+        _file = nullptr;
+    }
+
+    /** @brief Cabeçalho do arquivo aberto */
+    const FileHeader& header() const { return _header; }
+
+    /** @brief Contadores da leitura */
+    const Stats& stats() const { return _stats; }
+
+    /** @brief Índice da coluna pelo nome (-1 se não existe) */
+    static int columnIndex(const char* name) {
+        for (uint8_t i = 0; i < COLUMN_COUNT; i++)
+            if (strcmp(COLUMNS[i].name, name) == 0)
+                return i;
+        return -1;
+    }
+
+    /**
+     * @brief Entrega as colunas pedidas linha a linha, em ordem de gravação
+     * @param cols Índices em COLUMNS
+     * @param n Colunas pedidas
+     * @param fn Chamado com raw[0..n-1] (valores brutos, ver toDouble())
+     * @return false se o arquivo não está aberto ou um índice é inválido
+     */
+    template <typename Fn>
+    bool scan(const uint8_t* cols, uint8_t n, Fn fn) {
+        if (!_file)
+            return false;
+        for (uint8_t i = 0; i < n; i++)
+            if (cols[i] >= COLUMN_COUNT)
+                return false;
+
+        std::vector<std::vector<uint32_t>> values(n);
+        std::vector<uint8_t> chunk;
+        std::vector<uint32_t> row(n);
+
+        GroupHeader g;
+        for (uint64_t pos = sizeof(FileHeader);
+             pos + sizeof(g) <= _size && _read(pos, &g, sizeof(g)) &&
+             isValidGroupHeader(g) && g.groupBytes <= _size - pos;
+             pos += g.groupBytes) {
+            bool ok = true;
+            for (uint8_t i = 0; ok && i < n; i++) {
+                ChunkEntry e;
+                ok = _read(pos + sizeof(g) + cols[i] * sizeof(e), &e, sizeof(e)) &&
+                     e.offset >= GROUP_PREFIX && e.offset <= g.groupBytes &&
+                     e.size <= g.groupBytes - e.offset;
+                if (!ok)
+                    break;
+                chunk.resize(e.size);
+                ok = _read(pos + e.offset, chunk.data(), e.size) &&
+                     BinLog::crc32(0, chunk.data(), e.size) == e.crc32 &&
+                     _decode(cols[i], chunk, g.recordCount, values[i]);
+            }
+            if (!ok) {
+                _stats.badGroups++;
+                continue;
+            }
+
+            for (uint16_t r = 0; r < g.recordCount; r++) {
+                for (uint8_t i = 0; i < n; i++)
+                    row[i] = values[i][r];
+                fn(row.data());
+            }
+            _stats.groups++;
+            _stats.records += g.recordCount;
+        }
+        return true;
+    }
+
+private:
+    FILE* _file = nullptr;
+    uint64_t _size = 0;
+    FileHeader _header;
+    Stats _stats;
+
+    bool _read(uint64_t pos, void* out, size_t len) {
+        if (len == 0)
+            return true;
+        if (fseek(_file, (long)pos, SEEK_SET) != 0 ||
+            fread(out, 1, len, _file) != len)
+            return false;
+        _stats.bytesRead += len;
+        return true;
+    }
+
+    static bool _decode(uint8_t col, const std::vector<uint8_t>& chunk,
+                        uint16_t count, std::vector<uint32_t>& out) {
+        out.resize(count);
+        ChunkDecoder d(col, chunk.data(), chunk.size());
+        for (uint16_t i = 0; i < count; i++)
+            if (!d.next(out[i]))
+                return false;
+        return true;
+    }
+};
+
+} // namespace ColArch
+
+#endif // COLARCH_READER_H
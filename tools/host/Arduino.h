@@ -0,0 +1,98 @@
+/**
+ * @file Arduino.h
+ * @brief Camada mínima do framework Arduino para os testes de host (tools/)
+ *
+ * @details Permite compilar no PC drivers do firmware que dependem só de
+ *          tempo, GPIO e Serial:
+ *          - millis()/micros() do relógio monotônico do host, com
+ *            hostClockOffsetMs para avançar o tempo sem esperar
+ *          - digitalRead() devolve hostPinLevel[] (definido pelo teste)
+ *            ou, se definido, hostReadHook (nível que muda com as
+ *            escritas); digitalWrite() só conta escritas em hostPinWrites[]
+ *          - Serial.printf()/println() vão para stdout
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.1.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * @note Só para tools/: compilar com -std=c++17 -Itools/host
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <chrono>
+#include <math.h>
+#include <cstdarg>
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string.h>
+#include <thread>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define OUTPUT_OPEN_DRAIN 0x13
+#define IRAM_ATTR
+
+//=============================================================================
+// TEMPO
+//=============================================================================
+inline uint32_t hostClockOffsetMs = 0;  ///< Avanço artificial de millis()/micros()
+
+/** @brief Microssegundos desde o início do processo (mais o avanço) */
+inline uint64_t hostMicros() {
+    static const auto t0 = std::chrono::steady_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    return (uint64_t)us + (uint64_t)hostClockOffsetMs * 1000ULL;
+}
+
+inline unsigned long millis() { return (unsigned long)(hostMicros() / 1000ULL); }
+inline unsigned long micros() { return (unsigned long)hostMicros(); }
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void delayMicroseconds(unsigned int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+//=============================================================================
+// GPIO
+//=============================================================================
+inline uint8_t hostPinLevel[40] = {};     ///< Nível lido por digitalRead()
+inline uint32_t hostPinWrites[40] = {};   ///< Escritas por pino
+inline int (*hostReadHook)(uint8_t pin) = nullptr;  ///< Substitui hostPinLevel[]
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t) { if (pin < 40) hostPinWrites[pin]++; }
+inline int digitalRead(uint8_t pin) {
+    if (hostReadHook != nullptr) return hostReadHook(pin);
+    return pin < 40 ? hostPinLevel[pin] : LOW;
+}
+
+//=============================================================================
+// SERIAL
+//=============================================================================
+/**
+ * @class HardwareSerial
+ * @brief Saída de depuração em stdout
+ */
+class HardwareSerial {
+public:
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, format);
+        int n = vprintf(format, args);
+        va_end(args);
+        return n < 0 ? 0 : (size_t)n;
+    }
+    size_t println(const char* s = "") { return (size_t)::printf("%s\n", s); }
+    size_t println(int v) { return (size_t)::printf("%d\n", v); }
+};
+
+inline HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
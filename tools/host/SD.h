@@ -0,0 +1,127 @@
+/**
+ * @file SD.h
+ * @brief Cartão SD simulado sobre um diretório do host (testes de tools/)
+ *
+ * @details Mesma interface usada pelo firmware (SD.open/exists/remove/
+ *          rename/mkdir, File com read/write/seek/size e listagem com
+ *          openNextFile()):
+ *          - Caminhos "/x" viram hostSdRoot + "/x"
+ *          - hostSdRoot é criado pelo teste (ex.: mkdtemp)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * @note Só para tools/: compilar com -std=c++17 -Itools/host
+ */
+
+#ifndef HOST_SD_H
+#define HOST_SD_H
+
+#include <dirent.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+
+#include "Arduino.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+inline std::string hostSdRoot = "/tmp";  ///< Diretório que faz o papel do cartão
+
+/**
+ * @class File
+ * @brief Arquivo ou diretório aberto no cartão simulado
+ */
+class File {
+public:
+    File() {}
+    File(FILE* fp, const std::string& name)
+        : _file(fp, [](FILE* p) { if (p) fclose(p); }), _name(name) {}
+
+    size_t write(uint8_t b) { return write(&b, 1); }
+    size_t write(const uint8_t* buf, size_t len) {
+        return _file ? fwrite(buf, 1, len, _file.get()) : 0;
+    }
+    size_t read(uint8_t* buf, size_t len) { return _file ? fread(buf, 1, len, _file.get()) : 0; }
+    int read() { return _file ? fgetc(_file.get()) : -1; }
+    int available() { return _file ? (int)(size() - position()) : 0; }
+    bool seek(uint32_t pos) { return _file && fseek(_file.get(), pos, SEEK_SET) == 0; }
+    size_t position() const { return _file ? (size_t)ftell(_file.get()) : 0; }
+    size_t size() const {
+        if (!_file) return 0;
+        long pos = ftell(_file.get());
+        fseek(_file.get(), 0, SEEK_END);
+        long end = ftell(_file.get());
+        fseek(_file.get(), pos, SEEK_SET);
+        return (size_t)end;
+    }
+    void flush() { if (_file) fflush(_file.get()); }
+    void close() { _file.reset(); _dir.reset(); }
+
+    const char* name() const { return _name.c_str(); }
+    bool isDirectory() const { return (bool)_dir; }
+
+    /** @brief Próxima entrada do diretório (aberta para leitura) */
+    File openNextFile() {
+        if (!_dir) return File();
+        struct dirent* e;
+        while ((e = readdir(_dir.get())) != nullptr && e->d_name[0] == '.') {}
+        if (e == nullptr) return File();
+        return File(fopen((_dirPath + "/" + e->d_name).c_str(), "rb"), e->d_name);
+    }
+
+    operator bool() const { return (bool)_file || (bool)_dir; }
+
+private:
+    friend class SDFS;
+    std::shared_ptr<FILE> _file;   ///< Arquivo aberto
+    std::shared_ptr<DIR> _dir;     ///< Diretório aberto
+    std::string _name;             ///< Nome sem diretório
+    std::string _dirPath;          ///< Caminho do diretório no host
+};
+
+/**
+ * @class SDFS
+ * @brief Operações de arquivo do cartão simulado
+ */
+class SDFS {
+public:
+    File open(const char* path, const char* mode = FILE_READ) {
+        std::string host = _host(path);
+        struct stat st;
+        if (stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+            File dir;
+            dir._dir.reset(opendir(host.c_str()), [](DIR* d) { if (d) closedir(d); });
+            dir._dirPath = host;
+            return dir;
+        }
+        const char* m = strcmp(mode, FILE_WRITE) == 0 ? "wb"
+                      : strcmp(mode, FILE_APPEND) == 0 ? "ab" : "rb";
+        FILE* fp = fopen(host.c_str(), m);
+        if (fp == nullptr) return File();
+        const char* slash = strrchr(path, '/');
+        return File(fp, slash ? slash + 1 : path);
+    }
+    bool exists(const char* path) {
+        struct stat st;
+        return stat(_host(path).c_str(), &st) == 0;
+    }
+    bool remove(const char* path) { return ::remove(_host(path).c_str()) == 0; }
+    bool rename(const char* from, const char* to) {
+        return ::rename(_host(from).c_str(), _host(to).c_str()) == 0;
+    }
+    bool mkdir(const char* path) { return ::mkdir(_host(path).c_str(), 0755) == 0; }
+
+private:
+    static std::string _host(const char* path) { return hostSdRoot + path; }
+};
+
+inline SDFS SD;
+
+#endif // HOST_SD_H
@@ -0,0 +1,114 @@
+/**
+ * @file Wire.h
+ * @brief Barramento I2C simulado para os testes de host (tools/)
+ *
+ * @details TwoWire com a mesma interface usada pelo firmware e até 128
+ *          dispositivos simulados (mapa de 256 registradores cada):
+ *          - write() após beginTransmission(): 1º byte = ponteiro de
+ *            registrador, demais gravam a partir dele
+ *          - requestFrom() lê a partir do ponteiro (auto-incremento)
+ *          - Falhas injetadas por dispositivo: código devolvido por
+ *            endTransmission() (2 = NACK, 5 = timeout, ...)
+ *          - Contadores de transações, bytes lidos, begin()/end() e o
+ *            histórico de setTimeOut()
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <vector>
+
+#include "Arduino.h"
+
+/**
+ * @class TwoWire
+ * @brief Barramento simulado (um mestre, dispositivos em memória)
+ */
+class TwoWire {
+public:
+    /** @brief Dispositivo simulado */
+    struct Device {
+        bool present = false;   ///< Responde com ACK
+        uint8_t error = 0;      ///< Código forçado em endTransmission (0 = nenhum)
+        uint8_t pointer = 0;    ///< Ponteiro de registrador
+        uint8_t regs[256] = {}; ///< Mapa de registradores
+    };
+
+    Device devices[128];                ///< Por endereço de 7 bits
+    uint32_t transactions = 0;          ///< endTransmission() + requestFrom()
+    uint32_t bytesRead = 0;             ///< Bytes entregues por requestFrom()
+    uint32_t begins = 0;                ///< Chamadas a begin()
+    uint32_t ends = 0;                  ///< Chamadas a end()
+    uint16_t timeoutMs = 0;             ///< Último setTimeOut()
+    std::vector<uint16_t> timeoutLog;   ///< Todos os setTimeOut()
+
+    /** @brief Cria um dispositivo que responde em addr */
+    Device& attach(uint8_t addr) {
+        devices[addr & 0x7F].present = true;
+        return devices[addr & 0x7F];
+    }
+
+    bool begin(int = -1, int = -1, uint32_t = 0) { begins++; return true; }
+    bool end() { ends++; return true; }
+    void setClock(uint32_t) {}
+    size_t setBufferSize(size_t n) { return n; }
+    void setTimeOut(uint16_t ms) { timeoutMs = ms; timeoutLog.push_back(ms); }
+    uint16_t getTimeOut() const { return timeoutMs; }
+
+    void beginTransmission(uint16_t addr) {
+        _addr = addr & 0x7F;
+        _txLen = 0;
+    }
+
+    size_t write(uint8_t b) {
+        if (_txLen < sizeof(_tx)) _tx[_txLen++] = b;
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t len) {
+        for (size_t i = 0; i < len; i++) write(data[i]);
+        return len;
+    }
+
+    uint8_t endTransmission(bool = true) {
+        transactions++;
+        Device& d = devices[_addr];
+        if (d.error != 0) return d.error;
+        if (!d.present) return 2;
+        if (_txLen > 0) d.pointer = _tx[0];
+        for (size_t i = 1; i < _txLen; i++) d.regs[d.pointer++] = _tx[i];
+        return 0;
+    }
+
+    size_t requestFrom(uint16_t addr, size_t len, bool = true) {
+        transactions++;
+        _rxLen = _rxPos = 0;
+        Device& d = devices[addr & 0x7F];
+        if (!d.present || d.error != 0) return 0;
+        for (size_t i = 0; i < len && i < sizeof(_rx); i++) _rx[_rxLen++] = d.regs[d.pointer++];
+        bytesRead += _rxLen;
+        return _rxLen;
+    }
+
+    int available() const { return (int)(_rxLen - _rxPos); }
+    int read() { return _rxPos < _rxLen ? _rx[_rxPos++] : -1; }
+
+private:
+    uint8_t _addr = 0;      ///< Destino da transmissão atual
+    uint8_t _tx[64];        ///< Bytes da transmissão atual
+    size_t _txLen = 0;      ///< Bytes em _tx
+    uint8_t _rx[512];       ///< Resposta do último requestFrom()
+    size_t _rxLen = 0;      ///< Bytes em _rx
+    size_t _rxPos = 0;      ///< Próximo byte de _rx
+};
+
+inline TwoWire Wire;
+
+#endif // HOST_WIRE_H
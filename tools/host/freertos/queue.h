@@ -0,0 +1,21 @@
+/**
+ * @file queue.h
+ * @brief Filas do FreeRTOS para os testes de host (só o tipo)
+ *
+ * @details Globals.h declara as filas do firmware; nenhum teste de host
+ *          as usa.
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ */
+
+#ifndef HOST_QUEUE_H
+#define HOST_QUEUE_H
+
+#include "FreeRTOS.h"
+
+#endif // HOST_QUEUE_H
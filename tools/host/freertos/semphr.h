@@ -0,0 +1,59 @@
+/**
+ * @file semphr.h
+ * @brief Semáforos do FreeRTOS sobre std::mutex para os testes de host
+ *
+ * @details Mutex = semáforo binário que nasce livre (sem herança de
+ *          prioridade nem recursão, como xSemaphoreCreateMutex usado
+ *          pelo firmware). portMAX_DELAY espera sem limite.
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ */
+
+#ifndef HOST_SEMPHR_H
+#define HOST_SEMPHR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "FreeRTOS.h"
+
+/** @brief Semáforo binário do host */
+struct HostSemaphore {
+    std::mutex m;                ///< Protege count
+    std::condition_variable cv;  ///< Acorda quem espera
+    int count;                   ///< 0 ou 1
+};
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return new HostSemaphore{{}, {}, 0}; }
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return new HostSemaphore{{}, {}, 1}; }
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t handle, TickType_t ticks) {
+    HostSemaphore* s = static_cast<HostSemaphore*>(handle);
+    std::unique_lock<std::mutex> lock(s->m);
+    auto ready = [s] { return s->count > 0; };
+    if (ticks == portMAX_DELAY)
+        s->cv.wait(lock, ready);
+    else if (!s->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready))
+        return pdFALSE;
+    s->count = 0;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t handle) {
+    HostSemaphore* s = static_cast<HostSemaphore*>(handle);
+    {
+        std::lock_guard<std::mutex> lock(s->m);
+        if (s->count > 0) return pdFALSE;
+        s->count = 1;
+    }
+    s->cv.notify_all();
+    return pdTRUE;
+}
+
+#endif // HOST_SEMPHR_H
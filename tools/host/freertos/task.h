@@ -0,0 +1,26 @@
+/**
+ * @file task.h
+ * @brief Identidade de task do FreeRTOS para os testes de host
+ *
+ * @details Cada thread do host é uma task: o handle é o endereço de uma
+ *          variável thread_local.
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ */
+
+#ifndef HOST_TASK_H
+#define HOST_TASK_H
+
+#include "FreeRTOS.h"
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+    static thread_local char self;
+    return &self;
+}
+
+#endif // HOST_TASK_H
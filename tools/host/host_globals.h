@@ -0,0 +1,36 @@
+/**
+ * @file host_globals.h
+ * @brief Globais do firmware (Globals.cpp) para os testes de host
+ *
+ * @details Define o que config/debug.h declara: mutex da Serial, flag de
+ *          logs e safePrintf(), que aqui escreve direto em stdout.
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * @note Incluir em um único .cpp do teste (contém definições)
+ */
+
+#ifndef HOST_GLOBALS_H
+#define HOST_GLOBALS_H
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+
+SemaphoreHandle_t xSerialMutex = NULL;
+bool currentSerialLogsEnabled = true;
+
+void safePrintf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+#endif // HOST_GLOBALS_H
@@ -0,0 +1,297 @@
+/**
+ * @file i2cbus_recovery.cpp
+ * @brief Teste de host da recuperação incremental do I2CBus (injeção de falhas)
+ *
+ * @details Roda o I2CBus do firmware sobre o barramento simulado de
+ *          tools/host, forçando códigos de erro no Wire e o nível de SDA:
+ *          - Classificação dos códigos do Wire (NACK, DATA, TIMEOUT, BUS) e
+ *            pelo probe após Session::fail()
+ *          - Timeout por dispositivo, derivado do tamanho e explícito
+ *          - I2C_RECOVERY_THRESHOLD erros TIMEOUT/BUS seguidos agendam a
+ *            recuperação; NACK não
+ *          - Durante a recuperação: acquire() recusado na hora, submit()
+ *            enfileira e a fila é drenada ao terminar
+ *          - Um passo por service(), esperando o dono atual soltar
+ *          - Escravo que solta SDA após N clocks, SDA livre e SDA preso
+ *            (9 pulsos, falha e backoff de 1 s)
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Compilação
+ * @code{.sh}
+ * g++ -O2 -std=c++17 -pthread -Itools/host -Iinclude -o i2cbus_recovery \
+ *     tools/i2cbus_recovery.cpp src/core/I2CBus/I2CBus.cpp
+ * @endcode
+ *
+ * @note Tempo do barramento controlado por hostClockOffsetMs (sem esperas
+ *       reais longas). Código de saída 1 se alguma verificação falhar
+ */
+
+#include <chrono>
+#include <cstdio>
+
+#include "host_globals.h"
+#include "../src/core/I2CBus/I2CBus.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+typedef I2CBus::Priority P;
+typedef I2CBus::ErrorClass E;
+
+// Espelham as constantes privadas de I2CBus
+constexpr uint32_t RECOVERY_PULSES = 9;
+constexpr uint32_t RECOVERY_SETTLE_MS = 50;
+constexpr uint32_t RECOVERY_BACKOFF_MS = 1000;
+
+int failures = 0;
+int callbacks = 0;
+uint8_t buf[200];
+
+// Escravo preso: segura SDA em LOW até receber stuckPulses clocks
+uint32_t stuckPulses = 0;
+uint32_t sclBase = 0;
+
+void check(bool ok, const char* what) {
+    std::printf("  [%s] %s\n", ok ? " OK " : "FALHA", what);
+    if (!ok) failures++;
+}
+
+void done(const I2CBus::Transaction&, void*) { callbacks++; }
+
+int stuckSlave(uint8_t pin) {
+    if (pin != SENSOR_I2C_SDA) return hostPinLevel[pin];
+    return (hostPinWrites[SENSOR_I2C_SCL] - sclBase) / 2 < stuckPulses ? LOW : HIGH;
+}
+
+/** @brief Prende SDA até pulses clocks (0 = livre, UINT32_MAX = sempre) */
+void holdSda(uint32_t pulses) {
+    stuckPulses = pulses;
+    sclBase = hostPinWrites[SENSOR_I2C_SCL];
+    hostReadHook = stuckSlave;
+}
+
+const I2CBus::DeviceStats* device(uint8_t addr) {
+    I2CBus& bus = I2CBus::instance();
+    for (uint8_t i = 0; i < bus.getDeviceCount(); i++) {
+        if (bus.getDevice(i).addr == addr) return &bus.getDevice(i);
+    }
+    return nullptr;
+}
+
+/** @brief Força o código em 0x76 por I2C_RECOVERY_THRESHOLD leituras */
+void injectErrors(I2CBus& bus, uint8_t code) {
+    Wire.devices[0x76].error = code;
+    for (int i = 0; i < I2C_RECOVERY_THRESHOLD; i++) {
+        I2CBus::Transaction t = I2CBus::readReg(0x76, 0xF7, buf, 6, P::FAST);
+        bus.transfer(t);
+    }
+    Wire.devices[0x76].error = 0;
+}
+
+/** @brief PENDING -> CLOCK -> STOP -> RESTART -> SETTLE -> IDLE; pulsos de SCL no CLOCK */
+uint32_t runRecovery(I2CBus& bus) {
+    bus.service();                                   // PENDING -> CLOCK
+    uint32_t scl = hostPinWrites[SENSOR_I2C_SCL];
+    bus.service();                                   // CLOCK -> STOP
+    uint32_t pulses = (hostPinWrites[SENSOR_I2C_SCL] - scl) / 2;
+    bus.service();                                   // STOP -> RESTART
+    bus.service();                                   // RESTART -> SETTLE
+    hostClockOffsetMs += RECOVERY_SETTLE_MS + 10;
+    bus.service();                                   // SETTLE -> IDLE
+    return pulses;
+}
+
+void testClassify() {
+    std::printf("Classificacao dos codigos do Wire\n");
+    check(I2CBus::classify(0) == E::NONE, "0 -> NONE");
+    check(I2CBus::classify(2) == E::NACK, "2 -> NACK (endereco)");
+    check(I2CBus::classify(1) == E::DATA && I2CBus::classify(3) == E::DATA &&
+              I2CBus::classify(I2CBus::RESULT_SHORT_READ) == E::DATA,
+          "1, 3 e leitura curta -> DATA");
+    check(I2CBus::classify(5) == E::TIMEOUT, "5 -> TIMEOUT");
+    check(I2CBus::classify(4) == E::BUS && I2CBus::classify(0x42) == E::BUS,
+          "4 e desconhecidos -> BUS");
+}
+
+void testTimeouts(I2CBus& bus) {
+    std::printf("Timeout por dispositivo e por transacao\n");
+    bus.setDeviceTimeout(0x69, I2C_TIMEOUT_LONG_MS);
+    {
+        I2CBus::Session s(P::IMU, 0x69);
+        check(Wire.timeoutMs == I2C_TIMEOUT_LONG_MS, "sessao do MPU usa I2C_TIMEOUT_LONG_MS");
+    }
+    {
+        I2CBus::Session s(P::FAST, 0x76);
+        check(Wire.timeoutMs == I2C_TIMEOUT_MS, "demais usam I2C_TIMEOUT_MS");
+    }
+
+    I2CBus::Transaction big = I2CBus::readReg(0x76, 0x00, buf, 200, P::FAST);
+    Wire.timeoutLog.clear();
+    bus.transfer(big);
+    check(!Wire.timeoutLog.empty() && Wire.timeoutLog[0] == 37,
+          "leitura de 200 B: 37 ms derivado do tamanho");
+
+    I2CBus::Transaction quick = I2CBus::readReg(0x76, 0x00, buf, 2, P::FAST);
+    quick.timeoutMs = 4;
+    Wire.timeoutLog.clear();
+    bus.transfer(quick);
+    check(!Wire.timeoutLog.empty() && Wire.timeoutLog[0] == 4, "timeoutMs explicito prevalece");
+}
+
+void testSessionProbe(I2CBus& bus) {
+    std::printf("Falha de sessao classificada pelo probe\n");
+    Wire.devices[0x40].error = 2;
+    {
+        I2CBus::Session s(P::SLOW, 0x40);
+        s.fail();
+    }
+    Wire.devices[0x40].error = 0;
+    {
+        I2CBus::Session s(P::SLOW, 0x40);
+        s.fail();
+    }
+    const I2CBus::DeviceStats* d = device(0x40);
+    check(d != nullptr && d->byClass[(uint8_t)E::NACK] == 1, "dispositivo ausente: NACK");
+    check(d != nullptr && d->byClass[(uint8_t)E::DATA] == 1, "dispositivo responde: DATA");
+    check(!bus.isRecovering(), "NACK/DATA nao agendam recuperacao");
+}
+
+void testThreshold(I2CBus& bus) {
+    std::printf("Erros seguidos agendam a recuperacao\n");
+    Wire.devices[0x76].error = 5;
+    for (int i = 0; i < I2C_RECOVERY_THRESHOLD - 1; i++) {
+        I2CBus::Transaction t = I2CBus::readReg(0x76, 0xF7, buf, 6, P::FAST);
+        bus.transfer(t);
+    }
+    Wire.devices[0x76].error = 0;
+    I2CBus::Transaction ok = I2CBus::readReg(0x76, 0xF7, buf, 6, P::FAST);
+    bus.transfer(ok);
+    check(!bus.isRecovering(), "sucesso no meio zera a sequencia");
+
+    injectErrors(bus, 5);
+    check(device(0x76)->byClass[(uint8_t)E::TIMEOUT] == 2 * I2C_RECOVERY_THRESHOLD - 1,
+          "timeouts contados como TIMEOUT");
+    check(bus.isRecovering(), "I2C_RECOVERY_THRESHOLD timeouts: recuperacao agendada");
+}
+
+void testDuringRecovery(I2CBus& bus) {
+    std::printf("Durante a recuperacao\n");
+    Clock::time_point t0 = Clock::now();
+    bool granted;
+    {
+        I2CBus::Session s(P::IMU, 0x69, 200);
+        granted = (bool)s;
+    }
+    long waited = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now() - t0).count();
+    std::printf("  acquire() recusado em %ld ms\n", waited);
+    check(!granted && waited < 5, "acquire() recusado sem esperar o timeout");
+    check(bus.getRecoveryRejects() == 1, "recusa contada");
+
+    I2CBus::Transaction queued = I2CBus::readReg(0x76, 0xF7, buf, 6, P::FAST);
+    queued.callback = done;
+    check(bus.submit(queued) && callbacks == 0, "submit() enfileira sem executar");
+}
+
+void testSteps(I2CBus& bus) {
+    std::printf("Um passo por service() (SDA livre)\n");
+    holdSda(0);
+    uint32_t ends = Wire.ends;
+    uint32_t begins = Wire.begins;
+
+    bus.service();
+    check(Wire.ends == ends + 1 && Wire.begins == begins, "PENDING -> CLOCK: Wire.end()");
+    uint32_t scl = hostPinWrites[SENSOR_I2C_SCL];
+    bus.service();
+    check(hostPinWrites[SENSOR_I2C_SCL] == scl, "CLOCK: nenhum pulso com SDA livre");
+    bus.service();
+    check(Wire.begins == begins, "STOP: ainda sem Wire.begin()");
+    Wire.timeoutLog.clear();
+    bus.service();
+    check(Wire.begins == begins + 1 && !Wire.timeoutLog.empty() &&
+              Wire.timeoutLog.back() == I2C_TIMEOUT_MS,
+          "RESTART: Wire.begin() e I2C_TIMEOUT_MS");
+    bus.service();
+    check(bus.isRecovering() && callbacks == 0, "SETTLE aguarda 50 ms");
+    hostClockOffsetMs += RECOVERY_SETTLE_MS + 10;
+    bus.service();
+    check(!bus.isRecovering() && bus.getRecoveryCount() == 1, "IDLE: recuperacao contada");
+    check(callbacks == 1, "fila drenada ao terminar");
+    {
+        I2CBus::Session s(P::IMU, 0x69);
+        check((bool)s, "sessoes voltam a ser concedidas");
+    }
+
+    std::printf("Dono atual termina antes\n");
+    {
+        I2CBus::Session s(P::SLOW, 0x40);
+        bus.requestRecovery();
+        ends = Wire.ends;
+        bus.service();
+        check(Wire.ends == ends, "PENDING espera a sessao em curso");
+    }
+    runRecovery(bus);
+    check(Wire.ends == ends + 1, "inicia apos o release()");
+    check(!bus.isRecovering() && bus.getRecoveryCount() == 2, "concluida");
+}
+
+void testStuckSda(I2CBus& bus) {
+    std::printf("Escravo segurando SDA\n");
+    holdSda(3);
+    injectErrors(bus, 4);
+    check(device(0x76)->byClass[(uint8_t)E::BUS] == I2C_RECOVERY_THRESHOLD &&
+              bus.isRecovering(),
+          "erros BUS seguidos agendam a recuperacao");
+    uint32_t pulses = runRecovery(bus);
+    std::printf("  solta apos 3 clocks: %u pulsos\n", (unsigned)pulses);
+    check(pulses == 3, "CLOCK para assim que SDA sobe");
+    check(!bus.isRecovering() && bus.getRecoveryCount() == 3, "recuperado");
+    bus.requestRecovery();
+    check(bus.isRecovering(), "sem falha: nenhum backoff");
+    holdSda(0);
+    runRecovery(bus);
+
+    holdSda(UINT32_MAX);
+    bus.requestRecovery();
+    pulses = runRecovery(bus);
+    std::printf("  preso: %u pulsos\n", (unsigned)pulses);
+    check(pulses == RECOVERY_PULSES, "CLOCK limitado a 9 pulsos");
+    check(!bus.isRecovering() && bus.getRecoveryCount() == 5, "termina mesmo com SDA preso");
+    bus.requestRecovery();
+    check(!bus.isRecovering(), "nova tentativa bloqueada pelo backoff");
+    injectErrors(bus, 5);
+    check(!bus.isRecovering(), "erros durante o backoff nao agendam");
+    hostClockOffsetMs += RECOVERY_BACKOFF_MS;
+    bus.requestRecovery();
+    check(bus.isRecovering(), "permitida apos RECOVERY_BACKOFF_MS");
+    holdSda(0);
+    runRecovery(bus);
+    hostReadHook = nullptr;
+}
+
+} // namespace
+
+int main() {
+    for (uint8_t addr : {0x40, 0x69, 0x76}) Wire.attach(addr);
+
+    I2CBus& bus = I2CBus::instance();
+    bus.begin(&Wire);
+
+    testClassify();
+    testTimeouts(bus);
+    testSessionProbe(bus);
+    testThreshold(bus);
+    testDuringRecovery(bus);
+    testSteps(bus);
+    testStuckSda(bus);
+
+    bus.printStatus();
+    std::printf(failures ? "FALHOU (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file i2cbus_sched.cpp
+ * @brief Teste de host do escalonador do I2CBus (prioridades e inanição)
+ *
+ * @details Roda o I2CBus do firmware com threads do host no papel das
+ *          tasks e o barramento simulado de tools/host:
+ *          - Ordem de concessão por prioridade (IMU > FAST > SLOW >
+ *            BACKGROUND) entre sessões em espera
+ *          - Envelhecimento: BACKGROUND atendida em ~3 x I2C_AGING_MS sob
+ *            tráfego IMU contínuo
+ *          - Fila assíncrona: ordem de prioridade, prazo vencido na fila,
+ *            execução imediata com o barramento livre, reentrância do dono
+ *          - Timeout de sessão contabilizado por prioridade
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Compilação
+ * @code{.sh}
+ * g++ -O2 -std=c++17 -pthread -Itools/host -Iinclude -o i2cbus_sched \
+ *     tools/i2cbus_sched.cpp src/core/I2CBus/I2CBus.cpp
+ * @endcode
+ *
+ * @note Depende de tempo real (esperas de poucos ms): rodar com a máquina
+ *       sem carga pesada. Código de saída 1 se alguma verificação falhar
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "host_globals.h"
+#include "../src/core/I2CBus/I2CBus.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+typedef I2CBus::Priority P;
+
+int failures = 0;
+std::mutex logMutex;
+std::vector<std::string> events;  ///< Ordem em que as sessões/transações rodaram
+
+void check(bool ok, const char* what) {
+    std::printf("  [%s] %s\n", ok ? " OK " : "FALHA", what);
+    if (!ok) failures++;
+}
+
+void note(const std::string& s) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    events.push_back(s);
+}
+
+std::string joined() {
+    std::lock_guard<std::mutex> lock(logMutex);
+    std::string out;
+    for (const std::string& s : events) out += s + " ";
+    return out;
+}
+
+void sleepMs(int ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+/** @brief Task que pede o barramento e o segura por holdMs */
+void session(P prio, uint8_t addr, const char* tag, int holdMs, int timeoutMs) {
+    I2CBus::Session s(prio, addr, timeoutMs);
+    if (s) {
+        note(tag);
+        sleepMs(holdMs);
+    } else {
+        note(std::string("timeout:") + tag);
+    }
+}
+
+/** @brief Callback das transações assíncronas: "<tag>(<resultado>)" */
+void done(const I2CBus::Transaction& txn, void* ctx) {
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%s(%u)", (const char*)ctx, txn.result);
+    note(buf);
+}
+
+void testPriorityOrder() {
+    std::printf("Ordem por prioridade\n");
+    events.clear();
+
+    // BACKGROUND segura; os demais chegam do menos ao mais urgente, com
+    // esperas bem abaixo de I2C_AGING_MS (sem envelhecimento)
+    std::thread a(session, P::BACKGROUND, 0x68, "BACKGROUND", 12, 50);
+    sleepMs(2);
+    std::thread b(session, P::SLOW, 0x40, "SLOW", 1, 200);
+    sleepMs(1);
+    std::thread c(session, P::IMU, 0x69, "IMU", 1, 200);
+    sleepMs(1);
+    std::thread d(session, P::FAST, 0x76, "FAST", 1, 200);
+    a.join(); b.join(); c.join(); d.join();
+
+    std::string got = joined();
+    std::printf("  concessoes: %s\n", got.c_str());
+    check(got == "BACKGROUND IMU FAST SLOW ", "IMU > FAST > SLOW apos o dono atual");
+}
+
+void testStarvation() {
+    std::printf("Envelhecimento (inanicao)\n");
+
+    // Duas tasks IMU alternando sessões de 4 ms sem folga no barramento
+    std::atomic<bool> stop(false);
+    auto hog = [&stop] {
+        while (!stop) {
+            I2CBus::Session s(P::IMU, 0x69, 500);
+            if (s) sleepMs(4);
+        }
+    };
+    std::thread h1(hog), h2(hog);
+    sleepMs(10);
+
+    Clock::time_point t0 = Clock::now();
+    bool granted;
+    {
+        I2CBus::Session s(P::BACKGROUND, 0x68, 500);
+        granted = (bool)s;
+    }
+    long waited = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now() - t0).count();
+    stop = true;
+    h1.join();
+    h2.join();
+
+    std::printf("  BACKGROUND sob trafego IMU continuo: %s em %ld ms (limite %d ms)\n",
+                granted ? "concedida" : "TIMEOUT", waited, 3 * I2C_AGING_MS + 15);
+    check(granted && waited <= 3 * I2C_AGING_MS + 15, "concedida em ~3 x I2C_AGING_MS");
+}
+
+void testAsyncQueue(I2CBus& bus) {
+    std::printf("Fila assincrona\n");
+    events.clear();
+
+    static uint8_t buf[4][2];
+    std::thread holder(session, P::FAST, 0x76, "holder", 30, 50);
+    sleepMs(3);
+
+    I2CBus::Transaction slow = I2CBus::readReg(0x40, 0xE0, buf[0], 2, P::SLOW);
+    slow.callback = done;
+    slow.ctx = (void*)"slow";
+    I2CBus::Transaction imu = I2CBus::readReg(0x69, 0x3B, buf[1], 2, P::IMU);
+    imu.callback = done;
+    imu.ctx = (void*)"imu";
+    I2CBus::Transaction late = I2CBus::probe(0x68, P::BACKGROUND);
+    late.callback = done;
+    late.ctx = (void*)"late";
+    late.deadlineMs = 5;
+    I2CBus::Transaction fast = I2CBus::writeReg(0x5A, 0x05, buf[3], 2, P::FAST);
+    fast.callback = done;
+    fast.ctx = (void*)"fast";
+    check(bus.submit(slow) && bus.submit(imu) && bus.submit(late) && bus.submit(fast),
+          "submit() enfileira com o barramento ocupado");
+    holder.join();
+
+    // late venceu o prazo (5 ms) enquanto o holder segurava 30 ms
+    char expired[16];
+    std::snprintf(expired, sizeof(expired), "late(%u)", I2CBus::RESULT_EXPIRED);
+    std::string got = joined();
+    std::printf("  execucao: %s\n", got.c_str());
+    check(got == "holder imu(0) fast(0) " + std::string(expired) + " slow(0) " ||
+              got == "holder imu(0) fast(0) slow(0) " + std::string(expired) + " ",
+          "prioridade na fila e prazo vencido");
+
+    events.clear();
+    I2CBus::Transaction now = I2CBus::probe(0x40, P::SLOW);
+    now.callback = done;
+    now.ctx = (void*)"now";
+    bus.submit(now);
+    check(joined() == "now(0) ", "barramento livre: executa na hora");
+
+    {
+        I2CBus::Session s(P::FAST, 0x76);
+        I2CBus::Transaction inner = I2CBus::probe(0x76, P::FAST);
+        check(bus.transfer(inner), "transfer() reentrante dentro da sessao do dono");
+    }
+
+    I2CBus::Transaction absent = I2CBus::probe(0x77, P::FAST);
+    check(!bus.transfer(absent) && absent.result == 2, "endereco ausente: NACK (2)");
+}
+
+void testSessionTimeout(I2CBus& bus) {
+    std::printf("Timeout de sessao\n");
+    std::thread holder(session, P::IMU, 0x69, "h", 40, 50);
+    sleepMs(3);
+    uint32_t before = bus.getPriorityStats(P::SLOW).timeouts;
+    {
+        I2CBus::Session s(P::SLOW, 0x40, 10);
+        check(!s, "SLOW nao concedida em 10 ms");
+    }
+    holder.join();
+    check(bus.getPriorityStats(P::SLOW).timeouts == before + 1, "timeout contado em SLOW");
+}
+
+} // namespace
+
+int main() {
+    for (uint8_t addr : {0x40, 0x5A, 0x68, 0x69, 0x76}) Wire.attach(addr);
+
+    I2CBus& bus = I2CBus::instance();
+    bus.begin(&Wire);
+
+    testPriorityOrder();
+    testStarvation();
+    testAsyncQueue(bus);
+    testSessionTimeout(bus);
+
+    bus.printStatus();
+    std::printf(failures ? "FALHOU (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file lzlog_extract.cpp
+ * @brief Descompressor offline dos logs rotacionados comprimidos (.lzs)
+ *
+ * @details Ferramenta de host (PC) que restaura os arquivos
+ *          "<log>.<timestamp>.bak.lzs" gravados pelo LogArchiver:
+ *          - Validação do cabeçalho (CRC-32, versão, parâmetros do codec)
+ *          - Mesmo decodificador do firmware (LogArchive::Decoder)
+ *          - Conferência do tamanho e do CRC-32 do original (trailer)
+ *          - Taxa de compressão e tempo de descompressão em stderr
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Compilação
+ * @code{.sh}
+ * g++ -O2 -std=c++17 -o lzlog_extract tools/lzlog_extract.cpp
+ * @endcode
+ *
+ * ## Uso
+ * @code{.sh}
+ * ./lzlog_extract *.lzs                  # grava <arquivo> sem ".lzs"
+ * ./lzlog_extract -c telemetry.csv.*.lzs > telemetry_antigo.csv
+ * @endcode
+ *
+ * @note Saída incompleta ou com CRC divergente retorna código 2
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../src/storage/LogArchiveFormat.h"
+
+namespace {
+
+constexpr size_t READ_CHUNK = 64 * 1024;  ///< Leitura do .lzs
+
+/** @brief Sink do decodificador: grava no FILE* de saída */
+bool writeOut(const uint8_t* data, size_t len, void* ctx) {
+    return fwrite(data, 1, len, static_cast<FILE*>(ctx)) == len;
+}
+
+/** @brief Tamanho do arquivo aberto */
+long fileSize(FILE* f) {
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    return size;
+}
+
+bool extractFile(const char* path, bool toStdout) {
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        fprintf(stderr, "[lzlog_extract] ERRO: nao foi possivel abrir %s\n", path);
+        return false;
+    }
+
+    long size = fileSize(in);
+    LogArchive::Header h;
+    LogArchive::Trailer tr;
+    bool ok = size >= (long)(sizeof(h) + sizeof(tr)) &&
+              fread(&h, sizeof(h), 1, in) == 1 &&
+              fseek(in, size - sizeof(tr), SEEK_SET) == 0 &&
+              fread(&tr, sizeof(tr), 1, in) == 1;
+    if (!ok || !LogArchive::isValidHeader(h) || tr.magic != LogArchive::TRAILER_MAGIC ||
+        tr.packedSize != size - sizeof(h) - sizeof(tr)) {
+        fprintf(stderr, "[lzlog_extract] ERRO: %s nao e um conteiner .lzs v%u completo\n",
+                path, LogArchive::FORMAT_VERSION);
+        fclose(in);
+        return false;
+    }
+
+    std::string outPath = path;
+    const size_t suffix = strlen(".lzs");
+    if (outPath.size() > suffix && outPath.compare(outPath.size() - suffix, suffix, ".lzs") == 0) {
+        outPath.resize(outPath.size() - suffix);
+    } else {
+        outPath += ".raw";
+    }
+    FILE* out = toStdout ? stdout : fopen(outPath.c_str(), "wb");
+    if (!out) {
+        fprintf(stderr, "[lzlog_extract] ERRO: nao foi possivel criar %s\n", outPath.c_str());
+        fclose(in);
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    static LogArchive::Decoder decoder;
+    decoder.begin(tr.rawSize, writeOut, out);
+    fseek(in, sizeof(h), SEEK_SET);
+    std::vector<uint8_t> chunk(READ_CHUNK);
+    uint32_t remaining = tr.packedSize;
+    while (ok && remaining > 0) {
+        size_t want = remaining < chunk.size() ? remaining : chunk.size();
+        size_t n = fread(chunk.data(), 1, want, in);
+        if (n == 0) {
+            ok = false;
+            break;
+        }
+        ok = decoder.feed(chunk.data(), n);
+        remaining -= n;
+    }
+    ok = decoder.finish() && ok && decoder.crc() == tr.rawCrc32;
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+
+    fclose(in);
+    if (!toStdout) fclose(out);
+
+    if (!ok) {
+        fprintf(stderr, "[lzlog_extract] ERRO: %s corrompido (%lu de %lu bytes, CRC %s)\n",
+                path, (unsigned long)decoder.produced(), (unsigned long)tr.rawSize,
+                decoder.crc() == tr.rawCrc32 ? "ok" : "divergente");
+        return false;
+    }
+
+    double mb = tr.rawSize / 1048576.0;
+    fprintf(stderr, "[lzlog_extract] %s -> %s: %lu -> %lu bytes (%.1f%%), %.1f ms/MB\n",
+            path, toStdout ? "stdout" : outPath.c_str(), (unsigned long)size,
+            (unsigned long)tr.rawSize, tr.rawSize ? 100.0 * size / tr.rawSize : 0.0,
+            mb > 0 ? ms / mb : 0.0);
+    if (h.createdUnix != 0) {
+        fprintf(stderr, "[lzlog_extract]   original: %.48s, comprimido em unix %lu\n",
+                h.sourceName, (unsigned long)h.createdUnix);
+    }
+    return true;
+}
+
+void printUsage() {
+    fprintf(stderr, "Uso: lzlog_extract [-c] arquivo.lzs [arquivo2.lzs ...]\n"
+                    "  -c  escreve em stdout (concatena na ordem dada)\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool toStdout = false;
+    std::vector<const char*> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            toStdout = true;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printUsage();
+            return 0;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    bool ok = true;
+    for (const char* path : inputs) {
+        ok = extractFile(path, toStdout) && ok;
+    }
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file timeindex_query.cpp
+ * @brief Teste de host da consulta por intervalo com o TimeIndex
+ *
+ * @details Grava um log com segundos repetidos (1 a 200 registros por
+ *          segundo) no SD simulado de tools/host, indexado pelo TimeIndex
+ *          do firmware, e consulta como StorageManager::_queryFile():
+ *          - Entradas do índice caem no meio de segundos repetidos
+ *          - Cada segundo consultado sozinho devolve todos os seus
+ *            registros, lendo no máximo SD_INDEX_STRIDE bytes antes do
+ *            primeiro
+ *          - Consulta em fatias com a retomada do QUERY (from = último
+ *            segundo entregue, pulando os já entregues) devolve o log
+ *            inteiro, sem perda nem repetição, para vários tamanhos de fatia
+ *
+ * @author AgroSat Team
+ * @date 2025
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2025 AgroSat Project
+ * @license MIT License
+ *
+ * ## Compilação
+ * @code{.sh}
+ * g++ -O2 -std=c++17 -Itools/host -Iinclude -Isrc -o timeindex_query \
+ *     tools/timeindex_query.cpp src/storage/TimeIndex.cpp
+ * @endcode
+ *
+ * @note Usa um diretório temporário no host. Código de saída 1 se alguma
+ *       verificação falhar
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+#include "host_globals.h"
+#include "SD.h"
+#include "storage/TimeIndex.h"
+
+namespace {
+
+/** @brief Registro de tamanho fixo (o índice só vê offsets) */
+struct Record {
+    uint32_t timestamp;
+    uint32_t seq;
+    uint8_t pad[56];
+};
+
+constexpr const char* LOG_PATH = "/telemetry.bin";
+constexpr uint32_t BASE_TIME = 1760000000;
+constexpr uint32_t PER_STRIDE = SD_INDEX_STRIDE / sizeof(Record);
+constexpr uint32_t PER_SECOND[] = {1, 3, 7, 40, 200, 2, 129, 5};  ///< Ciclo de repetições
+
+int failures = 0;
+std::vector<Record> written;
+
+void check(bool ok, const char* what) {
+    std::printf("  [%s] %s\n", ok ? " OK " : "FALHA", what);
+    if (!ok) failures++;
+}
+
+/** @brief Grava o log e o índice como o caminho de escrita do StorageManager */
+void writeLog() {
+    File file = SD.open(LOG_PATH, FILE_WRITE);
+    TimeIndex idx(LOG_PATH);
+    idx.load(0);
+
+    uint32_t offset = 0;
+    uint32_t seq = 0;
+    uint32_t t = BASE_TIME;
+    for (int cycle = 0; cycle < 12; cycle++) {
+        for (uint32_t n : PER_SECOND) {
+            for (uint32_t i = 0; i < n; i++) {
+                Record r = {};
+                r.timestamp = t;
+                r.seq = seq++;
+                file.write((const uint8_t*)&r, sizeof(r));
+                idx.note(offset, offset, offset + sizeof(r), t);
+                idx.flush();
+                offset += sizeof(r);
+                written.push_back(r);
+            }
+            t++;
+        }
+    }
+    file.close();
+}
+
+/**
+ * @brief Mesma varredura de StorageManager::_queryFile()
+ * @param before [out] Registros lidos antes do primeiro do intervalo
+ * @return false se o visitante parou
+ */
+template <typename Visit>
+bool query(uint32_t fromUnix, uint32_t toUnix, Visit visit, uint32_t* before = nullptr) {
+    char idxPath[48];
+    snprintf(idxPath, sizeof(idxPath), "%s%s", LOG_PATH, SD_INDEX_SUFFIX);
+    uint32_t offset = 0;
+    TimeIndex::lookup(idxPath, fromUnix, offset);
+
+    File file = SD.open(LOG_PATH, FILE_READ);
+    file.seek(offset);
+    uint32_t skipped = 0;
+    Record r;
+    bool more = true;
+    while (file.read((uint8_t*)&r, sizeof(r)) == sizeof(r)) {
+        if (r.timestamp < fromUnix) {
+            skipped++;
+            continue;
+        }
+        if (r.timestamp > toUnix) break;
+        if (!visit(r)) {
+            more = false;
+            break;
+        }
+    }
+    file.close();
+    if (before != nullptr) *before = skipped;
+    return more;
+}
+
+/** @brief Entradas do .idx que caem depois do primeiro registro do seu segundo */
+uint32_t entriesInsideSeconds() {
+    char idxPath[48];
+    snprintf(idxPath, sizeof(idxPath), "%s%s", LOG_PATH, SD_INDEX_SUFFIX);
+    File file = SD.open(idxPath, FILE_READ);
+    uint32_t inside = 0;
+    TimeIndex::Entry e;
+    while (file.read((uint8_t*)&e, sizeof(e)) == sizeof(e)) {
+        uint32_t i = e.offset / sizeof(Record);
+        if (i > 0 && written[i - 1].timestamp == e.unixTime) inside++;
+    }
+    file.close();
+    return inside;
+}
+
+void testSingleSeconds() {
+    std::printf("Cada segundo consultado sozinho\n");
+    uint32_t inside = entriesInsideSeconds();
+    std::printf("  %u registros, %u entradas no meio de um segundo repetido\n",
+                (unsigned)written.size(), (unsigned)inside);
+    check(inside > 0, "indice tem entradas no meio de segundos repetidos");
+
+    uint32_t last = written.back().timestamp;
+    uint32_t wrong = 0;
+    uint32_t worstBefore = 0;
+    for (uint32_t t = BASE_TIME; t <= last; t++) {
+        uint32_t expected = 0;
+        for (const Record& r : written) expected += (r.timestamp == t);
+        uint32_t got = 0;
+        uint32_t before = 0;
+        query(t, t, [&](const Record&) { got++; return true; }, &before);
+        if (got != expected) wrong++;
+        if (before > worstBefore) worstBefore = before;
+    }
+    std::printf("  segundos incompletos: %u; maior leitura antes do intervalo: %u registros\n",
+                (unsigned)wrong, (unsigned)worstBefore);
+    check(wrong == 0, "todos os registros de cada segundo");
+    check(worstBefore <= PER_STRIDE, "le no maximo SD_INDEX_STRIDE antes do primeiro");
+}
+
+/** @brief Retomada de TelemetryManager::_runQueryChunk()/visitStoredRecord() */
+bool chunked(uint32_t chunk) {
+    uint32_t from = BASE_TIME;
+    uint32_t to = written.back().timestamp;
+    uint32_t skip = 0;
+    std::vector<uint32_t> seqs;
+
+    for (int guard = 0; guard < 100000; guard++) {
+        uint32_t skipTs = from, pending = skip, lastTs = from, atLastTs = skip, count = 0;
+        query(from, to, [&](const Record& r) {
+            if (pending > 0 && r.timestamp == skipTs) {
+                pending--;
+                return true;
+            }
+            seqs.push_back(r.seq);
+            if (r.timestamp == lastTs) {
+                atLastTs++;
+            } else {
+                lastTs = r.timestamp;
+                atLastTs = 1;
+            }
+            return ++count < chunk;
+        });
+        if (count < chunk) break;
+        from = lastTs;
+        skip = atLastTs;
+    }
+
+    if (seqs.size() != written.size()) return false;
+    for (size_t i = 0; i < seqs.size(); i++) {
+        if (seqs[i] != i) return false;
+    }
+    return true;
+}
+
+void testChunks() {
+    std::printf("Consulta em fatias (retomada do QUERY)\n");
+    char what[64];
+    for (uint32_t chunk : {1u, 5u, 50u, PER_STRIDE, 150u}) {
+        snprintf(what, sizeof(what), "fatias de %u: log inteiro, em ordem", (unsigned)chunk);
+        check(chunked(chunk), what);
+    }
+}
+
+} // namespace
+
+int main() {
+    char dir[] = "/tmp/timeindex_queryXXXXXX";
+    if (mkdtemp(dir) == nullptr) {
+        std::printf("Sem diretorio temporario\n");
+        return 1;
+    }
+    hostSdRoot = dir;
+
+    writeLog();
+    testSingleSeconds();
+    testChunks();
+
+    char idxPath[48];
+    snprintf(idxPath, sizeof(idxPath), "%s%s", LOG_PATH, SD_INDEX_SUFFIX);
+    SD.remove(LOG_PATH);
+    SD.remove(idxPath);
+    rmdir(dir);
+
+    std::printf(failures ? "FALHOU (%d)\n" : "OK\n", failures);
+    return failures ? 1 : 0;
+}